@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_PROFILING_ALLOCATION_COUNTER_H
+#define YARP_PROFILING_ALLOCATION_COUNTER_H
+
+// Counts the heap allocations of a profiling program, by replacing the
+// global operator new.  Include it in a single file of the program.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace allocation_counter {
+// Count the allocations of all the threads
+std::atomic<bool> counting{false};
+// Count the allocations of the calling thread
+thread_local bool countingThread = false;
+std::atomic<size_t> allocations{0};
+} // namespace allocation_counter
+
+void* operator new(size_t size)
+{
+    if (allocation_counter::counting || allocation_counter::countingThread) {
+        allocation_counter::allocations++;
+    }
+    void* p = std::malloc(size > 0 ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+#endif // YARP_PROFILING_ALLOCATION_COUNTER_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/DummyConnector.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <cstdio>
+
+using namespace yarp::os;
+
+// Numeric bottle test.
+// Time the steps that a large Bottle of doubles (e.g. the readings of a
+// skin patch) goes through: filled and serialized by the sender, read by
+// the receiver, its values accessed, and copied.  There is no network
+// involved, only the Bottle code.
+
+// Parameters:
+// --size: number of doubles in the bottle (default: 4000)
+// --nframes: how many times each step is repeated (default: 2000)
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int size = p.check("size", Value(4000)).asInt32();
+    int nframes = p.check("nframes", Value(2000)).asInt32();
+
+    Bottle b;
+    DummyConnector con;
+    double start = SystemClock::nowSystem();
+    for (int k = 0; k < nframes; k++) {
+        b.clear();
+        for (int i = 0; i < size; i++) {
+            b.addFloat64(i * 0.001);
+        }
+        con.reset();
+        b.write(con.getWriter());
+    }
+    double fill = SystemClock::nowSystem() - start;
+
+    Bottle b2;
+    start = SystemClock::nowSystem();
+    for (int k = 0; k < nframes; k++) {
+        b2.read(con.getReader());
+    }
+    double read = SystemClock::nowSystem() - start;
+
+    double sum = 0;
+    start = SystemClock::nowSystem();
+    for (int k = 0; k < nframes; k++) {
+        b2.read(con.getReader());
+        for (size_t i = 0; i < b2.size(); i++) {
+            sum += b2.get(i).asFloat64();
+        }
+    }
+    double access = SystemClock::nowSystem() - start;
+
+    Bottle b3;
+    b2.read(con.getReader());
+    start = SystemClock::nowSystem();
+    for (int k = 0; k < nframes; k++) {
+        b3 = b2;
+    }
+    double copy = SystemClock::nowSystem() - start;
+
+    printf("%d doubles, time for each bottle (checksum %g):\n", size, sum);
+    printf("  fill and write   %8.2f us\n", fill * 1e6 / nframes);
+    printf("  read             %8.2f us\n", read * 1e6 / nframes);
+    printf("  read and access  %8.2f us\n", access * 1e6 / nframes);
+    printf("  copy             %8.2f us\n", copy * 1e6 / nframes);
+    return 0;
+}
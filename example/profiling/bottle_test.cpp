@@ -51,6 +51,40 @@ void copy_test() {
     printf("(but use proper profiling, not this message)\n");
 }
 
+void parse_test() {
+    // a configuration with 10000 items, most of them in nested lists
+    Bottle config;
+    for (int i=0; i<1000; i++) {
+        Bottle& group = config.addList();
+        group.addString("group");
+        group.addInt32(i);
+        Bottle& gains = group.addList();
+        gains.addString("gains");
+        gains.addFloat64(0.5);
+        gains.addInt32(10);
+        Bottle& name = group.addList();
+        name.addString("name");
+        name.addString("joint");
+        name.addVocab(createVocab('p','o','s'));
+    }
+    std::string text = config.toString();
+    DummyConnector con;
+    config.write(con.getWriter());
+
+    Bottle b;
+    double start = SystemClock::nowSystem();
+    for (int i=0; i<200; i++) {
+        b.read(con.getReader());
+    }
+    double mid = SystemClock::nowSystem();
+    for (int i=0; i<200; i++) {
+        b.fromString(text);
+    }
+    double stop = SystemClock::nowSystem();
+    printf("Reading %zu items took about %g ms (binary), %g ms (text)\n",
+           config.size() * 10, (mid-start)*1000/200, (stop-mid)*1000/200);
+}
+
 int main() {
     printf("We don't recommend you use Bottles for large data structures\n");
     printf("But if you did, what parts gets slow first?\n");
@@ -59,5 +93,6 @@ int main() {
 
     net_test();
     //copy_test();
+    //parse_test();
     return 0;
 }
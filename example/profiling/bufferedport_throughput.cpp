@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "allocation_counter.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace yarp::os;
+
+// BufferedPort throughput test.
+// Unlike port_throughput, the sender does not wait for each message to be
+// read: a thread streams messages from a Port to a strict BufferedPort in
+// the same process, while the main thread reads them as fast as possible.
+// Report how many messages per second go through the reader buffer, and
+// how many heap allocations (in the whole process) each message costs, e.g.:
+//   ./bufferedport_throughput --max_buffer 16
+
+// Parameters:
+// --size: number of elements of the bottle (default: 10)
+// --nframes: how many messages are sent (default: 100000)
+// --max_buffer: messages kept by the BufferedPort, 0 = no limit (default: 0)
+// --carrier: carrier used for the connection (default: tcp)
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+    yarp.setLocalMode(true);
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int size = p.check("size", Value(10)).asInt32();
+    int nframes = p.check("nframes", Value(100000)).asInt32();
+    int maxBuffer = p.check("max_buffer", Value(0)).asInt32();
+    std::string carrier = p.check("carrier", Value("tcp")).asString();
+
+    BufferedPort<Bottle> in(static_cast<unsigned int>(maxBuffer));
+    Port out;
+    in.setStrict();
+    if (!in.open("/profiling/throughput/in") || !out.open("/profiling/throughput/out")) {
+        fprintf(stderr, "Cannot open ports\n");
+        return 1;
+    }
+    if (!Network::connect(out.getName(), in.getName(), carrier)) {
+        fprintf(stderr, "Cannot connect with carrier %s\n", carrier.c_str());
+        return 1;
+    }
+
+    Bottle datum;
+    for (int i = 0; i < size; i++) {
+        datum.addFloat64(i * 0.5);
+    }
+
+    // warm up
+    for (int i = 0; i < 100; i++) {
+        out.write(datum);
+        in.read();
+    }
+
+    double start = SystemClock::nowSystem();
+    allocation_counter::counting = true;
+    std::thread writer([&]() {
+        for (int i = 0; i < nframes; i++) {
+            out.write(datum);
+        }
+    });
+    for (int i = 0; i < nframes; i++) {
+        in.read();
+    }
+    allocation_counter::counting = false;
+    double elapsed = SystemClock::nowSystem() - start;
+    writer.join();
+
+    printf("%d messages in %.3f s: %.1f msg/s, %.2f allocations/msg\n",
+           nframes,
+           elapsed,
+           nframes / elapsed,
+           static_cast<double>(allocation_counter::allocations) / nframes);
+
+    out.close();
+    in.close();
+    return 0;
+}
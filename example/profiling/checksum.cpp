@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/NetType.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <cstdio>
+#include <vector>
+
+using namespace yarp::os;
+
+// Checksum speed test.
+// Compute the checksums available for datagrams (NetType::getCrc and
+// NetType::getCrc32c) over buffers of the given size, and report how long
+// each call takes and how many bytes per second are processed.
+
+// Parameters:
+// --size: size of the buffer in bytes (default: 65499, the largest
+//         datagram sent by the udp and mcast carriers)
+// --count: how many times each checksum is computed (default: 20000)
+
+int main(int argc, char** argv)
+{
+    Property p;
+    p.fromCommand(argc, argv);
+    int size = p.check("size", Value(65499)).asInt32();
+    int count = p.check("count", Value(20000)).asInt32();
+
+    std::vector<char> buf(size);
+    for (int i = 0; i < size; i++) {
+        buf[i] = static_cast<char>(i * 7 + 3);
+    }
+
+    unsigned long sink = 0;
+
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < count; i++) {
+        sink += NetType::getCrc(buf.data(), buf.size());
+    }
+    double crc32 = SystemClock::nowSystem() - start;
+
+    start = SystemClock::nowSystem();
+    for (int i = 0; i < count; i++) {
+        sink += NetType::getCrc32c(buf.data(), buf.size());
+    }
+    double crc32c = SystemClock::nowSystem() - start;
+
+    printf("%d checksums of %d bytes (%lx)\n", count, size, sink);
+    printf("crc32:  %8.2f us per call, %8.1f MB/s\n", crc32 / count * 1e6, static_cast<double>(size) * count / crc32 / 1e6);
+    printf("crc32c: %8.2f us per call, %8.1f MB/s\n", crc32c / count * 1e6, static_cast<double>(size) * count / crc32c / 1e6);
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "allocation_counter.h"
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <yarp/dev/IMultipleWrapper.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+
+// ControlBoardWrapper cycle test.
+// Attach a controlboardwrapper2 to some fakeMotionControl boards, and read
+// all the joints the way the wrapper thread does for each message it
+// publishes.  Then report the heap allocations done by each cycle once
+// the wrapper is running, and the distribution of the cycle time, e.g.:
+//   ./controlboardwrapper_cycle --subdevices 6 --joints 6
+
+// Parameters:
+// --subdevices: number of fakeMotionControl boards (default: 6)
+// --joints: number of joints of each board (default: 6)
+// --cycles: number of cycles measured (default: 10000)
+// --period: period of the wrapper thread [ms] (default: 1)
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+    yarp.setLocalMode(true);
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int nsubdevices = p.check("subdevices", Value(6)).asInt32();
+    int njoints = p.check("joints", Value(6)).asInt32();
+    int ncycles = p.check("cycles", Value(10000)).asInt32();
+    int period = p.check("period", Value(1)).asInt32();
+    int controlledJoints = nsubdevices * njoints;
+
+    std::vector<std::unique_ptr<PolyDriver>> boards;
+    PolyDriverList list;
+    std::string networks;
+    std::string mapping;
+    for (int i = 0; i < nsubdevices; i++) {
+        Property boardConfig;
+        boardConfig.put("device", "fakeMotionControl");
+        boardConfig.addGroup("GENERAL").put("Joints", njoints);
+        boards.emplace_back(new PolyDriver);
+        if (!boards.back()->open(boardConfig)) {
+            fprintf(stderr, "cannot open fakeMotionControl\n");
+            return 1;
+        }
+        std::string net = "net" + std::to_string(i);
+        networks += " " + net;
+        mapping += "(" + net + " (" + std::to_string(i * njoints) + " " + std::to_string((i + 1) * njoints - 1) + " 0 " + std::to_string(njoints - 1) + ")) ";
+        list.push(boards.back().get(), net.c_str());
+    }
+    Property wrapperConfig;
+    wrapperConfig.fromString(mapping + "(networks (" + networks + "))");
+    wrapperConfig.put("device", "controlboardwrapper2");
+    wrapperConfig.put("name", "/profiling/controlboard");
+    wrapperConfig.put("period", period);
+    wrapperConfig.put("joints", controlledJoints);
+
+    PolyDriver wrapper;
+    IMultipleWrapper* iwrap = nullptr;
+    if (!wrapper.open(wrapperConfig) || !wrapper.view(iwrap) || !iwrap->attachAll(list)) {
+        fprintf(stderr, "cannot open controlboardwrapper2\n");
+        return 1;
+    }
+
+    IEncodersTimed* enc = nullptr;
+    IMotorEncoders* motEnc = nullptr;
+    ITorqueControl* trq = nullptr;
+    IPWMControl* pwm = nullptr;
+    ICurrentControl* curr = nullptr;
+    IControlMode* mode = nullptr;
+    IInteractionMode* interact = nullptr;
+    wrapper.view(enc);
+    wrapper.view(motEnc);
+    wrapper.view(trq);
+    wrapper.view(pwm);
+    wrapper.view(curr);
+    wrapper.view(mode);
+    wrapper.view(interact);
+
+    std::vector<double> values(controlledJoints);
+    std::vector<double> times(controlledJoints);
+    std::vector<int> modes(controlledJoints);
+    std::vector<InteractionModeEnum> imodes(controlledJoints);
+    std::vector<double> durations(ncycles);
+
+    auto cycle = [&]() {
+        enc->getEncodersTimed(values.data(), times.data());
+        enc->getEncoderSpeeds(values.data());
+        enc->getEncoderAccelerations(values.data());
+        motEnc->getMotorEncoders(values.data());
+        motEnc->getMotorEncoderSpeeds(values.data());
+        motEnc->getMotorEncoderAccelerations(values.data());
+        trq->getTorques(values.data());
+        pwm->getDutyCycles(values.data());
+        curr->getCurrents(values.data());
+        mode->getControlModes(modes.data());
+        interact->getInteractionModes(imodes.data());
+    };
+
+    // warm up, while the wrapper thread publishes the state
+    for (int i = 0; i < 100; i++) {
+        cycle();
+    }
+
+    allocation_counter::countingThread = true;
+    for (int i = 0; i < ncycles; i++) {
+        double start = SystemClock::nowSystem();
+        cycle();
+        durations[i] = SystemClock::nowSystem() - start;
+    }
+    allocation_counter::countingThread = false;
+
+    std::sort(durations.begin(), durations.end());
+    auto percentile = [&](double fraction) {
+        return durations[static_cast<size_t>(fraction * (ncycles - 1))] * 1e6;
+    };
+    printf("joints: %d in %d subdevices\n", controlledJoints, nsubdevices);
+    printf("allocations per cycle: %.2f\n", static_cast<double>(allocation_counter::allocations) / ncycles);
+    printf("cycle time [us]: p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+           percentile(0.5), percentile(0.9), percentile(0.99), durations.back() * 1e6);
+
+    wrapper.close();
+    for (auto& board : boards) {
+        board->close();
+    }
+    return 0;
+}
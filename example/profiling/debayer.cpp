@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/impl/Demosaic.h>
+
+#include <cstdio>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::sig::impl;
+
+// Debayer test.
+// Time the conversion of a bayer image to rgb, with each method and with
+// a growing number of threads.
+
+// Parameters:
+// --width, --height: the size of the image (default: 2592x1944, 5 MP)
+// --threads: the maximum number of threads (default: 4)
+// --repeat: conversions for each test (default: 20)
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+    size_t width = p.check("width", Value(2592)).asInt32();
+    size_t height = p.check("height", Value(1944)).asInt32();
+    size_t maxThreads = p.check("threads", Value(4)).asInt32();
+    int repeat = p.check("repeat", Value(20)).asInt32();
+
+    ImageOf<PixelMono> src;
+    src.resize(width, height);
+    unsigned int seed = 1;
+    for (size_t y = 0; y < src.height(); y++) {
+        for (size_t x = 0; x < src.width(); x++) {
+            seed = seed * 1103515245 + 12345;
+            src.pixel(x, y) = static_cast<unsigned char>(seed >> 16);
+        }
+    }
+    ImageOf<PixelRgb> full;
+    full.resize(width, height);
+    ImageOf<PixelRgb> half;
+    half.resize(width / 2, height / 2);
+
+    printf("%zux%zu, time for each conversion in ms:\n", width, height);
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double start = SystemClock::nowSystem();
+        for (int i = 0; i < repeat; i++) {
+            demosaic(src.getRawImage(), src.getRowSize(),
+                     full.getRawImage(), full.getRowSize(), VOCAB_PIXEL_RGB,
+                     width, height, BayerOrder::GRBG, DemosaicMethod::Bilinear, threads);
+        }
+        double bilinear = (SystemClock::nowSystem() - start) / repeat;
+
+        start = SystemClock::nowSystem();
+        for (int i = 0; i < repeat; i++) {
+            demosaic(src.getRawImage(), src.getRowSize(),
+                     full.getRawImage(), full.getRowSize(), VOCAB_PIXEL_RGB,
+                     width, height, BayerOrder::GRBG, DemosaicMethod::EdgeAware, threads);
+        }
+        double edgeAware = (SystemClock::nowSystem() - start) / repeat;
+
+        start = SystemClock::nowSystem();
+        for (int i = 0; i < repeat; i++) {
+            demosaicHalf(src.getRawImage(), src.getRowSize(),
+                         half.getRawImage(), half.getRowSize(), VOCAB_PIXEL_RGB,
+                         width, height, BayerOrder::GRBG, threads);
+        }
+        double halfSize = (SystemClock::nowSystem() - start) / repeat;
+
+        printf("  threads %zu: bilinear %8.2f  edge aware %8.2f  half %8.2f\n",
+               threads, bilinear * 1e3, edgeAware * 1e3, halfSize * 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace yarp::os;
+
+// Delta portmonitor test.
+// Send the state of a robot through a plain tcp connection and through
+// a connection using the "delta" portmonitor, and report the bytes sent
+// for each message and the CPU time spent for each message.
+//
+// The state is read from a log written by yarpdatadumper, e.g.:
+//   yarpdatadumper --name /dump --dir state &
+//   yarp connect /icub/left_arm/stateExt:o /dump
+//   ./delta_state --file state/data.log
+// Without a log, the state of a robot with --joints joints is made up:
+// positions read by an encoder, velocities, torques, and the control and
+// interaction modes, half of the joints moving and the others still.
+
+// Parameters:
+// --file: yarpdatadumper log to send (default: none)
+// --skip: values at the start of each line of the log that are not part
+//         of the message, i.e. counter and time stamps (default: 2)
+// --joints: joints of the made up robot (default: 32)
+// --nframes: messages sent, when not reading a log (default: 5000)
+// --keyframe: keyframe interval of the delta portmonitor (default: 50)
+
+namespace {
+
+std::vector<Bottle> readLog(const std::string& filename, int skip)
+{
+    std::vector<Bottle> frames;
+    std::ifstream log(filename);
+    std::string line;
+    while (std::getline(log, line)) {
+        Bottle b(line);
+        if (b.size() <= static_cast<size_t>(skip)) {
+            continue;
+        }
+        frames.emplace_back();
+        for (size_t i = skip; i < b.size(); i++) {
+            frames.back().add(b.get(i));
+        }
+    }
+    return frames;
+}
+
+std::vector<Bottle> makeState(int joints, int nframes)
+{
+    std::vector<Bottle> frames;
+    std::mt19937 gen(42);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    const double resolution = 360.0 / 4096; // 12 bits encoders
+    for (int t = 0; t < nframes; t++) {
+        Bottle frame;
+        Bottle& pos = frame.addList();
+        Bottle& vel = frame.addList();
+        Bottle& trq = frame.addList();
+        Bottle& modes = frame.addList();
+        Bottle& interaction = frame.addList();
+        for (int j = 0; j < joints; j++) {
+            bool moving = (j % 2 == 0);
+            double q = 10.0 * j + (moving ? 30.0 * std::sin(0.002 * t * (j + 1)) : 0.0);
+            q = std::round(q / resolution) * resolution;
+            pos.addFloat64(q);
+            vel.addFloat64(moving ? 30.0 * 0.002 * (j + 1) * std::cos(0.002 * t * (j + 1)) : 0.0);
+            trq.addFloat64(0.5 * j + noise(gen));
+            modes.addVocab(moving ? createVocab('p', 'o', 's', 'd') : createVocab('i', 'd', 'l'));
+            interaction.addVocab(createVocab('s', 't', 'i', 'f'));
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+std::int64_t bytesTo(const Port& out, const std::string& name)
+{
+    Bottle cmd("stat " + name);
+    Bottle reply;
+    if (!Network::write(out.getName(), cmd, reply, true)) {
+        return -1;
+    }
+    for (size_t i = 0; i < reply.size(); i++) {
+        Bottle* connection = reply.get(i).asList();
+        if (connection != nullptr && connection->get(1).asString() == name) {
+            return connection->find("bytes").asInt64();
+        }
+    }
+    return -1;
+}
+
+bool run(const char* label, const std::vector<Bottle>& frames, const std::string& carrier)
+{
+    Port out;
+    BufferedPort<Bottle> in;
+    in.setStrict();
+    if (!out.open("/profiling/delta/o") || !in.open("/profiling/delta/i")) {
+        fprintf(stderr, "Cannot open ports\n");
+        return false;
+    }
+    if (!Network::connect(out.getName(), in.getName(), carrier)) {
+        fprintf(stderr, "Cannot connect with carrier %s\n", carrier.c_str());
+        return false;
+    }
+
+    int wrong = 0;
+    std::clock_t start = std::clock();
+    for (const auto& frame : frames) {
+        out.write(frame);
+        Bottle* received = in.read();
+        if (received == nullptr || received->toString() != frame.toString()) {
+            wrong++;
+        }
+    }
+    double cpu = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    std::int64_t bytes = bytesTo(out, in.getName());
+
+    printf("%-6s %6zu messages: %8.1f bytes/message, %6.1f us CPU/message, %d wrong\n",
+           label,
+           frames.size(),
+           static_cast<double>(bytes) / frames.size(),
+           cpu * 1e6 / frames.size(),
+           wrong);
+
+    in.close();
+    out.close();
+    return wrong == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+    Network::setLocalMode(true);
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int skip = p.check("skip", Value(2)).asInt32();
+    int joints = p.check("joints", Value(32)).asInt32();
+    int nframes = p.check("nframes", Value(5000)).asInt32();
+    int keyframe = p.check("keyframe", Value(50)).asInt32();
+
+    std::vector<Bottle> frames;
+    if (p.check("file")) {
+        frames = readLog(p.find("file").asString(), skip);
+        if (frames.empty()) {
+            fprintf(stderr, "Nothing to send in %s\n", p.find("file").asString().c_str());
+            return 1;
+        }
+    } else {
+        frames = makeState(joints, nframes);
+    }
+
+    bool ok = run("tcp", frames, "tcp");
+    ok &= run("delta", frames, "tcp+send.portmonitor+recv.portmonitor+type.dll+file.delta+keyframe." + std::to_string(keyframe));
+    return ok ? 0 : 1;
+}
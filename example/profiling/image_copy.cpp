@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Vocab.h>
+#include <yarp/sig/Image.h>
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Image conversion test.
+// Time Image::copy() between all the pairs of pixel types, at a few
+// resolutions, and print the time for each copy.
+
+// Parameters:
+// --width, --height: a single resolution to test (default: 320x240,
+//                    640x480 and 1920x1080)
+// --repeat: copies of each image (default: 10)
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int repeat = p.check("repeat", Value(10)).asInt32();
+
+    std::vector<std::pair<size_t, size_t>> sizes {{320, 240}, {640, 480}, {1920, 1080}};
+    if (p.check("width") && p.check("height")) {
+        sizes = {{static_cast<size_t>(p.find("width").asInt32()), static_cast<size_t>(p.find("height").asInt32())}};
+    }
+
+    // VOCAB_PIXEL_RGB_SIGNED and VOCAB_PIXEL_HSV_FLOAT images cannot be
+    // allocated (there is no IPL header for them)
+    const int codes[] = {
+        VOCAB_PIXEL_MONO,
+        VOCAB_PIXEL_MONO16,
+        VOCAB_PIXEL_RGB,
+        VOCAB_PIXEL_RGBA,
+        VOCAB_PIXEL_BGRA,
+        VOCAB_PIXEL_HSV,
+        VOCAB_PIXEL_BGR,
+        VOCAB_PIXEL_MONO_SIGNED,
+        VOCAB_PIXEL_MONO_FLOAT,
+        VOCAB_PIXEL_RGB_FLOAT,
+        VOCAB_PIXEL_INT,
+        VOCAB_PIXEL_RGB_INT
+    };
+
+    for (const auto& size : sizes) {
+        printf("%zux%zu, time for each copy in us:\n", size.first, size.second);
+        for (int from : codes) {
+            FlexImage src;
+            src.setPixelCode(from);
+            src.resize(size.first, size.second);
+            for (size_t y = 0; y < src.height(); y++) {
+                for (size_t x = 0; x < src.getRowSize(); x++) {
+                    src.getRow(y)[x] = static_cast<unsigned char>(x + y);
+                }
+            }
+            for (int to : codes) {
+                FlexImage dest;
+                dest.setPixelCode(to);
+                dest.resize(size.first, size.second);
+                double start = SystemClock::nowSystem();
+                for (int i = 0; i < repeat; i++) {
+                    dest.copy(src);
+                }
+                double t = (SystemClock::nowSystem() - start) / repeat;
+                printf("  %-6s -> %-6s %10.1f\n",
+                       Vocab::decode(from).c_str(),
+                       Vocab::decode(to).c_str(),
+                       t * 1e6);
+            }
+        }
+    }
+    return 0;
+}
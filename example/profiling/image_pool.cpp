@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/ImageBufferPool.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Image allocation test.
+// Simulate a stream of frames: each frame is a new image, resized,
+// filled and destroyed, as a reader of a video stream does.  Print the
+// time for each frame with the image buffer pool enabled and disabled.
+
+// Parameters:
+// --width, --height: size of the frames (default: 1920x1080)
+// --frames: number of frames (default: 200)
+
+namespace {
+double stream(size_t width, size_t height, int frames)
+{
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < frames; i++) {
+        ImageOf<PixelRgb> img;
+        img.resize(width, height);
+        memset(img.getRawImage(), i, img.getRawImageSize());
+    }
+    return (SystemClock::nowSystem() - start) / frames;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+    size_t width = p.check("width", Value(1920)).asInt32();
+    size_t height = p.check("height", Value(1080)).asInt32();
+    int frames = p.check("frames", Value(200)).asInt32();
+
+    ImageBufferPool& pool = ImageBufferPool::getInstance();
+    size_t capacity = pool.getCapacity();
+
+    pool.setCapacity(0);
+    double heap = stream(width, height, frames);
+
+    pool.setCapacity(capacity);
+    double pooled = stream(width, height, frames);
+    ImageBufferPool::Statistics stats = pool.getStatistics();
+
+    printf("%zux%zu rgb, time for each frame in us:\n", width, height);
+    printf("  without pool %10.1f\n", heap * 1e6);
+    printf("  with pool    %10.1f\n", pooled * 1e6);
+    printf("pool: %zu allocations, %zu reuses, %zu bytes cached, %zu bytes in huge pages\n",
+           stats.allocations,
+           stats.reuses,
+           stats.bytesCached,
+           stats.bytesHugePages);
+    return 0;
+}
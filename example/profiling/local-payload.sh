@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+# All rights reserved.
+#
+# This software may be modified and distributed under the terms of the
+# BSD-3-Clause license. See the accompanying LICENSE file for details.
+
+# Compare the latency of the carriers usable between two processes on the
+# same machine, for increasing payloads (6220800 bytes is a 1080p rgb image).
+# The ring size of "shmem+ring" can be changed with i.e. "shmem+ring+size.16777216"
+
+PROTOCOLS="tcp shmem shmem+ring"
+PAYLOAD="125 1000 8000 64000 512000 1000000 2000000 4000000 6220800"
+PL_VERBOSE=(125 1k 8k 64k 512k 1M 2M 4M 1080p)
+RATE=10
+NFRAMES=1000
+
+CLIENT_PORT=/profiling/client/end/port:i
+SERVER_PORT=/profiling/server/default/port:o
+
+k=0
+for payload in $PAYLOAD
+do
+    for protocol in $PROTOCOLS
+    do
+        echo "Starting server"
+        ./port_latency --server --period $RATE --payload $payload &
+        jobServer=$!
+
+        yarp wait $SERVER_PORT
+        echo "Ok server exists"
+        echo "Starting client"
+        ./port_latency --client --name end --nframes $NFRAMES &
+        jobClient=$!
+
+        yarp wait $CLIENT_PORT
+        yarp connect $SERVER_PORT $CLIENT_PORT $protocol
+
+        echo "Now waiting for test"
+        wait $jobClient
+
+        echo "Now killing server"
+        kill $jobServer
+
+        echo "Moving report file"
+        reportFile="rep-${PL_VERBOSE[$k]}-$protocol.txt"
+        mv timing.txt $reportFile
+    done
+    k=$(($k+1))
+done
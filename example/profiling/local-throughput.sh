@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+# All rights reserved.
+#
+# This software may be modified and distributed under the terms of the
+# BSD-3-Clause license. See the accompanying LICENSE file for details.
+
+# Measure the throughput of a local connection and the number of system
+# calls used to write each message, for bottles, vectors and images.
+# Requires strace.
+
+CARRIER=${1:-tcp}
+NFRAMES=10000
+TESTS=("bottle 10" "bottle 1000" "vector 10" "vector 10000" "image 64" "image 640")
+
+for test in "${TESTS[@]}"
+do
+    set -- $test
+    type=$1
+    size=$2
+    echo "== $type, size $size, carrier $CARRIER"
+    strace -f -c -o strace.txt ./port_throughput --type $type --size $size --nframes $NFRAMES --carrier $CARRIER
+    # write, writev, sendto and sendmsg calls, including the warm up messages
+    awk -v n=$((NFRAMES + 100)) '$NF ~ /^(write|writev|sendto|sendmsg)$/ { calls += $4 } END { printf "write syscalls per message: %.2f\n", calls / n }' strace.txt
+done
+rm -f strace.txt
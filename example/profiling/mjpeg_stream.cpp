@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Mjpeg streaming test.
+// Send images from one port to a few receivers connected with the mjpeg
+// carrier, and print the time for each frame (compression, transmission
+// and decompression).
+
+// Parameters:
+// --width, --height: size of the images (default: 1920x1080)
+// --receivers: number of receivers (default: 4)
+// --carrier: the carrier, with its parameters (default: mjpeg)
+// --frames: number of frames (default: 50)
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+    Network::setLocalMode(true);
+
+    Property p;
+    p.fromCommand(argc, argv);
+    size_t width = p.check("width", Value(1920)).asInt32();
+    size_t height = p.check("height", Value(1080)).asInt32();
+    int receivers = p.check("receivers", Value(4)).asInt32();
+    std::string carrier = p.check("carrier", Value("mjpeg")).asString();
+    int frames = p.check("frames", Value(50)).asInt32();
+
+    BufferedPort<ImageOf<PixelRgb>> out;
+    out.open("/mjpeg_stream/out");
+    std::vector<std::unique_ptr<BufferedPort<ImageOf<PixelRgb>>>> in;
+    for (int i = 0; i < receivers; i++) {
+        in.emplace_back(new BufferedPort<ImageOf<PixelRgb>>);
+        in.back()->open("/mjpeg_stream/in" + std::to_string(i));
+        Network::connect(out.getName(), in.back()->getName(), carrier);
+    }
+    SystemClock::delaySystem(0.5);
+
+    double start = SystemClock::nowSystem();
+    for (int f = 0; f < frames; f++) {
+        ImageOf<PixelRgb>& img = out.prepare();
+        img.resize(width, height);
+        for (size_t y = 0; y < height; y++) {
+            for (size_t x = 0; x < width; x++) {
+                img.pixel(x, y) = PixelRgb(x + f, y, x + y);
+            }
+        }
+        out.write(true);
+        out.waitForWrite();
+        for (auto& port : in) {
+            port->read();
+        }
+    }
+    double t = (SystemClock::nowSystem() - start) / frames;
+    printf("%zux%zu, %d receivers (%s): %.1f ms for each frame\n",
+           width, height, receivers, carrier.c_str(), t * 1e3);
+
+    for (auto& port : in) {
+        port->close();
+    }
+    out.close();
+    return 0;
+}
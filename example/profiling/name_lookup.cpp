@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace yarp::os;
+
+// Name lookup test.
+// Open many ports, then connect each of them to the next one and check
+// that the connections exist, the way an application does at startup.
+// Report how long the connections take, with and without caching the
+// addresses returned by the name server (YARP_NAME_CACHE_TTL).  A name
+// server must be running, e.g.:
+//   yarpserver &
+//   ./name_lookup --ports 300
+//   YARP_NAME_CACHE_TTL=10 ./name_lookup --ports 300
+
+// Parameters:
+// --ports: number of ports (default: 300)
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int nports = p.check("ports", Value(300)).asInt32();
+    const char* ttl = std::getenv("YARP_NAME_CACHE_TTL");
+
+    std::vector<std::unique_ptr<Port>> ports;
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < nports; i++) {
+        ports.emplace_back(new Port);
+        if (!ports.back()->open("/profiling/names/" + std::to_string(i))) {
+            fprintf(stderr, "Cannot open ports, is the name server running?\n");
+            return 1;
+        }
+    }
+    double opened = SystemClock::nowSystem();
+
+    for (int i = 0; i < nports; i++) {
+        Network::connect(ports[i]->getName(), ports[(i + 1) % nports]->getName(), "tcp", true);
+    }
+    double connected = SystemClock::nowSystem();
+
+    int found = 0;
+    for (int i = 0; i < nports; i++) {
+        if (Network::isConnected(ports[i]->getName(), ports[(i + 1) % nports]->getName(), true)) {
+            found++;
+        }
+    }
+    double checked = SystemClock::nowSystem();
+
+    printf("%d ports, cache ttl %s s: open %.3f s, connect %.3f s, check %.3f s (%d connected)\n",
+           nports,
+           (ttl != nullptr) ? ttl : "0",
+           opened - start,
+           connected - opened,
+           checked - connected,
+           found);
+
+    for (auto& port : ports) {
+        port->close();
+    }
+    return 0;
+}
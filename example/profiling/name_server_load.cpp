@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace yarp::os;
+
+// Name server load test.
+// Many clients send requests to the name server at the same time, the
+// way modules do when a whole application starts.  Most clients look up
+// ports, the others register and unregister ports.  Report the latency
+// of the requests.  A name server must be running, e.g.:
+//   yarpserver &
+//   ./name_server_load --clients 32 --writers 4
+
+// Parameters:
+// --clients: number of clients sending requests in parallel (default: 32)
+// --writers: how many of the clients register ports (default: 4)
+// --requests: requests sent by each client (default: 200)
+// --ports: ports registered before starting (default: 100)
+
+namespace {
+
+bool request(const Contact& server, const std::string& text, double& latency)
+{
+    Bottle cmd(text);
+    Bottle reply;
+    double start = SystemClock::nowSystem();
+    bool ok = Network::write(server, cmd, reply, false, true, 10.0);
+    latency = SystemClock::nowSystem() - start;
+    return ok;
+}
+
+void report(const char* kind, std::vector<double>& latencies)
+{
+    if (latencies.empty()) {
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    size_t n = latencies.size();
+    printf("%-8s %6zu requests: p50 %7.2f ms, p99 %7.2f ms, max %7.2f ms\n",
+           kind,
+           n,
+           latencies[n / 2] * 1000,
+           latencies[std::min(n - 1, n * 99 / 100)] * 1000,
+           latencies[n - 1] * 1000);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int nclients = p.check("clients", Value(32)).asInt32();
+    int nwriters = std::min(nclients, p.check("writers", Value(4)).asInt32());
+    int nrequests = p.check("requests", Value(200)).asInt32();
+    int nports = std::max(1, p.check("ports", Value(100)).asInt32());
+
+    Contact server = Network::getNameServerContact();
+    std::string prefix = "/profiling/load/";
+    for (int i = 0; i < nports; i++) {
+        double latency;
+        if (!request(server, "register " + prefix + std::to_string(i) + " tcp 127.0.0.1 " + std::to_string(20000 + i), latency)) {
+            fprintf(stderr, "Cannot reach the name server at %s\n", server.toURI().c_str());
+            return 1;
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<double> reads;
+    std::vector<double> writes;
+    int failures = 0;
+
+    double start = SystemClock::nowSystem();
+    std::vector<std::thread> clients;
+    for (int c = 0; c < nclients; c++) {
+        clients.emplace_back([&, c]() {
+            bool writer = (c < nwriters);
+            std::vector<double> local;
+            int failed = 0;
+            for (int i = 0; i < nrequests; i++) {
+                double latency;
+                bool ok;
+                if (writer) {
+                    std::string name = prefix + "writer" + std::to_string(c);
+                    if (i % 2 == 0) {
+                        ok = request(server, "register " + name + " tcp 127.0.0.1 " + std::to_string(30000 + c), latency);
+                    } else {
+                        ok = request(server, "unregister " + name, latency);
+                    }
+                } else {
+                    ok = request(server, "query " + prefix + std::to_string((c * nrequests + i) % nports), latency);
+                }
+                if (ok) {
+                    local.push_back(latency);
+                } else {
+                    failed++;
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<double>& all = writer ? writes : reads;
+            all.insert(all.end(), local.begin(), local.end());
+            failures += failed;
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    double elapsed = SystemClock::nowSystem() - start;
+
+    printf("%d clients (%d writers), %d requests each, %.3f s: %.0f requests/s, %d failed\n",
+           nclients,
+           nwriters,
+           nrequests,
+           elapsed,
+           (reads.size() + writes.size()) / elapsed,
+           failures);
+    report("lookups", reads);
+    report("changes", writes);
+
+    for (int i = 0; i < nports; i++) {
+        double latency;
+        request(server, "unregister " + prefix + std::to_string(i), latency);
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+using namespace yarp::os;
+
+// Many connections test.
+// Open some writers and readers in the same process, connect every writer
+// to every reader, and send messages for a while.  Then report how many
+// threads the process has, and how many context switches happened.
+//
+// Compare the default configuration with the reactor, e.g.:
+//   ./port_connections --writers 50 --readers 20
+//   YARP_PORT_REACTOR_THREADS=4 ./port_connections --writers 50 --readers 20
+// or a high rate fan-out with and without batched datagrams:
+//   ./port_connections --writers 1 --readers 20 --period 0.001 --carrier udp
+//   ./port_connections --writers 1 --readers 20 --period 0.001 --carrier udp+batch.4
+// or with coalesced messages:
+//   ./port_connections --writers 1 --readers 20 --period 0.0005 --carrier tcp+coalesce.2000
+
+// Parameters:
+// --writers: number of output ports (default: 50)
+// --readers: number of input ports (default: 20)
+// --period: time between two messages of each writer [s] (default: 0.01)
+// --duration: how long messages are sent [s] (default: 5)
+// --carrier: carrier used for the connections (default: tcp)
+
+namespace {
+int countThreads()
+{
+    int threads = -1;
+    FILE* status = fopen("/proc/self/status", "r");
+    if (status == nullptr) {
+        return threads;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), status) != nullptr) {
+        if (sscanf(line, "Threads: %d", &threads) == 1) {
+            break;
+        }
+    }
+    fclose(status);
+    return threads;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+    yarp.setLocalMode(true);
+
+    Property p;
+    p.fromCommand(argc, argv);
+    int nwriters = p.check("writers", Value(50)).asInt32();
+    int nreaders = p.check("readers", Value(20)).asInt32();
+    double period = p.check("period", Value(0.01)).asFloat64();
+    double duration = p.check("duration", Value(5.0)).asFloat64();
+    std::string carrier = p.check("carrier", Value("tcp")).asString();
+
+    std::vector<std::unique_ptr<BufferedPort<Bottle>>> writers;
+    std::vector<std::unique_ptr<BufferedPort<Bottle>>> readers;
+    for (int i = 0; i < nwriters; i++) {
+        writers.emplace_back(new BufferedPort<Bottle>);
+        writers.back()->open("/profiling/connections/out" + std::to_string(i));
+    }
+    for (int i = 0; i < nreaders; i++) {
+        readers.emplace_back(new BufferedPort<Bottle>);
+        readers.back()->setStrict();
+        readers.back()->open("/profiling/connections/in" + std::to_string(i));
+    }
+    int threadsBefore = countThreads();
+    for (auto& writer : writers) {
+        for (auto& reader : readers) {
+            Network::connect(writer->getName(), reader->getName(), carrier, true);
+        }
+    }
+
+    struct rusage before;
+    getrusage(RUSAGE_SELF, &before);
+    int threadsConnected = countThreads();
+
+    int sent = 0;
+    long received = 0;
+    double start = SystemClock::nowSystem();
+    while (SystemClock::nowSystem() - start < duration) {
+        for (auto& writer : writers) {
+            Bottle& b = writer->prepare();
+            b.clear();
+            b.addInt32(sent);
+            b.addFloat64(SystemClock::nowSystem());
+            writer->write();
+        }
+        sent++;
+        for (auto& reader : readers) {
+            while (reader->read(false) != nullptr) {
+                received++;
+            }
+        }
+        SystemClock::delaySystem(period);
+    }
+
+    struct rusage after;
+    getrusage(RUSAGE_SELF, &after);
+
+    printf("connections: %d\n", nwriters * nreaders);
+    printf("threads: %d before connecting, %d after\n", threadsBefore, threadsConnected);
+    printf("messages per writer: %d\n", sent);
+    printf("messages received: %ld of %ld\n", received, static_cast<long>(sent) * nwriters * nreaders);
+    printf("voluntary context switches: %ld\n", after.ru_nvcsw - before.ru_nvcsw);
+    printf("involuntary context switches: %ld\n", after.ru_nivcsw - before.ru_nivcsw);
+    printf("max resident set size: %ld kB\n", after.ru_maxrss);
+
+    for (auto& writer : writers) {
+        writer->close();
+    }
+    for (auto& reader : readers) {
+        reader->close();
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/Vector.h>
+
+#include <cstdio>
+#include <string>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Port throughput test.
+// Send a sequence of messages from a Port to a BufferedPort in the same
+// process, and report how many messages and bytes per second go through
+// the connection.
+//
+// Run it under "strace -f -c" (see local-throughput.sh) to get the number
+// of system calls needed to send each message.
+
+// Parameters:
+// --type: bottle, vector or image (default: bottle)
+// --size: number of elements of the bottle or vector, or width of the
+//         (square, rgb) image (default: 100)
+// --nframes: how many messages are sent (default: 10000)
+// --carrier: carrier used for the connection (default: tcp)
+
+template <class T>
+int run(T& datum, size_t bytes, const std::string& carrier, int nframes)
+{
+    BufferedPort<T> in;
+    Port out;
+    in.setStrict();
+    if (!in.open("/profiling/throughput/in") || !out.open("/profiling/throughput/out")) {
+        fprintf(stderr, "Cannot open ports\n");
+        return 1;
+    }
+    if (!Network::connect(out.getName(), in.getName(), carrier)) {
+        fprintf(stderr, "Cannot connect with carrier %s\n", carrier.c_str());
+        return 1;
+    }
+
+    // warm up
+    for (int i = 0; i < 100; i++) {
+        out.write(datum);
+        in.read();
+    }
+
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < nframes; i++) {
+        out.write(datum);
+        in.read();
+    }
+    double elapsed = SystemClock::nowSystem() - start;
+
+    printf("%d messages of %zu bytes in %.3f s: %.1f msg/s, %.2f MB/s\n",
+           nframes,
+           bytes,
+           elapsed,
+           nframes / elapsed,
+           nframes * bytes / elapsed / 1e6);
+
+    out.close();
+    in.close();
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+    yarp.setLocalMode(true);
+
+    Property p;
+    p.fromCommand(argc, argv);
+    std::string type = p.check("type", Value("bottle")).asString();
+    int size = p.check("size", Value(100)).asInt32();
+    int nframes = p.check("nframes", Value(10000)).asInt32();
+    std::string carrier = p.check("carrier", Value("tcp")).asString();
+
+    if (type == "bottle") {
+        Bottle b;
+        for (int i = 0; i < size; i++) {
+            b.addFloat64(i * 0.5);
+        }
+        size_t bytes = 0;
+        b.toBinary(&bytes);
+        return run(b, bytes, carrier, nframes);
+    }
+    if (type == "vector") {
+        Vector v(size, 0.5);
+        return run(v, v.size() * sizeof(double), carrier, nframes);
+    }
+    if (type == "image") {
+        ImageOf<PixelRgb> img;
+        img.resize(size, size);
+        img.zero();
+        return run(img, img.getRawImageSize(), carrier, nframes);
+    }
+
+    fprintf(stderr, "Unknown type %s (use bottle, vector or image)\n", type.c_str());
+    return 1;
+}
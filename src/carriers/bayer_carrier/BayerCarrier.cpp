@@ -11,6 +11,8 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/Route.h>
 #include <yarp/sig/ImageDraw.h>
+#include <yarp/sig/impl/Demosaic.h>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 
@@ -32,6 +34,15 @@ YARP_LOG_COMPONENT(BAYERCARRIER,
                    yarp::os::Log::LogTypeReserved,
                    yarp::os::Log::printCallback(),
                    nullptr)
+
+yarp::sig::impl::BayerOrder bayerOrder(int goff, int roff)
+{
+    using yarp::sig::impl::BayerOrder;
+    if (goff == 0) {
+        return (roff == 0) ? BayerOrder::GRBG : BayerOrder::GBRG;
+    }
+    return (roff == 0) ? BayerOrder::RGGB : BayerOrder::BGGR;
+}
 }
 
 // can't seem to do ipl/opencv/yarp style end-of-row padding
@@ -117,6 +128,14 @@ yarp::os::ConnectionReader& BayerCarrier::modifyIncomingData(yarp::os::Connectio
                 half = true;
             }
         }
+        threads = 1;
+        if (config.check("threads")) {
+            threads = static_cast<size_t>(std::max(1, config.find("threads").asInt32()));
+        }
+        if (workers == nullptr || workers->size() != threads) {
+            delete workers;
+            workers = new yarp::sig::impl::DemosaicWorkers(threads);
+        }
         if (config.check("method")) {
             std::string method = config.find("method").asString();
             bayer_method_set = true;
@@ -161,50 +180,19 @@ yarp::os::ConnectionReader& BayerCarrier::modifyIncomingData(yarp::os::Connectio
 
 bool BayerCarrier::debayerHalf(yarp::sig::ImageOf<PixelMono>& src,
                                yarp::sig::ImageOf<PixelRgb>& dest) {
-    // dc1394 doesn't seem safe for arbitrary data widths
-    if (src.width()%8==0) {
-        dc1394video_frame_t dc_src;
-        dc1394video_frame_t dc_dest;
-        setDcImage(src,&dc_src,dcformat);
-        setDcImage(dest,&dc_dest,dcformat);
-        dc1394_debayer_frames(&dc_src,&dc_dest,DC1394_BAYER_METHOD_DOWNSAMPLE);
-        return true;
-    }
-
-    if (bayer_method_set) {
-        yCWarning/*Once*/(BAYERCARRIER, "Not using dc1394 debayer methods (image width not a multiple of 8)");
-    }
-
-    // a safer implementation that doesn't use dc1394
-    int w = src.width();
-    int h = src.height();
-    int wo = dest.width();
-    int ho = dest.height();
-    int goff1 = 1-goff;
-    int roffx = roff?goff:goff1;
-    int boff = 1-roff;
-    int boffx = boff?goff:goff1;
-    for (int yo=0; yo<ho; yo++) {
-        for (int xo=0; xo<wo; xo++) {
-            PixelRgb& po = dest.pixel(xo,yo);
-            int x = xo*2;
-            int y = yo*2;
-            if (x+1>=w-1 || y+1>=h-1) {
-                po = PixelRgb{0,0,0};
-                continue;
-            }
-            po.r = src.pixel(x+roffx,y+roff);
-            po.b = src.pixel(x+boffx,y+boff);
-            po.g = static_cast<PixelMono>(0.5*(src.pixel(x+goff,y)+src.pixel(x+goff1,y+1)));
-        }
-    }
-    return true;
+    return yarp::sig::impl::demosaicHalf(src.getRawImage(), src.getRowSize(),
+                                         dest.getRawImage(), dest.getRowSize(), VOCAB_PIXEL_RGB,
+                                         src.width(), src.height(),
+                                         bayerOrder(goff, roff), *workers);
 }
 
 bool BayerCarrier::debayerFull(yarp::sig::ImageOf<PixelMono>& src,
                                yarp::sig::ImageOf<PixelRgb>& dest) {
+    // bilinear and edgesense are done by YARP_sig, for the other methods
     // dc1394 doesn't seem safe for arbitrary data widths
-    if (src.width()%8==0) {
+    bool own = (bayer_method == DC1394_BAYER_METHOD_BILINEAR ||
+                bayer_method == DC1394_BAYER_METHOD_EDGESENSE);
+    if (!own && src.width()%8==0) {
         dc1394video_frame_t dc_src;
         dc1394video_frame_t dc_dest;
         setDcImage(src,&dc_src,dcformat);
@@ -214,91 +202,16 @@ bool BayerCarrier::debayerFull(yarp::sig::ImageOf<PixelMono>& src,
         return true;
     }
 
-    if (bayer_method_set) {
+    if (!own && bayer_method_set) {
         yCWarning/*Once*/(BAYERCARRIER, "Not using dc1394 debayer methods (image width not a multiple of 8)");
     }
-    int w = dest.width();
-    int h = dest.height();
-    int goff1 = 1-goff;
-    int roffx = roff?goff:goff1;
-    int boff = 1-roff;
-    int boffx = boff?goff:goff1;
-    for (int y=0; y<h; y++) {
-        for (int x=0; x<w; x++) {
-            PixelRgb& po = dest.pixel(x,y);
-
-            // G
-            if ((x+y)%2==goff) {
-                po.g = src.pixel(x,y);
-            } else {
-                float g = 0;
-                int ct = 0;
-                if (x>0) { g += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { g += src.pixel(x+1,y); ct++; }
-                if (y>0) { g += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { g += src.pixel(x,y+1); ct++; }
-                if (ct>0) { g /= ct; }
-                po.g = static_cast<int>(g);
-            }
-
-            // B
-            if (y%2==boff && x%2==boffx) {
-                po.b = src.pixel(x,y);
-            } else if (y%2==boff) {
-                float b = 0;
-                int ct = 0;
-                if (x>0) { b += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { b += src.pixel(x+1,y); ct++; }
-                if (ct>0) { b /= ct; }
-                po.b = static_cast<int>(b);
-            } else if (x%2==boffx) {
-                float b = 0;
-                int ct = 0;
-                if (y>0) { b += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { b += src.pixel(x,y+1); ct++; }
-                if (ct>0) { b /= ct; }
-                po.b = static_cast<int>(b);
-            } else {
-                float b = 0;
-                int ct = 0;
-                if (x>0&&y>0) { b += src.pixel(x-1,y-1); ct++; }
-                if (x>0&&y<h-1) { b += src.pixel(x-1,y+1); ct++; }
-                if (x<w-1&&y>0) { b += src.pixel(x+1,y-1); ct++; }
-                if (x<w-1&&y<h-1) { b += src.pixel(x+1,y+1); ct++; }
-                if (ct>0) { b /= ct; }
-                po.b = static_cast<int>(b);
-            }
-
-            // R
-            if (y%2==roff && x%2==roffx) {
-                po.r = src.pixel(x,y);
-            } else if (y%2==roff) {
-                float r = 0;
-                int ct = 0;
-                if (x>0) { r += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { r += src.pixel(x+1,y); ct++; }
-                if (ct>0) { r /= ct; }
-                po.r = static_cast<int>(r);
-            } else if (x%2==roffx) {
-                float r = 0;
-                int ct = 0;
-                if (y>0) { r += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { r += src.pixel(x,y+1); ct++; }
-                if (ct>0) { r /= ct; }
-                po.r = static_cast<int>(r);
-            } else {
-                float r = 0;
-                int ct = 0;
-                if (x>0&&y>0) { r += src.pixel(x-1,y-1); ct++; }
-                if (x>0&&y<h-1) { r += src.pixel(x-1,y+1); ct++; }
-                if (x<w-1&&y>0) { r += src.pixel(x+1,y-1); ct++; }
-                if (x<w-1&&y<h-1) { r += src.pixel(x+1,y+1); ct++; }
-                if (ct>0) { r /= ct; }
-                po.r = static_cast<int>(r);
-            }
-        }
-    }
-    return true;
+    auto method = (bayer_method == DC1394_BAYER_METHOD_EDGESENSE) ?
+                  yarp::sig::impl::DemosaicMethod::EdgeAware :
+                  yarp::sig::impl::DemosaicMethod::Bilinear;
+    return yarp::sig::impl::demosaic(src.getRawImage(), src.getRowSize(),
+                                     dest.getRawImage(), dest.getRowSize(), VOCAB_PIXEL_RGB,
+                                     dest.width(), dest.height(),
+                                     bayerOrder(goff, roff), method, *workers);
 }
 
 bool BayerCarrier::processBuffered() const {
@@ -13,6 +13,7 @@
 #include <yarp/os/ConnectionReader.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/ImageNetworkHeader.h>
+#include <yarp/sig/impl/Demosaic.h>
 #include <yarp/os/DummyConnector.h>
 
 /**
@@ -22,6 +23,12 @@
  *   tcp+recv.bayer
  *   tcp+recv.bayer+size.half
  *   tcp+recv.bayer+size.half+order.bggr
+ *   tcp+recv.bayer+method.edgesense+threads.2
+ *
+ * The bilinear (default) and edgesense methods, and the half size
+ * conversion, split the image in bands of rows converted at the same
+ * time by "threads" threads (default: 1).  The threads are kept for the
+ * next images of the connection.
  *
  */
 class BayerCarrier :
@@ -47,6 +54,8 @@ private:
     bool bayer_method_set;
 
     int bayer_method;
+    size_t threads;
+    yarp::sig::impl::DemosaicWorkers* workers;
 
     // format offsets
     int goff; // x offset to green on even rows
@@ -71,6 +80,8 @@ public:
         half(false),
         bayer_method_set(false),
         bayer_method(-1),
+        threads(1),
+        workers(nullptr),
         goff(0),
         roff(1),
         dcformat(-1)
@@ -78,6 +89,7 @@ public:
 
     ~BayerCarrier() {
         if (local) delete local;
+        delete workers;
     }
 
     Carrier *create() const override {
@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "DeltaMonitor.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/Vocab.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+using namespace yarp::os;
+
+namespace {
+YARP_LOG_COMPONENT(DELTAMONITOR,
+                   "yarp.carrier.portmonitor.delta",
+                   yarp::os::Log::minimumPrintLevel(),
+                   yarp::os::Log::LogTypeReserved,
+                   yarp::os::Log::printCallback(),
+                   nullptr)
+
+constexpr yarp::conf::vocab32_t VOCAB_KEYFRAME = yarp::os::createVocab('k', 'e', 'y');
+constexpr yarp::conf::vocab32_t VOCAB_DELTA = yarp::os::createVocab('d', 'l', 't');
+
+// A run of unchanged bytes shorter than this is cheaper to send as part
+// of the changed bytes around it than as a new run
+constexpr size_t MIN_ZERO_RUN = 3;
+
+void putSize(std::vector<char>& out, size_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool getSize(const char*& in, const char* end, size_t& value)
+{
+    value = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        auto byte = static_cast<unsigned char>(*in++);
+        value |= static_cast<size_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t sameBytes(const char* a, const char* b, size_t from, size_t n)
+{
+    size_t i = from;
+    for (; i + sizeof(std::uint64_t) <= n; i += sizeof(std::uint64_t)) {
+        std::uint64_t wa;
+        std::uint64_t wb;
+        memcpy(&wa, a + i, sizeof(wa));
+        memcpy(&wb, b + i, sizeof(wb));
+        if (wa != wb) {
+            break;
+        }
+    }
+    while (i < n && a[i] == b[i]) {
+        i++;
+    }
+    return i - from;
+}
+
+// The difference between two messages of the same size, as a list of
+// (unchanged count, changed count, changed bytes XOR previous bytes).
+// The unchanged bytes at the end are not listed.
+void encodeDelta(const std::vector<char>& prev, const std::vector<char>& cur, std::vector<char>& out)
+{
+    out.clear();
+    const size_t n = cur.size();
+    size_t i = 0;
+    while (i < n) {
+        size_t same = sameBytes(prev.data(), cur.data(), i, n);
+        size_t start = i + same;
+        if (start == n) {
+            break;
+        }
+        size_t end = start;
+        while (end < n) {
+            if (prev[end] != cur[end]) {
+                end++;
+                continue;
+            }
+            size_t run = sameBytes(prev.data(), cur.data(), end, n);
+            if (run >= MIN_ZERO_RUN || end + run == n) {
+                break;
+            }
+            end += run;
+        }
+        putSize(out, same);
+        putSize(out, end - start);
+        for (size_t k = start; k < end; k++) {
+            out.push_back(static_cast<char>(prev[k] ^ cur[k]));
+        }
+        i = end;
+    }
+}
+
+bool applyDelta(const char* in, size_t len, std::vector<char>& base)
+{
+    const char* end = in + len;
+    size_t pos = 0;
+    while (in < end) {
+        size_t same;
+        size_t changed;
+        if (!getSize(in, end, same) || !getSize(in, end, changed)) {
+            return false;
+        }
+        pos += same;
+        if (pos > base.size() || changed > base.size() - pos || changed > static_cast<size_t>(end - in)) {
+            return false;
+        }
+        for (size_t k = 0; k < changed; k++) {
+            base[pos + k] ^= in[k];
+        }
+        pos += changed;
+        in += changed;
+    }
+    return true;
+}
+
+} // namespace
+
+
+bool DeltaMonitorObject::RawWriter::write(yarp::os::ConnectionWriter& connection) const
+{
+    connection.appendBlock(bytes.data(), bytes.size());
+    return true;
+}
+
+bool DeltaMonitorObject::create(const yarp::os::Property& options)
+{
+    senderSide = options.find("sender_side").asBool();
+    keyframe = std::max(1, options.check("keyframe", Value(50)).asInt32());
+    seq = 0;
+    hasBase = false;
+    return true;
+}
+
+void DeltaMonitorObject::destroy()
+{
+}
+
+bool DeltaMonitorObject::setparam(const yarp::os::Property& params)
+{
+    if (!params.check("keyframe")) {
+        return false;
+    }
+    keyframe = std::max(1, params.find("keyframe").asInt32());
+    return true;
+}
+
+bool DeltaMonitorObject::getparam(yarp::os::Property& params)
+{
+    params.put("keyframe", keyframe);
+    return true;
+}
+
+bool DeltaMonitorObject::accept(yarp::os::Things& thing)
+{
+    if (senderSide) {
+        if (thing.getPortWriter() == nullptr) {
+            yCError(DELTAMONITOR, "Nothing to send on the sender side!");
+            return false;
+        }
+        return true;
+    }
+
+    Bottle* msg = thing.cast_as<Bottle>();
+    if (msg == nullptr) {
+        yCError(DELTAMONITOR, "Expected type Bottle in receiver side, but got wrong data type!");
+        return false;
+    }
+    return decode(*msg);
+}
+
+yarp::os::Things& DeltaMonitorObject::update(yarp::os::Things& thing)
+{
+    if (senderSide) {
+        if (!encode(*thing.getPortWriter())) {
+            return thing;
+        }
+        th.setPortWriter(&data);
+    } else {
+        th.setPortWriter(&base);
+    }
+    return th;
+}
+
+bool DeltaMonitorObject::encode(const yarp::os::PortWriter& writer)
+{
+    buffer.restart();
+    if (!const_cast<PortWriter&>(writer).write(buffer)) {
+        yCError(DELTAMONITOR, "Failed to serialize the message");
+        return false;
+    }
+    current.clear();
+    for (size_t i = 0; i < buffer.length(); i++) {
+        current.insert(current.end(), buffer.data(i), buffer.data(i) + buffer.length(i));
+    }
+
+    bool key = !hasBase || (seq % keyframe == 0) || current.size() != base.bytes.size();
+    if (!key) {
+        encodeDelta(base.bytes, current, encoded);
+        key = (encoded.size() >= current.size());
+    }
+
+    data.clear();
+    if (key) {
+        data.addVocab(VOCAB_KEYFRAME);
+        data.addInt32(seq);
+        data.add(Value(current.data(), static_cast<int>(current.size())));
+    } else {
+        data.addVocab(VOCAB_DELTA);
+        data.addInt32(seq);
+        data.add(Value(encoded.data(), static_cast<int>(encoded.size())));
+    }
+    base.bytes.swap(current);
+    hasBase = true;
+    seq++;
+    return true;
+}
+
+bool DeltaMonitorObject::decode(const yarp::os::Bottle& msg)
+{
+    if (msg.size() != 3 || !msg.get(0).isVocab() || !msg.get(2).isBlob()) {
+        yCError(DELTAMONITOR, "Expected a (vocab seq blob) message, got %s", msg.toString().c_str());
+        return false;
+    }
+    int msgSeq = msg.get(1).asInt32();
+    const char* blob = msg.get(2).asBlob();
+    size_t len = msg.get(2).asBlobLength();
+
+    if (msg.get(0).asVocab() == VOCAB_KEYFRAME) {
+        base.bytes.assign(blob, blob + len);
+        hasBase = true;
+        seq = msgSeq;
+        return true;
+    }
+
+    if (!hasBase || msgSeq != seq + 1) {
+        // A message was lost, nothing to apply the difference to
+        if (hasBase) {
+            yCDebug(DELTAMONITOR, "Message %d lost, waiting for a keyframe", seq + 1);
+        }
+        hasBase = false;
+        return false;
+    }
+    if (!applyDelta(blob, len, base.bytes)) {
+        yCError(DELTAMONITOR, "Malformed delta, waiting for a keyframe");
+        hasBase = false;
+        return false;
+    }
+    seq = msgSeq;
+    return true;
+}
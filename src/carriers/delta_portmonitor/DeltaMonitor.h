@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_CARRIER_DELTA_DELTAMONITOR_H
+#define YARP_CARRIER_DELTA_DELTAMONITOR_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/MonitorObject.h>
+#include <yarp/os/PortWriter.h>
+#include <yarp/os/Things.h>
+#include <yarp/os/impl/BufferedConnectionWriter.h>
+
+#include <vector>
+
+//example usage:
+//yarp connect /robot/state:o /teleop/state:i tcp+send.portmonitor+recv.portmonitor+type.dll+file.delta+keyframe.100
+
+/**
+ * Send the messages of a stream as the difference from the previous one.
+ *
+ * On the sender side each message is serialized and XORed with the
+ * previous message of the connection; the runs of zeros, i.e. the bytes
+ * that did not change, are skipped.  Every `keyframe` messages (default
+ * 50), and whenever the size of the message changes, the whole message
+ * is sent instead.  Messages are sent as (vocab seq blob), with the vocab
+ * telling a keyframe (`key`) from a delta (`dlt`).
+ * The receiver side applies the differences and delivers the original
+ * message, so it works with any type (yarp::sig::Vector, Bottle, the
+ * state of the control boards...), but it is effective when the messages
+ * keep the same layout and most of their fields change slowly.
+ * If a message is lost (e.g. on udp or mcast), the following deltas are
+ * dropped until the next keyframe.
+ */
+class DeltaMonitorObject : public yarp::os::MonitorObject
+{
+public:
+    bool create(const yarp::os::Property& options) override;
+    void destroy() override;
+
+    bool setparam(const yarp::os::Property& params) override;
+    bool getparam(yarp::os::Property& params) override;
+
+    bool accept(yarp::os::Things& thing) override;
+    yarp::os::Things& update(yarp::os::Things& thing) override;
+
+private:
+    // Writes the bytes of the decoded message
+    class RawWriter : public yarp::os::PortWriter
+    {
+    public:
+        std::vector<char> bytes;
+        bool write(yarp::os::ConnectionWriter& connection) const override;
+    };
+
+    bool encode(const yarp::os::PortWriter& writer);
+    bool decode(const yarp::os::Bottle& msg);
+
+    bool senderSide {false};
+    int keyframe {50};
+    int seq {0};
+    bool hasBase {false};
+    std::vector<char> current;
+    std::vector<char> encoded;
+    yarp::os::impl::BufferedConnectionWriter buffer;
+    RawWriter base;
+    yarp::os::Bottle data;
+    yarp::os::Things th;
+};
+
+#endif // YARP_CARRIER_DELTA_DELTAMONITOR_H
@@ -10,8 +10,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <string>
 
 #include <yarp/os/LogComponent.h>
+#include <yarp/os/TransformCache.h>
 #include <yarp/sig/Image.h>
 
 using namespace yarp::os;
@@ -75,30 +77,49 @@ yarp::os::Things& DepthImageConverter::update(yarp::os::Things& thing)
     auto* img = thing.cast_as<Image>();
     inMatrix = reinterpret_cast<float **> (img->getRawImage());
 
-    outImg.setPixelCode(VOCAB_PIXEL_MONO);
-    outImg.setPixelSize(1);
-    outImg.resize(img->width(), img->height());
+    // On the sender side, the connections of the port share the converted
+    // image
+    TransformCache* cache = TransformCache::getCurrent();
+    if (cache == nullptr) {
+        convert(*img, outImg);
+        th.setPortWriter(&outImg);
+        return th;
+    }
+    std::string key = "depthimage?min=" + std::to_string(min) + "&max=" + std::to_string(max);
+    sharedImg = cache->get<FlexImage>(key, [this, img]() -> std::shared_ptr<const FlexImage> {
+        auto converted = std::make_shared<FlexImage>();
+        convert(*img, *converted);
+        return converted;
+    });
+    // Image::write() does not modify the image
+    th.setPortWriter(const_cast<FlexImage*>(sharedImg.get()));
+    return th;
+}
 
-    outImg.zero();
-    auto* inPixels = reinterpret_cast<float *> (img->getRawImage());
-    unsigned char *pixels = outImg.getRawImage();
-    for(size_t h=0; h<img->height(); h++)
+void DepthImageConverter::convert(const Image& img, FlexImage& out) const
+{
+    out.setPixelCode(VOCAB_PIXEL_MONO);
+    out.setPixelSize(1);
+    out.resize(img.width(), img.height());
+
+    out.zero();
+    auto* inPixels = reinterpret_cast<float *> (img.getRawImage());
+    unsigned char *pixels = out.getRawImage();
+    for(size_t h=0; h<img.height(); h++)
     {
-        for(size_t w=0; w<img->width(); w++)
+        for(size_t w=0; w<img.width(); w++)
         {
-            float inVal = inPixels[w + (h * img->width())];
+            float inVal = inPixels[w + (h * img.width())];
             if (inVal != inVal /* NaN */ || inVal < min || inVal > max) {
-                pixels[w + (h * (img->width() ))] = 0;
+                pixels[w + (h * (img.width() ))] = 0;
             } else {
                 int val = (int) (255.0 - (inVal * 255.0 / (max - min)));
                 if(val >= 255)
                     val = 255;
                 if(val <= 0)
                     val = 0;
-                pixels[w + (h * (img->width() ))] = (char) val;
+                pixels[w + (h * (img.width() ))] = (char) val;
             }
         }
     }
-    th.setPortWriter(&outImg);
-    return th;
 }
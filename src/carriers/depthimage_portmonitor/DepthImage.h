@@ -14,6 +14,8 @@
 #include <yarp/os/MonitorObject.h>
 #include <yarp/sig/Image.h>
 
+#include <memory>
+
 
 class DepthImageConverter : public yarp::os::MonitorObject
 {
@@ -28,6 +30,7 @@ public:
     yarp::os::Things& update(yarp::os::Things& thing) override;
 
 private:
+    void convert(const yarp::sig::Image& img, yarp::sig::FlexImage& out) const;
 
     double min, max;
     yarp::os::Bottle bt;
@@ -35,6 +38,7 @@ private:
     float **inMatrix;
     unsigned char **outMatrix;
     yarp::sig::FlexImage outImg;
+    std::shared_ptr<const yarp::sig::FlexImage> sharedImg; // converted by the connections of the port
 };
 
 #endif  // YARP_CARRIER_DEPTHIMAGECONVERTER_H
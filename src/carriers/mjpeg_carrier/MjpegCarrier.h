@@ -14,6 +14,7 @@
 #include <yarp/os/NetType.h>
 #include <yarp/os/ConnectionState.h>
 #include "MjpegStream.h"
+#include "MjpegCompression.h"
 #include "MjpegLogComponent.h"
 
 #include <cstring>
@@ -35,6 +36,13 @@
  * You can also view yarp image ports from a browser.  Do a "yarp name query /portname" to find their port number NNN, then go to:
  *   http://localhost:NNN/?output=stream
  *
+ * The receiver chooses the quality (1-100, default 75) and the chroma
+ * subsampling (444, 422, 420 or gray, default 420) of the frames:
+ *   yarp connect /grabber /view mjpeg+quality.90+subsampling.444
+ *   http://localhost:NNN/?action=stream&quality=90&subsampling=444
+ * The sender compresses each image once for all the connections asking
+ * for the same settings.
+ *
  */
 class MjpegCarrier :
         public yarp::os::Carrier
@@ -43,6 +51,8 @@ private:
     bool firstRound;
     bool sender;
     std::string envelope;
+    MjpegSettings settings;
+    MjpegCompression compression;
 public:
     MjpegCarrier() {
         firstRound = true;
@@ -143,10 +153,15 @@ public:
     }
 
     bool expectExtraHeader(yarp::os::ConnectionState& proto) override {
-        std::string txt;
-        do {
+        // the rest of the request line, "tion=stream&quality=... HTTP/1.1"
+        std::string txt = proto.is().readLine();
+        settings.fromQuery(txt);
+        while (txt!="") {
             txt = proto.is().readLine();
-        } while (txt!="");
+        }
+        yCDebug(MJPEGCARRIER, "Sending frames with quality %d and subsampling %s",
+                settings.quality,
+                MjpegSettings::subsamplingToString(settings.subsampling).c_str());
         return true;
     }
 
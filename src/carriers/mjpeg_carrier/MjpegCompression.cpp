@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "MjpegCompression.h"
+#include "MjpegLogComponent.h"
+
+#include <yarp/os/Log.h>
+#include <yarp/os/NetType.h>
+#include <yarp/os/TransformCache.h>
+#include <yarp/os/Vocab.h>
+#include <yarp/sig/Image.h>
+
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+#if defined(_WIN32)
+#define INT32 long  // jpeg's definition
+#define QGLOBAL_H 1
+#endif
+
+#ifdef _MSC_VER
+#pragma warning (push)
+#pragma warning (disable : 4091)
+#endif
+
+extern "C" {
+#include <jpeglib.h>
+}
+
+#ifdef _MSC_VER
+#pragma warning (pop)
+#endif
+
+#if defined(_WIN32)
+#undef INT32
+#undef QGLOBAL_H
+#endif
+
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+namespace {
+
+const std::map<int, J_COLOR_SPACE> yarpCode2Mjpeg { {VOCAB_PIXEL_MONO, JCS_GRAYSCALE},
+                                                    {VOCAB_PIXEL_MONO16, JCS_GRAYSCALE},
+                                                    {VOCAB_PIXEL_RGB , JCS_RGB},
+                                                    {VOCAB_PIXEL_RGBA , JCS_EXT_RGBA},
+                                                    {VOCAB_PIXEL_BGRA , JCS_EXT_BGRA},
+                                                    {VOCAB_PIXEL_BGR , JCS_EXT_BGR} };
+
+const std::map<int, int> yarpCode2Channels { {VOCAB_PIXEL_MONO, 1},
+                                             {VOCAB_PIXEL_MONO16, 2},
+                                             {VOCAB_PIXEL_RGB , 3},
+                                             {VOCAB_PIXEL_RGBA , 4},
+                                             {VOCAB_PIXEL_BGRA , 4},
+                                             {VOCAB_PIXEL_BGR , 3} };
+
+struct net_error_mgr {
+    struct jpeg_error_mgr pub;
+    jmp_buf setjmp_buffer;
+};
+using net_error_ptr = struct net_error_mgr*;
+
+void net_error_exit(j_common_ptr cinfo) {
+    auto myerr = (net_error_ptr) cinfo->err;
+    (*cinfo->err->output_message) (cinfo);
+    longjmp(myerr->setjmp_buffer, 1);
+}
+
+// Destination manager writing the compressed image in a vector, that
+// grows as needed.
+struct vector_destination_mgr
+{
+    struct jpeg_destination_mgr pub;
+    std::vector<unsigned char>* buffer;
+};
+using vector_destination_ptr = vector_destination_mgr*;
+
+void init_vector_destination(j_compress_ptr cinfo) {
+    auto dest = (vector_destination_ptr)cinfo->dest;
+    if (dest->buffer->size() < 65536) {
+        dest->buffer->resize(65536);
+    }
+    dest->pub.next_output_byte = dest->buffer->data();
+    dest->pub.free_in_buffer = dest->buffer->size();
+}
+
+boolean empty_vector_output_buffer(j_compress_ptr cinfo) {
+    auto dest = (vector_destination_ptr)cinfo->dest;
+    size_t used = dest->buffer->size();
+    dest->buffer->resize(used * 2);
+    dest->pub.next_output_byte = dest->buffer->data() + used;
+    dest->pub.free_in_buffer = dest->buffer->size() - used;
+    return TRUE;
+}
+
+void term_vector_destination(j_compress_ptr cinfo) {
+    auto dest = (vector_destination_ptr)cinfo->dest;
+    dest->buffer->resize(dest->buffer->size() - dest->pub.free_in_buffer);
+}
+
+} // namespace
+
+
+void MjpegSettings::fromQuery(const std::string& query)
+{
+    std::string params = query.substr(0, query.find(' '));
+    size_t start = 0;
+    while (start < params.length()) {
+        size_t end = params.find('&', start);
+        if (end == std::string::npos) {
+            end = params.length();
+        }
+        std::string param = params.substr(start, end - start);
+        size_t eq = param.find('=');
+        if (eq != std::string::npos) {
+            std::string key = param.substr(0, eq);
+            std::string value = param.substr(eq + 1);
+            if (key == "quality") {
+                int q = NetType::toInt(value);
+                if (q >= 1 && q <= 100) {
+                    quality = q;
+                } else {
+                    yCWarning(MJPEGCARRIER, "Invalid quality %s", value.c_str());
+                }
+            } else if (key == "subsampling") {
+                if (!subsamplingFromString(value, subsampling)) {
+                    yCWarning(MJPEGCARRIER, "Invalid subsampling %s", value.c_str());
+                }
+            }
+        }
+        start = end + 1;
+    }
+}
+
+bool MjpegSettings::subsamplingFromString(const std::string& str, Subsampling& subsampling)
+{
+    if (str == "444") {
+        subsampling = Subsampling444;
+    } else if (str == "422") {
+        subsampling = Subsampling422;
+    } else if (str == "420") {
+        subsampling = Subsampling420;
+    } else if (str == "gray") {
+        subsampling = SubsamplingGray;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string MjpegSettings::subsamplingToString(Subsampling subsampling)
+{
+    switch (subsampling) {
+    case Subsampling444:
+        return "444";
+    case Subsampling422:
+        return "422";
+    case SubsamplingGray:
+        return "gray";
+    case Subsampling420:
+    default:
+        return "420";
+    }
+}
+
+
+class MjpegCompressionHelper {
+public:
+    bool active{false};
+    struct jpeg_compress_struct cinfo;
+    struct net_error_mgr jerr;
+    struct vector_destination_mgr dest;
+    std::vector<JSAMPROW> rows;
+
+    MjpegCompressionHelper()
+    {
+        memset(&cinfo, 0, sizeof(jpeg_compress_struct));
+        memset(&jerr, 0, sizeof(net_error_mgr));
+        memset(&dest, 0, sizeof(vector_destination_mgr));
+    }
+
+    void init() {
+        cinfo.err = jpeg_std_error(&jerr.pub);
+        jerr.pub.error_exit = net_error_exit;
+        jpeg_create_compress(&cinfo);
+        dest.pub.init_destination = init_vector_destination;
+        dest.pub.empty_output_buffer = empty_vector_output_buffer;
+        dest.pub.term_destination = term_vector_destination;
+        cinfo.dest = &dest.pub;
+    }
+
+    bool compress(const Image& img, const MjpegSettings& settings,
+                  const std::string& comment, std::vector<unsigned char>& jpeg) {
+        auto colorSpace = yarpCode2Mjpeg.find(img.getPixelCode());
+        if (colorSpace == yarpCode2Mjpeg.end()) {
+            yCError(MJPEGCARRIER, "Cannot compress images of type %s", Vocab::decode(img.getPixelCode()).c_str());
+            return false;
+        }
+
+        if (!active) {
+            init();
+            active = true;
+        }
+        dest.buffer = &jpeg;
+
+        if (setjmp(jerr.setjmp_buffer)) {
+            jpeg_abort_compress(&cinfo);
+            return false;
+        }
+
+        cinfo.image_width = img.width();
+        cinfo.image_height = img.height();
+        cinfo.in_color_space = colorSpace->second;
+        cinfo.input_components = yarpCode2Channels.at(img.getPixelCode());
+        jpeg_set_defaults(&cinfo);
+        jpeg_set_quality(&cinfo, settings.quality, TRUE);
+        if (settings.subsampling == MjpegSettings::SubsamplingGray) {
+            jpeg_set_colorspace(&cinfo, JCS_GRAYSCALE);
+        } else if (cinfo.jpeg_color_space == JCS_YCbCr) {
+            // jpeg_set_defaults() chooses 4:2:0
+            cinfo.comp_info[0].h_samp_factor = (settings.subsampling == MjpegSettings::Subsampling444) ? 1 : 2;
+            cinfo.comp_info[0].v_samp_factor = (settings.subsampling == MjpegSettings::Subsampling420) ? 2 : 1;
+        }
+        jpeg_start_compress(&cinfo, TRUE);
+        if (!comment.empty()) {
+            jpeg_write_marker(&cinfo, JPEG_COM, reinterpret_cast<const JOCTET*>(comment.c_str()), comment.length() + 1);
+        }
+
+        // All the rows at once, the library takes as many as it can
+        rows.resize(cinfo.image_height);
+        for (size_t y = 0; y < rows.size(); y++) {
+            rows[y] = const_cast<JSAMPROW>(img.getRow(y));
+        }
+        while (cinfo.next_scanline < cinfo.image_height) {
+            jpeg_write_scanlines(&cinfo, rows.data() + cinfo.next_scanline, cinfo.image_height - cinfo.next_scanline);
+        }
+        jpeg_finish_compress(&cinfo);
+        yCTrace(MJPEGCARRIER, "Compressed image %dx%d in %zu bytes", cinfo.image_width, cinfo.image_height, jpeg.size());
+        return true;
+    }
+
+    void fini() {
+        jpeg_destroy_compress(&cinfo);
+    }
+
+    ~MjpegCompressionHelper() {
+        if (active) {
+            fini();
+            active = false;
+        }
+    }
+};
+
+#define HELPER(x) (*((MjpegCompressionHelper*)(x)))
+
+MjpegCompression::MjpegCompression() {
+    system_resource = new MjpegCompressionHelper;
+    yCAssert(MJPEGCARRIER, system_resource!=nullptr);
+}
+
+MjpegCompression::~MjpegCompression() {
+    if (system_resource!=nullptr) {
+        delete &HELPER(system_resource);
+        system_resource = nullptr;
+    }
+}
+
+bool MjpegCompression::compress(const Image& image,
+                                const MjpegSettings& settings,
+                                const std::string& comment,
+                                std::vector<unsigned char>& jpeg) {
+    MjpegCompressionHelper& helper = HELPER(system_resource);
+    return helper.compress(image, settings, comment, jpeg);
+}
+
+MjpegCompression::Frame MjpegCompression::compressShared(const Image& image,
+                                                         const MjpegSettings& settings,
+                                                         const std::string& comment) {
+    auto compressFrame = [&]() -> Frame {
+        auto jpeg = std::make_shared<std::vector<unsigned char>>();
+        if (!compress(image, settings, comment, *jpeg)) {
+            return nullptr;
+        }
+        return jpeg;
+    };
+
+    // The image is the message being sent by the port, the connections
+    // with the same settings share the frame
+    TransformCache* cache = TransformCache::getCurrent();
+    if (cache == nullptr) {
+        return compressFrame();
+    }
+    std::string key = "mjpeg?quality=" + std::to_string(settings.quality) +
+                      "&subsampling=" + MjpegSettings::subsamplingToString(settings.subsampling) +
+                      "#" + comment;
+    return cache->get<std::vector<unsigned char>>(key, compressFrame);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP2_MJPEGCOMPRESSION_INC
+#define YARP2_MJPEGCOMPRESSION_INC
+
+#include <yarp/sig/Image.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Quality and chroma subsampling of the JPEG frames of a connection.
+ * They are requested by the receiver in the query of the HTTP request,
+ * e.g. "GET /?action=stream&quality=90&subsampling=444".
+ */
+struct MjpegSettings
+{
+    enum Subsampling
+    {
+        Subsampling444,
+        Subsampling422,
+        Subsampling420,
+        SubsamplingGray
+    };
+
+    int quality{75};
+    Subsampling subsampling{Subsampling420};
+
+    /**
+     * Set the parameters found in the query of a request (the text after
+     * the '?'), ignoring the unknown ones.
+     */
+    void fromQuery(const std::string& query);
+
+    static bool subsamplingFromString(const std::string& str, Subsampling& subsampling);
+    static std::string subsamplingToString(Subsampling subsampling);
+};
+
+
+class MjpegCompression
+{
+private:
+    void *system_resource;
+public:
+    using Frame = std::shared_ptr<const std::vector<unsigned char>>;
+
+    MjpegCompression();
+
+    virtual ~MjpegCompression();
+
+    /**
+     * Compress an image, writing comment (if not empty) in a COM marker.
+     * The compressor is kept for the next images.
+     */
+    bool compress(const yarp::sig::Image& image,
+                  const MjpegSettings& settings,
+                  const std::string& comment,
+                  std::vector<unsigned char>& jpeg);
+
+    /**
+     * As compress(), but the frame is shared with the other connections of
+     * the port sending the image through its yarp::os::TransformCache:
+     * when the image is sent with the same settings on several connections
+     * it is compressed only once.
+     * @return the compressed frame, or nullptr on failure.
+     */
+    Frame compressShared(const yarp::sig::Image& image,
+                         const MjpegSettings& settings,
+                         const std::string& comment);
+};
+
+#endif
@@ -40,6 +40,9 @@ extern "C" {
 #endif
 
 
+#include <vector>
+
+
 using namespace yarp::os;
 using namespace yarp::sig;
 
@@ -119,6 +122,7 @@ public:
     struct jpeg_decompress_struct cinfo;
     struct net_error_mgr jerr;
     JOCTET error_buffer[4];
+    std::vector<JSAMPROW> rows;
     yarp::os::InputStream::readEnvelopeCallbackType readEnvelopeCallback{nullptr};
     void* readEnvelopeCallbackData{nullptr};
 
@@ -139,6 +143,7 @@ public:
     void init() {
         jpeg_create_decompress(&cinfo);
     }
+
     bool decompress(const Bytes& cimg, FlexImage& img) {
         if (!active) {
             init();
@@ -171,12 +176,13 @@ public:
         jpeg_start_decompress(&cinfo);
         //int row_stride = cinfo.output_width * cinfo.output_components;
 
-        int at = 0;
+        // All the rows at once, the library returns as many as it can
+        rows.resize(cinfo.output_height);
+        for (size_t y = 0; y < rows.size(); y++) {
+            rows[y] = (JSAMPROW)(img.getRow(y));
+        }
         while (cinfo.output_scanline < cinfo.output_height) {
-            JSAMPLE *lines[1];
-            lines[0] = (JSAMPLE*)(img.getPixelAddress(0,at));
-            jpeg_read_scanlines(&cinfo, lines, 1);
-            at++;
+            jpeg_read_scanlines(&cinfo, rows.data() + cinfo.output_scanline, cinfo.output_height - cinfo.output_scanline);
         }
         if(readEnvelopeCallback && cinfo.marker_list && cinfo.marker_list->data_length > 0) {
             Bytes envelope(reinterpret_cast<char*>(cinfo.marker_list->data), cinfo.marker_list->data_length);
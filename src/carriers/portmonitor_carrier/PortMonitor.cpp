@@ -84,8 +84,10 @@ bool PortMonitor::configureFromProperty(yarp::os::Property& options)
 
     // provide some useful information for the monitor object
     // which can be accessed in the create() callback.
+    // The other parameters of the carrier (e.g. "+keyframe.100") are
+    // passed as they are.
     Property info;
-    info.clear();
+    info.fromString(options.toString());
     info.put("filename", strFile);
     info.put("type", script);
     info.put("source", options.find("source").asString());
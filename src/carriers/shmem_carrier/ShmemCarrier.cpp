@@ -8,17 +8,30 @@
  */
 
 #include "ShmemCarrier.h"
-#include "ShmemHybridStream.h"
 #include "ShmemLogComponent.h"
+#include "ShmemTypes.h"
 
+#ifdef YARP_HAS_ACE
+#  include "ShmemHybridStream.h"
+#endif
+
+#ifdef YARP_SHMEM_HAS_RING
+#  include "ShmemRingStream.h"
+#endif
+
+#include <yarp/os/Bottle.h>
 #include <yarp/os/ConnectionState.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/TwoWayStream.h>
 
 #include <string>
 #include <cstdlib>
 
 
-ShmemCarrier::ShmemCarrier() = default;
+ShmemCarrier::ShmemCarrier() :
+        m_RingSize(SHMEM_RING_DEFAULT_SIZE)
+{
+}
 
 ShmemCarrier::~ShmemCarrier() = default;
 
@@ -64,8 +77,32 @@ void ShmemCarrier::setParameters(const yarp::os::Bytes& header)
     YARP_UNUSED(header);
 }
 
+bool ShmemCarrier::configure(yarp::os::ConnectionState& proto)
+{
+    configureFromSpecifier(proto.getSenderSpecifier());
+    return true;
+}
+
+void ShmemCarrier::configureFromSpecifier(const std::string& specifier)
+{
+    yarp::os::Bottle b(specifier);
+    m_bRing = b.check("ring");
+    if (b.check("size")) {
+        int size = b.find("size").asInt32();
+        if (size > 0) {
+            m_RingSize = static_cast<size_t>(size);
+        }
+    }
+}
+
 bool ShmemCarrier::becomeShmemVersionHybridStream(yarp::os::ConnectionState& proto, bool sender)
 {
+#ifndef YARP_HAS_ACE
+    YARP_UNUSED(proto);
+    YARP_UNUSED(sender);
+    yCError(SHMEMCARRIER, "YARP was built without ACE, only the \"shmem+ring\" carrier is available");
+    return false;
+#else
     auto* stream = new ShmemHybridStream();
     yCAssert(SHMEMCARRIER, stream != nullptr);
     yarp::os::Contact base;
@@ -101,16 +138,84 @@ bool ShmemCarrier::becomeShmemVersionHybridStream(yarp::os::ConnectionState& pro
     }
 
     return true;
+#endif
+}
+
+bool ShmemCarrier::becomeShmemVersionRingStream(yarp::os::ConnectionState& proto, bool sender)
+{
+#ifndef YARP_SHMEM_HAS_RING
+    YARP_UNUSED(proto);
+    YARP_UNUSED(sender);
+    yCError(SHMEMCARRIER, "The \"shmem+ring\" carrier is not supported on this platform");
+    return false;
+#else
+    yarp::os::Contact remote = proto.getStreams().getRemoteAddress();
+    yarp::os::Contact local = proto.getStreams().getLocalAddress();
+
+    if (remote.getHost() != local.getHost()) {
+        yCError(SHMEMCARRIER, "The ports are on different machines, shared memory not supported");
+        return false;
+    }
+
+    // Both ends compute the same name: receiver port first, sender port last.
+    std::string name = "/yarp_shmem_";
+    if (sender) {
+        name += std::to_string(remote.getPort()) + "_" + std::to_string(local.getPort());
+    } else {
+        name += std::to_string(local.getPort()) + "_" + std::to_string(remote.getPort());
+    }
+
+    auto* stream = new ShmemRingStream(name);
+    stream->setLocalAddress(local);
+    stream->setRemoteAddress(remote);
+
+    // The tcp connection is still used for the handshake: the receiver
+    // creates the segments, then the sender maps them and confirms, then
+    // the receiver removes their names, so that nothing is left behind in
+    // /dev/shm even if one of the processes is killed.
+    bool ok;
+    if (!sender) {
+        ok = stream->open(false, m_RingSize);
+        writeYarpInt(ok ? 1 : 0, proto);
+        proto.os().flush();
+        if (ok) {
+            ok = (readYarpInt(proto) == 1);
+        }
+        stream->unlink();
+    } else {
+        ok = (readYarpInt(proto) == 1);
+        if (ok) {
+            ok = stream->open(true);
+            writeYarpInt(ok ? 1 : 0, proto);
+            proto.os().flush();
+        }
+    }
+
+    if (!ok) {
+        delete stream;
+        return false;
+    }
+
+    proto.takeStreams(nullptr); // free up port from tcp
+    proto.takeStreams(stream);
+
+    yCDebug(SHMEMCARRIER, "Connected on shared memory ring %s as %s", name.c_str(), (sender ? "sender" : "receiver"));
+    return true;
+#endif
 }
 
 bool ShmemCarrier::becomeShmem(yarp::os::ConnectionState& proto, bool sender)
 {
+    if (m_bRing) {
+        return becomeShmemVersionRingStream(proto, sender);
+    }
     return becomeShmemVersionHybridStream(proto, sender);
 }
 
 bool ShmemCarrier::respondToHeader(yarp::os::ConnectionState& proto)
 {
     // i am the receiver
+    configureFromSpecifier(proto.getSenderSpecifier());
     return becomeShmem(proto, false);
 }
 
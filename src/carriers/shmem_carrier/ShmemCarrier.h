@@ -12,9 +12,15 @@
 
 #include <yarp/os/AbstractCarrier.h>
 
+#include <string>
+
 
 /**
  * Communicating between two ports via shared memory.
+ *
+ * By default the ACE based hybrid stream is used.  The "ring" parameter
+ * (i.e. "shmem+ring" or "shmem+ring+size.16777216") selects instead a
+ * lock-free ring buffer on a POSIX shared memory segment (Linux only).
  */
 class ShmemCarrier : public yarp::os::AbstractCarrier
 {
@@ -35,9 +41,18 @@ public:
     bool respondToHeader(yarp::os::ConnectionState& proto) override;
     bool expectReplyToHeader(yarp::os::ConnectionState& proto) override;
 
+    // The initiator reads the carrier parameters from the connection string
+    // (i.e. shmem+ring), the recipient from the sender specifier.
+    bool configure(yarp::os::ConnectionState& proto) override;
+
 private:
+    void configureFromSpecifier(const std::string& specifier);
     bool becomeShmemVersionHybridStream(yarp::os::ConnectionState& proto, bool sender);
+    bool becomeShmemVersionRingStream(yarp::os::ConnectionState& proto, bool sender);
     bool becomeShmem(yarp::os::ConnectionState& proto, bool sender);
+
+    bool m_bRing{false};
+    size_t m_RingSize{0};
 };
 
 #endif // YARP_SHMEM_SHMEMCARRIER_H
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmemRingBuffer.h"
+#include "ShmemLogComponent.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static_assert(sizeof(ShmemRingHeader_t) % SHMEM_CACHE_LINE_SIZE == 0,
+              "The ring data must start on a cache line boundary");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "The ring indexes must be lock free to be shared between processes");
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "The futex words must be plain 32 bit integers");
+
+namespace {
+
+// The futex words are shared between processes, therefore the
+// FUTEX_PRIVATE_FLAG variants cannot be used here.
+int futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected, int timeoutMs)
+{
+    struct timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0));
+}
+
+void futexWake(std::atomic<std::uint32_t>& word)
+{
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+size_t roundUpToPowerOfTwo(size_t size)
+{
+    size_t ret = SHMEM_DEFAULT_SIZE;
+    while (ret < size) {
+        ret <<= 1;
+    }
+    return ret;
+}
+
+} // namespace
+
+
+ShmemRingBuffer::~ShmemRingBuffer()
+{
+    close();
+    if (m_bOwner) {
+        unlink();
+    }
+    if (m_pMap != nullptr) {
+        munmap(m_pMap, m_MapSize);
+        m_pMap = nullptr;
+        m_pHeader = nullptr;
+        m_pData = nullptr;
+    }
+}
+
+bool ShmemRingBuffer::map(int fd, size_t total)
+{
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    // Prefault the whole ring now, instead of paying the page faults while
+    // the first frames are being sent.
+    flags |= MAP_POPULATE;
+#endif
+    void* addr = mmap(nullptr, total, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (addr == MAP_FAILED) {
+        yCError(SHMEMCARRIER, "mmap() error on %s: %d, %s", m_Name.c_str(), errno, strerror(errno));
+        return false;
+    }
+    m_pMap = addr;
+    m_MapSize = total;
+    m_pHeader = static_cast<ShmemRingHeader_t*>(addr);
+    m_pData = static_cast<char*>(addr) + sizeof(ShmemRingHeader_t);
+    return true;
+}
+
+bool ShmemRingBuffer::create(const std::string& name, size_t size, bool producer)
+{
+    m_Name = name;
+    m_bProducer = producer;
+
+    size_t capacity = roundUpToPowerOfTwo(size);
+    size_t total = sizeof(ShmemRingHeader_t) + capacity;
+
+    // Remove any leftover of a previous connection that was not closed.
+    shm_unlink(m_Name.c_str());
+
+    int fd = shm_open(m_Name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        yCError(SHMEMCARRIER, "shm_open() error on %s: %d, %s", m_Name.c_str(), errno, strerror(errno));
+        return false;
+    }
+    m_bOwner = true;
+
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        yCError(SHMEMCARRIER, "ftruncate() error on %s: %d, %s", m_Name.c_str(), errno, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    bool ok = map(fd, total);
+    ::close(fd);
+    if (!ok) {
+        return false;
+    }
+
+    new (m_pHeader) ShmemRingHeader_t();
+    m_pHeader->capacity = capacity;
+    m_pHeader->producerPid = producer ? getpid() : 0;
+    m_pHeader->consumerPid = producer ? 0 : getpid();
+    m_pHeader->head.store(0, std::memory_order_relaxed);
+    m_pHeader->tail.store(0, std::memory_order_relaxed);
+    m_pHeader->dataSeq.store(0, std::memory_order_relaxed);
+    m_pHeader->readerWaiting.store(0, std::memory_order_relaxed);
+    m_pHeader->spaceSeq.store(0, std::memory_order_relaxed);
+    m_pHeader->writerWaiting.store(0, std::memory_order_relaxed);
+    m_pHeader->closed.store(0, std::memory_order_relaxed);
+    m_pHeader->magic = SHMEM_RING_MAGIC;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_Mask = capacity - 1;
+    m_CachedHead = 0;
+    m_CachedTail = 0;
+
+    return true;
+}
+
+bool ShmemRingBuffer::attach(const std::string& name, bool producer)
+{
+    m_Name = name;
+    m_bProducer = producer;
+    m_bOwner = false;
+
+    int fd = shm_open(m_Name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        yCError(SHMEMCARRIER, "shm_open() error on %s: %d, %s", m_Name.c_str(), errno, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) <= sizeof(ShmemRingHeader_t)) {
+        yCError(SHMEMCARRIER, "Invalid shared memory segment %s", m_Name.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    bool ok = map(fd, static_cast<size_t>(st.st_size));
+    ::close(fd);
+    if (!ok) {
+        return false;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_pHeader->magic != SHMEM_RING_MAGIC || sizeof(ShmemRingHeader_t) + m_pHeader->capacity > m_MapSize) {
+        yCError(SHMEMCARRIER, "Shared memory segment %s is not a valid ring", m_Name.c_str());
+        return false;
+    }
+
+    if (producer) {
+        m_pHeader->producerPid = getpid();
+    } else {
+        m_pHeader->consumerPid = getpid();
+    }
+
+    m_Mask = m_pHeader->capacity - 1;
+    m_CachedHead = m_pHeader->head.load(std::memory_order_acquire);
+    m_CachedTail = m_pHeader->tail.load(std::memory_order_acquire);
+
+    return true;
+}
+
+void ShmemRingBuffer::unlink()
+{
+    if (m_bOwner) {
+        shm_unlink(m_Name.c_str());
+        m_bOwner = false;
+    }
+}
+
+size_t ShmemRingBuffer::capacity() const
+{
+    return (m_pHeader != nullptr) ? static_cast<size_t>(m_pHeader->capacity) : 0;
+}
+
+bool ShmemRingBuffer::isOk() const
+{
+    return m_pHeader != nullptr && m_pHeader->closed.load(std::memory_order_acquire) == 0;
+}
+
+void ShmemRingBuffer::close()
+{
+    if (m_pHeader == nullptr) {
+        return;
+    }
+    if (m_pHeader->closed.exchange(1, std::memory_order_acq_rel) != 0) {
+        return;
+    }
+    m_pHeader->dataSeq.fetch_add(1, std::memory_order_release);
+    futexWake(m_pHeader->dataSeq);
+    m_pHeader->spaceSeq.fetch_add(1, std::memory_order_release);
+    futexWake(m_pHeader->spaceSeq);
+}
+
+bool ShmemRingBuffer::peerAlive() const
+{
+    pid_t pid = m_bProducer ? m_pHeader->consumerPid : m_pHeader->producerPid;
+    if (pid == 0) {
+        return true;
+    }
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+void ShmemRingBuffer::wake(std::atomic<std::uint32_t>& seq, std::atomic<std::uint32_t>& waiting)
+{
+    // Pairs with the fence in the waiting side: either the waiting side
+    // sees the new index, or this side sees the waiting flag.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed) != 0) {
+        seq.fetch_add(1, std::memory_order_release);
+        futexWake(seq);
+    }
+}
+
+void ShmemRingBuffer::wait(std::atomic<std::uint32_t>& seq, std::uint32_t expected)
+{
+    if (futexWait(seq, expected, waitTimeoutMs) != 0 && errno == ETIMEDOUT) {
+        // Nobody woke us up. If the other process died without closing the
+        // ring, nobody ever will.
+        if (!peerAlive()) {
+            yCWarning(SHMEMCARRIER, "The other end of %s is gone", m_Name.c_str());
+            close();
+        }
+    }
+}
+
+bool ShmemRingBuffer::write(const char* data, size_t len)
+{
+    if (m_pHeader == nullptr) {
+        return false;
+    }
+
+    const std::uint64_t capacity = m_pHeader->capacity;
+
+    while (len > 0) {
+        if (m_pHeader->closed.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+
+        const std::uint64_t head = m_pHeader->head.load(std::memory_order_relaxed);
+        std::uint64_t space = capacity - (head - m_CachedTail);
+        if (space == 0) {
+            m_CachedTail = m_pHeader->tail.load(std::memory_order_acquire);
+            space = capacity - (head - m_CachedTail);
+        }
+
+        if (space == 0) {
+            std::uint32_t seq = m_pHeader->spaceSeq.load(std::memory_order_acquire);
+            m_pHeader->writerWaiting.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_CachedTail = m_pHeader->tail.load(std::memory_order_acquire);
+            if (head - m_CachedTail == capacity) {
+                wait(m_pHeader->spaceSeq, seq);
+            }
+            m_pHeader->writerWaiting.store(0, std::memory_order_relaxed);
+            continue;
+        }
+
+        const size_t chunk = static_cast<size_t>(std::min<std::uint64_t>(len, space));
+        const size_t offset = static_cast<size_t>(head & m_Mask);
+        const size_t first = std::min(chunk, static_cast<size_t>(capacity) - offset);
+        memcpy(m_pData + offset, data, first);
+        if (chunk > first) {
+            memcpy(m_pData, data + first, chunk - first);
+        }
+        m_pHeader->head.store(head + chunk, std::memory_order_release);
+        wake(m_pHeader->dataSeq, m_pHeader->readerWaiting);
+
+        data += chunk;
+        len -= chunk;
+    }
+
+    return true;
+}
+
+yarp::conf::ssize_t ShmemRingBuffer::read(char* data, size_t len)
+{
+    if (m_pHeader == nullptr) {
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    const std::uint64_t capacity = m_pHeader->capacity;
+
+    while (true) {
+        const std::uint64_t tail = m_pHeader->tail.load(std::memory_order_relaxed);
+        std::uint64_t avail = m_CachedHead - tail;
+        if (avail == 0) {
+            m_CachedHead = m_pHeader->head.load(std::memory_order_acquire);
+            avail = m_CachedHead - tail;
+        }
+
+        if (avail > 0) {
+            const size_t chunk = static_cast<size_t>(std::min<std::uint64_t>(len, avail));
+            const size_t offset = static_cast<size_t>(tail & m_Mask);
+            const size_t first = std::min(chunk, static_cast<size_t>(capacity) - offset);
+            memcpy(data, m_pData + offset, first);
+            if (chunk > first) {
+                memcpy(data + first, m_pData, chunk - first);
+            }
+            m_pHeader->tail.store(tail + chunk, std::memory_order_release);
+            wake(m_pHeader->spaceSeq, m_pHeader->writerWaiting);
+            return static_cast<yarp::conf::ssize_t>(chunk);
+        }
+
+        // Data written before closing is still delivered.
+        if (m_pHeader->closed.load(std::memory_order_acquire) != 0) {
+            return -1;
+        }
+
+        std::uint32_t seq = m_pHeader->dataSeq.load(std::memory_order_acquire);
+        m_pHeader->readerWaiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_CachedHead = m_pHeader->head.load(std::memory_order_acquire);
+        if (m_CachedHead == tail && m_pHeader->closed.load(std::memory_order_acquire) == 0) {
+            wait(m_pHeader->dataSeq, seq);
+        }
+        m_pHeader->readerWaiting.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHMEM_SHMEMRINGBUFFER_H
+#define YARP_SHMEM_SHMEMRINGBUFFER_H
+
+#include "ShmemTypes.h"
+
+#include <yarp/conf/numeric.h>
+
+#include <cstddef>
+#include <string>
+
+
+/**
+ * Single-producer/single-consumer byte ring living in a POSIX shared memory
+ * segment.
+ *
+ * One process creates the segment (create()), the other one maps it
+ * (attach()).  Data is exchanged without any lock: the producer publishes
+ * the new `head` and the consumer publishes the new `tail`.  When the ring
+ * is empty (or full) the waiting side sleeps on a futex, and is woken up by
+ * the other side only if it is actually sleeping.
+ */
+class ShmemRingBuffer
+{
+public:
+    ShmemRingBuffer() = default;
+    ShmemRingBuffer(const ShmemRingBuffer&) = delete;
+    ShmemRingBuffer(ShmemRingBuffer&&) = delete;
+    ShmemRingBuffer& operator=(const ShmemRingBuffer&) = delete;
+    ShmemRingBuffer& operator=(ShmemRingBuffer&&) = delete;
+    ~ShmemRingBuffer();
+
+    /**
+     * Create a new segment.  The capacity is rounded up to the next power
+     * of two and preallocated, so that a full frame fits in the ring.
+     */
+    bool create(const std::string& name, size_t size, bool producer);
+
+    /**
+     * Map a segment previously created by the other endpoint.
+     */
+    bool attach(const std::string& name, bool producer);
+
+    /**
+     * Remove the name of the segment.  The memory is released when both
+     * endpoints have unmapped it.
+     */
+    void unlink();
+
+    /**
+     * Copy all the data in the ring, waiting for space if needed.
+     * @return false if the ring was closed
+     */
+    bool write(const char* data, size_t len);
+
+    /**
+     * Copy up to len bytes from the ring, waiting until some are available.
+     * @return the number of bytes read, or -1 if the ring was closed and
+     *         there is nothing left to read
+     */
+    yarp::conf::ssize_t read(char* data, size_t len);
+
+    /**
+     * Mark the ring as closed and wake up both endpoints.
+     * The segment stays mapped until the object is destroyed.
+     */
+    void close();
+
+    bool isOk() const;
+
+    size_t capacity() const;
+
+private:
+    bool map(int fd, size_t total);
+    bool peerAlive() const;
+    void wake(std::atomic<std::uint32_t>& seq, std::atomic<std::uint32_t>& waiting);
+    void wait(std::atomic<std::uint32_t>& seq, std::uint32_t expected);
+
+    std::string m_Name;
+    bool m_bProducer{false};
+    bool m_bOwner{false};
+
+    void* m_pMap{nullptr};
+    size_t m_MapSize{0};
+    ShmemRingHeader_t* m_pHeader{nullptr};
+    char* m_pData{nullptr};
+    std::uint64_t m_Mask{0};
+
+    // Local copies of the other endpoint index, refreshed only when the
+    // ring looks full (or empty), to avoid touching the shared cache line.
+    std::uint64_t m_CachedHead{0};
+    std::uint64_t m_CachedTail{0};
+
+    static constexpr int waitTimeoutMs = 100;
+};
+
+#endif // YARP_SHMEM_SHMEMRINGBUFFER_H
@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmemRingStream.h"
+#include "ShmemLogComponent.h"
+
+#include <yarp/os/Bytes.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using yarp::os::SharedBufferPool;
+
+ShmemRingStream::ShmemRingStream(const std::string& baseName) :
+        m_BaseName(baseName)
+{
+}
+
+ShmemRingStream::~ShmemRingStream()
+{
+    close();
+    for (auto& it : m_Mappings) {
+        munmap(const_cast<char*>(it.second.map), it.second.size);
+    }
+}
+
+bool ShmemRingStream::open(bool sender, size_t size)
+{
+    // "s2r" carries data from the sender of the connection to the receiver,
+    // "r2s" carries acknowledgements and replies back to the sender.
+    const std::string s2r = m_BaseName + "_s2r";
+    const std::string r2s = m_BaseName + "_r2s";
+
+    bool ok;
+    if (sender) {
+        ok = m_Out.attach(s2r, true) && m_In.attach(r2s, false);
+    } else {
+        ok = m_In.create(s2r, size, false) && m_Out.create(r2s, size, true);
+    }
+
+    if (!ok) {
+        yCError(SHMEMCARRIER, "ShmemRingStream can't %s shared memory %s", (sender ? "attach" : "create"), m_BaseName.c_str());
+        return false;
+    }
+
+    yCDebug(SHMEMCARRIER, "ShmemRingStream %s opened with %zu bytes per direction", m_BaseName.c_str(), m_In.capacity());
+
+    m_bLinked = true;
+    return true;
+}
+
+void ShmemRingStream::unlink()
+{
+    m_In.unlink();
+    m_Out.unlink();
+}
+
+void ShmemRingStream::close()
+{
+    m_bLinked = false;
+    m_In.close();
+    m_Out.close();
+    unpinAll();
+}
+
+void ShmemRingStream::interrupt()
+{
+    yCDebug(SHMEMCARRIER, "INTERRUPT");
+    close();
+}
+
+void ShmemRingStream::write(const yarp::os::Bytes& b)
+{
+    if (b.length() == 0) {
+        return;
+    }
+
+    ShmemRingRecord_t record{SHMEM_RING_RECORD_DATA, 0, b.length()};
+    SharedBufferPool::Handle handle;
+    bool ok;
+    if (SharedBufferPool::getInstance().pin(b.get(), b.length(), handle)) {
+        {
+            std::lock_guard<std::mutex> lock(m_PinnedMutex);
+            m_Pinned.push_back(handle);
+        }
+        record.type = SHMEM_RING_RECORD_HANDLE;
+        ok = m_Out.write(reinterpret_cast<const char*>(&record), sizeof(record)) &&
+             m_Out.write(reinterpret_cast<const char*>(&handle), sizeof(handle));
+    } else {
+        ok = m_Out.write(reinterpret_cast<const char*>(&record), sizeof(record)) &&
+             m_Out.write(b.get(), b.length());
+    }
+    if (!ok) {
+        close();
+    }
+}
+
+yarp::conf::ssize_t ShmemRingStream::read(yarp::os::Bytes& b)
+{
+    if (b.length() == 0) {
+        return 0;
+    }
+    if (m_Remaining == 0) {
+        if (!readRecord()) {
+            close();
+            return -1;
+        }
+        // The sender gets the acknowledgement (or the reply) of a message
+        // when the receiver is done with it
+        unpinAll();
+    }
+
+    const size_t len = std::min(b.length(), m_Remaining);
+
+    if (m_pBufferData != nullptr) {
+        memcpy(b.get(), m_pBufferData, len);
+        m_pBufferData += len;
+        m_Remaining -= len;
+        if (m_Remaining == 0) {
+            m_pBufferData = nullptr;
+            // The sender reused the buffer while we were reading it
+            if (!checkGeneration()) {
+                yCError(SHMEMCARRIER, "ShmemRingStream shared buffer %u changed while reading it", m_Handle.segment);
+                close();
+                return -1;
+            }
+        }
+        return static_cast<yarp::conf::ssize_t>(len);
+    }
+
+    yarp::conf::ssize_t ret = m_In.read(b.get(), len);
+    if (ret == -1) {
+        close();
+        return -1;
+    }
+    m_Remaining -= static_cast<size_t>(ret);
+    return ret;
+}
+
+bool ShmemRingStream::readRing(char* data, size_t len)
+{
+    while (len > 0) {
+        yarp::conf::ssize_t ret = m_In.read(data, len);
+        if (ret <= 0) {
+            return false;
+        }
+        data += ret;
+        len -= static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool ShmemRingStream::readRecord()
+{
+    ShmemRingRecord_t record;
+    if (!readRing(reinterpret_cast<char*>(&record), sizeof(record))) {
+        return false;
+    }
+
+    if (record.type == SHMEM_RING_RECORD_DATA) {
+        m_Remaining = static_cast<size_t>(record.length);
+        return true;
+    }
+
+    if (record.type != SHMEM_RING_RECORD_HANDLE || !readRing(reinterpret_cast<char*>(&m_Handle), sizeof(m_Handle))) {
+        yCError(SHMEMCARRIER, "ShmemRingStream received an invalid record");
+        return false;
+    }
+
+    m_pBuffer = mapBuffer(m_Handle);
+    if (m_pBuffer == nullptr) {
+        return false;
+    }
+    if (m_Handle.offset < SharedBufferPool::dataOffset ||
+        m_Handle.offset > m_pBuffer->size ||
+        m_Handle.length > m_pBuffer->size - m_Handle.offset ||
+        m_Handle.length != record.length) {
+        yCError(SHMEMCARRIER, "ShmemRingStream received a handle outside of shared buffer %u", m_Handle.segment);
+        return false;
+    }
+    if (!checkGeneration()) {
+        yCError(SHMEMCARRIER, "ShmemRingStream received a stale handle for shared buffer %u", m_Handle.segment);
+        return false;
+    }
+
+    m_pBufferData = m_pBuffer->map + m_Handle.offset;
+    m_Remaining = static_cast<size_t>(m_Handle.length);
+    return true;
+}
+
+const ShmemRingStream::Mapping* ShmemRingStream::mapBuffer(const SharedBufferPool::Handle& handle)
+{
+    auto it = m_Mappings.find(handle.segment);
+    if (it != m_Mappings.end()) {
+        return &it->second;
+    }
+
+    // Segment ids are never reused by the sender, the oldest mappings are
+    // likely to refer to buffers already released.
+    if (m_Mappings.size() >= maxMappings) {
+        auto oldest = m_Mappings.begin();
+        munmap(const_cast<char*>(oldest->second.map), oldest->second.size);
+        m_Mappings.erase(oldest);
+    }
+
+    const std::string name = SharedBufferPool::segmentName(handle.pid, handle.segment);
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        yCError(SHMEMCARRIER, "ShmemRingStream can't open shared buffer %s", name.c_str());
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < SharedBufferPool::dataOffset) {
+        yCError(SHMEMCARRIER, "ShmemRingStream can't get the size of shared buffer %s", name.c_str());
+        ::close(fd);
+        return nullptr;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        yCError(SHMEMCARRIER, "ShmemRingStream can't map shared buffer %s", name.c_str());
+        return nullptr;
+    }
+    if (static_cast<const SharedBufferPool::SegmentHeader*>(map)->magic != SharedBufferPool::segmentMagic) {
+        yCError(SHMEMCARRIER, "ShmemRingStream %s is not a shared buffer", name.c_str());
+        munmap(map, size);
+        return nullptr;
+    }
+
+    yCDebug(SHMEMCARRIER, "ShmemRingStream mapped shared buffer %s", name.c_str());
+    return &(m_Mappings[handle.segment] = Mapping{static_cast<const char*>(map), size});
+}
+
+bool ShmemRingStream::checkGeneration() const
+{
+    const auto* header = reinterpret_cast<const SharedBufferPool::SegmentHeader*>(m_pBuffer->map);
+    return header->generation.load(std::memory_order_acquire) == m_Handle.generation;
+}
+
+void ShmemRingStream::unpinAll()
+{
+    std::lock_guard<std::mutex> lock(m_PinnedMutex);
+    for (const auto& handle : m_Pinned) {
+        SharedBufferPool::getInstance().unpin(handle);
+    }
+    m_Pinned.clear();
+}
+
+yarp::os::InputStream& ShmemRingStream::getInputStream()
+{
+    return *this;
+}
+
+yarp::os::OutputStream& ShmemRingStream::getOutputStream()
+{
+    return *this;
+}
+
+bool ShmemRingStream::isOk() const
+{
+    return m_bLinked && m_In.isOk() && m_Out.isOk();
+}
+
+void ShmemRingStream::reset()
+{
+    yCDebug(SHMEMCARRIER, "RECEIVED RESET COMMAND");
+    close();
+}
+
+void ShmemRingStream::beginPacket()
+{
+}
+
+void ShmemRingStream::endPacket()
+{
+}
+
+const yarp::os::Contact& ShmemRingStream::getLocalAddress() const
+{
+    return m_LocalAddress;
+}
+
+const yarp::os::Contact& ShmemRingStream::getRemoteAddress() const
+{
+    return m_RemoteAddress;
+}
+
+void ShmemRingStream::setLocalAddress(const yarp::os::Contact& localAddress)
+{
+    m_LocalAddress = localAddress;
+}
+
+void ShmemRingStream::setRemoteAddress(const yarp::os::Contact& remoteAddress)
+{
+    m_RemoteAddress = remoteAddress;
+}
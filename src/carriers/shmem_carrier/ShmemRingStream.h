@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHMEM_SHMEMRINGSTREAM_H
+#define YARP_SHMEM_SHMEMRINGSTREAM_H
+
+#include <yarp/os/Contact.h>
+#include <yarp/os/InputStream.h>
+#include <yarp/os/OutputStream.h>
+#include <yarp/os/SharedBufferPool.h>
+#include <yarp/os/TwoWayStream.h>
+
+#include "ShmemRingBuffer.h"
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * A stream abstraction for the "shmem+ring" carrier.
+ *
+ * Each direction of the connection is a lock-free single-producer/
+ * single-consumer ring.  Both segments are created by the receiver of the
+ * connection and mapped by the sender; no socket is used after the
+ * initial handshake.
+ *
+ * Blocks that live in a yarp::os::SharedBufferPool buffer of the sender are
+ * not copied into the ring: only their handle is sent, and the receiver
+ * reads them from the buffer segment, that stays mapped for the following
+ * messages.  The sender keeps these buffers pinned until it reads the
+ * acknowledgement of the message, that the receiver sends after copying
+ * them.
+ */
+class ShmemRingStream :
+        public yarp::os::TwoWayStream,
+        public yarp::os::InputStream,
+        public yarp::os::OutputStream
+{
+public:
+    ShmemRingStream(const std::string& baseName);
+    ShmemRingStream(const ShmemRingStream&) = delete;
+    ShmemRingStream(ShmemRingStream&&) = delete;
+    ShmemRingStream& operator=(const ShmemRingStream&) = delete;
+    ShmemRingStream& operator=(ShmemRingStream&&) = delete;
+
+    ~ShmemRingStream() override;
+
+    /**
+     * The receiver creates the two segments, the sender attaches to them.
+     */
+    bool open(bool sender, size_t size = SHMEM_RING_DEFAULT_SIZE);
+
+    /**
+     * Remove the names of the segments, once both processes mapped them.
+     */
+    void unlink();
+
+    void close() override;
+    void interrupt() override;
+
+    using yarp::os::OutputStream::write;
+    void write(const yarp::os::Bytes& b) override;
+
+    using yarp::os::InputStream::read;
+    yarp::conf::ssize_t read(yarp::os::Bytes& b) override;
+
+    yarp::os::InputStream& getInputStream() override;
+    yarp::os::OutputStream& getOutputStream() override;
+    bool isOk() const override;
+
+    void reset() override;
+
+    void beginPacket() override;
+    void endPacket() override;
+
+    const yarp::os::Contact& getLocalAddress() const override;
+    const yarp::os::Contact& getRemoteAddress() const override;
+
+    void setLocalAddress(const yarp::os::Contact& localAddress);
+    void setRemoteAddress(const yarp::os::Contact& remoteAddress);
+
+private:
+    struct Mapping
+    {
+        const char* map;
+        size_t size;
+    };
+
+    bool readRecord();
+    bool readRing(char* data, size_t len);
+    const Mapping* mapBuffer(const yarp::os::SharedBufferPool::Handle& handle);
+    bool checkGeneration() const;
+    void unpinAll();
+
+    std::string m_BaseName;
+    bool m_bLinked{false};
+
+    yarp::os::Contact m_LocalAddress;
+    yarp::os::Contact m_RemoteAddress;
+
+    ShmemRingBuffer m_In;
+    ShmemRingBuffer m_Out;
+
+    // Bytes left in the record being read.  If the record is a handle,
+    // m_pBufferData points to the next byte in the shared buffer.
+    size_t m_Remaining{0};
+    const char* m_pBufferData{nullptr};
+    const Mapping* m_pBuffer{nullptr};
+    yarp::os::SharedBufferPool::Handle m_Handle{};
+
+    // Shared buffers of the sender, by segment id
+    std::map<std::uint32_t, Mapping> m_Mappings;
+
+    // Shared buffers sent by this side and not acknowledged yet
+    std::mutex m_PinnedMutex;
+    std::vector<yarp::os::SharedBufferPool::Handle> m_Pinned;
+
+    static constexpr size_t maxMappings = 16;
+};
+
+#endif // YARP_SHMEM_SHMEMRINGSTREAM_H
@@ -10,8 +10,18 @@
 #ifndef YARP_SHMEM_SHMEMTYPES_H
 #define YARP_SHMEM_SHMEMTYPES_H
 
+#include <atomic>
+#include <cstdint>
+
 #define SHMEM_DEFAULT_SIZE 4096
 
+#define SHMEM_RING_DEFAULT_SIZE (8 * 1024 * 1024)
+#define SHMEM_RING_MAGIC 0x59524e47
+#define SHMEM_CACHE_LINE_SIZE 64
+
+#define SHMEM_RING_RECORD_DATA 0
+#define SHMEM_RING_RECORD_HANDLE 1
+
 struct ShmemHeader_t
 {
     bool resize;
@@ -32,4 +42,45 @@ struct ShmemPacket_t
     int size;
 };
 
+/**
+ * Control block at the beginning of a "shmem+ring" segment.
+ *
+ * The producer only writes `head`, the consumer only writes `tail`, and
+ * each of them lives on its own cache line, so that the two processes never
+ * write to the same line in the fast path.  `dataSeq` and `spaceSeq` are
+ * futex words used to sleep when the ring is empty or full.
+ */
+struct ShmemRingHeader_t
+{
+    alignas(SHMEM_CACHE_LINE_SIZE) std::uint32_t magic;
+    std::int32_t producerPid;
+    std::int32_t consumerPid;
+    std::uint64_t capacity;
+
+    alignas(SHMEM_CACHE_LINE_SIZE) std::atomic<std::uint64_t> head;
+
+    alignas(SHMEM_CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail;
+
+    alignas(SHMEM_CACHE_LINE_SIZE) std::atomic<std::uint32_t> dataSeq;
+    std::atomic<std::uint32_t> readerWaiting;
+
+    alignas(SHMEM_CACHE_LINE_SIZE) std::atomic<std::uint32_t> spaceSeq;
+    std::atomic<std::uint32_t> writerWaiting;
+
+    alignas(SHMEM_CACHE_LINE_SIZE) std::atomic<std::uint32_t> closed;
+};
+
+/**
+ * Every block written on a "shmem+ring" stream is preceded by a record.
+ * A SHMEM_RING_RECORD_DATA record is followed by `length` bytes of data,
+ * a SHMEM_RING_RECORD_HANDLE record by a yarp::os::SharedBufferPool::Handle
+ * referencing `length` bytes stored in a shared buffer of the sender.
+ */
+struct ShmemRingRecord_t
+{
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t length;
+};
+
 #endif // YARP_SHMEM_SHMEMTYPES_H
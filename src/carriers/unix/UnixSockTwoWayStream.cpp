@@ -14,7 +14,9 @@
 
 #include "UnixSockTwoWayStream.h"
 #include "UnixSocketLogComponent.h"
+#include <algorithm>
 #include <cerrno>
+#include <climits>
 #include <cstring>
 #include <fcntl.h> /* For O_* constants */
 #include <sys/socket.h>
@@ -186,6 +188,43 @@ void UnixSockTwoWayStream::write(const Bytes& b)
     }
 }
 
+void UnixSockTwoWayStream::writeBlocks(const Bytes* blocks, size_t count)
+{
+    if (reader_fd < 0) {
+        close();
+        return;
+    }
+    iov.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        iov[i].iov_base = const_cast<char*>(blocks[i].get());
+        iov[i].iov_len = blocks[i].length();
+    }
+    // Send everything with as few writev() calls as possible, resuming
+    // after partial writes.
+    iovec* next = iov.data();
+    size_t left = count;
+    while (left > 0) {
+        ssize_t writtenMem = ::writev(openedAsReader ? sender_fd : reader_fd, next, static_cast<int>(std::min<size_t>(left, IOV_MAX)));
+        if (writtenMem < 0) {
+            yCError(UNIXSOCK_CARRIER, "writev() error: %d, %s", errno, strerror(errno));
+            if (errno != ETIMEDOUT) {
+                close();
+            }
+            return;
+        }
+        auto written = static_cast<size_t>(writtenMem);
+        while (left > 0 && written >= next->iov_len) {
+            written -= next->iov_len;
+            ++next;
+            --left;
+        }
+        if (left > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + written;
+            next->iov_len -= written;
+        }
+    }
+}
+
 bool UnixSockTwoWayStream::isOk() const
 {
     return happy;
@@ -14,6 +14,9 @@
 #include <yarp/os/TwoWayStream.h>
 
 #include <mutex>
+#include <vector>
+
+#include <sys/uio.h>
 
 /**
  * A stream abstraction for unix socket communication.
@@ -46,6 +49,7 @@ public:
 
     using yarp::os::OutputStream::write;
     void write(const yarp::os::Bytes& b) override;
+    void writeBlocks(const yarp::os::Bytes* blocks, size_t count) override;
 
     bool isOk() const override;
 
@@ -68,6 +72,7 @@ private:
     std::string socketPath;
     int reader_fd{-1};
     int sender_fd{-1};
+    std::vector<iovec> iov;
 
     static constexpr size_t maxAttempts = 5;
     static constexpr double delayBetweenAttempts = 0.1;
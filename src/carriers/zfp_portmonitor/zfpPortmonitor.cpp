@@ -9,11 +9,14 @@
 #include "zfpPortmonitor.h"
 
 #include <yarp/os/LogComponent.h>
+#include <yarp/os/TransformCache.h>
 #include <yarp/sig/Image.h>
 
 #include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 extern "C" {
     #include "zfp.h"
@@ -29,6 +32,10 @@ YARP_LOG_COMPONENT(ZFPMONITOR,
                    yarp::os::Log::LogTypeReserved,
                    yarp::os::Log::printCallback(),
                    nullptr)
+
+// Accuracy of the compression, part of the key of the compressed images
+// in the TransformCache
+constexpr float tolerance = 1e-3;
 }
 
 
@@ -98,18 +105,30 @@ yarp::os::Things& ZfpMonitorObject::update(yarp::os::Things& thing)
 
    if(shouldCompress) {
         ImageOf<PixelFloat>* img = thing.cast_as< ImageOf<PixelFloat> >();
-        // .... buffer, len
-        int sizeCompressed;
-        compress((float*)img->getRawImage(), compressed, sizeCompressed, img->width(),img->height(),1e-3);
-        if(!compressed){
+        auto compressImage = [this, img]() -> std::shared_ptr<const std::vector<char>> {
+            int sizeCompressed;
+            if (compress((float*)img->getRawImage(), compressed, sizeCompressed, img->width(), img->height(), tolerance) != 0 || !compressed) {
+                return nullptr;
+            }
+            const char* begin = reinterpret_cast<const char*>(compressed);
+            return std::make_shared<std::vector<char>>(begin, begin + sizeCompressed);
+        };
+        // The connections of the port with this monitor share the compressed
+        // image
+        TransformCache* cache = TransformCache::getCurrent();
+        std::shared_ptr<const std::vector<char>> frame = (cache != nullptr) ?
+            cache->get<std::vector<char>>("zfp?tolerance=" + std::to_string(tolerance), compressImage) :
+            compressImage();
+        if(!frame){
             yCError(ZFPMONITOR, "Failed to compress, exiting...");
             return thing;
         }
+        int sizeCompressed = static_cast<int>(frame->size());
         data.clear();
         data.addInt32(img->width());
         data.addInt32(img->height());
         data.addInt32(sizeCompressed);
-        Value v(compressed, sizeCompressed);
+        Value v(const_cast<char*>(frame->data()), sizeCompressed);
         data.add(v);
         th.setPortWriter(&data);
    }
@@ -122,7 +141,7 @@ yarp::os::Things& ZfpMonitorObject::update(yarp::os::Things& thing)
        int height=compressedbt->get(1).asInt32();
        int sizeCompressed=compressedbt->get(2).asInt32();
        // cast thing to compressed.
-       decompress((float*)compressedbt->get(3).asBlob(), decompressed, sizeCompressed, width, height,1e-3);
+       decompress((float*)compressedbt->get(3).asBlob(), decompressed, sizeCompressed, width, height, tolerance);
 
        if(!decompressed){
            yCError(ZFPMONITOR, "Failed to decompress, exiting...");
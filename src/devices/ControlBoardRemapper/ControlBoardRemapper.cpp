@@ -14,6 +14,7 @@
 #include <yarp/os/LogStream.h>
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <mutex>
@@ -52,6 +53,8 @@ bool ControlBoardRemapper::parseOptions(Property& prop)
 {
     bool ok = true;
 
+    parallelSubdevices = prop.check("parallel_subdevices", Value(false), "read the subcontrolboards in parallel").asBool();
+
     usingAxesNamesForAttachAll  = prop.check("axesNames", "list of networks merged by this wrapper");
     usingNetworksForAttachAll = prop.check("networks", "list of networks merged by this wrapper");
 
@@ -467,6 +470,7 @@ bool ControlBoardRemapper::detachAll()
 {
     //check if we already instantiated a subdevice previously
     int devices=remappedControlBoards.getNrOfSubControlBoards();
+    parallelLoop.stop();
     for(int k=0;k<devices;k++)
         remappedControlBoards.getSubControlBoard(k)->detach();
 
@@ -478,6 +482,12 @@ void ControlBoardRemapper::configureBuffers()
 {
     allJointsBuffers.configure(remappedControlBoards);
     selectedJointsBuffers.configure(remappedControlBoards);
+
+    // The thread calling the methods reads a subcontrolboard as well
+    if (parallelSubdevices && remappedControlBoards.getNrOfSubControlBoards() > 1)
+    {
+        parallelLoop.start(remappedControlBoards.getNrOfSubControlBoards() - 1);
+    }
 }
 
 
@@ -1069,10 +1079,10 @@ bool ControlBoardRemapper::getTargetPosition(const int j, double* ref)
 
 bool ControlBoardRemapper::getTargetPositions(double *spds)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1089,8 +1099,11 @@ bool ControlBoardRemapper::getTargetPositions(double *spds)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(spds,remappedControlBoards);
 
@@ -1100,13 +1113,13 @@ bool ControlBoardRemapper::getTargetPositions(double *spds)
 
 bool ControlBoardRemapper::getTargetPositions(const int n_joints, const int *joints, double *targets)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(selectedJointsBuffers.mutex);
 
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1123,8 +1136,11 @@ bool ControlBoardRemapper::getTargetPositions(const int n_joints, const int *joi
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(targets,n_joints,joints,remappedControlBoards);
 
@@ -1420,10 +1436,10 @@ bool ControlBoardRemapper::getRefSpeed(int j, double *ref)
 
 bool ControlBoardRemapper::getRefSpeeds(double *spds)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1440,8 +1456,11 @@ bool ControlBoardRemapper::getRefSpeeds(double *spds)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(spds,remappedControlBoards);
 
@@ -1451,13 +1470,13 @@ bool ControlBoardRemapper::getRefSpeeds(double *spds)
 
 bool ControlBoardRemapper::getRefSpeeds(const int n_joints, const int *joints, double *spds)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(selectedJointsBuffers.mutex);
 
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1474,8 +1493,11 @@ bool ControlBoardRemapper::getRefSpeeds(const int n_joints, const int *joints, d
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(spds,n_joints,joints,remappedControlBoards);
 
@@ -1504,10 +1526,10 @@ bool ControlBoardRemapper::getRefAcceleration(int j, double *acc)
 
 bool ControlBoardRemapper::getRefAccelerations(double *accs)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1524,8 +1546,11 @@ bool ControlBoardRemapper::getRefAccelerations(double *accs)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(accs,remappedControlBoards);
 
@@ -1534,13 +1559,13 @@ bool ControlBoardRemapper::getRefAccelerations(double *accs)
 
 bool ControlBoardRemapper::getRefAccelerations(const int n_joints, const int *joints, double *accs)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(selectedJointsBuffers.mutex);
 
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1557,8 +1582,11 @@ bool ControlBoardRemapper::getRefAccelerations(const int n_joints, const int *jo
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(accs,n_joints,joints,remappedControlBoards);
 
@@ -3562,10 +3590,10 @@ bool ControlBoardRemapper::getControlMode(int j, int *mode)
 
 bool ControlBoardRemapper::getControlModes(int *modes)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3582,8 +3610,11 @@ bool ControlBoardRemapper::getControlModes(int *modes)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(modes,remappedControlBoards);
 
@@ -3593,13 +3624,13 @@ bool ControlBoardRemapper::getControlModes(int *modes)
 // iControlMode2
 bool ControlBoardRemapper::getControlModes(const int n_joints, const int *joints, int *modes)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(selectedJointsBuffers.mutex);
 
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3616,8 +3647,11 @@ bool ControlBoardRemapper::getControlModes(const int n_joints, const int *joints
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(modes,n_joints,joints,remappedControlBoards);
 
@@ -3804,10 +3838,10 @@ bool ControlBoardRemapper::getRefPosition(const int j, double* ref)
 
 bool ControlBoardRemapper::getRefPositions(double *spds)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3824,8 +3858,11 @@ bool ControlBoardRemapper::getRefPositions(double *spds)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(spds,remappedControlBoards);
 
@@ -3835,13 +3872,13 @@ bool ControlBoardRemapper::getRefPositions(double *spds)
 
 bool ControlBoardRemapper::getRefPositions(const int n_joints, const int *joints, double *targets)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(selectedJointsBuffers.mutex);
 
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3858,8 +3895,11 @@ bool ControlBoardRemapper::getRefPositions(const int n_joints, const int *joints
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(targets,n_joints,joints,remappedControlBoards);
 
@@ -3914,10 +3954,10 @@ bool ControlBoardRemapper::getRefVelocity(const int j, double* vel)
 
 bool ControlBoardRemapper::getRefVelocities(double* vels)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3934,8 +3974,11 @@ bool ControlBoardRemapper::getRefVelocities(double* vels)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(vels,remappedControlBoards);
 
@@ -3944,13 +3987,13 @@ bool ControlBoardRemapper::getRefVelocities(double* vels)
 
 bool ControlBoardRemapper::getRefVelocities(const int n_joints, const int* joints, double* vels)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(selectedJointsBuffers.mutex);
 
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3967,8 +4010,11 @@ bool ControlBoardRemapper::getRefVelocities(const int n_joints, const int* joint
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(vels,n_joints,joints,remappedControlBoards);
 
@@ -3997,13 +4043,13 @@ bool ControlBoardRemapper::getInteractionMode(int j, yarp::dev::InteractionModeE
 
 bool ControlBoardRemapper::getInteractionModes(int n_joints, int *joints, yarp::dev::InteractionModeEnum* modes)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(selectedJointsBuffers.mutex);
 
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -4020,8 +4066,11 @@ bool ControlBoardRemapper::getInteractionModes(int n_joints, int *joints, yarp::
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(modes,n_joints,joints,remappedControlBoards);
 
@@ -4030,10 +4079,10 @@ bool ControlBoardRemapper::getInteractionModes(int n_joints, int *joints, yarp::
 
 bool ControlBoardRemapper::getInteractionModes(yarp::dev::InteractionModeEnum* modes)
 {
-    bool ret=true;
+    std::atomic<bool> ret{true};
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    parallelLoop.run(remappedControlBoards.getNrOfSubControlBoards(), [&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -4050,8 +4099,11 @@ bool ControlBoardRemapper::getInteractionModes(yarp::dev::InteractionModeEnum* m
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        if (!ok)
+        {
+            ret = false;
+        }
+    });
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(modes,remappedControlBoards);
 
@@ -17,6 +17,7 @@
 #include <yarp/dev/IPreciselyTimed.h>
 #include <yarp/os/Semaphore.h>
 #include <yarp/dev/IMultipleWrapper.h>
+#include <yarp/dev/impl/ParallelLoop.h>
 
 #include <string>
 #include <vector>
@@ -41,6 +42,7 @@
  * | Parameter name | SubParameter   | Type    | Units          | Default Value | Required                    | Description                                                       | Notes |
  * |:--------------:|:--------------:|:-------:|:--------------:|:-------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
  * | axesNames     |      -         | vector of strings  | -      |   -           | Yes     | Ordered list of the axes that are part of the remapped device. |  |
+ * | parallel_subdevices | -        | bool    | -              | false         | No                          | Read all the subcontrolboards in parallel in the methods getting all the axes, so that they take as long as the slowest subcontrolboard | Uses one thread for each subcontrolboard but the first one |
  *
  * The axes are then mapped to the wrapped controlboard in the attachAll method, using the
  * values returned by the getAxisName method of the controlboard. If different axes
@@ -114,6 +116,10 @@ private:
     // Buffer data for multiple arbitrary joint methods
     ControlBoardArbitraryAxesDecomposition selectedJointsBuffers;
 
+    // Read the subcontrolboards in parallel in the multi joint methods
+    bool parallelSubdevices{false};
+    yarp::dev::impl::ParallelLoop parallelLoop;
+
     /**
      * Set the number of controlled axes, resizing appropriately
      * all the necessary buffers.
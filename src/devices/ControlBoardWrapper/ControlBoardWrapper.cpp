@@ -39,6 +39,8 @@ ControlBoardWrapper::ControlBoardWrapper() :yarp::os::PeriodicThread(0.02),
     top = 0;
     subDeviceOwned = nullptr;
     _verb = false;
+    wrapperThread = std::thread::id();
+    parallelSubdevices = false;
 
     // init ROS data
     rosNodeName = "";
@@ -79,6 +81,7 @@ bool ControlBoardWrapper::close()
     {
         yarp::os::PeriodicThread::stop();
     }
+    parallelLoop.stop();
 
     if(useROS != ROS_only)
     {
@@ -431,6 +434,8 @@ bool ControlBoardWrapper::open(Searchable& config)
         period = 0.02;
     }
 
+    parallelSubdevices = prop.check("parallel_subdevices", Value(false), "read the subdevices in parallel").asBool();
+
     // check if we need to create subdevice or if they are
     // passed later on thorugh attachAll()
     if(prop.check("subdevice"))
@@ -718,6 +723,41 @@ void ControlBoardWrapper::calculateMaxNumOfJointsInDevices()
         if(p->totalAxis > device.maxNumOfJointsInDevices)
             device.maxNumOfJointsInDevices = p->totalAxis;
     }
+
+    {
+        std::lock_guard<std::mutex> threadLock(threadScratch.mutex);
+        threadScratch.resize(device.maxNumOfJointsInDevices);
+    }
+    for (auto& scratch : callerScratch) {
+        std::lock_guard<std::mutex> callerLock(scratch.mutex);
+        scratch.resize(device.maxNumOfJointsInDevices);
+    }
+
+    subdeviceStates.resize(device.subdevices.size());
+    for(unsigned int d=0; d<device.subdevices.size(); d++)
+    {
+        subdeviceStates[d].resize(device.subdevices[d].totalAxis);
+    }
+}
+
+JointsScratch& ControlBoardWrapper::lockScratch(std::unique_lock<std::mutex>& lock)
+{
+    const std::thread::id caller = std::this_thread::get_id();
+    if (caller == wrapperThread.load()) {
+        lock = std::unique_lock<std::mutex>(threadScratch.mutex);
+        return threadScratch;
+    }
+    for (auto& scratch : callerScratch) {
+        std::unique_lock<std::mutex> tryLock(scratch.mutex, std::try_to_lock);
+        if (tryLock.owns_lock()) {
+            lock = std::move(tryLock);
+            return scratch;
+        }
+    }
+    // All in use: wait for one, spreading the callers over the pool
+    JointsScratch& scratch = callerScratch[std::hash<std::thread::id>()(caller) % callerScratchCount];
+    lock = std::unique_lock<std::mutex>(scratch.mutex);
+    return scratch;
 }
 
 bool ControlBoardWrapper::updateAxisName()
@@ -846,6 +886,13 @@ bool ControlBoardWrapper::attachAll(const PolyDriverList &polylist)
 
     updateAxisName();
     calculateMaxNumOfJointsInDevices();
+
+    // The wrapper thread reads a subdevice as well
+    if (parallelSubdevices && device.subdevices.size() > 1)
+    {
+        parallelLoop.start(device.subdevices.size() - 1);
+    }
+
     PeriodicThread::setPeriod(period);
     return PeriodicThread::start();
 }
@@ -858,6 +905,7 @@ bool ControlBoardWrapper::detachAll()
 
         if (yarp::os::PeriodicThread::isRunning())
             yarp::os::PeriodicThread::stop();
+        parallelLoop.stop();
 
         int devices=device.subdevices.size();
 
@@ -870,6 +918,12 @@ bool ControlBoardWrapper::detachAll()
         return true;
 }
 
+bool ControlBoardWrapper::threadInit()
+{
+    wrapperThread = std::this_thread::get_id();
+    return true;
+}
+
 void ControlBoardWrapper::run()
 {
     // check we are not overflowing with input messages
@@ -878,67 +932,46 @@ void ControlBoardWrapper::run()
         yCWarning(CONTROLBOARDWRAPPER) << "Number of streaming intput messages to be read is " << inputStreamingPort.getPendingReads() << " and can overflow";
     }
 
-    // Small optimization: Avoid to call getEncoders twice, one for YARP port
-    // and again for ROS topic.
-    //
-    // Calling getStuff here on ros_struct because it is a class member, hence
-    // always available. In the other side, to have the yarp struct to write into
-    // it will be rewuired to call port.prepare, that it is something I should
-    // not do if the wrapper is in ROS_only configuration.
+    // handle stateExt first
+    jointData* yarp_struct = nullptr;
+    if(useROS != ROS_only)
+    {
+        yarp_struct = &extendedOutputState_buffer.get();
 
-    bool positionsOk = getEncodersTimed(ros_struct.position.data(), times.data());
-    bool speedsOk    = getEncoderSpeeds(ros_struct.velocity.data());
-    bool torqueOk    = getTorques(ros_struct.effort.data());
+        yarp_struct->jointPosition.resize(controlledJoints);
+        yarp_struct->jointVelocity.resize(controlledJoints);
+        yarp_struct->jointAcceleration.resize(controlledJoints);
+        yarp_struct->motorPosition.resize(controlledJoints);
+        yarp_struct->motorVelocity.resize(controlledJoints);
+        yarp_struct->motorAcceleration.resize(controlledJoints);
+        yarp_struct->torque.resize(controlledJoints);
+        yarp_struct->pwmDutycycle.resize(controlledJoints);
+        yarp_struct->current.resize(controlledJoints);
+        yarp_struct->controlMode.resize(controlledJoints);
+        yarp_struct->interactionMode.resize(controlledJoints);
+    }
+
+    if(parallelLoop.getWorkers() > 0)
+    {
+        readStateInParallel(yarp_struct);
+    }
+    else
+    {
+        readState(yarp_struct);
+    }
 
     // Update the port envelope time by averaging all timestamps
     time.update(std::accumulate(times.begin(), times.end(), 0.0) / controlledJoints);
 
     if(useROS != ROS_only)
     {
-        // handle stateExt first
-        jointData &yarp_struct = extendedOutputState_buffer.get();
-
-        yarp_struct.jointPosition.resize(controlledJoints);
-        yarp_struct.jointVelocity.resize(controlledJoints);
-        yarp_struct.jointAcceleration.resize(controlledJoints);
-        yarp_struct.motorPosition.resize(controlledJoints);
-        yarp_struct.motorVelocity.resize(controlledJoints);
-        yarp_struct.motorAcceleration.resize(controlledJoints);
-        yarp_struct.torque.resize(controlledJoints);
-        yarp_struct.pwmDutycycle.resize(controlledJoints);
-        yarp_struct.current.resize(controlledJoints);
-        yarp_struct.controlMode.resize(controlledJoints);
-        yarp_struct.interactionMode.resize(controlledJoints);
-
-        // Get already stored data from before. This is to avoid a double call to HW device,
-        // which may require more time.        //
-        yarp_struct.jointPosition_isValid       = positionsOk;
-        std::copy(ros_struct.position.begin(), ros_struct.position.end(),  yarp_struct.jointPosition.begin());
-
-        yarp_struct.jointVelocity_isValid       = speedsOk;
-        std::copy(ros_struct.velocity.begin(), ros_struct.velocity.end(),  yarp_struct.jointVelocity.begin());
-
-        yarp_struct.torque_isValid              = torqueOk;
-        std::copy(ros_struct.effort.begin(), ros_struct.effort.end(),  yarp_struct.torque.begin());
-
-        // Get remaining data from HW
-        yarp_struct.jointAcceleration_isValid   = getEncoderAccelerations(yarp_struct.jointAcceleration.data());
-        yarp_struct.motorPosition_isValid       = getMotorEncoders(yarp_struct.motorPosition.data());
-        yarp_struct.motorVelocity_isValid       = getMotorEncoderSpeeds(yarp_struct.motorVelocity.data());
-        yarp_struct.motorAcceleration_isValid   = getMotorEncoderAccelerations(yarp_struct.motorAcceleration.data());
-        yarp_struct.torque_isValid              = getTorques(yarp_struct.torque.data());
-        yarp_struct.pwmDutycycle_isValid        = getDutyCycles(yarp_struct.pwmDutycycle.data());
-        yarp_struct.current_isValid             = getCurrents(yarp_struct.current.data());
-        yarp_struct.controlMode_isValid         = getControlModes(yarp_struct.controlMode.data());
-        yarp_struct.interactionMode_isValid     = getInteractionModes((yarp::dev::InteractionModeEnum* ) yarp_struct.interactionMode.data());
-
         extendedOutputStatePort.setEnvelope(time);
         extendedOutputState_buffer.write();
 
         // handle state:o
         yarp::sig::Vector& v = outputPositionStatePort.prepare();
         v.resize(controlledJoints);
-        std::copy(yarp_struct.jointPosition.begin(), yarp_struct.jointPosition.end(), v.begin());
+        std::copy(yarp_struct->jointPosition.begin(), yarp_struct->jointPosition.end(), v.begin());
 
         outputPositionStatePort.setEnvelope(time);
         outputPositionStatePort.write();
@@ -967,6 +1000,155 @@ void ControlBoardWrapper::run()
     }
 }
 
+void ControlBoardWrapper::readState(jointData* yarp_struct)
+{
+    // Small optimization: Avoid to call getEncoders twice, one for YARP port
+    // and again for ROS topic.
+    //
+    // Calling getStuff here on ros_struct because it is a class member, hence
+    // always available. In the other side, to have the yarp struct to write into
+    // it will be rewuired to call port.prepare, that it is something I should
+    // not do if the wrapper is in ROS_only configuration.
+
+    bool positionsOk = getEncodersTimed(ros_struct.position.data(), times.data());
+    bool speedsOk    = getEncoderSpeeds(ros_struct.velocity.data());
+    bool torqueOk    = getTorques(ros_struct.effort.data());
+
+    if(yarp_struct == nullptr)
+    {
+        return;
+    }
+
+    // Get already stored data from before. This is to avoid a double call to HW device,
+    // which may require more time.        //
+    yarp_struct->jointPosition_isValid       = positionsOk;
+    std::copy(ros_struct.position.begin(), ros_struct.position.end(),  yarp_struct->jointPosition.begin());
+
+    yarp_struct->jointVelocity_isValid       = speedsOk;
+    std::copy(ros_struct.velocity.begin(), ros_struct.velocity.end(),  yarp_struct->jointVelocity.begin());
+
+    yarp_struct->torque_isValid              = torqueOk;
+    std::copy(ros_struct.effort.begin(), ros_struct.effort.end(),  yarp_struct->torque.begin());
+
+    // Get remaining data from HW
+    yarp_struct->jointAcceleration_isValid   = getEncoderAccelerations(yarp_struct->jointAcceleration.data());
+    yarp_struct->motorPosition_isValid       = getMotorEncoders(yarp_struct->motorPosition.data());
+    yarp_struct->motorVelocity_isValid       = getMotorEncoderSpeeds(yarp_struct->motorVelocity.data());
+    yarp_struct->motorAcceleration_isValid   = getMotorEncoderAccelerations(yarp_struct->motorAcceleration.data());
+    yarp_struct->torque_isValid              = getTorques(yarp_struct->torque.data());
+    yarp_struct->pwmDutycycle_isValid        = getDutyCycles(yarp_struct->pwmDutycycle.data());
+    yarp_struct->current_isValid             = getCurrents(yarp_struct->current.data());
+    yarp_struct->controlMode_isValid         = getControlModes(yarp_struct->controlMode.data());
+    yarp_struct->interactionMode_isValid     = getInteractionModes((yarp::dev::InteractionModeEnum* ) yarp_struct->interactionMode.data());
+}
+
+void ControlBoardWrapper::readStateInParallel(jointData* yarp_struct)
+{
+    // Each subdevice writes its own joints, the time spent is the one of
+    // the slowest subdevice
+    parallelLoop.run(device.subdevices.size(), [this, yarp_struct](size_t d) {
+        readSubdeviceState(d, yarp_struct);
+    });
+
+    bool positionsOk = true;
+    bool speedsOk = true;
+    bool torqueOk = true;
+    for(const auto& state : subdeviceStates)
+    {
+        positionsOk = positionsOk && state.positionOk;
+        speedsOk = speedsOk && state.velocityOk;
+        torqueOk = torqueOk && state.torqueOk;
+    }
+
+    if(yarp_struct == nullptr)
+    {
+        return;
+    }
+
+    yarp_struct->jointPosition_isValid       = positionsOk;
+    std::copy(ros_struct.position.begin(), ros_struct.position.end(),  yarp_struct->jointPosition.begin());
+
+    yarp_struct->jointVelocity_isValid       = speedsOk;
+    std::copy(ros_struct.velocity.begin(), ros_struct.velocity.end(),  yarp_struct->jointVelocity.begin());
+
+    yarp_struct->torque_isValid              = torqueOk;
+    std::copy(ros_struct.effort.begin(), ros_struct.effort.end(),  yarp_struct->torque.begin());
+
+    yarp_struct->jointAcceleration_isValid   = true;
+    yarp_struct->motorPosition_isValid       = true;
+    yarp_struct->motorVelocity_isValid       = true;
+    yarp_struct->motorAcceleration_isValid   = true;
+    yarp_struct->pwmDutycycle_isValid        = true;
+    yarp_struct->current_isValid             = true;
+    yarp_struct->controlMode_isValid         = true;
+    yarp_struct->interactionMode_isValid     = true;
+    for(const auto& state : subdeviceStates)
+    {
+        yarp_struct->jointAcceleration_isValid   = yarp_struct->jointAcceleration_isValid && state.accelerationOk;
+        yarp_struct->motorPosition_isValid       = yarp_struct->motorPosition_isValid && state.motorPositionOk;
+        yarp_struct->motorVelocity_isValid       = yarp_struct->motorVelocity_isValid && state.motorVelocityOk;
+        yarp_struct->motorAcceleration_isValid   = yarp_struct->motorAcceleration_isValid && state.motorAccelerationOk;
+        yarp_struct->pwmDutycycle_isValid        = yarp_struct->pwmDutycycle_isValid && state.pwmDutycycleOk;
+        yarp_struct->current_isValid             = yarp_struct->current_isValid && state.currentOk;
+        yarp_struct->controlMode_isValid         = yarp_struct->controlMode_isValid && state.controlModeOk;
+        yarp_struct->interactionMode_isValid     = yarp_struct->interactionMode_isValid && state.interactionModeOk;
+    }
+}
+
+void ControlBoardWrapper::readSubdeviceState(size_t d, jointData* yarp_struct)
+{
+    SubDevice *p = device.getSubdevice(d);
+    SubDeviceState& state = subdeviceStates[d];
+
+    // Copy the joints of the subdevice read, if the reading succeeded
+    auto remap = [p](bool ok, const auto* src, auto* dst) {
+        if(ok)
+        {
+            for(int juser= p->wbase, jdevice=p->base; juser<=p->wtop; juser++, jdevice++)
+            {
+                dst[juser] = src[jdevice];
+            }
+        }
+        return ok;
+    };
+
+    double* values = state.values.data();
+    double* tValues = state.times.data();
+
+    state.positionOk = remap(p->iJntEnc && p->iJntEnc->getEncodersTimed(values, tValues), values, ros_struct.position.data());
+    remap(state.positionOk, tValues, times.data());
+    state.velocityOk = remap(p->iJntEnc && p->iJntEnc->getEncoderSpeeds(values), values, ros_struct.velocity.data());
+    state.torqueOk = remap(p->iTorque && p->iTorque->getTorques(values), values, ros_struct.effort.data());
+
+    if(yarp_struct == nullptr)
+    {
+        return;
+    }
+
+    bool currentOk = false;
+    if(p->iCurr)
+    {
+        currentOk = p->iCurr->getCurrents(values);
+    }
+    else if(p->amp)
+    {
+        currentOk = p->amp->getCurrents(values);
+    }
+    state.currentOk = remap(currentOk, values, yarp_struct->current.data());
+
+    state.accelerationOk = remap(p->iJntEnc && p->iJntEnc->getEncoderAccelerations(values), values, yarp_struct->jointAcceleration.data());
+    state.motorPositionOk = remap(p->iMotEnc && p->iMotEnc->getMotorEncoders(values), values, yarp_struct->motorPosition.data());
+    state.motorVelocityOk = remap(p->iMotEnc && p->iMotEnc->getMotorEncoderSpeeds(values), values, yarp_struct->motorVelocity.data());
+    state.motorAccelerationOk = remap(p->iMotEnc && p->iMotEnc->getMotorEncoderAccelerations(values), values, yarp_struct->motorAcceleration.data());
+    state.pwmDutycycleOk = remap(p->iPWM && p->iPWM->getDutyCycles(values), values, yarp_struct->pwmDutycycle.data());
+
+    int* modes = state.controlModes.data();
+    state.controlModeOk = remap(p->iMode && p->iMode->getControlModes(modes), modes, yarp_struct->controlMode.data());
+
+    yarp::dev::InteractionModeEnum* imodes = state.interactionModes.data();
+    state.interactionModeOk = remap(p->iInteract && p->iInteract->getInteractionModes(imodes), imodes, yarp_struct->interactionMode.data());
+}
+
 //
 //  IPid Interface
 //
@@ -1106,7 +1288,9 @@ bool ControlBoardWrapper::getPidError(const PidControlTypeEnum& pidtype, int j,
 
 bool ControlBoardWrapper::getPidErrors(const PidControlTypeEnum& pidtype, double *errs)
 {
-    auto* errors = new double [device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* errors = scratch.values.data();
 
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
@@ -1132,7 +1316,6 @@ bool ControlBoardWrapper::getPidErrors(const PidControlTypeEnum& pidtype, double
         }
     }
 
-    delete[] errors;
     return ret;
 }
 
@@ -1155,7 +1338,9 @@ bool ControlBoardWrapper::getPidOutput(const PidControlTypeEnum& pidtype, int j,
 
 bool ControlBoardWrapper::getPidOutputs(const PidControlTypeEnum& pidtype, double *outs)
 {
-    auto* outputs = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* outputs = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -1181,7 +1366,6 @@ bool ControlBoardWrapper::getPidOutputs(const PidControlTypeEnum& pidtype, doubl
         }
     }
 
-    delete [] outputs;
     return ret;
 }
 
@@ -1220,7 +1404,9 @@ bool ControlBoardWrapper::getPid(const PidControlTypeEnum& pidtype, int j, Pid *
 
 bool ControlBoardWrapper::getPids(const PidControlTypeEnum& pidtype, Pid *pids)
 {
-    Pid *pids_device = new Pid[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    Pid* pids_device = scratch.pids.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -1246,7 +1432,6 @@ bool ControlBoardWrapper::getPids(const PidControlTypeEnum& pidtype, Pid *pids)
         }
     }
 
-    delete[] pids_device;
     return ret;
 }
 
@@ -1266,7 +1451,9 @@ bool ControlBoardWrapper::getPidReference(const PidControlTypeEnum& pidtype, int
 
 bool ControlBoardWrapper::getPidReferences(const PidControlTypeEnum& pidtype, double *refs)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -1292,7 +1479,6 @@ bool ControlBoardWrapper::getPidReferences(const PidControlTypeEnum& pidtype, do
         }
     }
 
-    delete [] references;
     return ret;
 }
 
@@ -1313,7 +1499,9 @@ bool ControlBoardWrapper::getPidErrorLimit(const PidControlTypeEnum& pidtype, in
 
 bool ControlBoardWrapper::getPidErrorLimits(const PidControlTypeEnum& pidtype, double *limits)
 {
-    auto* lims = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* lims = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -1339,7 +1527,6 @@ bool ControlBoardWrapper::getPidErrorLimits(const PidControlTypeEnum& pidtype, d
         }
     }
 
-    delete [] lims;
     return ret;
 }
 
@@ -1450,6 +1637,9 @@ bool ControlBoardWrapper::positionMove(const double *refs)
     bool ret = true;
     int j_wrap = 0;         // index of the wrapper joint
 
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+
     int nDev = device.subdevices.size();
     for(int subDev_idx=0; subDev_idx < nDev; subDev_idx++)
     {
@@ -1462,7 +1652,7 @@ bool ControlBoardWrapper::positionMove(const double *refs)
         }
 
         int wrapped_joints=(p->top - p->base) + 1;
-        int *joints = new int[wrapped_joints];
+        int *joints = scratch.ints.data();
 
         if(p->pos)
         {
@@ -1479,10 +1669,6 @@ bool ControlBoardWrapper::positionMove(const double *refs)
         {
             ret=false;
         }
-
-        if(joints!=nullptr)
-        { delete [] joints;
-          joints = nullptr;}
     }
 
     return ret;
@@ -1555,7 +1741,9 @@ bool ControlBoardWrapper::getTargetPosition(const int j, double* ref)
 */
 bool ControlBoardWrapper::getTargetPositions(double *spds)
 {
-    auto* targets = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* targets = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -1581,7 +1769,6 @@ bool ControlBoardWrapper::getTargetPositions(double *spds)
         }
     }
 
-    delete [] targets;
     return ret;
 }
 
@@ -1875,6 +2062,9 @@ bool ControlBoardWrapper::setRefSpeeds(const double *spds)
     bool ret = true;
     int j_wrap = 0;         // index of the wrapper joint
 
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+
     for(unsigned int subDev_idx=0; subDev_idx < device.subdevices.size(); subDev_idx++)
     {
         SubDevice *p=device.getSubdevice(subDev_idx);
@@ -1883,7 +2073,7 @@ bool ControlBoardWrapper::setRefSpeeds(const double *spds)
             return false;
 
         int wrapped_joints=(p->top - p->base) + 1;
-        int *joints = new int[wrapped_joints];
+        int *joints = scratch.ints.data();
 
         if(p->pos)
         {
@@ -1900,10 +2090,6 @@ bool ControlBoardWrapper::setRefSpeeds(const double *spds)
         {
             ret=false;
         }
-
-        if(joints!=nullptr)
-        { delete [] joints;
-          joints = nullptr;}
     }
 
     return ret;
@@ -1984,6 +2170,9 @@ bool ControlBoardWrapper::setRefAccelerations(const double *accs)
     bool ret = true;
     int j_wrap = 0;    // index of the joint from the wrapper side (useful if wrapper joins 2 subdevices)
 
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+
     // for all subdevices
     for(unsigned int subDev_idx=0; subDev_idx < device.subdevices.size(); subDev_idx++)
     {
@@ -1993,7 +2182,7 @@ bool ControlBoardWrapper::setRefAccelerations(const double *accs)
             return false;
 
         int wrapped_joints=(p->top - p->base) + 1;
-        int *joints = new int[wrapped_joints];  // to be defined once and for all?
+        int *joints = scratch.ints.data();
 
         if(p->pos)
         {
@@ -2010,10 +2199,6 @@ bool ControlBoardWrapper::setRefAccelerations(const double *accs)
         {
             ret=false;
         }
-
-        if(joints!=nullptr)
-        { delete [] joints;
-        joints = nullptr;}
     }
 
     return ret;
@@ -2093,7 +2278,9 @@ bool ControlBoardWrapper::getRefSpeed(int j, double *ref) {
 */
 bool ControlBoardWrapper::getRefSpeeds(double *spds)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -2119,7 +2306,6 @@ bool ControlBoardWrapper::getRefSpeeds(double *spds)
         }
     }
 
-    delete [] references;
     return ret;
 }
 
@@ -2217,7 +2403,9 @@ bool ControlBoardWrapper::getRefAcceleration(int j, double *acc) {
 */
 bool ControlBoardWrapper::getRefAccelerations(double *accs)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -2243,7 +2431,6 @@ bool ControlBoardWrapper::getRefAccelerations(double *accs)
         }
     }
 
-    delete [] references;
     return ret;
 }
 
@@ -2420,6 +2607,9 @@ bool ControlBoardWrapper::velocityMove(const double *v)
     bool ret = true;
     int j_wrap = 0;         // index of the wrapper joint
 
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+
     for(unsigned int subDev_idx=0; subDev_idx < device.subdevices.size(); subDev_idx++)
     {
         SubDevice *p=device.getSubdevice(subDev_idx);
@@ -2428,7 +2618,7 @@ bool ControlBoardWrapper::velocityMove(const double *v)
             return false;
 
         int wrapped_joints=(p->top - p->base) + 1;
-        int *joints = new int[wrapped_joints];
+        int *joints = scratch.ints.data();
 
         if(p->vel)
         {
@@ -2445,10 +2635,6 @@ bool ControlBoardWrapper::velocityMove(const double *v)
         {
             ret=false;
         }
-
-        if(joints!=nullptr)
-        { delete [] joints;
-          joints = nullptr;}
     }
 
     return ret;
@@ -2548,7 +2734,9 @@ bool ControlBoardWrapper::getEncoder(int j, double *v) {
 
 bool ControlBoardWrapper::getEncoders(double *encs)
 {
-    auto* encValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* encValues = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -2574,15 +2762,16 @@ bool ControlBoardWrapper::getEncoders(double *encs)
         }
     }
 
-    delete [] encValues;
     return ret;
 
 }
 
 bool ControlBoardWrapper::getEncodersTimed(double *encs, double *t)
 {
-    auto* encValues = new double[device.maxNumOfJointsInDevices];
-    auto* tValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* encValues = scratch.values.data();
+    double* tValues = scratch.values2.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -2609,8 +2798,6 @@ bool ControlBoardWrapper::getEncodersTimed(double *encs, double *t)
         }
     }
 
-    delete [] encValues;
-    delete [] tValues;
     return ret;
 }
 
@@ -2648,7 +2835,9 @@ bool ControlBoardWrapper::getEncoderSpeed(int j, double *sp) {
 
 bool ControlBoardWrapper::getEncoderSpeeds(double *spds)
 {
-    auto* sValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* sValues = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -2674,7 +2863,6 @@ bool ControlBoardWrapper::getEncoderSpeeds(double *spds)
         }
     }
 
-    delete [] sValues;
     return ret;
 }
 
@@ -2696,7 +2884,9 @@ bool ControlBoardWrapper::getEncoderAcceleration(int j, double *acc) {
 
 bool ControlBoardWrapper::getEncoderAccelerations(double *accs)
 {
-    auto* aValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* aValues = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -2722,7 +2912,6 @@ bool ControlBoardWrapper::getEncoderAccelerations(double *accs)
         }
     }
 
-    delete [] aValues;
     return ret;
 }
 
@@ -2750,7 +2939,9 @@ bool ControlBoardWrapper::getTemperature      (int m, double* val) {
 
 bool ControlBoardWrapper::getTemperatures     (double *vals)
 {
-    auto* temps = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* temps = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -2776,7 +2967,6 @@ bool ControlBoardWrapper::getTemperatures     (double *vals)
         }
     }
 
-    delete [] temps;
     return ret;
 }
 
@@ -3033,7 +3223,9 @@ bool ControlBoardWrapper::getMotorEncoder(int m, double *v) {
 bool ControlBoardWrapper::getMotorEncoders(double *encs)
 {
 
-    auto* encValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* encValues = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -3059,14 +3251,15 @@ bool ControlBoardWrapper::getMotorEncoders(double *encs)
         }
     }
 
-    delete [] encValues;
     return ret;
 }
 
 bool ControlBoardWrapper::getMotorEncodersTimed(double *encs, double *t)
 {
-    auto* encValues = new double[device.maxNumOfJointsInDevices];
-    auto* tValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* encValues = scratch.values.data();
+    double* tValues = scratch.values2.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -3093,8 +3286,6 @@ bool ControlBoardWrapper::getMotorEncodersTimed(double *encs, double *t)
         }
     }
 
-    delete [] encValues;
-    delete [] tValues;
     return ret;
 }
 
@@ -3132,7 +3323,9 @@ bool ControlBoardWrapper::getMotorEncoderSpeed(int m, double *sp) {
 
 bool ControlBoardWrapper::getMotorEncoderSpeeds(double *spds)
 {
-    auto* sValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* sValues = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -3158,7 +3351,6 @@ bool ControlBoardWrapper::getMotorEncoderSpeeds(double *spds)
         }
     }
 
-    delete [] sValues;
     return ret;
 }
 
@@ -3180,7 +3372,9 @@ bool ControlBoardWrapper::getMotorEncoderAcceleration(int m, double *acc) {
 
 bool ControlBoardWrapper::getMotorEncoderAccelerations(double *accs)
 {
-    auto* aValues = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* aValues = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -3206,7 +3400,6 @@ bool ControlBoardWrapper::getMotorEncoderAccelerations(double *accs)
         }
     }
 
-    delete [] aValues;
     return ret;
 
 }
@@ -3262,7 +3455,9 @@ bool ControlBoardWrapper::disableAmp(int j)
 
 bool ControlBoardWrapper::getAmpStatus(int *st)
 {
-    int *status = new int[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    int* status = scratch.ints.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -3288,7 +3483,6 @@ bool ControlBoardWrapper::getAmpStatus(int *st)
         }
     }
 
-    delete [] status;
     return ret;
 }
 
@@ -3745,7 +3939,9 @@ bool ControlBoardWrapper::getJointType(int j, yarp::dev::JointTypeEnum& type)
 
 bool ControlBoardWrapper::getRefTorques(double *refs)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -3771,7 +3967,6 @@ bool ControlBoardWrapper::getRefTorques(double *refs)
         }
     }
 
-    delete [] references;
     return ret;
 }
 
@@ -3951,7 +4146,9 @@ bool ControlBoardWrapper::getTorque(int j, double *t)
 
 bool ControlBoardWrapper::getTorques(double *t)
 {
-    auto* trqs = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* trqs = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -3977,7 +4174,6 @@ bool ControlBoardWrapper::getTorques(double *t)
         }
     }
 
-    delete [] trqs;
     return ret;
 
  }
@@ -4001,8 +4197,10 @@ bool ControlBoardWrapper::getTorqueRange(int j, double *min, double *max)
 
 bool ControlBoardWrapper::getTorqueRanges(double *min, double *max)
 {
-    auto* t_min = new double[device.maxNumOfJointsInDevices];
-    auto* t_max = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* t_min = scratch.values.data();
+    double* t_max = scratch.values2.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4029,8 +4227,6 @@ bool ControlBoardWrapper::getTorqueRanges(double *min, double *max)
         }
     }
 
-    delete [] t_min;
-    delete [] t_max;
     return ret;
 
 }
@@ -4104,7 +4300,9 @@ bool ControlBoardWrapper::getControlMode(int j, int *mode)
 
 bool ControlBoardWrapper::getControlModes(int *modes)
 {
-    int *all_mode = new int[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    int* all_mode = scratch.ints.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4130,7 +4328,6 @@ bool ControlBoardWrapper::getControlModes(int *modes)
         }
     }
 
-    delete [] all_mode;
     return ret;
 
 }
@@ -4216,6 +4413,9 @@ bool ControlBoardWrapper::setControlModes(int *modes)
     bool ret = true;
     int j_wrap = 0;         // index of the wrapper joint
 
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+
     int nDev = device.subdevices.size();
     for(int subDev_idx=0; subDev_idx < nDev; subDev_idx++)
     {
@@ -4226,7 +4426,7 @@ bool ControlBoardWrapper::setControlModes(int *modes)
         }
 
         int wrapped_joints=(p->top - p->base) + 1;
-        int *joints = new int[wrapped_joints];
+        int *joints = scratch.ints.data();
 
         if(p->iMode)
         {
@@ -4239,12 +4439,6 @@ bool ControlBoardWrapper::setControlModes(int *modes)
             ret = ret && p->iMode->setControlModes(wrapped_joints, joints, &modes[j_wrap]);
             j_wrap+=wrapped_joints;
         }
-
-        if(joints!=nullptr)
-        {
-            delete [] joints;
-            joints = nullptr;
-        }
     }
 
     return ret;
@@ -4355,7 +4549,9 @@ bool ControlBoardWrapper::getRefPosition(const int j, double* ref)
 
 bool ControlBoardWrapper::getRefPositions(double *spds)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4381,7 +4577,6 @@ bool ControlBoardWrapper::getRefPositions(double *spds)
         }
     }
 
-    delete [] references;
     return ret;
 
 }
@@ -4503,7 +4698,9 @@ bool ControlBoardWrapper::getRefVelocity(const int j, double* vel)
 
 bool ControlBoardWrapper::getRefVelocities(double* vels)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4529,7 +4726,6 @@ bool ControlBoardWrapper::getRefVelocities(double* vels)
         }
     }
 
-    delete [] references;
     return ret;
 
 }
@@ -4664,7 +4860,9 @@ bool ControlBoardWrapper::getInteractionModes(int n_joints, int *joints, yarp::d
 bool ControlBoardWrapper::getInteractionModes(yarp::dev::InteractionModeEnum* modes)
 {
 
-    auto* imodes = new yarp::dev::InteractionModeEnum[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    yarp::dev::InteractionModeEnum* imodes = scratch.modes.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4690,7 +4888,6 @@ bool ControlBoardWrapper::getInteractionModes(yarp::dev::InteractionModeEnum* mo
         }
     }
 
-    delete [] imodes;
     return ret;
 }
 
@@ -4827,7 +5024,9 @@ bool ControlBoardWrapper::getRefDutyCycle(int j, double *v)
 
 bool ControlBoardWrapper::getRefDutyCycles(double *v)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4853,7 +5052,6 @@ bool ControlBoardWrapper::getRefDutyCycles(double *v)
         }
     }
 
-    delete [] references;
     return ret;
 
 }
@@ -4877,7 +5075,9 @@ bool ControlBoardWrapper::getDutyCycle(int j, double *v)
 
 bool ControlBoardWrapper::getDutyCycles(double *v)
 {
-    auto* dutyCicles = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* dutyCicles = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4903,7 +5103,6 @@ bool ControlBoardWrapper::getDutyCycles(double *v)
         }
     }
 
-    delete [] dutyCicles;
     return ret;
 
 }
@@ -4917,7 +5116,9 @@ bool ControlBoardWrapper::getDutyCycles(double *v)
 
 bool ControlBoardWrapper::getCurrents(double *vals)
 {
-    auto* currs = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* currs = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -4950,7 +5151,6 @@ bool ControlBoardWrapper::getCurrents(double *vals)
             break;
         }
     }
-    delete [] currs;
     return ret;
 }
 
@@ -4995,8 +5195,10 @@ bool ControlBoardWrapper::getCurrentRange(int j, double *min, double *max)
 
 bool ControlBoardWrapper::getCurrentRanges(double *min, double *max)
 {
-    auto* c_min = new double[device.maxNumOfJointsInDevices];
-    auto* c_max = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* c_min = scratch.values.data();
+    double* c_max = scratch.values2.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -5023,8 +5225,6 @@ bool ControlBoardWrapper::getCurrentRanges(double *min, double *max)
         }
     }
 
-    delete [] c_min;
-    delete [] c_max;
     return ret;
 
 }
@@ -5106,7 +5306,9 @@ bool ControlBoardWrapper::setRefCurrents(const int n_joint, const int *joints, c
 
 bool ControlBoardWrapper::getRefCurrents(double *t)
 {
-    auto* references = new double[device.maxNumOfJointsInDevices];
+    std::unique_lock<std::mutex> lock;
+    JointsScratch& scratch = lockScratch(lock);
+    double* references = scratch.values.data();
     bool ret = true;
     for(unsigned int d=0; d<device.subdevices.size(); d++)
     {
@@ -5132,7 +5334,6 @@ bool ControlBoardWrapper::getRefCurrents(double *t)
         }
     }
 
-    delete [] references;
     return ret;
 
 }
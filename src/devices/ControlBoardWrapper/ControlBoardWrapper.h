@@ -30,9 +30,13 @@
 #include <yarp/sig/Vector.h>
 #include <yarp/dev/IMultipleWrapper.h>
 #include <yarp/dev/ControlBoardHelpers.h>
+#include <yarp/dev/impl/ParallelLoop.h>
 
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <yarp/dev/impl/jointData.h>           // struct for YARP extended port
@@ -138,6 +142,7 @@ public:
  * |:--------------:|:--------------:|:-------:|:--------------:|:-------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
  * | name           |      -         | string  | -              |   -           | Yes                         | full name of the port opened by the device, like /robotName/part/ | MUST start with a '/' character |
  * | period         |      -         | int     | ms             |   20          | No                          | refresh period of the broadcasted values in ms                    | optional, default 20ms |
+ * | parallel_subdevices | -         | bool    | -              |   false       | No                          | read the state of all the subdevices in parallel before broadcasting it, so that it takes as long as the slowest subdevice | uses one thread for each subdevice but the first one |
  * | subdevice      |      -         | string  | -              |   -           | alternative to netwok group | name of the subdevice to instantiate                              | when used, parameters for the subdevice must be provided as well |
  * | networks       |      -         | group   | -              |   -           | alternative to subdevice    | this is expected to be a group parameter in xml format, a list in .ini file format. SubParameter are mandatory if this is used| - |
  * | -              | networkName_1  | 4 * int | joint number   |   -           |   if networks is used       | describe how to match subdevice_1 joints with the wrapper joints. First 2 numbers indicate first/last wrapper joint, last 2 numbers are subdevice first/last joint | The joints are intended to be consequent |
@@ -286,6 +291,19 @@ private:
     std::mutex                                 rpcDataMutex;                   // mutex to avoid concurrency between more clients using rppc port
     MultiJointData                 rpcData;                        // Structure used to re-arrange data from "multiple_joints" calls.
 
+    // Scratch memory used to read/write all the joints of the subdevices: the
+    // wrapper thread has its own, so that it never waits for the RPC calls,
+    // and the other callers take a free one from a small pool.
+    static constexpr size_t        callerScratchCount = 4;
+    std::atomic<std::thread::id>   wrapperThread;                  // id of the thread publishing the state
+    JointsScratch                  threadScratch;                  // scratch memory of the wrapper thread
+    std::array<JointsScratch, callerScratchCount> callerScratch;   // scratch memory of the other callers
+
+    // Read the state of the subdevices in parallel in the wrapper thread
+    bool                           parallelSubdevices;             // read the subdevices in parallel
+    yarp::dev::impl::ParallelLoop  parallelLoop;                   // threads reading the subdevices
+    std::vector<SubDeviceState>    subdeviceStates;                // state read from each subdevice
+
     std::string         partName;               // to open ports and print more detailed debug messages
 
     int               controlledJoints;
@@ -323,6 +341,31 @@ private:
 
     void calculateMaxNumOfJointsInDevices();
 
+    /**
+     * Lock some scratch memory for the calling thread: its own for the
+     * wrapper thread, a free one of the pool for the others (they wait
+     * only when all of them are in use).
+     * @param lock holds the lock of the scratch memory returned
+     */
+    JointsScratch& lockScratch(std::unique_lock<std::mutex>& lock);
+
+    /**
+     * Read the state published by the wrapper thread, one subdevice after
+     * the other.
+     * @param yarp_struct the data of the stateExt:o port, or nullptr when
+     *                    only the ROS topic is published
+     */
+    void readState(yarp::dev::impl::jointData* yarp_struct);
+
+    /**
+     * Read the state published by the wrapper thread, all the subdevices
+     * at the same time.
+     * @param yarp_struct the data of the stateExt:o port, or nullptr when
+     *                    only the ROS topic is published
+     */
+    void readStateInParallel(yarp::dev::impl::jointData* yarp_struct);
+    void readSubdeviceState(size_t d, yarp::dev::impl::jointData* yarp_struct);
+
 public:
     ControlBoardWrapper();
     ControlBoardWrapper(const ControlBoardWrapper&) = delete;
@@ -369,6 +412,8 @@ public:
 
     bool attachAll(const yarp::dev::PolyDriverList &l) override;
 
+    bool threadInit() override;
+
     /**
     * The thread main loop deals with writing on ports here.
     */
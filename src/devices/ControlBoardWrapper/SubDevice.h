@@ -29,6 +29,7 @@
 #include <yarp/sig/Vector.h>
 #include <yarp/os/Semaphore.h>
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -39,12 +40,6 @@
     #pragma warning(disable:4355)
 #endif
 
-/*
- * To optimize memory allocation, for group of joints we can have one mem reserver for rpc port
- * and on e for streaming. The size could be numOfSubDevices*maxNumOfjointForSubdevice.
- * (we could also use the actual joint number for each subdevice using a for loop). TODO
- */
-
 class ControlBoardWrapper;
 
 /*
@@ -119,6 +114,65 @@ struct DevicesLutEntry
 };
 
 
+/*
+ * Scratch memory used to read or write the values of all the joints of a
+ * subdevice.  It is sized when the subdevices are attached, so that the
+ * calls on all the joints do not allocate memory.
+ */
+class JointsScratch
+{
+public:
+    std::mutex mutex;
+    std::vector<double> values;
+    std::vector<double> values2;
+    std::vector<int> ints;
+    std::vector<yarp::dev::Pid> pids;
+    std::vector<yarp::dev::InteractionModeEnum> modes;
+
+    void resize(int maxNumOfJointsInDevices)
+    {
+        values.resize(maxNumOfJointsInDevices);
+        values2.resize(maxNumOfJointsInDevices);
+        ints.resize(maxNumOfJointsInDevices);
+        pids.resize(maxNumOfJointsInDevices);
+        modes.resize(maxNumOfJointsInDevices);
+    }
+};
+
+/*
+ * The state of the joints of a subdevice, read by the wrapper thread when
+ * the subdevices are read in parallel.  Each subdevice has its own, so that
+ * they can be filled at the same time.
+ */
+class SubDeviceState
+{
+public:
+    std::vector<double> values;
+    std::vector<double> times;
+    std::vector<int> controlModes;
+    std::vector<yarp::dev::InteractionModeEnum> interactionModes;
+
+    bool positionOk{false};
+    bool velocityOk{false};
+    bool torqueOk{false};
+    bool accelerationOk{false};
+    bool motorPositionOk{false};
+    bool motorVelocityOk{false};
+    bool motorAccelerationOk{false};
+    bool pwmDutycycleOk{false};
+    bool currentOk{false};
+    bool controlModeOk{false};
+    bool interactionModeOk{false};
+
+    void resize(int totalAxis)
+    {
+        values.resize(totalAxis);
+        times.resize(totalAxis);
+        controlModes.resize(totalAxis);
+        interactionModes.resize(totalAxis);
+    }
+};
+
 class WrappedDevice
 {
 public:
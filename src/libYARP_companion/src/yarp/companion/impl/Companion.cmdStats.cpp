@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/companion/impl/Companion.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Contact.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Vocab.h>
+
+using yarp::companion::impl::Companion;
+using yarp::os::Bottle;
+using yarp::os::Contact;
+using yarp::os::NetworkBase;
+
+int Companion::cmdStats(int argc, char *argv[])
+{
+    if (argc < 1 || argc > 2) {
+        yCInfo(COMPANION, "Usage:");
+        yCInfo(COMPANION, "  yarp stats /port         # statistics of the port and of all its connections");
+        yCInfo(COMPANION, "  yarp stats /port /other  # statistics of the connections between /port and /other");
+        return 1;
+    }
+
+    Bottle cmd;
+    Bottle reply;
+    cmd.addVocab(yarp::os::createVocab('s', 't', 'a', 't'));
+    if (argc == 2) {
+        cmd.addString(argv[1]);
+    }
+    bool ok = NetworkBase::write(Contact::fromString(argv[0]), cmd, reply, true, true, 2.0);
+    if (!ok) {
+        yCError(COMPANION, "Cannot get the statistics of %s", argv[0]);
+        return 1;
+    }
+    if (reply.get(0).asVocab() == yarp::os::createVocab('f', 'a', 'i', 'l')) {
+        yCError(COMPANION, "%s", reply.get(1).asString().c_str());
+        return 1;
+    }
+
+    for (size_t i = 0; i < reply.size(); i++) {
+        yCInfo(COMPANION, "%s", reply.get(i).toString().c_str());
+    }
+    return 0;
+}
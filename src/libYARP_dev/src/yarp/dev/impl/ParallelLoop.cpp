@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/dev/impl/ParallelLoop.h>
+
+#include <yarp/os/Thread.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using yarp::dev::impl::ParallelLoop;
+
+class ParallelLoop::Private
+{
+    class Worker : public yarp::os::Thread
+    {
+    public:
+        explicit Worker(ParallelLoop::Private& owner) :
+                owner(owner)
+        {
+        }
+
+        void run() override
+        {
+            owner.serve();
+        }
+
+        void onStop() override
+        {
+            owner.wakeUp();
+        }
+
+    private:
+        ParallelLoop::Private& owner;
+    };
+
+public:
+    // Taken by the loop using the workers, and to start and stop them
+    std::mutex runMutex;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex mutex;
+    std::condition_variable loopStarted;
+    std::condition_variable workerIdle;
+    bool active{false};
+    size_t generation{0};   // incremented for each loop run
+    size_t busyWorkers{0};  // workers taking part to the current loop
+
+    // The loop being run, changed only when no worker is busy
+    size_t count{0};
+    void (*iteration)(void*, size_t){nullptr};
+    void* body{nullptr};
+    std::atomic<size_t> next{0};
+
+    bool start(size_t n)
+    {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        stopWorkers();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active = true;
+        }
+        for (size_t i = 0; i < n; i++) {
+            workers.emplace_back(new Worker(*this));
+            if (!workers.back()->start()) {
+                stopWorkers();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        stopWorkers();
+    }
+
+    size_t getWorkers()
+    {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        return workers.size();
+    }
+
+    // Called with runMutex held
+    void stopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active = false;
+        }
+        for (auto& worker : workers) {
+            worker->stop();
+        }
+        workers.clear();
+    }
+
+    void wakeUp()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        loopStarted.notify_all();
+    }
+
+    // Execute iterations until the loop is exhausted
+    void work()
+    {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            iteration(body, i);
+        }
+    }
+
+    void serve()
+    {
+        size_t served = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            loopStarted.wait(lock, [&] { return generation != served || !active; });
+            if (!active) {
+                return;
+            }
+            served = generation;
+            busyWorkers++;
+            lock.unlock();
+            work();
+            lock.lock();
+            busyWorkers--;
+            if (busyWorkers == 0) {
+                workerIdle.notify_all();
+            }
+        }
+    }
+
+    // Called with runMutex held, so that a single loop uses the workers
+    void run(size_t n, void (*it)(void*, size_t), void* b)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // a worker late for the previous loop may still be looking at it
+        workerIdle.wait(lock, [&] { return busyWorkers == 0; });
+        count = n;
+        iteration = it;
+        body = b;
+        next = 0;
+        generation++;
+        lock.unlock();
+        loopStarted.notify_all();
+
+        work();
+
+        // all the iterations are taken, wait for the ones still running
+        lock.lock();
+        workerIdle.wait(lock, [&] { return busyWorkers == 0; });
+    }
+};
+
+
+ParallelLoop::ParallelLoop() :
+        mPriv(new Private)
+{
+}
+
+ParallelLoop::~ParallelLoop()
+{
+    mPriv->stop();
+    delete mPriv;
+}
+
+bool ParallelLoop::start(size_t workers)
+{
+    return mPriv->start(workers);
+}
+
+void ParallelLoop::stop()
+{
+    mPriv->stop();
+}
+
+size_t ParallelLoop::getWorkers() const
+{
+    return mPriv->getWorkers();
+}
+
+void ParallelLoop::runIterations(size_t count, void (*iteration)(void*, size_t), void* body)
+{
+    if (count >= 2) {
+        // When another thread is running a loop, this one is sequential
+        // rather than waiting for the workers
+        std::unique_lock<std::mutex> runLock(mPriv->runMutex, std::try_to_lock);
+        if (runLock.owns_lock() && !mPriv->workers.empty()) {
+            mPriv->run(count, iteration, body);
+            return;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        iteration(body, i);
+    }
+}
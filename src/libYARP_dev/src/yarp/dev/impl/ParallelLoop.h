@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_IMPL_PARALLELLOOP_H
+#define YARP_DEV_IMPL_PARALLELLOOP_H
+
+#include <yarp/dev/api.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace yarp {
+namespace dev {
+namespace impl {
+
+/**
+ * @brief Runs the iterations of a loop over independent items (e.g. the
+ * subdevices of a wrapper) on a fixed set of worker threads.
+ *
+ * The thread calling run() executes iterations as well, and the call
+ * returns when all the iterations are complete, therefore a loop over n
+ * items needs at most n-1 workers.  Without workers, run() is a plain
+ * sequential loop.
+ *
+ * Running a loop does not allocate memory.  The iterations must not call
+ * run() on the same object.  run() can be called by several threads: the
+ * workers serve one loop at a time, the loops started while they are busy
+ * are executed sequentially by their callers.
+ */
+class YARP_dev_API ParallelLoop
+{
+public:
+    ParallelLoop();
+    ParallelLoop(const ParallelLoop&) = delete;
+    ParallelLoop(ParallelLoop&&) = delete;
+    ParallelLoop& operator=(const ParallelLoop&) = delete;
+    ParallelLoop& operator=(ParallelLoop&&) = delete;
+    ~ParallelLoop();
+
+    /**
+     * @brief Start the worker threads, stopping the previous ones.
+     *
+     * @param workers the number of worker threads
+     * @return true on success
+     */
+    bool start(size_t workers);
+
+    /**
+     * @brief Stop the worker threads, the following loops are sequential.
+     */
+    void stop();
+
+    /**
+     * @brief Return the number of worker threads running.
+     */
+    size_t getWorkers() const;
+
+    /**
+     * @brief Call @c body(i) for each i in [0, count) and wait for all the
+     * calls to complete.  The calls may run concurrently and in any order.
+     */
+    template <typename F>
+    void run(size_t count, F&& body)
+    {
+        runIterations(count, &call<typename std::remove_reference<F>::type>, &body);
+    }
+
+private:
+    template <typename F>
+    static void call(void* body, size_t i)
+    {
+        (*static_cast<F*>(body))(i);
+    }
+
+    void runIterations(size_t count, void (*iteration)(void*, size_t), void* body);
+
+    class Private;
+    Private* mPriv;
+};
+
+} // namespace impl
+} // namespace dev
+} // namespace yarp
+
+#endif // YARP_DEV_IMPL_PARALLELLOOP_H
@@ -64,8 +64,13 @@ public:
         }
         yarp::os::Contact remote;
         remote = reader.getRemoteContact();
+        bool shared = service->isReadOnly(cmd);
         if (lock) {
-            service->lock();
+            if (shared) {
+                service->lockShared();
+            } else {
+                service->lock();
+            }
         }
         service->apply(cmd,reply,event,remote);
         for (size_t i=0; i<event.size(); i++) {
@@ -75,7 +80,11 @@ public:
             }
         }
         if (lock) {
-            service->unlock();
+            if (shared) {
+                service->unlockShared();
+            } else {
+                service->unlock();
+            }
         }
         if (writer == nullptr) {
             writer = reader.getWriter();
@@ -13,7 +13,7 @@
 #include <yarp/name/NameServerConnectionHandler.h>
 
 #include <yarp/os/PortReaderCreator.h>
-#include <mutex>
+#include <shared_mutex>
 #include <yarp/os/Port.h>
 
 
@@ -25,7 +25,9 @@ namespace yarp {
 
 /**
  *
- * Manage the name server.
+ * Manage the name server.  Commands that do not change the name
+ * service (see NameService::isReadOnly()) are served concurrently,
+ * the others one at a time.
  *
  */
 class yarp::name::NameServerManager : public NameService,
@@ -33,7 +35,7 @@ class yarp::name::NameServerManager : public NameService,
 private:
     NameService& ns;
     yarp::os::Port *port;
-    std::mutex mutex;
+    std::shared_timed_mutex mutex;
 public:
     NameServerManager(NameService& ns,
                       yarp::os::Port *port = NULL) : ns(ns),
@@ -63,6 +65,18 @@ public:
         mutex.unlock();
     }
 
+    void lockShared() override {
+        mutex.lock_shared();
+    }
+
+    void unlockShared() override {
+        mutex.unlock_shared();
+    }
+
+    bool isReadOnly(const yarp::os::Bottle& cmd) override {
+        return ns.isReadOnly(cmd);
+    }
+
     virtual bool apply(yarp::os::Bottle& cmd,
                        yarp::os::Bottle& reply,
                        yarp::os::Bottle& event,
@@ -50,6 +50,19 @@ public:
     virtual void lock() {}
     virtual void unlock() {}
 
+    /**
+     * Lock the service for a command that does not change it, other
+     * commands of the same kind can run at the same time.
+     */
+    virtual void lockShared() { lock(); }
+    virtual void unlockShared() { unlock(); }
+
+    /**
+     * @return true if applying the command does not change the state of
+     * this service (including when the service does not handle it at all)
+     */
+    virtual bool isReadOnly(const yarp::os::Bottle& cmd) { return false; }
+
     virtual void goPublic() {}
 
     yarp::os::Contact query(const std::string& name) override {
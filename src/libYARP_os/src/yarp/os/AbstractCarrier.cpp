@@ -16,6 +16,8 @@
 #include <yarp/os/SizedWriter.h>
 #include <yarp/os/impl/LogComponent.h>
 
+#include <cstring>
+
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
@@ -227,20 +229,32 @@ bool AbstractCarrier::sendSenderSpecifier(ConnectionState& proto)
 
 bool AbstractCarrier::defaultSendIndex(ConnectionState& proto, SizedWriter& writer)
 {
-    writeYarpInt(10, proto);
+    // The index is assembled in a single buffer, so that it goes out
+    // with one write rather than one per field.
+    constexpr size_t maxFragments = 255;
+    char buf[8 + 10 + (maxFragments + 1) * sizeof(NetInt32)];
+    size_t used = 0;
+    OutputStream& os = proto.os();
+
+    Bytes header(buf, 8);
+    createYarpNumber(10, header);
+    used += 8;
     int len = (int)writer.length();
     char lens[] = {(char)len, (char)1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1};
-    Bytes b(lens, 10);
-    OutputStream& os = proto.os();
-    os.write(b);
+    memcpy(buf + used, lens, 10);
+    used += 10;
     NetInt32 numberSrc;
     Bytes number((char*)&numberSrc, sizeof(NetInt32));
-    for (int i = 0; i < len; i++) {
-        NetType::netInt((int)writer.length(i), number);
-        os.write(number);
+    for (int i = 0; i <= len; i++) {
+        if (used + sizeof(NetInt32) > sizeof(buf)) {
+            os.write(Bytes(buf, used));
+            used = 0;
+        }
+        NetType::netInt((i < len) ? (int)writer.length(i) : 0, number);
+        memcpy(buf + used, number.get(), sizeof(NetInt32));
+        used += sizeof(NetInt32);
     }
-    NetType::netInt(0, number);
-    os.write(number);
+    os.write(Bytes(buf, used));
     return os.isOk();
 }
 
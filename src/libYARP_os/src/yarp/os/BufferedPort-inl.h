@@ -23,6 +23,17 @@ yarp::os::BufferedPort<T>::BufferedPort() :
     port.enableBackgroundWrite(true);
 }
 
+template <typename T>
+yarp::os::BufferedPort<T>::BufferedPort(unsigned int maxBuffer) :
+        reader(maxBuffer),
+        interrupted(false),
+        attached(false)
+{
+    T example;
+    port.promiseType(example.getType());
+    port.enableBackgroundWrite(true);
+}
+
 template <typename T>
 yarp::os::BufferedPort<T>::BufferedPort(Port& port) :
         interrupted(false),
@@ -75,6 +75,19 @@ public:
      */
     BufferedPort();
 
+    /**
+     * Constructor for a port keeping at most @p maxBuffer messages waiting
+     * to be read (0 = no limit).
+     *
+     * With a limit, all the buffers are allocated when the port is
+     * opened, and then reused for the following messages.  A limit greater
+     * than 1 is useful only in strict mode (see setStrict()), when the
+     * sender waits for a free buffer instead of dropping messages.
+     * Otherwise a new message replaces the oldest one waiting, and the
+     * sender never waits.
+     */
+    explicit BufferedPort(unsigned int maxBuffer);
+
     /**
      * Wrap an existing unbuffered port.
      */
@@ -9,12 +9,14 @@
 
 #include <yarp/os/Carriers.h>
 
+#include <yarp/os/Network.h>
 #include <yarp/os/YarpPlugin.h>
 #include <yarp/os/impl/FakeFace.h>
 #include <yarp/os/impl/HttpCarrier.h>
 #include <yarp/os/impl/LocalCarrier.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/McastCarrier.h>
+#include <yarp/os/impl/NameClient.h>
 #include <yarp/os/impl/NameserCarrier.h>
 #include <yarp/os/impl/Protocol.h>
 #include <yarp/os/impl/TcpCarrier.h>
@@ -282,13 +284,14 @@ Face* Carriers::listen(const Contact& address)
 }
 
 
-OutputProtocol* Carriers::connect(const Contact& address)
+namespace {
+OutputProtocol* connectFace(const Contact& address)
 {
     yarp::os::Face* face = nullptr;
     Carrier* c = nullptr;
 
     if (!address.getCarrier().empty()) {
-        c = getCarrierTemplate(address.getCarrier());
+        c = Carriers::getCarrierTemplate(address.getCarrier());
     }
     if (c != nullptr) {
         face = c->createFace();
@@ -301,6 +304,26 @@ OutputProtocol* Carriers::connect(const Contact& address)
     delete face;
     return proto;
 }
+} // namespace
+
+OutputProtocol* Carriers::connect(const Contact& address)
+{
+    OutputProtocol* proto = connectFace(address);
+    if (proto == nullptr && !address.getRegName().empty()) {
+        // The address may come from the cache of the name client, and the
+        // port may have moved since then
+        if (NameClient::forgetName(address.getRegName())) {
+            Contact current = NetworkBase::queryName(address.getRegName());
+            if (current.isValid() && (current.getHost() != address.getHost() || current.getPort() != address.getPort())) {
+                yCDebug(CARRIERS, "%s moved to %s", address.getRegName().c_str(), current.toURI().c_str());
+                Contact retry = address;
+                retry.setSocket(address.getCarrier(), current.getHost(), current.getPort());
+                proto = connectFace(retry);
+            }
+        }
+    }
+    return proto;
+}
 
 
 bool Carriers::addCarrierPrototype(Carrier* carrier)
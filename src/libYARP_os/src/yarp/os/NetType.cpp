@@ -13,10 +13,16 @@
 #include <yarp/os/impl/LogComponent.h>
 
 #include <clocale>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define YARP_CRC32C_SSE42
+#    include <nmmintrin.h>
+#endif
+
 
 /*
  * The maximum string length for a 'double' printed as a string using ("%.*g", DECIMAL_DIG) will be:
@@ -251,3 +257,105 @@ unsigned long NetType::getCrc(char* buf, size_t len)
 {
     return update_crc(0xffffffffL, (unsigned char*)buf, len) ^ 0xffffffffL;
 }
+
+
+/*
+  CRC32C (Castagnoli polynomial), computed with the SSE4.2 crc32
+  instruction when the cpu has it, and with the "slicing-by-8" tables
+  otherwise.
+*/
+
+namespace {
+
+constexpr std::uint32_t crc32c_poly = 0x82f63b78; // reflected 0x1edc6f41
+
+struct Crc32cTables
+{
+    std::uint32_t t[8][256];
+
+    Crc32cTables()
+    {
+        for (std::uint32_t n = 0; n < 256; n++) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = ((c & 1) != 0) ? (crc32c_poly ^ (c >> 1)) : (c >> 1);
+            }
+            t[0][n] = c;
+        }
+        for (std::uint32_t n = 0; n < 256; n++) {
+            for (int k = 1; k < 8; k++) {
+                t[k][n] = (t[k - 1][n] >> 8) ^ t[0][t[k - 1][n] & 0xff];
+            }
+        }
+    }
+};
+
+std::uint32_t crc32c_sw(std::uint32_t crc, const unsigned char* buf, size_t len)
+{
+    static const Crc32cTables tables;
+    const auto& t = tables.t;
+    while (len >= 8) {
+        // Little endian words, independently of the platform
+        std::uint32_t lo = crc ^ (static_cast<std::uint32_t>(buf[0]) | static_cast<std::uint32_t>(buf[1]) << 8 | static_cast<std::uint32_t>(buf[2]) << 16 | static_cast<std::uint32_t>(buf[3]) << 24);
+        std::uint32_t hi = static_cast<std::uint32_t>(buf[4]) | static_cast<std::uint32_t>(buf[5]) << 8 | static_cast<std::uint32_t>(buf[6]) << 16 | static_cast<std::uint32_t>(buf[7]) << 24;
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^ t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        buf += 8;
+        len -= 8;
+    }
+    while (len > 0) {
+        crc = t[0][(crc ^ *buf) & 0xff] ^ (crc >> 8);
+        buf++;
+        len--;
+    }
+    return crc;
+}
+
+#if defined(YARP_CRC32C_SSE42)
+__attribute__((target("sse4.2"))) std::uint32_t crc32c_sse42(std::uint32_t crc, const unsigned char* buf, size_t len)
+{
+#    if defined(__x86_64__)
+    std::uint64_t crc64 = crc;
+    while (len >= 8) {
+        std::uint64_t word;
+        memcpy(&word, buf, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        buf += 8;
+        len -= 8;
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+#    endif
+    while (len >= 4) {
+        std::uint32_t word;
+        memcpy(&word, buf, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        buf += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        crc = _mm_crc32_u8(crc, *buf);
+        buf++;
+        len--;
+    }
+    return crc;
+}
+#endif
+
+using crc32c_function = std::uint32_t (*)(std::uint32_t, const unsigned char*, size_t);
+
+crc32c_function choose_crc32c()
+{
+#if defined(YARP_CRC32C_SSE42)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return crc32c_sse42;
+    }
+#endif
+    return crc32c_sw;
+}
+
+} // namespace
+
+std::uint32_t NetType::getCrc32c(const char* buf, size_t len)
+{
+    static const crc32c_function crc32c = choose_crc32c();
+    return crc32c(0xffffffff, reinterpret_cast<const unsigned char*>(buf), len) ^ 0xffffffff;
+}
@@ -17,6 +17,7 @@
 #include <yarp/os/NetFloat64.h>
 #include <yarp/os/NetInt32.h>
 
+#include <cstdint>
 #include <string>
 
 namespace yarp {
@@ -49,6 +50,12 @@ public:
 
     static int toInt(const std::string& x);
     static unsigned long int getCrc(char* buf, size_t len);
+
+    /**
+     * Compute the CRC32C (Castagnoli) checksum of a block of bytes.
+     * The crc32 instruction of SSE4.2 is used when the cpu supports it.
+     */
+    static std::uint32_t getCrc32c(const char* buf, size_t len);
 };
 
 } // namespace os
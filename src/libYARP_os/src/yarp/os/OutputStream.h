@@ -12,6 +12,8 @@
 
 #include <yarp/os/api.h>
 
+#include <cstddef>
+
 namespace yarp {
 namespace os {
 
@@ -54,6 +56,17 @@ public:
      */
     virtual void write(const yarp::os::Bytes& b) = 0;
 
+    /**
+     * Write a sequence of blocks of bytes to the stream, in order.
+     * Streams that can send several buffers with a single operation
+     * (e.g. writev) should override this.  By default, this
+     * calls write(const Bytes& b) once for each block.
+     *
+     * @param blocks the blocks to write
+     * @param count the number of blocks
+     */
+    virtual void writeBlocks(const yarp::os::Bytes* blocks, size_t count);
+
     /**
      * Terminate the stream.
      */
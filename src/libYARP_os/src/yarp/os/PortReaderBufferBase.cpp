@@ -20,7 +20,6 @@
 #include <yarp/os/impl/PortCorePacket.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
-#include <list>
 #include <mutex>
 
 using namespace yarp::os::impl;
@@ -97,8 +96,8 @@ public:
 
     void setEnvelope(const Bytes& bytes)
     {
-        envelope = std::string(bytes.get(), bytes.length());
-        //envelope.set(bytes.get(), bytes.length(), 1);
+        // reuse the memory of the previous envelope
+        envelope.assign(bytes.get(), bytes.length());
     }
 
     void resetExternal()
@@ -112,11 +111,65 @@ public:
 };
 
 
+/*
+ * A list of packets, linked through their own prev_/next_ pointers, so that
+ * moving a packet from a list to another never allocates memory.
+ */
+class PortReaderPacketList
+{
+private:
+    PortReaderPacket* head{nullptr};
+    PortReaderPacket* tail{nullptr};
+    size_t count{0};
+
+public:
+    size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    void push_back(PortReaderPacket* packet)
+    {
+        packet->next_ = nullptr;
+        packet->prev_ = tail;
+        if (tail != nullptr) {
+            tail->next_ = packet;
+        } else {
+            head = packet;
+        }
+        tail = packet;
+        count++;
+    }
+
+    PortReaderPacket* pop_front()
+    {
+        PortReaderPacket* packet = head;
+        if (packet == nullptr) {
+            return nullptr;
+        }
+        head = packet->next_;
+        if (head != nullptr) {
+            head->prev_ = nullptr;
+        } else {
+            tail = nullptr;
+        }
+        packet->prev_ = packet->next_ = nullptr;
+        count--;
+        return packet;
+    }
+};
+
+
 class PortReaderPool
 {
 private:
-    std::list<PortReaderPacket*> inactive;
-    std::list<PortReaderPacket*> active;
+    PortReaderPacketList inactive;
+    PortReaderPacketList active;
 
 public:
     size_t getCount()
@@ -136,9 +189,8 @@ public:
             obj = new PortReaderPacket();
             inactive.push_back(obj);
         }
-        PortReaderPacket* next = inactive.front();
+        PortReaderPacket* next = inactive.pop_front();
         yCAssert(PORTREADERBUFFERBASE, next != nullptr);
-        inactive.remove(next);
         return next;
     }
 
@@ -146,9 +198,8 @@ public:
     {
         PortReaderPacket* next = nullptr;
         if (getCount() >= 1) {
-            next = active.front();
+            next = active.pop_front();
             yCAssert(PORTREADERBUFFERBASE, next != nullptr);
-            active.remove(next);
         }
         return next;
     }
@@ -170,12 +221,10 @@ public:
     void reset()
     {
         while (!active.empty()) {
-            delete active.back();
-            active.pop_back();
+            delete active.pop_front();
         }
         while (!inactive.empty()) {
-            delete inactive.back();
-            inactive.pop_back();
+            delete inactive.pop_front();
         }
     }
 };
@@ -198,6 +247,7 @@ public:
     PortReaderPool pool;
 
     int ct;
+    int waitingWriters; // writers waiting on consumeSema for a free packet
     Port* port;
     yarp::os::Semaphore contentSema;
     yarp::os::Semaphore consumeSema;
@@ -213,6 +263,7 @@ public:
             period(-1),
             last_recv(-1),
             ct(0),
+            waitingWriters(0),
             port(nullptr),
             contentSema(0),
             consumeSema(0),
@@ -257,22 +308,13 @@ public:
 
     PortReaderPacket* get()
     {
-        PortReaderPacket* result = nullptr;
-        bool grab = true;
-        if (pool.getFree() == 0) {
-            grab = false;
-            if (maxBuffer == 0 || pool.getCount() < maxBuffer) {
-                grab = true;
-            } else {
-                // ok, can't get free, clean space.
-                // here would be a good place to do buffer reuse.
-            }
-        }
-        if (grab) {
-            result = pool.getInactivePacket();
+        // free packets may be preallocated, the limit is on the messages
+        // waiting to be read.  Without strict mode, the writer never waits:
+        // the oldest message is dropped when the new one is added.
+        if (maxBuffer != 0 && !prune && pool.getCount() >= maxBuffer) {
+            return nullptr;
         }
-
-        return result;
+        return pool.getInactivePacket();
     }
 
     int checkContent()
@@ -326,9 +368,42 @@ public:
     void attach(Port& port)
     {
         this->port = &port;
+        preallocate();
         port.setReader(owner);
     }
 
+    // With a limited number of buffers, create all of them now: maxBuffer
+    // waiting to be read, plus the one currently held by the reader.
+    void preallocate()
+    {
+        if (maxBuffer == 0 || creator == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(stateMutex);
+        while (pool.getFree() + pool.getCount() < maxBuffer + 1) {
+            auto* packet = new PortReaderPacket();
+            packet->setReader(creator->create());
+            pool.addInactivePacket(packet);
+        }
+    }
+
+    // Called with stateMutex locked when get() failed
+    void waitForPacket()
+    {
+        waitingWriters++;
+    }
+
+    // Called with stateMutex locked when a packet was freed, returns true if
+    // a writer waiting for a packet must be woken up.
+    bool wakeWriter()
+    {
+        if (waitingWriters > 0) {
+            waitingWriters--;
+            return true;
+        }
+        return false;
+    }
+
     void* acquire()
     {
         if (prev != nullptr) {
@@ -425,6 +500,7 @@ PortReader* PortReaderBufferBase::readBase(bool& missed, bool cleanup)
     mPriv->stateMutex.lock();
     PortReaderPacket* readerPacket = mPriv->getContent();
     PortReader* reader = nullptr;
+    bool wake = false;
     if (readerPacket != nullptr) {
         PortReader* external = readerPacket->getExternal();
         if (external == nullptr) {
@@ -432,9 +508,10 @@ PortReader* PortReaderBufferBase::readBase(bool& missed, bool cleanup)
         } else {
             reader = external;
         }
+        wake = mPriv->wakeWriter();
     }
     mPriv->stateMutex.unlock();
-    if (reader != nullptr) {
+    if (wake) {
         mPriv->consumeSema.post();
     }
     return reader;
@@ -463,7 +540,9 @@ bool PortReaderBufferBase::read(ConnectionReader& connection)
             yCAssert(PORTREADERBUFFERBASE, next != nullptr);
             reader->setReader(next);
         }
-
+        if (reader == nullptr) {
+            mPriv->waitForPacket();
+        }
         mPriv->stateMutex.unlock();
         if (reader == nullptr) {
             mPriv->consumeSema.wait();
@@ -565,6 +644,9 @@ bool PortReaderBufferBase::acceptObjectBase(PortReader* obj,
     while (reader == nullptr) {
         mPriv->stateMutex.lock();
         reader = mPriv->get();
+        if (reader == nullptr) {
+            mPriv->waitForPacket();
+        }
         mPriv->stateMutex.unlock();
         if (reader == nullptr) {
             mPriv->consumeSema.wait();
@@ -611,7 +693,11 @@ void PortReaderBufferBase::release(void* key)
 {
     mPriv->stateMutex.lock();
     mPriv->release(key);
+    bool wake = (key != nullptr) && mPriv->wakeWriter();
     mPriv->stateMutex.unlock();
+    if (wake) {
+        mPriv->consumeSema.post();
+    }
 }
 
 
@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/SharedBufferPool.h>
+
+#include <yarp/os/Os.h>
+#include <yarp/os/impl/LogComponent.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+
+#if !defined(_WIN32)
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+#if defined(__linux__)
+#  include <dirent.h>
+#endif
+
+using yarp::os::SharedBufferPool;
+
+namespace {
+YARP_OS_LOG_COMPONENT(SHAREDBUFFERPOOL, "yarp.os.SharedBufferPool")
+
+// Released segments kept around to be recycled.
+constexpr size_t maxFreeSegments = 4;
+
+size_t roundToPage(size_t size)
+{
+    constexpr size_t page = 4096;
+    return (size + page - 1) & ~(page - 1);
+}
+} // namespace
+
+
+class SharedBufferPool::Private
+{
+public:
+    struct Segment
+    {
+        std::uint32_t id;
+        char* map;
+        size_t mapSize;
+        SegmentHeader* header;
+        bool used;
+        int pins;      // handles sent and not read yet
+        bool released; // released while pinned
+    };
+
+    // Remove the names of all the segments, so that nothing is left behind
+    // in the system when the process exits.  The memory stays mapped, since
+    // images with static storage duration can still be using it.
+    void unlinkAll()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& it : segments) {
+            unlink(it.second);
+        }
+    }
+
+    char* allocate(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Recycle a free segment, as long as it doesn't waste more than half
+        // of its memory.
+        for (auto& it : segments) {
+            Segment& seg = it.second;
+            if (!seg.used && seg.header->size >= size && seg.header->size / 2 <= size) {
+                seg.used = true;
+                seg.header->generation++;
+                freeCount--;
+                return data(seg);
+            }
+        }
+
+        Segment seg;
+        if (!create(size, seg)) {
+            return nullptr;
+        }
+        segments[data(seg)] = seg;
+        return data(seg);
+    }
+
+    void release(const char* ptr)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = segments.find(ptr);
+        if (it == segments.end() || !it->second.used || it->second.released) {
+            yCError(SHAREDBUFFERPOOL, "Trying to release a buffer not allocated by the pool");
+            return;
+        }
+        if (it->second.pins > 0) {
+            // A receiver is reading it, recycle it in unpin()
+            it->second.released = true;
+            return;
+        }
+        recycle(it->second);
+    }
+
+    bool find(const char* ptr, size_t len, Handle& handle, bool pin)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Segment* seg = lookup(ptr, len);
+        if (seg == nullptr) {
+            return false;
+        }
+        handle.pid = yarp::os::getpid();
+        handle.segment = seg->id;
+        handle.generation = seg->header->generation;
+        handle.reserved = 0;
+        handle.offset = dataOffset + (ptr - data(*seg));
+        handle.length = len;
+        if (pin) {
+            seg->pins++;
+        }
+        return true;
+    }
+
+    void unpin(const Handle& handle)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& it : segments) {
+            Segment& seg = it.second;
+            if (seg.id == handle.segment) {
+                if (seg.pins > 0) {
+                    seg.pins--;
+                }
+                if (seg.pins == 0 && seg.released) {
+                    seg.released = false;
+                    recycle(seg);
+                }
+                return;
+            }
+        }
+    }
+
+    size_t count() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return segments.size();
+    }
+
+private:
+    static char* data(const Segment& seg)
+    {
+        return seg.map + dataOffset;
+    }
+
+    // The buffer in use containing [ptr, ptr+len), called with the lock held
+    Segment* lookup(const char* ptr, size_t len)
+    {
+        if (segments.empty()) {
+            return nullptr;
+        }
+        // The last segment starting at or before ptr
+        auto it = segments.upper_bound(ptr);
+        if (it == segments.begin()) {
+            return nullptr;
+        }
+        --it;
+        Segment& seg = it->second;
+        size_t offset = ptr - it->first;
+        if (!seg.used || seg.released || offset + len > seg.header->size) {
+            return nullptr;
+        }
+        return &seg;
+    }
+
+    // Put a released buffer among the free ones, called with the lock held
+    void recycle(Segment& seg)
+    {
+        seg.used = false;
+        seg.header->generation++;
+        freeCount++;
+
+        // Too many free segments, destroy the oldest one.
+        if (freeCount > maxFreeSegments) {
+            auto oldest = segments.end();
+            for (auto jt = segments.begin(); jt != segments.end(); ++jt) {
+                if (!jt->second.used && (oldest == segments.end() || jt->second.id < oldest->second.id)) {
+                    oldest = jt;
+                }
+            }
+            destroy(oldest->second);
+            segments.erase(oldest);
+            freeCount--;
+        }
+    }
+
+    bool create(size_t size, Segment& seg)
+    {
+#if !defined(_WIN32)
+        seg.id = nextId++;
+        seg.mapSize = roundToPage(dataOffset + size);
+        std::string name = SharedBufferPool::segmentName(yarp::os::getpid(), seg.id);
+
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            yCError(SHAREDBUFFERPOOL, "Can't create shared memory segment %s", name.c_str());
+            return false;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(seg.mapSize)) != 0) {
+            yCError(SHAREDBUFFERPOOL, "Can't allocate %zu bytes for shared memory segment %s", seg.mapSize, name.c_str());
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            return false;
+        }
+        void* map = ::mmap(nullptr, seg.mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            yCError(SHAREDBUFFERPOOL, "Can't map shared memory segment %s", name.c_str());
+            ::shm_unlink(name.c_str());
+            return false;
+        }
+
+        seg.map = static_cast<char*>(map);
+        seg.header = new (map) SegmentHeader;
+        seg.header->magic = segmentMagic;
+        seg.header->generation = 0;
+        seg.header->size = seg.mapSize - dataOffset;
+        seg.used = true;
+        seg.pins = 0;
+        seg.released = false;
+        yCDebug(SHAREDBUFFERPOOL, "Created shared memory segment %s (%zu bytes)", name.c_str(), seg.mapSize);
+        return true;
+#else
+        YARP_UNUSED(size);
+        YARP_UNUSED(seg);
+        return false;
+#endif
+    }
+
+    static void unlink(Segment& seg)
+    {
+#if !defined(_WIN32)
+        ::shm_unlink(SharedBufferPool::segmentName(yarp::os::getpid(), seg.id).c_str());
+#else
+        YARP_UNUSED(seg);
+#endif
+    }
+
+    static void destroy(Segment& seg)
+    {
+        unlink(seg);
+#if !defined(_WIN32)
+        ::munmap(seg.map, seg.mapSize);
+#endif
+    }
+
+    mutable std::mutex mutex;
+    // Segments sorted by the address of their data
+    std::map<const char*, Segment> segments;
+    size_t freeCount{0};
+    std::uint32_t nextId{0};
+};
+
+
+SharedBufferPool::SharedBufferPool() :
+        mPriv(new Private)
+{
+    removeStaleSegments();
+}
+
+SharedBufferPool::~SharedBufferPool()
+{
+    // mPriv is intentionally leaked, release() can still be called by
+    // objects destroyed after the pool.
+    mPriv->unlinkAll();
+}
+
+SharedBufferPool& SharedBufferPool::getInstance()
+{
+    static SharedBufferPool instance;
+    return instance;
+}
+
+bool SharedBufferPool::isAvailable()
+{
+#if !defined(_WIN32)
+    return true;
+#else
+    return false;
+#endif
+}
+
+char* SharedBufferPool::allocate(size_t size)
+{
+    return mPriv->allocate(size);
+}
+
+void SharedBufferPool::release(const char* ptr)
+{
+    mPriv->release(ptr);
+}
+
+bool SharedBufferPool::find(const char* ptr, size_t len, Handle& handle) const
+{
+    return mPriv->find(ptr, len, handle, false);
+}
+
+bool SharedBufferPool::pin(const char* ptr, size_t len, Handle& handle)
+{
+    return mPriv->find(ptr, len, handle, true);
+}
+
+void SharedBufferPool::unpin(const Handle& handle)
+{
+    mPriv->unpin(handle);
+}
+
+size_t SharedBufferPool::removeStaleSegments()
+{
+    size_t removed = 0;
+#if defined(__linux__)
+    // The POSIX shared memory segments are the files of /dev/shm
+    DIR* dir = ::opendir("/dev/shm");
+    if (dir == nullptr) {
+        return 0;
+    }
+    const std::string prefix = "yarp_buf_";
+    while (dirent* entry = ::readdir(dir)) {
+        const std::string file = entry->d_name;
+        if (file.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        char* end = nullptr;
+        long pid = std::strtol(file.c_str() + prefix.size(), &end, 10);
+        if (end == nullptr || *end != '_' || pid <= 0) {
+            continue;
+        }
+        if (::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH) {
+            if (::shm_unlink(("/" + file).c_str()) == 0) {
+                yCDebug(SHAREDBUFFERPOOL, "Removed shared memory segment %s of a process that is no longer running", file.c_str());
+                removed++;
+            }
+        }
+    }
+    ::closedir(dir);
+#endif
+    return removed;
+}
+
+std::string SharedBufferPool::segmentName(std::int32_t pid, std::uint32_t segment)
+{
+    return "/yarp_buf_" + std::to_string(pid) + "_" + std::to_string(segment);
+}
+
+size_t SharedBufferPool::getSegmentCount() const
+{
+    return mPriv->count();
+}
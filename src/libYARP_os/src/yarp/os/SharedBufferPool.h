@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_SHAREDBUFFERPOOL_H
+#define YARP_OS_SHAREDBUFFERPOOL_H
+
+#include <yarp/os/api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace yarp {
+namespace os {
+
+/**
+ * \ingroup comm_class
+ *
+ * A process-wide pool of buffers allocated in named shared memory
+ * segments.
+ *
+ * Large payloads (e.g. the pixels of a yarp::sig::Image) can be allocated
+ * from this pool.  When they are written to a connection through
+ * ConnectionWriter::appendExternalBlock(), a carrier that understands it
+ * (currently "shmem+ring") can send a Handle to the buffer instead of its
+ * content, and the receiving process reads the data directly from the
+ * segment.
+ *
+ * Each allocation lives in its own segment.  Released segments are kept for
+ * a while and recycled for allocations of similar size; every time a
+ * segment is reused its generation is incremented, so that a reader can
+ * detect a handle that refers to a previous use of the segment.
+ * A carrier pins the buffers it sent a handle for, until the receiver
+ * copied them: a pinned buffer released meanwhile is recycled only when it
+ * is unpinned.  The content of a buffer must not be changed while it is
+ * being written, as for any other block given to appendExternalBlock().
+ *
+ * The names of the segments are removed when the process exits.  Those
+ * left behind by a process that crashed are removed by the next process
+ * using the pool (see removeStaleSegments()).
+ *
+ * Shared memory is available only on POSIX systems, elsewhere allocate()
+ * always fails and the caller is expected to fall back to the heap.
+ */
+class YARP_os_API SharedBufferPool
+{
+public:
+    /**
+     * Reference to a range of bytes inside a shared buffer.
+     * This is what goes on the wire instead of the data.
+     */
+    struct Handle
+    {
+        std::int32_t pid;
+        std::uint32_t segment;
+        std::uint32_t generation;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+        std::uint64_t length;
+    };
+
+    /**
+     * Layout of the beginning of each segment.
+     * The data starts at `dataOffset` bytes from the beginning.
+     */
+    struct SegmentHeader
+    {
+        std::uint32_t magic;
+        std::atomic<std::uint32_t> generation;
+        std::uint64_t size;
+    };
+
+    static constexpr std::uint32_t segmentMagic = 0x59534250;
+    static constexpr size_t dataOffset = 64;
+
+    static SharedBufferPool& getInstance();
+
+    /**
+     * @return true if shared buffers can be allocated on this platform.
+     */
+    static bool isAvailable();
+
+    /**
+     * Allocate a buffer of at least size bytes in shared memory.
+     * @return a pointer to the buffer, or nullptr if shared memory is not
+     *         available.
+     */
+    char* allocate(size_t size);
+
+    /**
+     * Release a buffer returned by allocate().
+     */
+    void release(const char* ptr);
+
+    /**
+     * Look for the buffer containing the range [ptr, ptr+len).
+     * @return true if the range belongs to a buffer of this pool.
+     */
+    bool find(const char* ptr, size_t len, Handle& handle) const;
+
+    /**
+     * As find(), and keep the buffer from being recycled until unpin() is
+     * called with the same handle.
+     * @return true if the range belongs to a buffer of this pool.
+     */
+    bool pin(const char* ptr, size_t len, Handle& handle);
+
+    /**
+     * Release a pin taken with pin(); a buffer released while it was
+     * pinned is recycled when its last pin is released.
+     */
+    void unpin(const Handle& handle);
+
+    /**
+     * Remove the shared memory segments left by the processes that are no
+     * longer running.  Called when the pool is created.
+     * @return the number of segments removed.
+     */
+    static size_t removeStaleSegments();
+
+    /**
+     * Name of the shared memory segment referenced by a handle.
+     */
+    static std::string segmentName(std::int32_t pid, std::uint32_t segment);
+
+    /**
+     * Number of segments currently in use or waiting to be recycled.
+     */
+    size_t getSegmentCount() const;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+private:
+    SharedBufferPool();
+    ~SharedBufferPool();
+    SharedBufferPool(const SharedBufferPool&) = delete;
+    SharedBufferPool& operator=(const SharedBufferPool&) = delete;
+
+    class Private;
+    Private* const mPriv;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_SHAREDBUFFERPOOL_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/TransformCache.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+
+using yarp::os::TransformCache;
+
+namespace {
+// The cache of the message being sent by this thread
+thread_local TransformCache* current = nullptr;
+} // namespace
+
+
+class TransformCache::Private
+{
+public:
+    struct Entry
+    {
+        std::string key;
+        std::shared_future<std::shared_ptr<const void>> result;
+    };
+
+    // A message is sent on a few connections, a vector is enough
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    std::atomic<size_t> hits {0};
+    std::atomic<size_t> misses {0};
+
+    void erase(const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->key == key) {
+                entries.erase(it);
+                break;
+            }
+        }
+    }
+};
+
+
+TransformCache::TransformCache() :
+        mPriv(new Private)
+{
+}
+
+TransformCache::~TransformCache()
+{
+    delete mPriv;
+}
+
+std::shared_ptr<const void> TransformCache::getShared(const std::string& key,
+                                                      const std::function<std::shared_ptr<const void>()>& transform)
+{
+    std::unique_lock<std::mutex> lock(mPriv->mutex);
+    for (const auto& entry : mPriv->entries) {
+        if (entry.key == key) {
+            std::shared_future<std::shared_ptr<const void>> result = entry.result;
+            lock.unlock();
+            mPriv->hits++;
+            // Wait for the connection that is running the transformation
+            return result.get();
+        }
+    }
+    std::promise<std::shared_ptr<const void>> promise;
+    mPriv->entries.push_back({key, promise.get_future().share()});
+    lock.unlock();
+    mPriv->misses++;
+
+    std::shared_ptr<const void> result;
+    try {
+        result = transform();
+    } catch (...) {
+        // The connections waiting get the exception, the next ones try again
+        promise.set_exception(std::current_exception());
+        mPriv->erase(key);
+        throw;
+    }
+    promise.set_value(result);
+    if (result == nullptr) {
+        mPriv->erase(key);
+    }
+    return result;
+}
+
+void TransformCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    mPriv->entries.clear();
+    mPriv->hits = 0;
+    mPriv->misses = 0;
+}
+
+size_t TransformCache::getHits() const
+{
+    return mPriv->hits.load();
+}
+
+size_t TransformCache::getMisses() const
+{
+    return mPriv->misses.load();
+}
+
+TransformCache* TransformCache::getCurrent()
+{
+    return current;
+}
+
+
+TransformCache::Scope::Scope(TransformCache* cache) :
+        previous(current)
+{
+    current = cache;
+}
+
+TransformCache::Scope::~Scope()
+{
+    current = previous;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_TRANSFORMCACHE_H
+#define YARP_OS_TRANSFORMCACHE_H
+
+#include <yarp/os/api.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace yarp {
+namespace os {
+
+/**
+ * \ingroup comm_class
+ *
+ * The results of the transformations of a message (e.g. its compression)
+ * shared by the connections it is sent on.
+ *
+ * Each message written to a port has its own cache, that lives as long as
+ * the message is being sent and is emptied when it has been sent on all
+ * the connections.  While a connection sends a message, its cache is
+ * returned by getCurrent(), so that the carriers and the port monitors
+ * of the connections sharing the same configuration transform the
+ * message only once, e.g.
+ *
+ * \code
+ * TransformCache* cache = TransformCache::getCurrent();
+ * if (cache != nullptr) {
+ *     frame = cache->get<std::vector<char>>("mjpeg?quality=90", compress);
+ * } else {
+ *     frame = compress();
+ * }
+ * \endcode
+ *
+ * The key must identify the carrier and all the parameters that change the
+ * result.  The first connection asking for a key runs the transformation,
+ * the ones asking for it meanwhile wait for the result.
+ */
+class YARP_os_API TransformCache
+{
+public:
+    TransformCache();
+    virtual ~TransformCache();
+
+    TransformCache(const TransformCache&) = delete;
+    TransformCache& operator=(const TransformCache&) = delete;
+
+    /**
+     * Get the result of a transformation of the message, running it if
+     * it is not in the cache.
+     * A failed transformation (returning nullptr) is not kept, the next
+     * connection asking for the same key runs it again.  The same happens
+     * when the transformation throws, the exception is rethrown to the
+     * connection that ran it and to the ones waiting for its result.
+     *
+     * @param key the carrier and its parameters
+     * @param transform the transformation to run on a miss
+     * @return the shared result, or nullptr on failure
+     */
+    template <typename T>
+    std::shared_ptr<const T> get(const std::string& key,
+                                 const std::function<std::shared_ptr<const T>()>& transform)
+    {
+        return std::static_pointer_cast<const T>(getShared(key, [&transform]() -> std::shared_ptr<const void> { return transform(); }));
+    }
+
+    /**
+     * Remove all the results, and reset the counters.
+     */
+    void clear();
+
+    /**
+     * @return the number of times a result was found in the cache.
+     */
+    size_t getHits() const;
+
+    /**
+     * @return the number of transformations run.
+     */
+    size_t getMisses() const;
+
+    /**
+     * @return the cache of the message being sent by the calling thread,
+     * nullptr if it is not sending a message on a connection of a port.
+     */
+    static TransformCache* getCurrent();
+
+    /**
+     * Make a cache the current one for the calling thread, for the
+     * lifetime of this object.
+     */
+    class YARP_os_API Scope
+    {
+    public:
+        explicit Scope(TransformCache* cache);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TransformCache* previous;
+    };
+
+private:
+    std::shared_ptr<const void> getShared(const std::string& key,
+                                          const std::function<std::shared_ptr<const void>()>& transform);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    class Private;
+    Private* const mPriv;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_TRANSFORMCACHE_H
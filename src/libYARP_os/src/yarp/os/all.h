@@ -57,6 +57,7 @@
 #include <yarp/os/RpcServer.h>
 #include <yarp/os/Searchable.h>
 #include <yarp/os/Semaphore.h>
+#include <yarp/os/SharedBufferPool.h>
 #include <yarp/os/Stamp.h>
 #include <yarp/os/Subscriber.h>
 #include <yarp/os/SystemClock.h>
@@ -64,6 +65,7 @@
 #include <yarp/os/Things.h>
 #include <yarp/os/Thread.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/TransformCache.h>
 #include <yarp/os/UnbufferedContactable.h>
 #include <yarp/os/Value.h>
 #include <yarp/os/Vocab.h>
@@ -18,25 +18,103 @@
 #include <yarp/os/impl/MemoryOutputStream.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
 using yarp::os::Bottle;
 using yarp::os::Bytes;
 using yarp::os::ConnectionReader;
 using yarp::os::ConnectionWriter;
+using yarp::os::NetFloat32;
+using yarp::os::NetFloat64;
+using yarp::os::NetInt16;
+using yarp::os::NetInt32;
+using yarp::os::NetInt64;
 using yarp::os::Searchable;
 using yarp::os::Value;
 using yarp::os::impl::BottleImpl;
 using yarp::os::impl::Storable;
+using yarp::os::impl::StorableArena;
+using yarp::os::impl::StoreFloat32;
+using yarp::os::impl::StoreFloat64;
+using yarp::os::impl::StoreInt16;
+using yarp::os::impl::StoreInt32;
+using yarp::os::impl::StoreInt64;
+using yarp::os::impl::StoreInt8;
+using yarp::os::impl::StoreList;
+using yarp::os::impl::StoreString;
+using yarp::os::impl::StoreVocab;
 
 namespace {
 YARP_OS_LOG_COMPONENT(BOTTLEIMPL, "yarp.os.impl.BottleImpl")
+
+// Largest block read at once for a packed list, so that a corrupted
+// length fails at the end of the stream instead of allocating it all
+constexpr size_t MAX_PACKED_CHUNK = 65536;
+
+// Largest number of items reserved in advance, for the same reason
+constexpr size_t MAX_RESERVED_ITEMS = 4096;
+
+template <typename Store, typename Net>
+void unpackAs(const std::vector<char>& packed, std::vector<Storable*>& content)
+{
+    const size_t count = packed.size() / sizeof(Net);
+    content.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        Net x;
+        memcpy(&x, packed.data() + i * sizeof(Net), sizeof(Net));
+        content.push_back(new Store(x));
+    }
+}
+
+// The arena of the message that this thread is parsing, set by the
+// outermost read() or fromString(), and used by the nested lists.
+thread_local std::shared_ptr<StorableArena>* parsing = nullptr;
+
+class ArenaScope
+{
+public:
+    explicit ArenaScope(std::shared_ptr<StorableArena>& arena)
+    {
+        if (parsing == nullptr) {
+            if (!arena) {
+                arena = std::make_shared<StorableArena>();
+            }
+            parsing = &arena;
+            outermost = true;
+        }
+    }
+
+    ~ArenaScope()
+    {
+        if (outermost) {
+            parsing = nullptr;
+        }
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    bool outermost {false};
+};
+
+template <typename Store, typename... Args>
+Store* make(StorableArena* arena, Args&&... args)
+{
+    if (arena != nullptr) {
+        return arena->create<Store>(std::forward<Args>(args)...);
+    }
+    return new Store(std::forward<Args>(args)...);
+}
 } // namespace
 
 BottleImpl::BottleImpl() :
         parent(nullptr),
         invalid(false),
         ro(false),
+        packedCode(0),
         speciality(0),
         nested(false),
         dirty(true)
@@ -47,6 +125,7 @@ BottleImpl::BottleImpl(Searchable* parent) :
         parent(parent),
         invalid(false),
         ro(false),
+        packedCode(0),
         speciality(0),
         nested(false),
         dirty(true)
@@ -62,6 +141,8 @@ BottleImpl::~BottleImpl()
 
 void BottleImpl::add(Storable* s)
 {
+    unpack();
+    packed.clear();
     content.push_back(s);
     dirty = true;
 }
@@ -70,16 +151,153 @@ void BottleImpl::add(Storable* s)
 void BottleImpl::clear()
 {
     for (auto& i : content) {
-        delete i;
+        destroy(i);
     }
     content.clear();
+    packed.clear();
+    packedCode = 0;
+    if (arena) {
+        if (arena.use_count() == 1) {
+            // nobody else has items in it
+            arena->reset();
+        } else {
+            arena.reset();
+        }
+    }
     dirty = true;
 }
 
+
+StorableArena* BottleImpl::parseArena()
+{
+    if (parsing == nullptr) {
+        return nullptr;
+    }
+    if (!arena) {
+        arena = *parsing;
+    }
+    // A bottle that already has items in another arena uses the heap
+    return (arena == *parsing) ? arena.get() : nullptr;
+}
+
+
+void BottleImpl::destroy(Storable* s)
+{
+    if (arena && arena->owns(s)) {
+        s->~Storable();
+    } else {
+        delete s;
+    }
+}
+
+
+size_t BottleImpl::packedUnit(std::int32_t code)
+{
+    switch (code) {
+    case BOTTLE_TAG_INT8:
+        return sizeof(std::int8_t);
+    case BOTTLE_TAG_INT16:
+        return sizeof(NetInt16);
+    case BOTTLE_TAG_INT32:
+    case BOTTLE_TAG_VOCAB:
+        return sizeof(NetInt32);
+    case BOTTLE_TAG_INT64:
+        return sizeof(NetInt64);
+    case BOTTLE_TAG_FLOAT32:
+        return sizeof(NetFloat32);
+    case BOTTLE_TAG_FLOAT64:
+        return sizeof(NetFloat64);
+    default:
+        return 0;
+    }
+}
+
+bool BottleImpl::addPacked(std::int32_t code, const void* x, size_t len)
+{
+    if (!content.empty() || (packedCode != 0 && packedCode != code)) {
+        return false;
+    }
+    packedCode = code;
+    const char* bytes = static_cast<const char*>(x);
+    packed.insert(packed.end(), bytes, bytes + len);
+    dirty = true;
+    return true;
+}
+
+bool BottleImpl::readItems(ConnectionReader& reader, std::int32_t len)
+{
+    size_t unit = packedUnit(speciality);
+    if (unit == 0 || len <= 0) {
+        if (len > 0) {
+            content.reserve(std::min(static_cast<size_t>(len), MAX_RESERVED_ITEMS));
+        }
+        for (int i = 0; i < len; i++) {
+            bool ok = fromBytes(reader);
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const size_t total = unit * static_cast<size_t>(len);
+    while (packed.size() < total) {
+        size_t at = packed.size();
+        size_t chunk = std::min(total - at, MAX_PACKED_CHUNK);
+        packed.resize(at + chunk);
+        if (!reader.expectBlock(&packed[at], chunk)) {
+            packed.clear();
+            return false;
+        }
+    }
+    packedCode = speciality;
+    return true;
+}
+
+void BottleImpl::unpack() const
+{
+    if (packedCode.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(unpackMutex);
+    const std::int32_t code = packedCode.load(std::memory_order_relaxed);
+    if (code == 0) {
+        // Another thread did it meanwhile
+        return;
+    }
+    switch (code) {
+    case BOTTLE_TAG_INT8:
+        unpackAs<StoreInt8, std::int8_t>(packed, content);
+        break;
+    case BOTTLE_TAG_INT16:
+        unpackAs<StoreInt16, NetInt16>(packed, content);
+        break;
+    case BOTTLE_TAG_INT32:
+        unpackAs<StoreInt32, NetInt32>(packed, content);
+        break;
+    case BOTTLE_TAG_VOCAB:
+        unpackAs<StoreVocab, NetInt32>(packed, content);
+        break;
+    case BOTTLE_TAG_INT64:
+        unpackAs<StoreInt64, NetInt64>(packed, content);
+        break;
+    case BOTTLE_TAG_FLOAT32:
+        unpackAs<StoreFloat32, NetFloat32>(packed, content);
+        break;
+    case BOTTLE_TAG_FLOAT64:
+        unpackAs<StoreFloat64, NetFloat64>(packed, content);
+        break;
+    default:
+        yCAssert(BOTTLEIMPL, false);
+    }
+    packedCode.store(0, std::memory_order_release);
+}
+
 void BottleImpl::smartAdd(const std::string& str)
 {
     if (str.length() > 0) {
         char ch = str[0];
+        StorableArena* itemArena = parseArena();
         Storable* s = nullptr;
         StoreString* ss = nullptr;
         bool numberLike = true;
@@ -143,18 +361,18 @@ void BottleImpl::smartAdd(const std::string& str)
             ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-' || ch == '.' || ch == 'i' /* inf */ || ch == 'n' /* nan */) &&
             (ch != '.' || str.length() > 1)) {
             if (!hasPeriodOrE) {
-                s = new StoreInt64(0);
+                s = make<StoreInt64>(itemArena, 0);
             } else {
-                s = new StoreFloat64(0);
+                s = make<StoreFloat64>(itemArena, 0);
             }
         } else if (ch == '(') {
-            s = new StoreList();
+            s = make<StoreList>(itemArena);
         } else if (ch == '[') {
-            s = new StoreVocab();
+            s = make<StoreVocab>(itemArena);
         } else if (ch == '{') {
-            s = new StoreBlob();
+            s = make<StoreBlob>(itemArena);
         } else {
-            s = ss = new StoreString("");
+            s = ss = make<StoreString>(itemArena, "");
         }
         if (s != nullptr) {
             s->fromStringNested(str);
@@ -166,8 +384,8 @@ void BottleImpl::smartAdd(const std::string& str)
             if (s->isInt64()
                 && s->asInt64() >= std::numeric_limits<int32_t>::min()
                 && s->asInt64() <= std::numeric_limits<int32_t>::max()) {
-                Storable* s_i32 = new StoreInt32(s->asInt32());
-                delete s;
+                Storable* s_i32 = make<StoreInt32>(itemArena, s->asInt32());
+                destroy(s);
                 s = s_i32;
                 s_i32 = nullptr;
             }
@@ -176,11 +394,11 @@ void BottleImpl::smartAdd(const std::string& str)
                 if (str.length() == 0 || str[0] != '\"') {
                     std::string val = ss->asString();
                     if (val == "true") {
-                        delete s;
-                        s = new StoreVocab(static_cast<int>('1'));
+                        destroy(s);
+                        s = make<StoreVocab>(itemArena, static_cast<int>('1'));
                     } else if (val == "false") {
-                        delete s;
-                        s = new StoreVocab(0);
+                        destroy(s);
+                        s = make<StoreVocab>(itemArena, 0);
                     }
                 }
             }
@@ -194,6 +412,7 @@ void BottleImpl::fromString(const std::string& line)
 {
     clear();
     dirty = true;
+    ArenaScope scope(arena);
     std::string arg;
     bool quoted = false;
     bool back = false;
@@ -239,7 +458,7 @@ void BottleImpl::fromString(const std::string& line)
                         (nestedAlt == 0) && (nested == 0)) {
                         if (!arg.empty()) {
                             if (arg == "null") {
-                                add(new StoreVocab(yarp::os::createVocab('n', 'u', 'l', 'l')));
+                                add(make<StoreVocab>(parseArena(), yarp::os::createVocab('n', 'u', 'l', 'l')));
                             } else {
                                 smartAdd(arg);
                             }
@@ -314,6 +533,7 @@ bool BottleImpl::isComplete(const char* txt)
 
 std::string BottleImpl::toString() const
 {
+    unpack();
     std::string result;
     for (unsigned int i = 0; i < content.size(); i++) {
         if (i > 0) {
@@ -327,6 +547,10 @@ std::string BottleImpl::toString() const
 
 BottleImpl::size_type BottleImpl::size() const
 {
+    const std::int32_t code = packedCode.load(std::memory_order_acquire);
+    if (code != 0) {
+        return packed.size() / packedUnit(code);
+    }
     return content.size();
 }
 
@@ -344,7 +568,7 @@ bool BottleImpl::fromBytes(ConnectionReader& reader)
     } else {
         yCTrace(BOTTLEIMPL, "READ skipped subcode %" PRId32, speciality);
     }
-    Storable* storable = Storable::createByCode(id);
+    Storable* storable = Storable::createByCode(id, parseArena());
     if (storable == nullptr) {
         yCError(BOTTLEIMPL, "Reader failed, unrecognized object code %" PRId32, id);
         return false;
@@ -398,14 +622,8 @@ bool BottleImpl::fromBytes(const Bytes& data)
         return false;
     }
     yCTrace(BOTTLEIMPL, "READ bottle length %d", len);
-    for (int i = 0; i < len; i++) {
-        bool ok = fromBytes(reader);
-        if (!ok) {
-            return false;
-        }
-    }
-
-    return true;
+    ArenaScope scope(arena);
+    return readItems(reader, len);
 }
 
 void BottleImpl::toBytes(Bytes& data)
@@ -507,11 +725,9 @@ bool BottleImpl::read(ConnectionReader& reader)
             return false;
         }
         yCTrace(BOTTLEIMPL, "READ got length %d", len);
-        for (int i = 0; i < len; i++) {
-            bool ok = fromBytes(reader);
-            if (!ok) {
-                return false;
-            }
+        ArenaScope scope(arena);
+        if (!readItems(reader, len)) {
+            return false;
         }
     }
     return result;
@@ -524,6 +740,17 @@ void BottleImpl::synch() const
 
 void BottleImpl::synch()
 {
+    if (dirty && packedCode != 0) {
+        // The items are already in their wire representation
+        speciality = packedCode;
+        NetInt32 header[2] = {StoreList::code + speciality, static_cast<std::int32_t>(size())};
+        const size_t headerSize = nested ? sizeof(NetInt32) : sizeof(header);
+        data.resize(headerSize + packed.size());
+        memcpy(&data[0], nested ? &header[1] : &header[0], headerSize);
+        memcpy(&data[headerSize], packed.data(), packed.size());
+        dirty = false;
+        return;
+    }
     if (dirty) {
         if (!nested) {
             subCode();
@@ -577,6 +804,10 @@ void BottleImpl::setNested(bool nested)
 
 std::int32_t BottleImpl::subCode()
 {
+    if (packedCode != 0) {
+        specialize(packedCode);
+        return packedCode;
+    }
     return subCoder(*this);
 }
 
@@ -587,52 +818,68 @@ bool BottleImpl::checkIndex(size_type index) const
 
 bool BottleImpl::isInt8(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isInt8() : false);
 }
 
 bool BottleImpl::isInt16(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isInt16() : false);
 }
 
 bool BottleImpl::isInt32(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isInt32() : false);
 }
 
 bool BottleImpl::isInt64(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isInt64() : false);
 }
 
 bool BottleImpl::isFloat32(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isFloat32() : false);
 }
 
 bool BottleImpl::isFloat64(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isFloat64() : false);
 }
 
 bool BottleImpl::isString(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isString() : false);
 }
 
 bool BottleImpl::isList(int index)
 {
+    unpack();
     return (checkIndex(index) ? content[index]->isList() : false);
 }
 
 Storable* BottleImpl::pop()
 {
+    unpack();
+    packed.clear();
     Storable* stb = nullptr;
     if (size() == 0) {
         stb = new StoreNull();
     } else {
         stb = content[size() - 1];
         content.pop_back();
+        if (arena && arena->owns(stb)) {
+            // the caller deletes it
+            Storable* copy = stb->cloneStorable();
+            stb->~Storable();
+            stb = copy;
+        }
         dirty = true;
     }
     yCAssert(BOTTLEIMPL, stb != nullptr);
@@ -641,6 +888,7 @@ Storable* BottleImpl::pop()
 
 Storable& BottleImpl::get(size_type index) const
 {
+    unpack();
     return (checkIndex(index) ? *(content[index]) : getNull());
 }
 
@@ -666,6 +914,24 @@ void BottleImpl::copyRange(const BottleImpl* alt, size_type first, size_type len
         return;
     }
 
+    const std::int32_t code = alt->packedCode.load(std::memory_order_acquire);
+    if (code != 0) {
+        // Copy the packed items (alt can be this bottle)
+        const size_t unit = packedUnit(code);
+        const size_t count = alt->packed.size() / unit;
+        std::vector<char> items;
+        if (first < count) {
+            const size_t n = std::min(len, count - first);
+            items.assign(alt->packed.begin() + first * unit, alt->packed.begin() + (first + n) * unit);
+        }
+        clear();
+        if (!items.empty()) {
+            packed.swap(items);
+            packedCode = code;
+        }
+        return;
+    }
+
     // Handle copying to the same object just a subset of the bottle
     const BottleImpl* src = alt;
     BottleImpl tmp(nullptr);
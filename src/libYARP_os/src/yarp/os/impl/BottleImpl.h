@@ -12,8 +12,16 @@
 #define YARP_OS_IMPL_BOTTLEIMPL_H
 
 #include <yarp/os/Bytes.h>
+#include <yarp/os/NetFloat32.h>
+#include <yarp/os/NetFloat64.h>
+#include <yarp/os/NetInt16.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/NetInt64.h>
 #include <yarp/os/impl/Storable.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace yarp {
@@ -59,37 +67,57 @@ public:
 
     void addInt8(std::int8_t x)
     {
-        add(new StoreInt8(x));
+        if (!addPacked(StoreInt8::code, &x, sizeof(x))) {
+            add(new StoreInt8(x));
+        }
     }
 
     void addInt16(std::int16_t x)
     {
-        add(new StoreInt16(x));
+        NetInt16 y = x;
+        if (!addPacked(StoreInt16::code, &y, sizeof(y))) {
+            add(new StoreInt16(x));
+        }
     }
 
     void addInt32(std::int32_t x)
     {
-        add(new StoreInt32(x));
+        NetInt32 y = x;
+        if (!addPacked(StoreInt32::code, &y, sizeof(y))) {
+            add(new StoreInt32(x));
+        }
     }
 
     void addInt64(std::int64_t x)
     {
-        add(new StoreInt64(x));
+        NetInt64 y = x;
+        if (!addPacked(StoreInt64::code, &y, sizeof(y))) {
+            add(new StoreInt64(x));
+        }
     }
 
     void addFloat32(yarp::conf::float32_t x)
     {
-        add(new StoreFloat32(x));
+        NetFloat32 y = x;
+        if (!addPacked(StoreFloat32::code, &y, sizeof(y))) {
+            add(new StoreFloat32(x));
+        }
     }
 
     void addFloat64(yarp::conf::float64_t x)
     {
-        add(new StoreFloat64(x));
+        NetFloat64 y = x;
+        if (!addPacked(StoreFloat64::code, &y, sizeof(y))) {
+            add(new StoreFloat64(x));
+        }
     }
 
     void addVocab(std::int32_t x)
     {
-        add(new StoreVocab(x));
+        NetInt32 y = x;
+        if (!addPacked(StoreVocab::code, &y, sizeof(y))) {
+            add(new StoreVocab(x));
+        }
     }
 
     void addString(const std::string& text)
@@ -180,8 +208,27 @@ public:
     Value& findBit(const std::string& key) const;
 
 private:
-    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<Storable*>) content;
+    // A list of numbers of the same type (see packedUnit()) can be kept
+    // as a packed array of their wire representation instead of as
+    // Storables.  The Storables are created only when somebody asks for
+    // them (get(), toString(), ...), so that reading, writing and
+    // copying these lists are just a copy of the array.
+    // When packedCode is not 0, content is empty.  When it is 0, packed is
+    // not used, and it is emptied by the next change of the bottle.
+    // Several threads can read the same const bottle, so unpack() creates
+    // the Storables under unpackMutex, and packedCode is set to 0 when they
+    // are all there.  The const methods do not change packed.
+    mutable YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<Storable*>) content;
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<char>) packed;
+    mutable YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::atomic<std::int32_t>) packedCode;
+    mutable YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::mutex) unpackMutex;
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<char>) data;
+    // The items created while parsing a message (read(), fromString())
+    // are taken from an arena shared by the outermost bottle and by all
+    // the lists nested in it, and given back at once by clear().  Each
+    // bottle holding items of the arena keeps a reference to it, so that
+    // a nested list moved out of the message stays valid.
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::shared_ptr<StorableArena>) arena;
     int speciality;
     bool nested;
     bool dirty;
@@ -189,6 +236,14 @@ private:
     void add(Storable* s);
     void smartAdd(const std::string& str);
 
+    StorableArena* parseArena();
+    void destroy(Storable* s);
+
+    static size_t packedUnit(std::int32_t code);
+    bool addPacked(std::int32_t code, const void* x, size_t len);
+    bool readItems(ConnectionReader& reader, std::int32_t len);
+    void unpack() const;
+
     /*
      * Bottle is using a lazy synchronization method. Whenever some operation
      * is performed, a dirty flag is set, and when it is used, the synch()
@@ -42,7 +42,12 @@ BufferedConnectionWriter::BufferedConnectionWriter(bool textMode,
         lst_used(0),
         header_used(0),
         target_used(&lst_used),
-        initialPoolSize(BUFFERED_CONNECTION_INITIAL_POOL_SIZE)
+        initialPoolSize(BUFFERED_CONNECTION_INITIAL_POOL_SIZE),
+        blocks_used(0),
+        blocks_bytes_used(0),
+        allocations(0),
+        pooledBytes(0),
+        highWaterMark(0)
 {
     stopPool();
 }
@@ -67,9 +72,12 @@ void BufferedConnectionWriter::restart()
 {
     lst_used = 0;
     header_used = 0;
+    blocks_used = 0;
+    blocks_bytes_used = 0;
     reader = nullptr;
     ref = nullptr;
     convertTextModePending = false;
+    shouldDrop = false;
     target = &lst;
     target_used = &lst_used;
     stopPool();
@@ -89,9 +97,58 @@ void BufferedConnectionWriter::clear()
         delete header[i];
     }
     header.clear();
+    for (i = 0; i < blocks.size(); i++) {
+        delete blocks[i];
+    }
+    blocks.clear();
     stopPool();
     lst_used = 0;
     header_used = 0;
+    blocks_used = 0;
+    blocks_bytes_used = 0;
+    pooledBytes = 0;
+}
+
+yarp::os::ManagedBytes* BufferedConnectionWriter::nextSlot()
+{
+    if (*target_used == target->size()) {
+        target->push_back(new yarp::os::ManagedBytes);
+        allocations++;
+    }
+    return (*target)[(*target_used)++];
+}
+
+char* BufferedConnectionWriter::allocateBlock(size_t len)
+{
+    // Look for a free block large enough, moving it in the next position
+    // so that the same blocks are used in the same order next time.
+    yarp::os::ManagedBytes* block = nullptr;
+    for (size_t i = blocks_used; i < blocks.size(); i++) {
+        if (blocks[i]->length() >= len) {
+            std::swap(blocks[i], blocks[blocks_used]);
+            block = blocks[blocks_used];
+            break;
+        }
+    }
+    if (block == nullptr) {
+        if (blocks_used < blocks.size()) {
+            // No free block is large enough, grow the next one
+            block = blocks[blocks_used];
+            pooledBytes -= block->length();
+            block->allocate(len);
+        } else {
+            block = new yarp::os::ManagedBytes(len);
+            blocks.push_back(block);
+        }
+        pooledBytes += len;
+        allocations++;
+    }
+    blocks_used++;
+    blocks_bytes_used += block->length();
+    if (blocks_bytes_used > highWaterMark) {
+        highWaterMark = blocks_bytes_used;
+    }
+    return block->get();
 }
 
 bool BufferedConnectionWriter::addPool(const yarp::os::Bytes& data)
@@ -102,34 +159,14 @@ bool BufferedConnectionWriter::addPool(const yarp::os::Bytes& data)
         }
     }
     if (pool == nullptr && data.length() < poolLength) {
-        bool add = false;
-        if (*target_used < target->size()) {
-            yarp::os::ManagedBytes*& bytes = (*target)[*target_used];
-            if (bytes->length() < poolLength) {
-                delete bytes;
-                bytes = new yarp::os::ManagedBytes(poolLength);
-            }
-            pool = bytes;
-            if (pool == nullptr) {
-                return false;
-            }
-        } else {
-            pool = new yarp::os::ManagedBytes(poolLength);
-            if (pool == nullptr) {
-                return false;
-            }
-            add = true;
-        }
-        (*target_used)++;
+        pool = nextSlot();
+        *pool = yarp::os::ManagedBytes(yarp::os::Bytes(allocateBlock(poolLength), poolLength), false);
         poolCount++;
         poolIndex = 0;
         if (poolLength < 65536) {
             poolLength *= 2;
         }
         pool->setUsed(0);
-        if (add) {
-            target->push_back(pool);
-        }
     }
     if (pool != nullptr) {
         memcpy(pool->get() + poolIndex, data.get(), data.length());
@@ -156,37 +193,12 @@ void BufferedConnectionWriter::push(const Bytes& data, bool copy)
         if (addPool(data)) {
             return;
         }
-    }
-    yarp::os::ManagedBytes* buf = nullptr;
-    if (*target_used < target->size()) {
-        yarp::os::ManagedBytes*& bytes = (*target)[*target_used];
-        if (bytes->isOwner() != copy || bytes->length() < data.length()) {
-            delete bytes;
-            bytes = new yarp::os::ManagedBytes(data, false);
-            if (copy) {
-                bytes->copy();
-            }
-            (*target_used)++;
-            return;
-        }
-        buf = bytes;
-        bytes->setUsed(data.length());
-    }
-    if (buf == nullptr) {
-        buf = new yarp::os::ManagedBytes(data, false);
-        if (copy) {
-            buf->copy();
-        }
-        target->push_back(buf);
+        char* block = allocateBlock(data.length());
+        memcpy(block, data.get(), data.length());
+        *nextSlot() = yarp::os::ManagedBytes(yarp::os::Bytes(block, data.length()), false);
     } else {
-        if (copy) {
-            buf->copy();
-            memmove(buf->get(), data.get(), data.length());
-        } else {
-            *buf = ManagedBytes(data, false);
-        }
+        *nextSlot() = yarp::os::ManagedBytes(data, false);
     }
-    (*target_used)++;
 }
 
 
@@ -327,7 +339,7 @@ size_t BufferedConnectionWriter::length(size_t index) const
         yarp::os::ManagedBytes& b = *(header[index]);
         return b.used();
     }
-    yarp::os::ManagedBytes& b = *(lst[index - header.size()]);
+    yarp::os::ManagedBytes& b = *(lst[index - header_used]);
     return b.used();
 }
 
@@ -337,7 +349,7 @@ const char* BufferedConnectionWriter::data(size_t index) const
         yarp::os::ManagedBytes& b = *(header[index]);
         return b.get();
     }
-    yarp::os::ManagedBytes& b = *(lst[index - header.size()]);
+    yarp::os::ManagedBytes& b = *(lst[index - header_used]);
     return b.get();
 }
 
@@ -359,14 +371,16 @@ bool BufferedConnectionWriter::write(ConnectionWriter& connection) const
 void BufferedConnectionWriter::write(OutputStream& os)
 {
     stopWrite();
+    // Hand all the fragments to the stream at once, so that it can send
+    // them with a single vectored write.
+    fragments.clear();
     for (size_t i = 0; i < header_used; i++) {
-        yarp::os::ManagedBytes& b = *(header[i]);
-        os.write(b.usedBytes());
+        fragments.push_back(header[i]->usedBytes());
     }
     for (size_t i = 0; i < lst_used; i++) {
-        yarp::os::ManagedBytes& b = *(lst[i]);
-        os.write(b.usedBytes());
+        fragments.push_back(lst[i]->usedBytes());
     }
+    os.writeBlocks(fragments.data(), fragments.size());
     os.flush();
 }
 
@@ -401,6 +415,21 @@ size_t BufferedConnectionWriter::bufferCount() const
     return header.size() + lst.size();
 }
 
+size_t BufferedConnectionWriter::allocationCount() const
+{
+    return allocations;
+}
+
+size_t BufferedConnectionWriter::pooledSize() const
+{
+    return pooledBytes;
+}
+
+size_t BufferedConnectionWriter::pooledHighWaterMark() const
+{
+    return highWaterMark;
+}
+
 
 PortReader* BufferedConnectionWriter::getReplyHandler()
 {
@@ -512,12 +541,9 @@ bool BufferedConnectionWriter::applyConvertTextMode()
         const std::string& str = sos.str();
         b.fromBinary(str.c_str(), static_cast<int>(str.length()));
         std::string replacement = b.toString() + "\n";
-        for (auto& i : lst) {
-            delete i;
-        }
         lst_used = 0;
         target = &lst;
-        lst.clear();
+        target_used = &lst_used;
         stopPool();
         Bytes data(const_cast<char*>(replacement.c_str()), replacement.length());
         appendBlockCopy(data);
@@ -10,6 +10,7 @@
 #ifndef YARP_OS_IMPL_BUFFEREDCONNECTIONWRITER_H
 #define YARP_OS_IMPL_BUFFEREDCONNECTIONWRITER_H
 
+#include <yarp/os/Bytes.h>
 #include <yarp/os/ConnectionWriter.h>
 #include <yarp/os/SizedWriter.h>
 
@@ -43,6 +44,11 @@ constexpr size_t BUFFERED_CONNECTION_INITIAL_POOL_SIZE = 1024;
  * lifecycle of external blocks (e.g. when they are created/destroyed,
  * or when they may change in value). If you use external blocks, be
  * sure to pay attention to onCompletion() events on your object.
+ *
+ * The buffer space is kept when restart() is called, and reused for the
+ * following messages, so that once the writer is warmed up, serializing
+ * a message does not allocate any memory.  allocationCount() can be used
+ * to check that.
  */
 class YARP_os_impl_API BufferedConnectionWriter :
         public yarp::os::ConnectionWriter,
@@ -187,6 +193,24 @@ public:
 
     size_t bufferCount() const;
 
+    /**
+     * @return the number of memory allocations made by the writer since it
+     * was created or cleared.  It does not change across restart() calls
+     * once the writer has seen messages of the same shape.
+     */
+    size_t allocationCount() const;
+
+    /**
+     * @return the size in bytes of the buffer space held by the writer.
+     */
+    size_t pooledSize() const;
+
+    /**
+     * @return the largest amount of buffer space, in bytes, used by a single
+     * message.
+     */
+    size_t pooledHighWaterMark() const;
+
 
     // defined by yarp::os::SizedWriter
     PortReader* getReplyHandler() override;
@@ -249,10 +273,23 @@ private:
     bool applyConvertTextMode();
     bool applyConvertTextMode() const;
 
+    /**
+     * Get the next slot in the current target list, creating it if needed.
+     */
+    yarp::os::ManagedBytes* nextSlot();
+
+    /**
+     * Get a block of at least len bytes from the buffer space, reusing the
+     * blocks of the previous messages where possible.
+     */
+    char* allocateBlock(size_t len);
+
 
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::ManagedBytes*>) lst;     ///< buffers in payload
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::ManagedBytes*>) header;  ///< buffers in header
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::ManagedBytes*>) blocks;  ///< buffer space for copied data
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::ManagedBytes*>*) target; ///< points to header or payload
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::Bytes>) fragments;       ///< gather list for writing to a stream
     yarp::os::ManagedBytes* pool; ///< the pool buffer (in lst or header)
     size_t poolIndex;             ///< current offset into pool buffer
     size_t poolCount;             ///< number of pool buffers allocated
@@ -267,6 +304,11 @@ private:
     size_t header_used;           ///< how many header buffers are in use for the current message
     size_t* target_used;          ///< points to lst_used of header_used
     size_t initialPoolSize;       ///< size of new pool buffers
+    size_t blocks_used;           ///< how many blocks are in use for the current message
+    size_t blocks_bytes_used;     ///< size of the blocks in use for the current message
+    size_t allocations;           ///< number of memory allocations
+    size_t pooledBytes;           ///< size of all the blocks
+    size_t highWaterMark;         ///< maximum value of blocks_bytes_used
 };
 
 
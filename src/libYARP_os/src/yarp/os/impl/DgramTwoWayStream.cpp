@@ -38,6 +38,10 @@
 #    include <unistd.h>
 #endif
 
+#if defined(__linux__)
+#    include <sys/socket.h>
+#endif
+
 #include <cerrno>
 #include <cstring>
 
@@ -47,21 +51,46 @@ using namespace yarp::os;
 #define CRC_SIZE 8
 #define UDP_MAX_DATAGRAM_SIZE (65507 - CRC_SIZE)
 
+// Batched format: crc, sequence number, offset of the first message that
+// begins in the datagram (-1 if none)
+#define BATCH_HEADER_SIZE 12
+// How many datagrams are sent or received with a single system call
+#define BATCH_SLOTS 16
+#define BATCH_SEQ_MASK 0x7fffffff
+
 
 namespace {
 YARP_OS_LOG_COMPONENT(DGRAMTWOWAYSTREAM, "yarp.os.impl.DgramTwoWayStream")
 } // namespace
 
+constexpr double DgramTwoWayStream::defaultBatchDelay;
+
+
+static NetInt32 computeCrc(DgramTwoWayStream::Checksum checksum, char* buf, yarp::conf::ssize_t length)
+{
+    if (length <= 0) {
+        length = 0;
+    }
+    switch (checksum) {
+    case DgramTwoWayStream::Checksum::Crc32c:
+        return (NetInt32)NetType::getCrc32c(buf, length);
+    case DgramTwoWayStream::Checksum::None:
+        return 0;
+    case DgramTwoWayStream::Checksum::Crc32:
+    default:
+        return (NetInt32)NetType::getCrc(buf, length);
+    }
+}
+
 
-static bool checkCrc(char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t crcLength, int pct, int* store_altPct = nullptr)
+static bool checkCrc(DgramTwoWayStream::Checksum checksum, char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t crcLength, int pct, int* store_altPct = nullptr)
 {
-    auto alt = (NetInt32)NetType::getCrc(buf + crcLength,
-                                         (length > crcLength) ? (length - crcLength) : 0);
+    NetInt32 alt = computeCrc(checksum, buf + crcLength, length - crcLength);
     Bytes b(buf, 4);
     Bytes b2(buf + 4, 4);
     NetInt32 curr = NetType::netInt(b);
     int altPct = NetType::netInt(b2);
-    bool ok = (alt == curr && pct == altPct);
+    bool ok = ((alt == curr || checksum == DgramTwoWayStream::Checksum::None) && pct == altPct);
     if (!ok) {
         if (alt != curr) {
             yCDebug(DGRAMTWOWAYSTREAM, "crc mismatch");
@@ -78,10 +107,9 @@ static bool checkCrc(char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t
 }
 
 
-static void addCrc(char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t crcLength, int pct)
+static void addCrc(DgramTwoWayStream::Checksum checksum, char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t crcLength, int pct)
 {
-    auto alt = (NetInt32)NetType::getCrc(buf + crcLength,
-                                         (length > crcLength) ? (length - crcLength) : 0);
+    NetInt32 alt = computeCrc(checksum, buf + crcLength, length - crcLength);
     Bytes b(buf, 4);
     Bytes b2(buf + 4, 4);
     NetType::netInt((NetInt32)alt, b);
@@ -248,7 +276,7 @@ void DgramTwoWayStream::allocate(int readSize, int writeSize)
     writeBuffer.allocate(_write_size);
     readAt = 0;
     readAvail = 0;
-    writeAvail = CRC_SIZE;
+    writeAvail = (batchMessages > 0) ? BATCH_HEADER_SIZE : CRC_SIZE;
     //happy = true;
     pct = 0;
 }
@@ -665,6 +693,15 @@ void DgramTwoWayStream::interrupt()
 void DgramTwoWayStream::closeMain()
 {
     if (dgram != nullptr) {
+        if (batchMessages > 0 && !reader) {
+            stopFlusher();
+            if (happy) {
+                // Send the messages still waiting for their batch
+                std::lock_guard<std::mutex> lock(batchMutex);
+                sealDatagram();
+                sendBatch();
+            }
+        }
         //printf("Dgram closing, interrupt state %d\n", interrupting);
         interrupt();
         mutex.lock();
@@ -699,6 +736,9 @@ void DgramTwoWayStream::closeMain()
 yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
 {
     reader = true;
+    if (batchMessages > 0) {
+        return readBatched(b);
+    }
     bool done = false;
 
     while (!done) {
@@ -734,13 +774,7 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
 #endif
                 if (dgram != nullptr) {
                 yCAssert(DGRAMTWOWAYSTREAM, dgram != nullptr);
-#if defined(YARP_HAS_ACE)
-                ACE_INET_Addr dummy((u_short)0, (ACE_UINT32)INADDR_ANY);
-                yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
-                result = dgram->recv(readBuffer.get(), readBuffer.length(), dummy);
-#else
-                result = recv(dgram_sockfd, readBuffer.get(), readBuffer.length(), 0);
-#endif
+                result = receiveDatagram(readBuffer.get(), readBuffer.length());
                 yCDebug(DGRAMTWOWAYSTREAM, "DGRAM Got %zd bytes", result);
             } else {
                 onMonitorInput();
@@ -761,7 +795,7 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
 
             // deal with CRC
             int altPct = 0;
-            bool crcOk = checkCrc(readBuffer.get(), readAvail, CRC_SIZE, pct, &altPct);
+            bool crcOk = checkCrc(checksum, readBuffer.get(), readAvail, CRC_SIZE, pct, &altPct);
             if (altPct != -1) {
                 pct++;
                 if (!crcOk) {
@@ -824,6 +858,11 @@ void DgramTwoWayStream::write(const Bytes& b)
         return;
     }
 
+    if (batchMessages > 0) {
+        writeBatched(b);
+        return;
+    }
+
     Bytes local = b;
     while (local.length() > 0) {
         yCTrace(DGRAMTWOWAYSTREAM, "DGRAM prep writing");
@@ -850,11 +889,16 @@ void DgramTwoWayStream::flush()
         return;
     }
 
+    // In the batched format datagrams are sent at the end of the messages
+    if (batchMessages > 0) {
+        return;
+    }
+
     // should set CRC
     if (writeAvail <= CRC_SIZE) {
         return;
     }
-    addCrc(writeBuffer.get(), writeAvail, CRC_SIZE, pct);
+    addCrc(checksum, writeBuffer.get(), writeAvail, CRC_SIZE, pct);
     pct++;
 
     if (writeAvail > 0) {
@@ -868,11 +912,7 @@ void DgramTwoWayStream::flush()
         } else
 #endif
             if (dgram != nullptr) {
-#if defined(YARP_HAS_ACE)
-            len = dgram->send(writeBuffer.get(), writeAvail, remoteHandle);
-#else
-            len = send(dgram_sockfd, writeBuffer.get(), writeAvail, 0);
-#endif
+            len = sendDatagram(writeBuffer.get(), writeAvail);
             yCDebug(DGRAMTWOWAYSTREAM, "DGRAM - wrote %zd bytes to %s", len, remoteAddress.toString().c_str());
         } else {
             Bytes b(writeBuffer.get(), writeAvail);
@@ -935,6 +975,17 @@ void DgramTwoWayStream::reset()
     readAvail = 0;
     writeAvail = CRC_SIZE;
     pct = 0;
+    if (batchMessages > 0) {
+        // Drop what is pending, and wait for the beginning of a message
+        std::lock_guard<std::mutex> lock(batchMutex);
+        writeAvail = BATCH_HEADER_SIZE;
+        inMessage = false;
+        messageStart = -1;
+        pendingMessages = 0;
+        batchCount = 0;
+        batchNext = 0;
+        needResync = true;
+    }
 }
 
 
@@ -942,6 +993,19 @@ void DgramTwoWayStream::beginPacket()
 {
 //     yCError(DGRAMTWOWAYSTREAM, "Packet begins: %s", (reader ? "reader" : "writer"));
     pct = 0;
+    if (batchMessages > 0) {
+        if (reader) {
+            aborted = false;
+            consumed = 0;
+        } else {
+            std::lock_guard<std::mutex> lock(batchMutex);
+            inMessage = true;
+            if (messageStart < 0) {
+                // A reader that lost some datagrams can start again from here
+                messageStart = writeAvail - BATCH_HEADER_SIZE;
+            }
+        }
+    }
 }
 
 void DgramTwoWayStream::endPacket()
@@ -949,6 +1013,26 @@ void DgramTwoWayStream::endPacket()
 //     yCError(DGRAMTWOWAYSTREAM, "Packet ends: %s", (reader ? "reader" : "writer"));
     if (!reader) {
         pct = 0;
+        if (batchMessages > 0) {
+            std::lock_guard<std::mutex> lock(batchMutex);
+            inMessage = false;
+            pendingMessages++;
+            auto now = std::chrono::steady_clock::now();
+            if (pendingMessages == 1) {
+                batchDeadline = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(batchDelay));
+            }
+            // Messages longer than a datagram are not delayed
+            if (pendingMessages >= batchMessages || batchCount > 0 || now >= batchDeadline) {
+                sealDatagram();
+                sendBatch();
+            } else if (dgram != nullptr) {
+                if (!flusher.joinable()) {
+                    flusherStopping = false;
+                    flusher = std::thread(&DgramTwoWayStream::flushOldBatches, this);
+                }
+                batchWaiting.notify_one();
+            }
+        }
     }
 }
 
@@ -991,3 +1075,361 @@ int DgramTwoWayStream::getTypeOfService()
 #endif
     return tos;
 }
+
+
+yarp::conf::ssize_t DgramTwoWayStream::sendDatagram(const char* data, size_t length)
+{
+#if defined(YARP_HAS_ACE)
+    if (mgram != nullptr) {
+        return mgram->send(data, length);
+    }
+    return dgram->send(data, length, remoteHandle);
+#else
+    return send(dgram_sockfd, data, length, 0);
+#endif
+}
+
+
+yarp::conf::ssize_t DgramTwoWayStream::receiveDatagram(char* data, size_t length)
+{
+#if defined(YARP_HAS_ACE)
+    ACE_INET_Addr dummy((u_short)0, (ACE_UINT32)INADDR_ANY);
+    yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
+    return dgram->recv(data, length, dummy);
+#else
+    return recv(dgram_sockfd, data, length, 0);
+#endif
+}
+
+
+void DgramTwoWayStream::setBatchMode(int messages, double delay)
+{
+    batchMessages = (messages > 0) ? messages : 1;
+    batchDelay = (delay > 0) ? delay : 0;
+    pendingMessages = 0;
+    messageStart = -1;
+    writeAvail = BATCH_HEADER_SIZE;
+    yCDebug(DGRAMTWOWAYSTREAM, "Batched datagrams, up to %d messages per batch, waiting up to %g s", batchMessages, batchDelay);
+}
+
+
+void DgramTwoWayStream::flushOldBatches()
+{
+    std::unique_lock<std::mutex> lock(batchMutex);
+    while (!flusherStopping) {
+        if (pendingMessages == 0 || inMessage) {
+            // endPacket() sends a late batch when the message is complete
+            batchWaiting.wait(lock);
+        } else if (std::chrono::steady_clock::now() < batchDeadline) {
+            batchWaiting.wait_until(lock, batchDeadline);
+        } else {
+            sealDatagram();
+            sendBatch();
+        }
+    }
+}
+
+
+void DgramTwoWayStream::stopFlusher()
+{
+    if (flusher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(batchMutex);
+            flusherStopping = true;
+        }
+        batchWaiting.notify_all();
+        flusher.join();
+    }
+}
+
+
+void DgramTwoWayStream::allocateBatch(size_t length)
+{
+    if (!batchBuffers.empty()) {
+        return;
+    }
+    batchBuffers.resize(BATCH_SLOTS);
+    batchLengths.resize(BATCH_SLOTS, 0);
+    for (auto& buffer : batchBuffers) {
+        buffer.allocate(length);
+    }
+    batchCount = 0;
+    batchNext = 0;
+}
+
+
+yarp::conf::ssize_t DgramTwoWayStream::readBatched(Bytes& b)
+{
+    while (true) {
+        if (closed) {
+            happy = false;
+            return -1;
+        }
+        if (aborted) {
+            // Nothing more for this message, wait for the next one
+            return -1;
+        }
+        if (readAvail == 0) {
+            if (!nextBatchDatagram()) {
+                happy = false;
+                return -1;
+            }
+            continue;
+        }
+        size_t take = readAvail;
+        if (take > b.length()) {
+            take = b.length();
+        }
+        memcpy(b.get(), batchBuffers[batchCurrent].get() + readAt, take);
+        readAt += take;
+        readAvail -= take;
+        consumed += take;
+        return take;
+    }
+}
+
+
+bool DgramTwoWayStream::receiveBatch()
+{
+    allocateBatch(UDP_MAX_DATAGRAM_SIZE + CRC_SIZE);
+    batchCount = 0;
+    batchNext = 0;
+
+    if (dgram == nullptr) {
+        onMonitorInput();
+        if (monitor.length() == 0 || monitor.length() > batchBuffers[0].length()) {
+            return false;
+        }
+        memcpy(batchBuffers[0].get(), monitor.get(), monitor.length());
+        batchLengths[0] = monitor.length();
+        batchCount = 1;
+        return true;
+    }
+
+#if defined(__linux__)
+#    if defined(YARP_HAS_ACE)
+    int fd = dgram->get_handle();
+#    else
+    int fd = dgram_sockfd;
+#    endif
+    mmsghdr msgs[BATCH_SLOTS];
+    iovec iov[BATCH_SLOTS];
+    memset(msgs, 0, sizeof(msgs));
+    for (size_t i = 0; i < BATCH_SLOTS; i++) {
+        iov[i].iov_base = batchBuffers[i].get();
+        iov[i].iov_len = batchBuffers[i].length();
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    // Wait for one datagram, then take all those already available
+    int result = -1;
+    do {
+        result = recvmmsg(fd, msgs, BATCH_SLOTS, MSG_WAITFORONE, nullptr);
+    } while (result < 0 && errno == EINTR && !closed);
+    if (result < 0) {
+        yCDebug(DGRAMTWOWAYSTREAM, "DGRAM failed to receive datagrams: %s", strerror(errno));
+        return false;
+    }
+    for (int i = 0; i < result; i++) {
+        bool truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        batchLengths[i] = truncated ? 0 : msgs[i].msg_len;
+    }
+    batchCount = result;
+#else
+    yarp::conf::ssize_t result = receiveDatagram(batchBuffers[0].get(), batchBuffers[0].length());
+    if (result < 0) {
+        return false;
+    }
+    batchLengths[0] = result;
+    batchCount = 1;
+#endif
+    yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Got %zu datagrams", batchCount);
+    return true;
+}
+
+
+bool DgramTwoWayStream::nextBatchDatagram()
+{
+    while (!closed) {
+        if (batchNext >= batchCount) {
+            if (!receiveBatch()) {
+                return false;
+            }
+            continue;
+        }
+        size_t index = batchNext++;
+        char* data = batchBuffers[index].get();
+        yarp::conf::ssize_t length = batchLengths[index];
+        if (length < BATCH_HEADER_SIZE) {
+            continue;
+        }
+        Bytes crcBytes(data, 4);
+        Bytes seqBytes(data + 4, 4);
+        Bytes startBytes(data + 8, 4);
+        int seqIn = NetType::netInt(seqBytes);
+        if (seqIn == -1) {
+            // Sent by interrupt() to wake us up
+            continue;
+        }
+        if (checksum != Checksum::None && computeCrc(checksum, data + 4, length - 4) != NetType::netInt(crcBytes)) {
+            yCDebug(DGRAMTWOWAYSTREAM, "crc mismatch");
+            noteDropped(1);
+            needResync = true;
+            continue;
+        }
+        if (seqKnown && seqIn != seq) {
+            noteDropped(static_cast<size_t>((seqIn - seq) & BATCH_SEQ_MASK));
+            needResync = true;
+        }
+        seq = (seqIn + 1) & BATCH_SEQ_MASK;
+        seqKnown = true;
+
+        batchCurrent = index;
+        readAt = BATCH_HEADER_SIZE;
+        readAvail = length - BATCH_HEADER_SIZE;
+        if (needResync) {
+            int start = NetType::netInt(startBytes);
+            if (start < 0 || start > readAvail) {
+                // Only the middle of a message we can't use
+                readAvail = 0;
+                continue;
+            }
+            readAt += start;
+            readAvail -= start;
+            needResync = false;
+            if (consumed > 0) {
+                // Part of the current message was lost
+                aborted = true;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+
+void DgramTwoWayStream::noteDropped(size_t count)
+{
+    dropped += count;
+    errCount += static_cast<int>(count);
+    double now = SystemClock::nowSystem();
+    if (now - lastReportTime > 1) {
+        yCWarning(DGRAMTWOWAYSTREAM, "*** %d datagram(s) from %s lost (%zu since the connection started) ***",
+                  errCount,
+                  remoteAddress.toURI().c_str(),
+                  dropped);
+        lastReportTime = now;
+        errCount = 0;
+    }
+}
+
+
+void DgramTwoWayStream::writeBatched(const Bytes& b)
+{
+    std::lock_guard<std::mutex> lock(batchMutex);
+    allocateBatch(writeBuffer.length());
+
+    Bytes local = b;
+    while (local.length() > 0) {
+        ManagedBytes& datagram = batchBuffers[batchCount];
+        yarp::conf::ssize_t rem = local.length();
+        yarp::conf::ssize_t space = datagram.length() - writeAvail;
+        if (rem > space) {
+            rem = space;
+        }
+        memcpy(datagram.get() + writeAvail, local.get(), rem);
+        writeAvail += rem;
+        local = Bytes(local.get() + rem, local.length() - rem);
+        if (writeAvail == static_cast<yarp::conf::ssize_t>(datagram.length())) {
+            sealDatagram();
+        }
+    }
+}
+
+
+void DgramTwoWayStream::sealDatagram()
+{
+    if (writeAvail <= BATCH_HEADER_SIZE) {
+        return;
+    }
+    char* data = batchBuffers[batchCount].get();
+    Bytes seqBytes(data + 4, 4);
+    Bytes startBytes(data + 8, 4);
+    NetType::netInt((NetInt32)seq, seqBytes);
+    NetType::netInt((NetInt32)messageStart, startBytes);
+    Bytes crcBytes(data, 4);
+    NetType::netInt(computeCrc(checksum, data + 4, writeAvail - 4), crcBytes);
+    batchLengths[batchCount] = writeAvail;
+    batchCount++;
+
+    seq = (seq + 1) & BATCH_SEQ_MASK;
+    messageStart = -1;
+    writeAvail = BATCH_HEADER_SIZE;
+    if (batchCount == BATCH_SLOTS) {
+        sendBatch();
+    }
+}
+
+
+void DgramTwoWayStream::sendBatch()
+{
+    pendingMessages = 0;
+    if (batchCount == 0) {
+        return;
+    }
+    if (dgram == nullptr) {
+        for (size_t i = 0; i < batchCount; i++) {
+            monitor = ManagedBytes(Bytes(batchBuffers[i].get(), batchLengths[i]), false);
+            monitor.copy();
+            onMonitorOutput();
+        }
+        batchCount = 0;
+        return;
+    }
+
+    size_t sent = 0;
+#if defined(__linux__)
+#    if defined(YARP_HAS_ACE)
+    int fd = dgram->get_handle();
+#    else
+    int fd = dgram_sockfd;
+#    endif
+    mmsghdr msgs[BATCH_SLOTS];
+    iovec iov[BATCH_SLOTS];
+    memset(msgs, 0, sizeof(msgs));
+    for (size_t i = 0; i < batchCount; i++) {
+        iov[i].iov_base = batchBuffers[i].get();
+        iov[i].iov_len = batchLengths[i];
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+#    if defined(YARP_HAS_ACE)
+        // The ACE sockets are not connected
+        msgs[i].msg_hdr.msg_name = remoteHandle.get_addr();
+        msgs[i].msg_hdr.msg_namelen = remoteHandle.get_size();
+#    endif
+    }
+    while (sent < batchCount) {
+        int result = sendmmsg(fd, msgs + sent, batchCount - sent, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        sent += result;
+    }
+#else
+    for (; sent < batchCount; sent++) {
+        if (sendDatagram(batchBuffers[sent].get(), batchLengths[sent]) < 0) {
+            break;
+        }
+    }
+#endif
+    if (sent < batchCount) {
+        happy = false;
+        yCDebug(DGRAMTWOWAYSTREAM, "DGRAM failed to send datagrams with error: %s", strerror(errno));
+    } else {
+        yCDebug(DGRAMTWOWAYSTREAM, "DGRAM - wrote %zu datagrams to %s", sent, remoteAddress.toString().c_str());
+    }
+    batchCount = 0;
+}
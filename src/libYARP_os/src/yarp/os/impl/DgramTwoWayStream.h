@@ -13,8 +13,13 @@
 #include <yarp/os/ManagedBytes.h>
 #include <yarp/os/TwoWayStream.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdlib>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef YARP_HAS_ACE
 #    include <ace/SOCK_Dgram.h>
@@ -40,6 +45,16 @@ class YARP_os_impl_API DgramTwoWayStream :
 {
 
 public:
+    /**
+     * The checksum added to each datagram.
+     */
+    enum class Checksum
+    {
+        Crc32,  ///< NetType::getCrc (the default)
+        Crc32c, ///< NetType::getCrc32c, faster on most cpus
+        None    ///< rely on the checksum of the UDP protocol
+    };
+
     DgramTwoWayStream() :
             closed(false),
             interrupting(false),
@@ -59,7 +74,23 @@ public:
             bufferAlerted(false),
             multiMode(false),
             errCount(0),
-            lastReportTime(0)
+            lastReportTime(0),
+            checksum(Checksum::Crc32),
+            batchMessages(0),
+            batchDelay(0),
+            pendingMessages(0),
+            messageStart(-1),
+            seq(0),
+            seqKnown(false),
+            needResync(true),
+            aborted(false),
+            consumed(0),
+            dropped(0),
+            batchCount(0),
+            batchNext(0),
+            batchCurrent(0),
+            inMessage(false),
+            flusherStopping(false)
     {
     }
 
@@ -151,6 +182,52 @@ public:
 
     void removeMonitor();
 
+    /**
+     * Choose the checksum of the datagrams.  Both ends of the connection
+     * must use the same one.
+     */
+    void setChecksum(Checksum checksum)
+    {
+        this->checksum = checksum;
+    }
+
+    Checksum getChecksum() const
+    {
+        return checksum;
+    }
+
+    /**
+     * Use the batched datagram format.  Several small messages can share
+     * a single datagram, datagrams are sent and received in groups (with
+     * sendmmsg/recvmmsg where available), and each datagram carries a
+     * sequence number, so that lost datagrams are counted and the reader
+     * skips to the next message instead of resetting.  Both ends of the
+     * connection must use this format.
+     *
+     * @param messages the writer sends what it has collected after this
+     * many messages, or as soon as a datagram is full.
+     * @param delay the longest time (in seconds) a message waits for the
+     * others of its batch.  When the stream is closed, the messages waiting
+     * are sent.
+     */
+    void setBatchMode(int messages, double delay = defaultBatchDelay);
+
+    static constexpr double defaultBatchDelay = 0.005;
+
+    bool isBatchMode() const
+    {
+        return batchMessages > 0;
+    }
+
+    /**
+     * @return the number of datagrams lost or corrupted since the stream
+     * was opened (batched format only).
+     */
+    size_t getDroppedCount() const
+    {
+        return dropped;
+    }
+
     virtual void onMonitorInput()
     {
     }
@@ -183,10 +260,60 @@ private:
     bool multiMode;
     int errCount;
     double lastReportTime;
+    Checksum checksum;
+
+    // Batched format (see setBatchMode)
+    int batchMessages;
+    double batchDelay;
+    int pendingMessages;
+    yarp::conf::ssize_t messageStart;
+    int seq;
+    bool seqKnown;
+    bool needResync;
+    bool aborted;
+    yarp::conf::ssize_t consumed;
+    size_t dropped;
+    std::vector<yarp::os::ManagedBytes> batchBuffers;
+    std::vector<yarp::conf::ssize_t> batchLengths;
+    size_t batchCount;
+    size_t batchNext;
+    size_t batchCurrent;
+
+    // The writer sends the batches that wait for too long from a thread
+    std::mutex batchMutex;
+    std::condition_variable batchWaiting;
+    std::thread flusher;
+    std::chrono::steady_clock::time_point batchDeadline;
+    bool inMessage;
+    bool flusherStopping;
 
     void allocate(int readSize = 0, int writeSize = 0);
 
     void configureSystemBuffers();
+
+    yarp::conf::ssize_t sendDatagram(const char* data, size_t length);
+
+    yarp::conf::ssize_t receiveDatagram(char* data, size_t length);
+
+    void allocateBatch(size_t length);
+
+    yarp::conf::ssize_t readBatched(yarp::os::Bytes& b);
+
+    bool receiveBatch();
+
+    bool nextBatchDatagram();
+
+    void noteDropped(size_t count);
+
+    void writeBatched(const yarp::os::Bytes& b);
+
+    void sealDatagram();
+
+    void sendBatch();
+
+    void flushOldBatches();
+
+    void stopFlusher();
 };
 
 } // namespace impl
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/LatencyHistogram.h>
+
+#include <yarp/os/Value.h>
+
+using yarp::os::impl::LatencyHistogram;
+
+namespace {
+int bucketOf(std::uint64_t us)
+{
+    int bucket = 0;
+    while (us != 0 && bucket < LatencyHistogram::bucketCount - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+{
+    clear();
+}
+
+void LatencyHistogram::add(double seconds)
+{
+    if (seconds < 0) {
+        return;
+    }
+    auto us = static_cast<std::uint64_t>(seconds * 1e6);
+    buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(us, std::memory_order_relaxed);
+    std::uint64_t prev = max.load(std::memory_order_relaxed);
+    while (prev < us && !max.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {
+        // prev was reloaded, try again
+    }
+}
+
+void LatencyHistogram::clear()
+{
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getCount() const
+{
+    return count.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::getMean() const
+{
+    std::uint64_t n = getCount();
+    if (n == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(total.load(std::memory_order_relaxed)) / n;
+}
+
+std::uint64_t LatencyHistogram::getMax() const
+{
+    return max.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getPercentile(double fraction) const
+{
+    // The buckets may change while they are summed, use their own total
+    std::uint64_t counts[bucketCount];
+    std::uint64_t n = 0;
+    for (int i = 0; i < bucketCount; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        n += counts[i];
+    }
+    if (n == 0) {
+        return 0;
+    }
+    auto target = static_cast<std::uint64_t>(fraction * n);
+    if (target >= n) {
+        target = n - 1;
+    }
+    std::uint64_t seen = 0;
+    for (int i = 0; i < bucketCount - 1; i++) {
+        seen += counts[i];
+        if (seen > target) {
+            // never report more than the longest duration seen
+            std::uint64_t bound = (std::uint64_t(1) << i);
+            std::uint64_t longest = getMax();
+            return (bound < longest) ? bound : longest;
+        }
+    }
+    return getMax();
+}
+
+void LatencyHistogram::report(yarp::os::Property& stats) const
+{
+    stats.put("count", yarp::os::Value::makeInt64(static_cast<std::int64_t>(getCount())));
+    stats.put("mean_us", getMean());
+    stats.put("p50_us", yarp::os::Value::makeInt64(static_cast<std::int64_t>(getPercentile(0.5))));
+    stats.put("p90_us", yarp::os::Value::makeInt64(static_cast<std::int64_t>(getPercentile(0.9))));
+    stats.put("p99_us", yarp::os::Value::makeInt64(static_cast<std::int64_t>(getPercentile(0.99))));
+    stats.put("max_us", yarp::os::Value::makeInt64(static_cast<std::int64_t>(getMax())));
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_LATENCYHISTOGRAM_H
+#define YARP_OS_IMPL_LATENCYHISTOGRAM_H
+
+#include <yarp/os/Property.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * A histogram of durations, cheap enough to be updated for every message
+ * sent or received by a port.
+ *
+ * Durations are counted in buckets of microseconds with power of two
+ * bounds, so percentiles are approximated by the upper bound of the
+ * bucket they fall in.  All the counters are relaxed atomics: any thread
+ * may add a value or read the histogram without locks.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * Number of buckets.  Bucket 0 counts durations below 1us, bucket i
+     * counts durations in [2^(i-1), 2^i) us, the last one counts all the
+     * longer durations (more than about 8 seconds).
+     */
+    static constexpr int bucketCount = 25;
+
+    LatencyHistogram();
+
+    /**
+     * Count a duration.
+     *
+     * @param seconds the duration, negative durations are ignored
+     */
+    void add(double seconds);
+
+    /**
+     * Forget all the durations counted.
+     */
+    void clear();
+
+    /**
+     * @return the number of durations counted
+     */
+    std::uint64_t getCount() const;
+
+    /**
+     * @return the mean of the durations counted [us]
+     */
+    double getMean() const;
+
+    /**
+     * @return the longest duration counted [us]
+     */
+    std::uint64_t getMax() const;
+
+    /**
+     * @param fraction the fraction of durations, between 0 and 1
+     * @return the upper bound of the bucket that contains the given
+     * percentile [us], or 0 if no duration was counted
+     */
+    std::uint64_t getPercentile(double fraction) const;
+
+    /**
+     * Describe the histogram with the "count", "mean_us", "p50_us",
+     * "p90_us", "p99_us" and "max_us" keys.
+     */
+    void report(yarp::os::Property& stats) const;
+
+private:
+    std::atomic<std::uint64_t> buckets[bucketCount];
+    std::atomic<std::uint64_t> count;
+    std::atomic<std::uint64_t> total; // [us]
+    std::atomic<std::uint64_t> max;   // [us]
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_LATENCYHISTOGRAM_H
@@ -99,6 +99,7 @@ bool yarp::os::impl::McastCarrier::sendHeader(ConnectionState& proto)
 
     Contact alt = proto.getStreams().getLocalAddress();
     std::string altKey = proto.getRoute().getFromName() + "/net=" + alt.getHost();
+    altKey += getFormatKey();
     McastCarrier* elect = getCaster().getElect(altKey);
     if (elect != nullptr) {
         yCDebug(MCASTCARRIER, "picking up peer mcast name");
@@ -204,6 +205,7 @@ bool yarp::os::impl::McastCarrier::becomeMcast(ConnectionState& proto, bool send
         key = proto.getRoute().getFromName();
         key += "/net=";
         key += local.getHost();
+        key += getFormatKey();
 
         yCDebug(MCASTCARRIER, "multicast key: %s", key.c_str());
         addSender(key);
@@ -218,12 +220,14 @@ bool yarp::os::impl::McastCarrier::becomeMcast(ConnectionState& proto, bool send
         delete stream;
         return false;
     }
+    configureStream(stream);
     proto.takeStreams(stream);
     return true;
 }
 
 bool yarp::os::impl::McastCarrier::respondToHeader(ConnectionState& proto)
 {
+    configureFromSpecifier(proto.getSenderSpecifier());
     return becomeMcast(proto, false);
 }
 
@@ -233,6 +237,21 @@ bool yarp::os::impl::McastCarrier::expectReplyToHeader(ConnectionState& proto)
     return becomeMcast(proto, true);
 }
 
+std::string yarp::os::impl::McastCarrier::getFormatKey() const
+{
+    // Senders using different datagram formats can't share a group
+    std::string format;
+    if (batch > 0) {
+        format += "/batch";
+    }
+    if (checksum == DgramTwoWayStream::Checksum::Crc32c) {
+        format += "/crc32c";
+    } else if (checksum == DgramTwoWayStream::Checksum::None) {
+        format += "/nocrc";
+    }
+    return format;
+}
+
 void yarp::os::impl::McastCarrier::addSender(const std::string& key)
 {
     getCaster().add(key, this);
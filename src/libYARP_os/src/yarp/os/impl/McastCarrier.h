@@ -39,6 +39,8 @@ protected:
 
     static ElectionOf<PeerRecord<McastCarrier>>& getCaster();
 
+    std::string getFormatKey() const;
+
 public:
     McastCarrier();
 
@@ -17,6 +17,7 @@
 #include <yarp/os/NetType.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/Os.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/impl/FallbackNameClient.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/NameConfig.h>
@@ -24,7 +25,11 @@
 #include <yarp/os/impl/TcpFace.h>
 
 #include <cstdio>
+#include <cstdlib>
 #include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace yarp::os::impl;
 using namespace yarp::os;
@@ -102,6 +107,106 @@ public:
         argc = at;
     }
 };
+
+/*
+  Addresses returned by the name servers, shared by all the name clients
+*/
+class NameCache
+{
+private:
+    struct Entry
+    {
+        Contact contact;
+        double expiry;
+    };
+
+    std::mutex mutex;
+    double ttl;
+    double negativeTtl;
+    // port name -> name server -> address
+    std::unordered_map<std::string, std::unordered_map<std::string, Entry>> entries;
+    // name servers whose registrations have been listed
+    std::unordered_set<std::string> listed;
+
+    NameCache()
+    {
+        ttl = std::atof(yarp::conf::environment::getEnvironment("YARP_NAME_CACHE_TTL").c_str());
+        negativeTtl = std::atof(yarp::conf::environment::getEnvironment("YARP_NAME_CACHE_NEGATIVE_TTL").c_str());
+    }
+
+public:
+    static NameCache& getInstance()
+    {
+        static NameCache instance;
+        return instance;
+    }
+
+    void setTimeouts(double ttl, double negativeTtl)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->ttl = ttl;
+        this->negativeTtl = negativeTtl;
+        if (ttl <= 0) {
+            entries.clear();
+            listed.clear();
+        }
+    }
+
+    bool isEnabled()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ttl > 0;
+    }
+
+    bool find(const std::string& server, const std::string& name, Contact& contact)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(name);
+        if (it == entries.end()) {
+            return false;
+        }
+        auto it2 = it->second.find(server);
+        if (it2 == it->second.end()) {
+            return false;
+        }
+        if (it2->second.expiry < SystemClock::nowSystem()) {
+            it->second.erase(it2);
+            return false;
+        }
+        contact = it2->second.contact;
+        return true;
+    }
+
+    void add(const std::string& server, const std::string& name, const Contact& contact)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        double t = contact.isValid() ? ttl : negativeTtl;
+        if (ttl <= 0 || t <= 0) {
+            return;
+        }
+        entries[name][server] = Entry{contact, SystemClock::nowSystem() + t};
+    }
+
+    // true the first time it is called for a name server
+    bool needsListing(const std::string& server)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ttl > 0 && listed.insert(server).second;
+    }
+
+    bool forget(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.erase(name) > 0;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        listed.clear();
+    }
+};
 } // namespace
 
 
@@ -158,9 +263,37 @@ Contact NameClient::queryName(const std::string& name)
         return c;
     }
 
+    NameCache& cache = NameCache::getInstance();
+    if (!cache.isEnabled()) {
+        std::string q("NAME_SERVER query ");
+        q += name;
+        return probe(q);
+    }
+
+    std::string server = getAddress().toURI();
+    Contact c;
+    if (cache.find(server, name, c)) {
+        return c;
+    }
+    if (cache.needsListing(server)) {
+        // One round trip for all the ports that will be looked up next
+        std::istringstream lines(send("NAME_SERVER list"));
+        std::string line;
+        while (std::getline(lines, line)) {
+            Contact registration = extractAddress(line);
+            if (registration.isValid()) {
+                cache.add(server, registration.getRegName(), registration);
+            }
+        }
+        if (cache.find(server, name, c)) {
+            return c;
+        }
+    }
     std::string q("NAME_SERVER query ");
     q += name;
-    return probe(q);
+    c = probe(q);
+    cache.add(server, name, c);
+    return c;
 }
 
 Contact NameClient::registerName(const std::string& name)
@@ -221,8 +354,10 @@ Contact NameClient::registerName(const std::string& name, const Contact& suggest
     yCDebug(NAMECLIENT, "Received reply: %s", reply.toString().c_str());
 
     Contact address = extractAddress(reply);
+    NameCache::getInstance().forget(name);
     if (address.isValid()) {
         std::string reg = address.getRegName();
+        NameCache::getInstance().forget(reg);
 
 
         std::string cmdOffers = "set /port offers ";
@@ -259,6 +394,7 @@ Contact NameClient::registerName(const std::string& name, const Contact& suggest
 
 Contact NameClient::unregisterName(const std::string& name)
 {
+    NameCache::getInstance().forget(name);
     std::string q("NAME_SERVER unregister ");
     q += name;
     return probe(q);
@@ -496,6 +632,21 @@ yarp::os::Nodes& NameClient::getNodes()
     return nodes;
 }
 
+void NameClient::setCacheTimeouts(double ttl, double negativeTtl)
+{
+    NameCache::getInstance().setTimeouts(ttl, negativeTtl);
+}
+
+bool NameClient::forgetName(const std::string& name)
+{
+    return NameCache::getInstance().forget(name);
+}
+
+void NameClient::clearCache()
+{
+    NameCache::getInstance().clear();
+}
+
 NameServer& NameClient::getServer()
 {
     if (fakeServer == nullptr) {
@@ -30,6 +30,13 @@ class NameServer;
  * client is rather old; there are simpler ways of talking to the
  * name server these days - it is now a regular port, that can read
  * and respond to messages in the bottle format.
+ *
+ * The addresses returned by the name server can be cached for a while
+ * (see setCacheTimeouts()), so that looking up the same ports again (e.g.
+ * when a process connects many ports) needs no round trip to the name
+ * server.  The first lookup that misses the cache fills it with all the
+ * registrations, with a single "list" command.  The cache is shared by
+ * all the clients in the process.
  */
 class YARP_os_impl_API NameClient
 {
@@ -197,6 +204,32 @@ public:
 
     yarp::os::Nodes& getNodes();
 
+    /**
+     * Set for how long the results of queryName() are cached.  The
+     * defaults are read from the YARP_NAME_CACHE_TTL and
+     * YARP_NAME_CACHE_NEGATIVE_TTL environment variables, and are 0 if
+     * they are not set.
+     *
+     * @param ttl how long the address of a port is kept [s], 0 disables
+     * the cache
+     * @param negativeTtl how long the lack of a port is remembered [s]
+     */
+    static void setCacheTimeouts(double ttl, double negativeTtl);
+
+    /**
+     * Forget the cached address of a port, e.g. because connecting to it
+     * failed.
+     *
+     * @param name the name of the port
+     * @return true if an address was cached for the port
+     */
+    static bool forgetName(const std::string& name);
+
+    /**
+     * Forget all the cached addresses.
+     */
+    static void clearCache();
+
 private:
     Contact address;
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::string) host;
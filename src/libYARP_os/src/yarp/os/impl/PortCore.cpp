@@ -59,7 +59,14 @@ namespace {
 YARP_OS_LOG_COMPONENT(PORTCORE, "yarp.os.impl.PortCore")
 } // namespace
 
-PortCore::PortCore() = default;
+PortCore::PortCore()
+{
+    std::string capacity = yarp::conf::environment::getEnvironment("YARP_PORT_PACKET_CAPACITY");
+    if (!capacity.empty()) {
+        int count = NetType::toInt(capacity);
+        m_packets.setCapacity((count > 0) ? static_cast<size_t>(count) : 0);
+    }
+}
 
 PortCore::~PortCore()
 {
@@ -346,6 +353,12 @@ void PortCore::interrupt()
     // Ignore any future incoming data
     m_interrupted = true;
 
+    // Release the writers waiting for room in a queue
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+    }
+    m_queueRoom.notify_all();
+
     // What about data that is already coming in?
     // If interruptable is not currently set, no worries, the user
     // did not or will not end up blocked on a read.
@@ -388,6 +401,10 @@ void PortCore::closeMain()
     m_finishing = true;
     yCDebug(PORTCORE, "now preparing to shut down port");
     m_stateSemaphore.post();
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+    }
+    m_queueRoom.notify_all();
 
     // Start disconnecting inputs.  We ask the other side of the
     // connection to do this, so it won't come as a surprise.
@@ -1324,6 +1341,17 @@ bool PortCore::sendHelper(const PortWriter& writer,
     // set by setWaitAfterSend() and setWaitBeforeSend().
     m_stateSemaphore.wait();
 
+    // A writer waits for room in the queues of the connections without
+    // holding the port, so that it can still be used meanwhile.
+    while (hasFullQueue() && !m_finished) {
+        m_stateSemaphore.post();
+        bool room = waitQueueRoom();
+        m_stateSemaphore.wait();
+        if (!room) {
+            break;
+        }
+    }
+
     // If the port is shutting down, abort.
     if (m_finished) {
         m_stateSemaphore.post();
@@ -1332,12 +1360,17 @@ bool PortCore::sendHelper(const PortWriter& writer,
 
     yCTrace(PORTCORE, "------- send in");
     // Prepare a "packet" for tracking a single message which
-    // may travel by multiple outputs.
-    m_packetMutex.lock();
+    // may travel by multiple outputs.  Packets are only taken here, with
+    // the state semaphore held.
     PortCorePacket* packet = m_packets.getFreePacket();
-    yCAssert(PORTCORE, packet != nullptr);
+    if (packet == nullptr) {
+        // Too many messages are still being sent.
+        yCDebug(PORTCORE, "skipping message, all the packets of port %s are in use", getName().c_str());
+        m_stateSemaphore.post();
+        ((callback != nullptr) ? callback : (&writer))->onCompletion();
+        return false;
+    }
     packet->setContent(&writer, false, callback);
-    m_packetMutex.unlock();
 
     // Scan connections, placing message everywhere we can.
     for (auto* unit : m_units) {
@@ -1353,9 +1386,7 @@ bool PortCore::sendHelper(const PortWriter& writer,
             }
             bool waiter = m_waitAfterSend || (mode == PORTCORE_SEND_LOG);
             yCTrace(PORTCORE, "------- -- inc");
-            m_packetMutex.lock();
             packet->inc(); // One more connection carrying message.
-            m_packetMutex.unlock();
             yCTrace(PORTCORE, "------- -- pre-send");
             bool gotReplyOne = false;
             // Send the message off on this connection.
@@ -1371,10 +1402,8 @@ bool PortCore::sendHelper(const PortWriter& writer,
             yCTrace(PORTCORE, "------- -- send");
             if (out != nullptr) {
                 // We got back a report of a message already sent.
-                m_packetMutex.lock();
-                (static_cast<PortCorePacket*>(out))->dec(); // Message on one fewer connections.
-                m_packets.checkPacket(static_cast<PortCorePacket*>(out));
-                m_packetMutex.unlock();
+                // Message on one fewer connections.
+                m_packets.releasePacket(static_cast<PortCorePacket*>(out));
             }
             if (waiter) {
                 if (unit->isFinished()) {
@@ -1385,15 +1414,11 @@ bool PortCore::sendHelper(const PortWriter& writer,
         }
     }
     yCTrace(PORTCORE, "------- pack check");
-    m_packetMutex.lock();
 
     // We no longer concern ourselves with the message.
     // It may or may not be traveling on some connections.
     // But that is not our problem anymore.
-    packet->dec();
-
-    m_packets.checkPacket(packet);
-    m_packetMutex.unlock();
+    m_packets.releasePacket(packet);
     yCTrace(PORTCORE, "------- packed");
     yCTrace(PORTCORE, "------- send out");
     if (mode == PORTCORE_SEND_LOG) {
@@ -1404,6 +1429,9 @@ bool PortCore::sendHelper(const PortWriter& writer,
     m_stateSemaphore.post();
     yCTrace(PORTCORE, "------- send out real");
 
+    // The message took the last place of a full queue
+    waitQueueRoom();
+
     if (m_waitAfterSend && reader != nullptr) {
         all_ok = all_ok && gotReply;
     }
@@ -1456,16 +1484,40 @@ int PortCore::getOutputCount()
 void PortCore::notifyCompletion(void* tracker)
 {
     yCTrace(PORTCORE, "starting notifyCompletion");
-    m_packetMutex.lock();
     if (tracker != nullptr) {
-        (static_cast<PortCorePacket*>(tracker))->dec();
-        m_packets.checkPacket(static_cast<PortCorePacket*>(tracker));
+        m_packets.releasePacket(static_cast<PortCorePacket*>(tracker));
     }
-    m_packetMutex.unlock();
     yCTrace(PORTCORE, "stopping notifyCompletion");
 }
 
 
+void PortCore::setQueueFull(bool full)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_fullQueues += (full ? 1 : -1);
+    }
+    if (!full) {
+        m_queueRoom.notify_all();
+    }
+}
+
+
+bool PortCore::waitQueueRoom()
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_queueRoom.wait(lock, [this] { return m_fullQueues == 0 || m_interrupted || m_finishing; });
+    return m_fullQueues == 0;
+}
+
+
+bool PortCore::hasFullQueue()
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_fullQueues > 0;
+}
+
+
 bool PortCore::setEnvelope(PortWriter& envelope)
 {
     m_envelopeWriter.restart();
@@ -1566,6 +1618,7 @@ enum class PortCoreCommand : yarp::conf::vocab32_t
     RosRequestTopic = yarp::os::createVocab('r', 't', 'o', 'p'),
     RosGetPid = yarp::os::createVocab('p', 'i', 'd'),
     RosGetBusInfo = yarp::os::createVocab('b', 'u', 's'),
+    Stat = yarp::os::createVocab('s', 't', 'a', 't'),
 };
 
 enum class PortCoreConnectionDirection : yarp::conf::vocab32_t
@@ -1619,6 +1672,7 @@ PortCoreCommand parseCommand(const yarp::os::Value& v)
     case PortCoreCommand::RosRequestTopic:
     case PortCoreCommand::RosGetPid:
     case PortCoreCommand::RosGetBusInfo:
+    case PortCoreCommand::Stat:
         return cmd;
     default:
         return PortCoreCommand::Unknown;
@@ -1717,6 +1771,8 @@ bool PortCore::adminBlock(ConnectionReader& reader,
         result.addString("[atch] [in]  $prop      # attach a portmonitor plug-in to the port's input");
         result.addString("[dtch] [out]            # detach portmonitor plug-in from the port's output");
         result.addString("[dtch] [in]             # detach portmonitor plug-in from the port's input");
+        result.addString("[stat]                  # get message and latency statistics of the port");
+        result.addString("[stat] $portname        # get statistics of the connection to/from a port");
         //result.addString("[atch] $portname $prop  # attach a portmonitor plug-in to the connection to/from $portname");
         //result.addString("[dtch] $portname        # detach any portmonitor plug-in from the connection to/from $portname");
         return result;
@@ -1727,9 +1783,10 @@ bool PortCore::adminBlock(ConnectionReader& reader,
         // It is distinct from YARP library versioning.
         Bottle result;
         result.addVocab(Vocab::encode("ver"));
+        // 1.3: data connections take coalesced messages ('b' command)
         result.addInt32(1);
-        result.addInt32(2);
         result.addInt32(3);
+        result.addInt32(0);
         return result;
     };
 
@@ -2243,6 +2300,17 @@ bool PortCore::adminBlock(ConnectionReader& reader,
                         port_prop.put("is_output", is_output);
                         port_prop.put("is_rpc", is_rpc);
                         port_prop.put("type", getType().getName());
+
+                        Bottle& packets = result.addList();
+                        packets.addString("packets");
+                        Property& packets_prop = packets.addDict();
+                        packets_prop.put("in_use", static_cast<int>(m_packets.getCount()));
+                        packets_prop.put("allocated", static_cast<int>(m_packets.getAllocatedCount()));
+                        packets_prop.put("peak", static_cast<int>(m_packets.getPeakCount()));
+                        packets_prop.put("capacity", static_cast<int>(m_packets.getCapacity()));
+                        packets_prop.put("dropped", static_cast<int>(m_packets.getDroppedCount()));
+                        packets_prop.put("transform_hits", static_cast<int>(m_packets.getTransformHits()));
+                        packets_prop.put("transform_misses", static_cast<int>(m_packets.getTransformMisses()));
                     } else {
                         for (auto* unit : m_units) {
                             if ((unit != nullptr) && !unit->isFinished()) {
@@ -2264,6 +2332,12 @@ bool PortCore::adminBlock(ConnectionReader& reader,
                                     qos.addString("qos");
                                     Property& qos_prop = qos.addDict();
                                     qos_prop.put("tos", tos);
+                                    auto* outUnit = dynamic_cast<PortCoreOutputUnit*>(unit);
+                                    if (outUnit != nullptr) {
+                                        Bottle& buffer = result.addList();
+                                        buffer.addString("buffer");
+                                        outUnit->getBufferStats(buffer.addDict());
+                                    }
                                 }
                             } // end isFinished()
                         }     // end for loop
@@ -2434,6 +2508,69 @@ bool PortCore::adminBlock(ConnectionReader& reader,
         return result;
     };
 
+    auto handleAdminStatCmd = [this, id](const std::string& target) {
+        // Statistics of the traffic of the port, and of each connection
+        // (or of the connections to/from the given port), except the one
+        // asking for them.
+        Bottle result;
+        std::int64_t messagesIn = 0;
+        std::int64_t bytesIn = 0;
+        std::int64_t messagesOut = 0;
+        std::int64_t bytesOut = 0;
+        std::int64_t dropped = static_cast<std::int64_t>(m_packets.getDroppedCount());
+        Bottle connections;
+        bool found = false;
+        m_stateSemaphore.wait();
+        for (auto* unit : m_units) {
+            if (dynamic_cast<PortCoreInputUnit*>(unit) == id) {
+                continue;
+            }
+            if ((unit != nullptr) && !unit->isFinished() && (unit->isInput() || unit->isOutput())) {
+                Route route = unit->getRoute();
+                std::string name = (unit->isOutput()) ? route.getToName() : route.getFromName();
+                Property stats;
+                unit->getStats(stats);
+                if (unit->isOutput()) {
+                    messagesOut += stats.find("messages").asInt64();
+                    bytesOut += stats.find("bytes").asInt64();
+                    dropped += stats.find("dropped").asInt64();
+                } else {
+                    messagesIn += stats.find("messages").asInt64();
+                    bytesIn += stats.find("bytes").asInt64();
+                }
+                if (target.empty() || target == name) {
+                    found = true;
+                    Bottle& connection = connections.addList();
+                    connection.addString((unit->isOutput()) ? "out" : "in");
+                    connection.addString(name);
+                    connection.append(Bottle(stats.toString()));
+                }
+            }
+        }
+        m_stateSemaphore.post();
+
+        if (!target.empty() && !found) {
+            result.addVocab(Vocab::encode("fail"));
+            result.addString("cannot find any connection to/from " + target);
+            return result;
+        }
+        if (target.empty()) {
+            Bottle& totals = result.addList();
+            totals.addString("port");
+            Property& totals_prop = totals.addDict();
+            totals_prop.put("messages_in", Value::makeInt64(messagesIn));
+            totals_prop.put("bytes_in", Value::makeInt64(bytesIn));
+            totals_prop.put("messages_out", Value::makeInt64(messagesOut));
+            totals_prop.put("bytes_out", Value::makeInt64(bytesOut));
+            totals_prop.put("dropped", Value::makeInt64(dropped));
+            totals_prop.put("packets_in_use", static_cast<int>(m_packets.getCount()));
+            totals_prop.put("transform_hits", Value::makeInt64(static_cast<std::int64_t>(m_packets.getTransformHits())));
+            totals_prop.put("transform_misses", Value::makeInt64(static_cast<std::int64_t>(m_packets.getTransformMisses())));
+        }
+        result.append(connections);
+        return result;
+    };
+
     // NOTE: YARP partially supports the ROS Slave API https://wiki.ros.org/ROS/Slave_API
 
     auto handleAdminRosPublisherUpdateCmd = [this](const std::string& topic, Bottle* pubs) {
@@ -2679,6 +2816,10 @@ bool PortCore::adminBlock(ConnectionReader& reader,
             break;
         }
     } break;
+    case PortCoreCommand::Stat: {
+        const std::string target = cmd.get(1).asString();
+        result = handleAdminStatCmd(target);
+    } break;
     case PortCoreCommand::RosPublisherUpdate: {
         yCDebug(PORTCORE, "publisherUpdate! --> %s", cmd.toString().c_str());
         // std::string caller_id = cmd.get(1).asString(); // Currently unused
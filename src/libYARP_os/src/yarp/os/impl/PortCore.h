@@ -32,6 +32,7 @@
 #undef YARP_INCLUDING_DEPRECATED_HEADER_ON_PURPOSE
 #endif
 
+#include <condition_variable>
 #include <mutex>
 #include <vector>
 
@@ -373,6 +374,15 @@ public:
         return true;
     }
 
+    /**
+     * @return true if the messages are passed to the reader as soon as
+     * they arrive, without waiting for the user to ask for them.
+     */
+    virtual bool isReadBackground()
+    {
+        return false;
+    }
+
     /**
      * Begin main thread.
      */
@@ -404,6 +414,17 @@ public:
                     yarp::os::PortReader* reader = nullptr,
                     const yarp::os::PortWriter* callback = nullptr);
 
+    /**
+     * Wait until the queues of the output connections have room.
+     * @return false if there is a full queue and the port is being closed
+     */
+    bool waitQueueRoom();
+
+    /**
+     * @return true if an output connection has a full queue
+     */
+    bool hasFullQueue();
+
     /**
      * Shut down port.
      */
@@ -436,6 +457,13 @@ public:
      */
     void notifyCompletion(void* tracker);
 
+    /**
+     * Called by an output connection when its queue of messages gets
+     * more than its capacity, and again when it has room.  The writers of
+     * the port wait for room after releasing the port.
+     */
+    void setQueueFull(bool full);
+
     /**
      * Normally the port will unregister its name with the name server
      * when shutting down.  This can be inhibited.
@@ -514,7 +542,10 @@ private:
     // main internal PortCore state and operations
     std::vector<PortCoreUnit *> m_units;  ///< list of connections
     yarp::os::Semaphore m_stateSemaphore {1};       ///< control access to essential port state
-    std::mutex m_packetMutex;      ///< control access to message cache
+    std::mutex m_packetMutex;      ///< control access to the connection counts
+    std::mutex m_queueMutex;       ///< control access to the count of full queues
+    std::condition_variable m_queueRoom; ///< signal when a queue has room
+    int m_fullQueues {0};          ///< output connections whose queue is full
     yarp::os::Semaphore m_connectionChangeSemaphore {1}; ///< signal changes in connections
     Face* m_face {nullptr};  ///< network server
     std::string m_name; ///< name of port
@@ -173,6 +173,12 @@ bool yarp::os::impl::PortCoreAdapter::read(ConnectionReader& reader)
     return result;
 }
 
+bool yarp::os::impl::PortCoreAdapter::isReadBackground()
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return permanentReadDelegate != nullptr;
+}
+
 bool yarp::os::impl::PortCoreAdapter::read(PortReader& reader, bool willReply)
 {
     // called by user
@@ -80,6 +80,7 @@ YARP_WARNING_POP
     void finishWriting();
     void resumeFull();
     bool read(ConnectionReader& reader) override;
+    bool isReadBackground() override;
     bool read(PortReader& reader, bool willReply = false);
     bool reply(PortWriter& writer, bool drop, bool interrupted);
     void configReader(PortReader& reader);
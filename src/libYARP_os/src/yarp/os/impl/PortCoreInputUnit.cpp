@@ -13,13 +13,19 @@
 #include <yarp/os/Os.h>
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/PortReport.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PlatformSignal.h>
 #include <yarp/os/impl/PortCommand.h>
+#include <yarp/os/impl/SocketTwoWayStream.h>
+#include <yarp/os/impl/StreamConnectionReader.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 
 using namespace yarp::os::impl;
@@ -27,6 +33,58 @@ using namespace yarp::os;
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTCOREINPUTUNIT, "yarp.os.impl.PortCoreInputUnit")
+
+// The descriptor the reactor can wait on, or -1 if the connection does not
+// read directly from a socket.
+int getSocketHandle(InputProtocol* ip)
+{
+#if !defined(_WIN32)
+    if (ip != nullptr) {
+        auto* stream = dynamic_cast<SocketTwoWayStream*>(&ip->getInputStream());
+        if (stream != nullptr) {
+            return stream->getHandle();
+        }
+    }
+#else
+    YARP_UNUSED(ip);
+#endif
+    return -1;
+}
+
+// Reads a message of a batch, that was already received
+class BlockInputStream : public InputStream
+{
+public:
+    using InputStream::read;
+
+    BlockInputStream(const char* data, size_t len) :
+            data(data),
+            len(len)
+    {
+    }
+
+    yarp::conf::ssize_t read(Bytes& b) override
+    {
+        size_t n = std::min(b.length(), len - at);
+        memcpy(b.get(), data + at, n);
+        at += n;
+        return static_cast<yarp::conf::ssize_t>(n);
+    }
+
+    void close() override
+    {
+    }
+
+    bool isOk() const override
+    {
+        return true;
+    }
+
+private:
+    const char* data;
+    size_t len;
+    size_t at {0};
+};
 } // namespace
 
 PortCoreInputUnit::PortCoreInputUnit(PortCore& owner,
@@ -42,7 +100,16 @@ PortCoreInputUnit::PortCoreInputUnit(PortCore& owner,
         running(false),
         name(owner.getName()),
         localReader(nullptr),
-        reversed(reversed)
+        reversed(reversed),
+        messagesIn(0),
+        bytesIn(0),
+        wasNoticed(false),
+        posted(false),
+        begun(false),
+        reactive(false),
+        reactorClosing(false),
+        watchId(0),
+        stopped(0)
 {
     yCAssert(PORTCOREINPUTUNIT, ip != nullptr);
 
@@ -66,6 +133,24 @@ bool PortCoreInputUnit::start()
 {
     yCDebug(PORTCOREINPUTUNIT, "new input connection to %s starting", getOwner().getName().c_str());
 
+    // The threads of the reactor can serve the connection only if the port
+    // doesn't wait for the user to take each message.
+    PortCoreReactor& reactor = PortCoreReactor::getInstance();
+    if (reactor.isEnabled() && (localReader != nullptr || getOwner().isReadBackground())) {
+        reactive = true;
+        if (reactor.post(this)) {
+            yCDebug(PORTCOREINPUTUNIT, "new input connection to %s handed to the reactor", getOwner().getName().c_str());
+            return true;
+        }
+        reactive = false;
+    }
+
+    return startThread();
+}
+
+
+bool PortCoreInputUnit::startThread()
+{
     phase.wait();
 
     bool result = PortCoreUnit::start();
@@ -87,16 +172,27 @@ void PortCoreInputUnit::run()
     running = true;
     phase.post();
 
+    // When the connection comes from the reactor, it has already begun
+    bool more = begun || runBegin();
+    while (more) {
+        more = runStep();
+    }
+    runEnd();
+}
+
+
+bool PortCoreInputUnit::runBegin()
+{
+    begun = true;
+
     Route route;
-    bool wasNoticed = false;
-    bool posted = false;
+    wasNoticed = false;
+    posted = false;
 
     bool done = false;
 
     yCAssert(PORTCOREINPUTUNIT, ip != nullptr);
 
-    PortCommand cmd;
-
     bool ok = true;
     if (!reversed) {
         ip->open(getName());
@@ -167,225 +263,282 @@ void PortCoreInputUnit::run()
         done = true;
     }
 
-    auto* id = reinterpret_cast<void*>(this);
-
     if (ip != nullptr && !ip->getConnection().canEscape()) {
         InputStream* is = &ip->getInputStream();
         is->setReadEnvelopeCallback(envelopeReadCallback, this);
     }
 
-    while (!done) {
-        if (ip == nullptr) {
-            break;
-        }
-        ConnectionReader& br = ip->beginRead();
-
-        if (br.getReference() != nullptr) {
-            //printf("HAVE A REFERENCE\n");
-            if (localReader != nullptr) {
-                bool ok = localReader->read(br);
-                if (!br.isActive()) {
-                    break;
-                }
-                if (!ok) {
-                    continue;
-                }
-            } else {
-                PortCore& man = getOwner();
-                bool ok = man.readBlock(br, id, nullptr);
-                if (!br.isActive()) {
-                    break;
-                }
-                if (!ok) {
-                    continue;
-                }
-            }
-            //printf("DONE WITH A REFERENCE\n");
-            if (ip != nullptr) {
-                ip->endRead();
-            }
-            continue;
-        }
+    return !done;
+}
+
+
+bool PortCoreInputUnit::runStep()
+{
+    auto* id = reinterpret_cast<void*>(this);
+    bool done = false;
+
+    if (ip == nullptr) {
+        return false;
+    }
+    ConnectionReader& br = ip->beginRead();
 
-        if (ip->getConnection().canEscape()) {
-            bool ok = cmd.read(br);
+    if (br.getReference() != nullptr) {
+        //printf("HAVE A REFERENCE\n");
+        messagesIn.fetch_add(1, std::memory_order_relaxed);
+        if (localReader != nullptr) {
+            bool ok = localReader->read(br);
             if (!br.isActive()) {
-                break;
+                return false;
             }
             if (!ok) {
-                continue;
+                return true;
             }
         } else {
-            cmd = PortCommand('d', "");
-            if (!ip->isOk()) {
-                break;
+            PortCore& man = getOwner();
+            bool ok = man.readBlock(br, id, nullptr);
+            if (!br.isActive()) {
+                return false;
+            }
+            if (!ok) {
+                return true;
             }
         }
+        //printf("DONE WITH A REFERENCE\n");
+        if (ip != nullptr) {
+            ip->endRead();
+        }
+        return true;
+    }
 
-        if (closing || isDoomed()) {
-            break;
+    if (ip->getConnection().canEscape()) {
+        bool ok = cmd.read(br);
+        if (!br.isActive()) {
+            return false;
+        }
+        if (!ok) {
+            return true;
         }
-        char key = cmd.getKey();
-        //printf("Port command is [%c:%d/%s]\n",
-        //         (key>=32)?key:'?', key, cmd.getText().c_str());
-
-        PortCore& man = getOwner();
-        OutputStream* os = nullptr;
-        if (br.isTextMode()) {
-            os = &(ip->getOutputStream());
+    } else {
+        cmd = PortCommand('d', "");
+        if (!ip->isOk()) {
+            return false;
         }
+    }
 
-        switch (key) {
-        case '/':
-            yCDebug(PORTCOREINPUTUNIT,
-                    "Port command (%s): %s should add connection: %s",
-                    route.toString().c_str(),
-                    getOwner().getName().c_str(),
-                    cmd.getText().c_str());
-            man.addOutput(cmd.getText(), id, os);
-            break;
-        case '!':
-            yCDebug(PORTCOREINPUTUNIT,
-                    "Port command (%s): %s should remove output: %s",
-                    route.toString().c_str(),
-                    getOwner().getName().c_str(),
-                    cmd.getText().c_str());
-            man.removeOutput(cmd.getText().substr(1, std::string::npos), id, os);
-            break;
-        case '~':
-            yCDebug(PORTCOREINPUTUNIT,
-                    "Port command (%s): %s should remove input: %s",
-                    route.toString().c_str(),
-                    getOwner().getName().c_str(),
-                    cmd.getText().c_str());
-            man.removeInput(cmd.getText().substr(1, std::string::npos), id, os);
-            break;
-        case '*':
-            man.describe(id, os);
-            break;
-        case 'D':
-        case 'd': {
-            if (key == 'D') {
-                ip->suppressReply();
-            }
+    if (closing || isDoomed()) {
+        return false;
+    }
+    char key = cmd.getKey();
+    //printf("Port command is [%c:%d/%s]\n",
+    //         (key>=32)?key:'?', key, cmd.getText().c_str());
+
+    PortCore& man = getOwner();
+    OutputStream* os = nullptr;
+    if (br.isTextMode()) {
+        os = &(ip->getOutputStream());
+    }
+
+    switch (key) {
+    case '/':
+        yCDebug(PORTCOREINPUTUNIT,
+                "Port command (%s): %s should add connection: %s",
+                officialRoute.toString().c_str(),
+                getOwner().getName().c_str(),
+                cmd.getText().c_str());
+        man.addOutput(cmd.getText(), id, os);
+        break;
+    case '!':
+        yCDebug(PORTCOREINPUTUNIT,
+                "Port command (%s): %s should remove output: %s",
+                officialRoute.toString().c_str(),
+                getOwner().getName().c_str(),
+                cmd.getText().c_str());
+        man.removeOutput(cmd.getText().substr(1, std::string::npos), id, os);
+        break;
+    case '~':
+        yCDebug(PORTCOREINPUTUNIT,
+                "Port command (%s): %s should remove input: %s",
+                officialRoute.toString().c_str(),
+                getOwner().getName().c_str(),
+                cmd.getText().c_str());
+        man.removeInput(cmd.getText().substr(1, std::string::npos), id, os);
+        break;
+    case '*':
+        man.describe(id, os);
+        break;
+    case 'D':
+    case 'd': {
+        if (key == 'D') {
+            ip->suppressReply();
+        }
 
-            std::string env = cmd.getText();
-            if (env.length() > 2) {
-                yCTrace(PORTCOREINPUTUNIT, "***** received an envelope! [%s]", env.c_str());
-                std::string env2 = env.substr(2, env.length());
-                man.setEnvelope(env2);
-                ip->setEnvelope(env2);
+        std::string env = cmd.getText();
+        if (env.length() > 2) {
+            yCTrace(PORTCOREINPUTUNIT, "***** received an envelope! [%s]", env.c_str());
+            setEnvelope(env.substr(2, env.length()));
+        }
+        messagesIn.fetch_add(1, std::memory_order_relaxed);
+        bytesIn.fetch_add(br.getSize(), std::memory_order_relaxed);
+        deliver(br, id, os);
+        if (!br.isActive()) {
+            done = true;
+            break;
+        }
+    } break;
+    case 'b': {
+        // Messages coalesced by the sender (see PortCoreOutputUnit).
+        // Each one has the length of its envelope and of its data.
+        ip->suppressReply();
+        bool broken = false;
+        std::int32_t count = br.expectInt32();
+        for (std::int32_t i = 0; i < count && !broken; i++) {
+            std::int32_t envLen = br.expectInt32();
+            std::int32_t len = br.expectInt32();
+            // The lengths come from the peer, a message cannot be longer
+            // than what is left of the batch
+            if (br.isError() || envLen < 0 || len < 0 || static_cast<size_t>(envLen) + static_cast<size_t>(len) > br.getSize()) {
+                broken = true;
+                break;
             }
-            if (localReader != nullptr) {
-                localReader->read(br);
-                if (!br.isActive()) {
-                    done = true;
-                    break;
-                }
-            } else {
-                if (ip->getReceiver().acceptIncomingData(br)) {
-                    ConnectionReader* cr = &(ip->getReceiver().modifyIncomingData(br));
-                    yarp::os::impl::PortDataModifier& modifier = getOwner().getPortModifier();
-                    modifier.inputMutex.lock();
-                    if (modifier.inputModifier != nullptr) {
-                        if (modifier.inputModifier->acceptIncomingData(*cr)) {
-                            cr = &(modifier.inputModifier->modifyIncomingData(*cr));
-                            modifier.inputMutex.unlock();
-                            man.readBlock(*cr, id, os);
-                        } else {
-                            modifier.inputMutex.unlock();
-                            skipIncomingData(*cr);
-                        }
-                    } else {
-                        modifier.inputMutex.unlock();
-                        man.readBlock(*cr, id, os);
-                    }
-                } else {
-                    skipIncomingData(br);
-                }
-                if (!br.isActive()) {
-                    done = true;
-                    break;
-                }
+            size_t total = static_cast<size_t>(envLen) + static_cast<size_t>(len);
+            batchData.allocateOnNeed(total, total);
+            if (!br.expectBlock(batchData.get(), total)) {
+                broken = true;
+                break;
             }
-        } break;
-        case 'a': {
-            man.adminBlock(br, id);
-        } break;
-        case 'r':
-            /*
-              In YARP implementation, OP=IP.
-              (This information is used rarely, and when used
-              is tagged with OP=IP keyword)
-              If it were not true, memory alloc would need to
-              reorganized here
-            */
-            {
-                OutputProtocol* op = &(ip->getOutput());
-                ip->endRead();
-                Route r = op->getRoute();
-                // reverse route
-                r.swapNames();
-                op->rename(r);
-
-                getOwner().addOutput(op);
-                ip = nullptr;
-                done = true;
+            if (envLen > 0) {
+                setEnvelope(std::string(batchData.get(), envLen));
             }
+            messagesIn.fetch_add(1, std::memory_order_relaxed);
+            bytesIn.fetch_add(len, std::memory_order_relaxed);
+            BlockInputStream sis(batchData.get() + envLen, len);
+            StreamConnectionReader sbr;
+            sbr.reset(sis, nullptr, ip->getRoute(), len, false, br.isBareMode());
+            sbr.setParentConnectionReader(&br);
+            deliver(sbr, id, os);
+        }
+        if (broken || br.isError()) {
+            yCError(PORTCOREINPUTUNIT, "Broken batch of messages from %s, closing the connection", ip->getRoute().getFromName().c_str());
+            done = true;
             break;
-        case 'q':
+        }
+        if (!br.isActive()) {
             done = true;
             break;
+        }
+    } break;
+    case 'a': {
+        man.adminBlock(br, id);
+    } break;
+    case 'r':
+        /*
+          In YARP implementation, OP=IP.
+          (This information is used rarely, and when used
+          is tagged with OP=IP keyword)
+          If it were not true, memory alloc would need to
+          reorganized here
+        */
+        {
+            OutputProtocol* op = &(ip->getOutput());
+            ip->endRead();
+            Route r = op->getRoute();
+            // reverse route
+            r.swapNames();
+            op->rename(r);
+
+            getOwner().addOutput(op);
+            ip = nullptr;
+            done = true;
+        }
+        break;
+    case 'q':
+        done = true;
+        break;
 #if !defined(NDEBUG)
-        case 'i':
-            printf("Interrupt requested\n");
-            //yarp::os::impl::kill(0, 2); // SIGINT
-            //yarp::os::impl::kill(yarp::os::getpid(), 2); // SIGINT
-            yarp::os::impl::kill(yarp::os::getpid(), 15); // SIGTERM
-            break;
+    case 'i':
+        printf("Interrupt requested\n");
+        //yarp::os::impl::kill(0, 2); // SIGINT
+        //yarp::os::impl::kill(yarp::os::getpid(), 2); // SIGINT
+        yarp::os::impl::kill(yarp::os::getpid(), 15); // SIGTERM
+        break;
 #endif
-        case '?':
-        case 'h':
-            if (os != nullptr) {
-                BufferedConnectionWriter bw(true);
-                bw.appendLine("This is a YARP port.  Here are the commands it responds to:");
-                bw.appendLine("*       Gives a description of this port");
-                bw.appendLine("d       Signals the beginning of input for the port's owner");
-                bw.appendLine(R"(do      The same as "d" except replies should be suppressed ("data-only"))");
-                bw.appendLine("q       Disconnects");
+    case '?':
+    case 'h':
+        if (os != nullptr) {
+            BufferedConnectionWriter bw(true);
+            bw.appendLine("This is a YARP port.  Here are the commands it responds to:");
+            bw.appendLine("*       Gives a description of this port");
+            bw.appendLine("d       Signals the beginning of input for the port's owner");
+            bw.appendLine(R"(do      The same as "d" except replies should be suppressed ("data-only"))");
+            bw.appendLine("q       Disconnects");
 #if !defined(NDEBUG)
-                bw.appendLine("i       Interrupt parent process (unix only)");
+            bw.appendLine("i       Interrupt parent process (unix only)");
 #endif
-                bw.appendLine("r       Reverse connection type to be a reader");
-                bw.appendLine("/port   Requests to send output to /port");
-                bw.appendLine("!/port  Requests to stop sending output to /port");
-                bw.appendLine("~/port  Requests to stop receiving input from /port");
-                bw.appendLine("a       Signals the beginning of an administrative message");
-                bw.appendLine("?       Gives this help");
-                bw.write(*os);
-            }
-            break;
-        default:
-            if (os != nullptr) {
-                BufferedConnectionWriter bw(true);
-                bw.appendLine("Port command not understood.");
-                bw.appendLine("Type d to send data to the port's owner.");
-                bw.appendLine("Type ? for help.");
-                bw.write(*os);
-            }
-            break;
-        }
-        if (ip != nullptr) {
-            ip->endRead();
+            bw.appendLine("r       Reverse connection type to be a reader");
+            bw.appendLine("/port   Requests to send output to /port");
+            bw.appendLine("!/port  Requests to stop sending output to /port");
+            bw.appendLine("~/port  Requests to stop receiving input from /port");
+            bw.appendLine("a       Signals the beginning of an administrative message");
+            bw.appendLine("?       Gives this help");
+            bw.write(*os);
         }
-        if (ip == nullptr) {
-            break;
+        break;
+    default:
+        if (os != nullptr) {
+            BufferedConnectionWriter bw(true);
+            bw.appendLine("Port command not understood.");
+            bw.appendLine("Type d to send data to the port's owner.");
+            bw.appendLine("Type ? for help.");
+            bw.write(*os);
         }
-        if (closing || isDoomed() || (!ip->isOk())) {
-            break;
+        break;
+    }
+    if (ip != nullptr) {
+        ip->endRead();
+    }
+    if (ip == nullptr) {
+        return false;
+    }
+    if (closing || isDoomed() || (!ip->isOk())) {
+        return false;
+    }
+
+    return !done;
+}
+
+
+void PortCoreInputUnit::deliver(ConnectionReader& reader, void* id, OutputStream* os)
+{
+    if (localReader != nullptr) {
+        localReader->read(reader);
+        return;
+    }
+    PortCore& man = getOwner();
+    if (ip->getReceiver().acceptIncomingData(reader)) {
+        ConnectionReader* cr = &(ip->getReceiver().modifyIncomingData(reader));
+        yarp::os::impl::PortDataModifier& modifier = getOwner().getPortModifier();
+        modifier.inputMutex.lock();
+        if (modifier.inputModifier != nullptr) {
+            if (modifier.inputModifier->acceptIncomingData(*cr)) {
+                cr = &(modifier.inputModifier->modifyIncomingData(*cr));
+                modifier.inputMutex.unlock();
+                man.readBlock(*cr, id, os);
+            } else {
+                modifier.inputMutex.unlock();
+                skipIncomingData(*cr);
+            }
+        } else {
+            modifier.inputMutex.unlock();
+            man.readBlock(*cr, id, os);
         }
+    } else {
+        skipIncomingData(reader);
     }
+}
+
 
+void PortCoreInputUnit::runEnd()
+{
     setDoomed();
 
     yCDebug(PORTCOREINPUTUNIT, "Closing ip");
@@ -396,9 +549,9 @@ void PortCoreInputUnit::run()
     access.post();
     yCDebug(PORTCOREINPUTUNIT, "Closed ip");
 
-    std::string msg = std::string("Removing input from ") + route.getFromName() + " to " + route.getToName();
+    std::string msg = std::string("Removing input from ") + officialRoute.getFromName() + " to " + officialRoute.getToName();
 
-    if (Name(route.getFromName()).isRooted()) {
+    if (Name(officialRoute.getFromName()).isRooted()) {
         if (posted) {
             yCInfo(PORTCOREINPUTUNIT, "%s", msg.c_str());
         }
@@ -415,10 +568,10 @@ void PortCoreInputUnit::run()
         info.tag = yarp::os::PortInfo::PORTINFO_CONNECTION;
         info.incoming = true;
         info.created = false;
-        info.sourceName = route.getFromName();
-        info.targetName = route.getToName();
+        info.sourceName = officialRoute.getFromName();
+        info.targetName = officialRoute.getToName();
         info.portName = info.targetName;
-        info.carrierName = route.getCarrierName();
+        info.carrierName = officialRoute.getCarrierName();
 
         if (info.sourceName != "admin") {
             getOwner().report(info);
@@ -438,6 +591,65 @@ void PortCoreInputUnit::run()
     // thread within and from themselves
 }
 
+void PortCoreInputUnit::handleEvent()
+{
+    // Called by a thread of the reactor: first to begin the connection,
+    // then every time there is a message to read, or to end the connection
+    // after closeMain() removed it from the reactor.
+    PortCoreReactor& reactor = PortCoreReactor::getInstance();
+    if (!begun) {
+        if (runBegin()) {
+            std::lock_guard<std::mutex> lock(reactorMutex);
+            if (!reactorClosing) {
+                int fd = getSocketHandle(ip);
+                if (fd >= 0) {
+                    watchId = reactor.watch(fd, this);
+                }
+                if (watchId != 0) {
+                    return;
+                }
+                // This carrier cannot be multiplexed, it needs its own thread
+                yCDebug(PORTCOREINPUTUNIT, "input connection to %s cannot use the reactor", getOwner().getName().c_str());
+                reactive = false;
+                if (startThread()) {
+                    return;
+                }
+            }
+        }
+    } else {
+        std::unique_lock<std::mutex> lock(reactorMutex);
+        if (watchId != 0) {
+            lock.unlock();
+            double start = SystemClock::nowSystem();
+            bool more = runStep();
+            bool blocked = (SystemClock::nowSystem() - start > PortCoreReactor::blockedHandlerDelay);
+            lock.lock();
+            if (more && !reactorClosing) {
+                if (!blocked && reactor.rearm(watchId)) {
+                    return;
+                }
+                if (blocked) {
+                    // A slow peer would keep a thread of the reactor busy
+                    // at each message, the connection gets its own thread
+                    yCDebug(PORTCOREINPUTUNIT, "input connection to %s is slow, leaving the reactor", getOwner().getName().c_str());
+                    reactor.unwatch(watchId);
+                    watchId = 0;
+                    reactive = false;
+                    if (startThread()) {
+                        return;
+                    }
+                }
+            }
+            if (watchId != 0) {
+                reactor.unwatch(watchId);
+                watchId = 0;
+            }
+        }
+    }
+    runEnd();
+    stopped.post();
+}
+
 bool PortCoreInputUnit::isInput()
 {
     return true;
@@ -500,6 +712,27 @@ void PortCoreInputUnit::closeMain()
 
     yCDebug(PORTCOREINPUTUNIT, "[%s] closing", r.toString().c_str());
 
+    reactorMutex.lock();
+    reactorClosing = true;
+    bool wasReactive = reactive;
+    std::uint64_t id = watchId;
+    watchId = 0;
+    reactorMutex.unlock();
+    if (wasReactive) {
+        // Leave the reactor before closing the socket.  If a thread of the
+        // reactor is reading from the connection, it will end it.
+        yCDebug(PORTCOREINPUTUNIT, "[%s] leaving the reactor", r.toString().c_str());
+        PortCoreReactor& reactor = PortCoreReactor::getInstance();
+        bool waiting = (id != 0 && reactor.unwatch(id));
+        interrupt();
+        if (waiting && !reactor.post(this)) {
+            runEnd();
+            stopped.post();
+        }
+        stopped.wait();
+        stopped.post();
+    }
+
     if (running) {
         yCDebug(PORTCOREINPUTUNIT, "[%s] joining", r.toString().c_str());
         interrupt();
@@ -557,6 +790,28 @@ void PortCoreInputUnit::envelopeReadCallback(void* data, const Bytes& envelope)
     if (p == nullptr) {
         return;
     }
-    p->getOwner().setEnvelope(envelope.get());
-    p->ip->setEnvelope(envelope.get());
+    p->setEnvelope(envelope.get());
+}
+
+
+void PortCoreInputUnit::setEnvelope(const std::string& envelope)
+{
+    getOwner().setEnvelope(envelope);
+    ip->setEnvelope(envelope);
+
+    // A yarp::os::Stamp is written as "count time"
+    int count = 0;
+    double time = 0.0;
+    char extra = 0;
+    if (std::sscanf(envelope.c_str(), "%d %lf %c", &count, &time, &extra) == 2) {
+        latency.add(yarp::os::Time::now() - time);
+    }
+}
+
+
+void PortCoreInputUnit::getStats(yarp::os::Property& stats)
+{
+    stats.put("messages", Value::makeInt64(static_cast<std::int64_t>(messagesIn.load(std::memory_order_relaxed))));
+    stats.put("bytes", Value::makeInt64(static_cast<std::int64_t>(bytesIn.load(std::memory_order_relaxed))));
+    latency.report(stats.addGroup("latency"));
 }
@@ -11,10 +11,18 @@
 #define YARP_OS_IMPL_PORTCOREINPUTUNIT_H
 
 #include <yarp/os/InputProtocol.h>
+#include <yarp/os/ManagedBytes.h>
 #include <yarp/os/Semaphore.h>
+#include <yarp/os/impl/LatencyHistogram.h>
+#include <yarp/os/impl/PortCommand.h>
 #include <yarp/os/impl/PortCore.h>
+#include <yarp/os/impl/PortCoreReactor.h>
 #include <yarp/os/impl/PortCoreUnit.h>
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
 namespace yarp {
 namespace os {
 namespace impl {
@@ -22,9 +30,13 @@ namespace impl {
 /**
  * Manager for a single input to a port.  Associated
  * with a PortCore object.
+ *
+ * The input is served by its own thread, or by the threads of the
+ * PortCoreReactor when it is enabled.
  */
 class PortCoreInputUnit :
-        public PortCoreUnit
+        public PortCoreUnit,
+        public PortCoreReactor::Handler
 {
 public:
     /**
@@ -63,6 +75,14 @@ public:
      */
     void run() override;
 
+    /**
+     *
+     * Called by the reactor to begin the connection, to read a message
+     * when one is available, and to end the connection.
+     *
+     */
+    void handleEvent() override;
+
     bool isInput() override;
 
     void close() override;
@@ -84,19 +104,59 @@ public:
 
     bool isBusy() override;
 
+    /**
+     * Describe the traffic of this connection: messages and bytes received
+     * ("messages" and "bytes"), and the latency of the messages that had a
+     * timestamp as envelope ("latency"), measured from the time in the
+     * envelope to their arrival.
+     */
+    void getStats(yarp::os::Property& stats) override;
+
 private:
     InputProtocol* ip;
     yarp::os::Semaphore phase, access;
-    bool closing, finished, running;
+    std::atomic<bool> closing;
+    bool finished, running;
     std::string name;
     yarp::os::PortReader* localReader;
     Route officialRoute;
     bool reversed;
+    PortCommand cmd;
+    yarp::os::ManagedBytes batchData;
+    std::atomic<std::uint64_t> messagesIn;
+    std::atomic<std::uint64_t> bytesIn;
+    LatencyHistogram latency;
+    bool wasNoticed;
+    bool posted;
+    bool begun;
+
+    // State of a connection served by the reactor
+    std::mutex reactorMutex;
+    bool reactive;
+    bool reactorClosing;
+    std::uint64_t watchId;
+    yarp::os::Semaphore stopped;
+
+    bool startThread();
+    bool runBegin();
+    bool runStep();
+    void runEnd();
 
     void closeMain();
 
     bool skipIncomingData(yarp::os::ConnectionReader& reader);
 
+    /**
+     * Hand a message to the reader of the connection, or to the port.
+     */
+    void deliver(yarp::os::ConnectionReader& reader, void* id, OutputStream* os);
+
+    /**
+     * Pass on the envelope of a message, and measure its latency if the
+     * envelope is a timestamp.
+     */
+    void setEnvelope(const std::string& envelope);
+
     static void envelopeReadCallback(void* data, const Bytes& envelope);
 };
 
@@ -9,17 +9,50 @@
 
 #include <yarp/os/impl/PortCoreOutputUnit.h>
 
+#include <yarp/os/Bottle.h>
 #include <yarp/os/Name.h>
+#include <yarp/os/NetType.h>
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/PortReport.h>
 #include <yarp/os/Portable.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/TransformCache.h>
+#include <yarp/os/Vocab.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PortCommand.h>
+#include <yarp/os/impl/PortCorePacket.h>
+
+#include <cstdint>
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTCOREOUTPUTUNIT, "yarp.os.impl.PortCoreOutputUnit")
+
+// Messages that can wait in a batch.  When a batch is full, new messages
+// are skipped, as they are when a connection is busy with a single message.
+constexpr int maxBatchMessages = 1000;
+
+// Longest queue of messages waiting to be written on a connection
+constexpr int maxQueuedMessages = 1000;
+
+// The trackers given by PortCore are the packets of the messages
+yarp::os::TransformCache* transformCache(void* tracker)
+{
+    return (tracker != nullptr) ? &static_cast<yarp::os::impl::PortCorePacket*>(tracker)->transforms : nullptr;
+}
+
+// The buffers are set up from the connection, with the default binary mode
+// when the unit has no protocol
+bool isTextMode(yarp::os::OutputProtocol* op)
+{
+    return (op != nullptr) && op->getConnection().isTextMode();
+}
+
+bool isBareMode(yarp::os::OutputProtocol* op)
+{
+    return (op != nullptr) && op->getConnection().isBareMode();
+}
 } // namespace
 
 using namespace yarp::os::impl;
@@ -32,16 +65,40 @@ PortCoreOutputUnit::PortCoreOutputUnit(PortCore& owner, int index, OutputProtoco
         finished(false),
         running(false),
         threaded(false),
+        reactive(false),
         sending(false),
         phase(1),
         activate(0),
+        posted(false),
+        reposted(false),
         trackerMutex(),
         cachedWriter(nullptr),
         cachedReader(nullptr),
         cachedCallback(nullptr),
-        cachedTracker(nullptr)
+        cachedTracker(nullptr),
+        sendBuffer(isTextMode(op), isBareMode(op)),
+        bufAllocations(0),
+        bufPooled(0),
+        bufHighWater(0),
+        coalesce(false),
+        coalesceBudget(0.0),
+        flushing(false),
+        batchStart(0.0),
+        batchCount(0),
+        pendingBatch(0),
+        itemBuffer(false, isBareMode(op)),
+        messagesOut(0),
+        bytesOut(0),
+        droppedOut(0),
+        blockedOut(0),
+        queuedAt(0.0),
+        queueCapacity(0),
+        overflow(Overflow::DropNewest),
+        queueHead(0),
+        queueCount(0),
+        queueFull(false),
+        draining(false)
 {
-    yCAssert(PORTCOREOUTPUTUNIT, op != nullptr);
 }
 
 PortCoreOutputUnit::~PortCoreOutputUnit()
@@ -76,8 +133,8 @@ bool PortCoreOutputUnit::start()
 
 void PortCoreOutputUnit::run()
 {
+    // A connection that leaves the reactor can be sending already
     running = true;
-    sending = false;
 
     // By default, we don't start up a thread for outputs.
 
@@ -91,27 +148,92 @@ void PortCoreOutputUnit::run()
             yCDebug(PORTCOREOUTPUTUNIT, "waiting");
             activate.wait();
             yCDebug(PORTCOREOUTPUTUNIT, "woken");
-            if (!closing) {
-                if (sending) {
-                    yCDebug(PORTCOREOUTPUTUNIT, "write something in background");
-                    sendHelper();
-                    yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
-                    trackerMutex.lock();
-                    if (cachedTracker != nullptr) {
-                        void* t = cachedTracker;
-                        cachedTracker = nullptr;
-                        sending = false;
-                        getOwner().notifyCompletion(t);
-                    } else {
-                        sending = false;
-                    }
-                    trackerMutex.unlock();
-                }
+            // Give the batch some time to fill up, this thread has nothing
+            // else to do meanwhile
+            double wait = batchWait();
+            if (wait > 0) {
+                SystemClock::delaySystem(wait);
             }
+            sendInBackground();
             yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
         }
         yCDebug(PORTCOREOUTPUTUNIT, "thread closing");
+        trackerMutex.lock();
         sending = false;
+        trackerMutex.unlock();
+    }
+}
+
+
+void PortCoreOutputUnit::handleEvent()
+{
+    // Give the batch some time to fill up, without keeping a thread of
+    // the reactor busy
+    double wait = batchWait();
+    if (wait > 0) {
+        if (PortCoreReactor::getInstance().post(this, wait)) {
+            return;
+        }
+        // Called by the writer, the reactor is not available
+        SystemClock::delaySystem(wait);
+    }
+
+    bool blocked = false;
+    std::unique_lock<std::mutex> lock(reactorMutex);
+    do {
+        reposted = false;
+        lock.unlock();
+        double start = SystemClock::nowSystem();
+        sendInBackground();
+        blocked = blocked || (SystemClock::nowSystem() - start > PortCoreReactor::blockedHandlerDelay);
+        lock.lock();
+    } while (reposted && !closing);
+    posted = false;
+    if (blocked && !closing) {
+        // A slow peer would keep a thread of the reactor busy at each
+        // message, the connection gets its own thread
+        yCDebug(PORTCOREOUTPUTUNIT, "output connection is slow, leaving the reactor");
+        reactive = false;
+        threaded = true;
+        start();
+    }
+    lock.unlock();
+    reactorIdle.notify_all();
+}
+
+
+void PortCoreOutputUnit::sendInBackground()
+{
+    if (!closing && coalesce) {
+        while (sendBatch(true)) {
+            // Messages that came during a send go out right away
+        }
+    }
+    if (queueCapacity > 0) {
+        sendQueue();
+        return;
+    }
+    if (!closing) {
+        trackerMutex.lock();
+        bool pending = sending;
+        double start = queuedAt;
+        trackerMutex.unlock();
+        if (pending) {
+            yCDebug(PORTCOREOUTPUTUNIT, "write something in background");
+            queueTime.add(SystemClock::nowSystem() - start);
+            sendHelper(*cachedWriter, cachedReader, cachedEnvelope, cachedTracker);
+            yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
+            trackerMutex.lock();
+            if (cachedTracker != nullptr) {
+                void* t = cachedTracker;
+                cachedTracker = nullptr;
+                sending = false;
+                getOwner().notifyCompletion(t);
+            } else {
+                sending = false;
+            }
+            trackerMutex.unlock();
+        }
     }
 }
 
@@ -121,6 +243,63 @@ void PortCoreOutputUnit::runSingleThreaded()
     if (op != nullptr) {
         Route route = op->getRoute();
         setMode();
+
+        Name name(route.getCarrierName() + std::string("://test"));
+        bool hasBudget = false;
+        std::string budget = name.getCarrierModifier("coalesce", &hasBudget);
+        if (hasBudget) {
+            Connection& connection = op->getConnection();
+            if (connection.canEscape() && !connection.isTextMode() && !connection.isLocal() && connection.supportReply()) {
+                if (acceptsBatches()) {
+                    coalesce = true;
+                    coalesceBudget = NetType::toInt(budget) * 1e-6;
+                } else {
+                    yCWarning(PORTCOREOUTPUTUNIT, "the receiver of %s does not take coalesced messages", route.toString().c_str());
+                }
+            } else {
+                yCWarning(PORTCOREOUTPUTUNIT, "messages cannot be coalesced on %s", route.toString().c_str());
+            }
+        }
+
+        bool hasQueue = false;
+        std::string queueSize = name.getCarrierModifier("queue", &hasQueue);
+        if (hasQueue) {
+            int size = NetType::toInt(queueSize);
+            if (size > 0 && size <= maxQueuedMessages) {
+                queueCapacity = static_cast<size_t>(size);
+            } else {
+                yCWarning(PORTCOREOUTPUTUNIT, "invalid queue size %s on %s", queueSize.c_str(), route.toString().c_str());
+            }
+        }
+        bool hasOverflow = false;
+        std::string policy = name.getCarrierModifier("overflow", &hasOverflow);
+        if (hasOverflow) {
+            if (policy == "block") {
+                overflow = Overflow::Block;
+            } else if (policy == "drop_oldest") {
+                overflow = Overflow::DropOldest;
+            } else if (policy == "drop_newest") {
+                overflow = Overflow::DropNewest;
+            } else if (policy == "keep_latest") {
+                overflow = Overflow::KeepLatest;
+            } else {
+                yCWarning(PORTCOREOUTPUTUNIT, "unknown overflow policy %s on %s", policy.c_str(), route.toString().c_str());
+                hasOverflow = false;
+            }
+            if (hasOverflow && queueCapacity == 0) {
+                queueCapacity = 1;
+            }
+        }
+        if (overflow == Overflow::KeepLatest) {
+            queueCapacity = 1;
+        }
+        if (queueCapacity > 0 && coalesce) {
+            yCWarning(PORTCOREOUTPUTUNIT, "messages are coalesced on %s, the queue is not used", route.toString().c_str());
+            queueCapacity = 0;
+        }
+        // A blocked writer leaves its message in the spare entry
+        queue.resize((queueCapacity > 0 && overflow == Overflow::Block) ? queueCapacity + 1 : queueCapacity);
+
         getOwner().reportUnit(this, true);
 
         std::string msg = std::string("Sending output from ") + route.getFromName() + " to " + route.getToName() + " using " + route.getCarrierName();
@@ -218,6 +397,23 @@ void PortCoreOutputUnit::closeMain()
 
     yCDebug(PORTCOREOUTPUTUNIT, "closing");
 
+    if (coalesce) {
+        // don't lose the messages waiting in the batch
+        sendBatch(false);
+    }
+
+    {
+        // wait for the reactor to finish any background write
+        std::unique_lock<std::mutex> lock(reactorMutex);
+        if (reactive) {
+            if (op != nullptr) {
+                op->interrupt();
+            }
+            closing = true;
+            reactorIdle.wait(lock, [this] { return !posted; });
+        }
+    }
+
     if (running) {
         // give a kick (unfortunately unavoidable)
 
@@ -231,6 +427,12 @@ void PortCoreOutputUnit::closeMain()
         join();
     }
 
+    if (queueCapacity > 0) {
+        // release a writer waiting for room, and the messages left behind
+        closing = true;
+        dropQueue();
+    }
+
     yCDebug(PORTCOREOUTPUTUNIT, "internal join");
 
     closeBasic();
@@ -252,65 +454,78 @@ Route PortCoreOutputUnit::getRoute()
     return PortCoreUnit::getRoute();
 }
 
-bool PortCoreOutputUnit::sendHelper()
+bool PortCoreOutputUnit::sendHelper(const yarp::os::PortWriter& writer,
+                                    yarp::os::PortReader* reader,
+                                    const std::string& envelope,
+                                    void* tracker)
 {
     bool replied = false;
+    const yarp::os::PortWriter* message = &writer;
+    std::lock_guard<std::mutex> lock(writeMutex);
     if (op != nullptr) {
         bool done = false;
-        BufferedConnectionWriter buf(op->getConnection().isTextMode(),
-                                     op->getConnection().isBareMode());
-        if (cachedReader != nullptr) {
-            buf.setReplyHandler(*cachedReader);
+        // The buffer keeps its memory from the previous messages
+        sendBuffer.restart();
+        if (reader != nullptr) {
+            sendBuffer.setReplyHandler(*reader);
         }
 
+        // The port monitor and the carrier can share their work on the
+        // message with the other connections
+        TransformCache* transforms = transformCache(tracker);
         if (op->getSender().modifiesOutgoingData()) {
-            if (op->getSender().acceptOutgoingData(*cachedWriter)) {
-                cachedWriter = &op->getSender().modifyOutgoingData(*cachedWriter);
+            TransformCache::Scope monitorTransforms(transforms);
+            if (op->getSender().acceptOutgoingData(*message)) {
+                message = &op->getSender().modifyOutgoingData(*message);
             } else {
                 return (done = true);
             }
+            // The carrier sends what the monitor made of the message
+            transforms = nullptr;
         }
+        TransformCache::Scope carrierTransforms(transforms);
 
         if (op->getConnection().isLocal()) {
             // WARNING Cast away const qualifier.
             //         This may actually cause bugs when using the local carrier
             //         with something that is actually const (i.e. that is using
             //         some parts of memory that cannot be written.
-            auto* pw = const_cast<yarp::os::PortWriter*>(cachedWriter);
+            auto* pw = const_cast<yarp::os::PortWriter*>(message);
             auto* p = dynamic_cast<yarp::os::Portable*>(pw);
             if (p == nullptr) {
                 yCError(PORTCOREOUTPUTUNIT, "cast failed.");
                 return false;
             }
-            buf.setReference(p);
+            sendBuffer.setReference(p);
         } else {
-            yCAssert(PORTCOREOUTPUTUNIT, cachedWriter != nullptr);
-            bool ok = cachedWriter->write(buf);
+            double serializeStart = SystemClock::nowSystem();
+            bool ok = message->write(sendBuffer);
+            serializeTime.add(SystemClock::nowSystem() - serializeStart);
             if (!ok) {
                 done = true;
             }
 
-            bool suppressReply = (buf.getReplyHandler() == nullptr);
+            bool suppressReply = (sendBuffer.getReplyHandler() == nullptr);
 
             if (!done) {
                 if (!op->getConnection().canEscape()) {
-                    if (!cachedEnvelope.empty()) {
-                        op->getConnection().handleEnvelope(cachedEnvelope);
+                    if (!envelope.empty()) {
+                        op->getConnection().handleEnvelope(envelope);
                     }
                 } else {
-                    buf.addToHeader();
+                    sendBuffer.addToHeader();
 
-                    if (!cachedEnvelope.empty()) {
-                        if (cachedEnvelope == "__ADMIN") {
+                    if (!envelope.empty()) {
+                        if (envelope == "__ADMIN") {
                             PortCommand pc('a', "");
-                            pc.write(buf);
+                            pc.write(sendBuffer);
                         } else {
-                            PortCommand pc('\0', std::string(suppressReply ? "D " : "d ") + cachedEnvelope);
-                            pc.write(buf);
+                            PortCommand pc('\0', std::string(suppressReply ? "D " : "d ") + envelope);
+                            pc.write(sendBuffer);
                         }
                     } else {
                         PortCommand pc(suppressReply ? 'D' : 'd', "");
-                        pc.write(buf);
+                        pc.write(sendBuffer);
                     }
                 }
             }
@@ -318,9 +533,14 @@ bool PortCoreOutputUnit::sendHelper()
 
         if (!done) {
             if (op->getConnection().isActive()) {
-                replied = op->write(buf);
-                if (replied && op->getSender().modifiesReply() && cachedReader != nullptr) {
-                    cachedReader = &op->getSender().modifyReply(*cachedReader);
+                replied = op->write(sendBuffer);
+                // write() tells if there was a reply, the stream if it worked
+                if (op->isOk()) {
+                    messagesOut.fetch_add(1, std::memory_order_relaxed);
+                    bytesOut.fetch_add(sendBuffer.dataSize(), std::memory_order_relaxed);
+                }
+                if (replied && op->getSender().modifiesReply() && reader != nullptr) {
+                    op->getSender().modifyReply(*reader);
                 }
             }
             if (!op->isOk()) {
@@ -328,7 +548,11 @@ bool PortCoreOutputUnit::sendHelper()
             }
         }
 
-        if (buf.dropRequested()) {
+        bufAllocations = sendBuffer.allocationCount();
+        bufPooled = sendBuffer.pooledSize();
+        bufHighWater = sendBuffer.pooledHighWaterMark();
+
+        if (sendBuffer.dropRequested()) {
             done = true;
         }
         if (done) {
@@ -360,39 +584,45 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
         }
     }
 
+    if (coalesce && reader == nullptr) {
+        // replies can't be delivered to the messages of a batch
+        return sendCoalesced(writer, tracker, envelopeString, waitAfter);
+    }
+
+    if (queueCapacity > 0 && reader == nullptr && !waitAfter) {
+        return sendQueued(writer, tracker, envelopeString);
+    }
+
     if (!waitBefore || !waitAfter) {
-        if (!running) {
-            // we must have a thread if we're going to be skipping waits
-            threaded = true;
-            yCDebug(PORTCOREOUTPUTUNIT, "starting a thread for output");
-            start();
-            yCDebug(PORTCOREOUTPUTUNIT, "started a thread for output");
-        }
+        prepareBackground();
     }
 
     if ((!waitBefore) && waitAfter) {
         yCError(PORTCOREOUTPUTUNIT, "chosen port wait combination not yet implemented");
     }
+    std::unique_lock<std::mutex> lock(trackerMutex);
     if (!sending) {
-        cachedWriter = &writer;
-        cachedReader = reader;
-        cachedCallback = callback;
-        cachedEnvelope = envelopeString;
-
         sending = true;
         if (waitAfter) {
-            replied = sendHelper();
+            lock.unlock();
+            replied = sendHelper(writer, reader, envelopeString, tracker);
+            lock.lock();
             sending = false;
         } else {
-            trackerMutex.lock();
+            cachedWriter = &writer;
+            cachedReader = reader;
+            cachedCallback = callback;
+            cachedEnvelope = envelopeString;
+            queuedAt = SystemClock::nowSystem();
             void* nextTracker = tracker;
             tracker = cachedTracker;
             cachedTracker = nextTracker;
-            activate.post();
-            trackerMutex.unlock();
+            lock.unlock();
+            wakeBackground();
         }
     } else {
         yCDebug(PORTCOREOUTPUTUNIT, "skipping connection tagged as sending something");
+        droppedOut.fetch_add(1, std::memory_order_relaxed);
     }
 
     if (waitAfter) {
@@ -406,6 +636,326 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
 }
 
 
+void PortCoreOutputUnit::prepareBackground()
+{
+    std::lock_guard<std::mutex> lock(reactorMutex);
+    if (!running && !reactive && PortCoreReactor::getInstance().isEnabled()) {
+        // the threads of the reactor will do the background writes
+        reactive = true;
+    }
+    if (!running && !reactive) {
+        // we must have a thread if we're going to be skipping waits
+        threaded = true;
+        yCDebug(PORTCOREOUTPUTUNIT, "starting a thread for output");
+        start();
+        yCDebug(PORTCOREOUTPUTUNIT, "started a thread for output");
+    }
+}
+
+
+void PortCoreOutputUnit::wakeBackground()
+{
+    std::unique_lock<std::mutex> lock(reactorMutex);
+    if (!reactive) {
+        activate.post();
+        return;
+    }
+    if (posted) {
+        // the reactor writes these too before leaving the connection
+        reposted = true;
+        return;
+    }
+    posted = true;
+    lock.unlock();
+    if (!PortCoreReactor::getInstance().post(this)) {
+        handleEvent();
+    }
+}
+
+
+void* PortCoreOutputUnit::sendCoalesced(const yarp::os::PortWriter& writer,
+                                        void* tracker,
+                                        const std::string& envelopeString,
+                                        bool waitAfter)
+{
+    if (!waitAfter) {
+        prepareBackground();
+    }
+
+    if (op == nullptr) {
+        return tracker;
+    }
+
+    bool schedule = false;
+    batchMutex.lock();
+    if (batchCount >= maxBatchMessages) {
+        yCDebug(PORTCOREOUTPUTUNIT, "skipping message, the batch is full");
+        droppedOut.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        const PortWriter* item = &writer;
+        bool ok = true;
+        if (op->getSender().modifiesOutgoingData()) {
+            TransformCache::Scope monitorTransforms(transformCache(tracker));
+            if (op->getSender().acceptOutgoingData(*item)) {
+                item = &op->getSender().modifyOutgoingData(*item);
+            } else {
+                ok = false;
+            }
+        }
+        // The message is copied, so that the caller gets its tracker back
+        // right away
+        itemBuffer.restart();
+        double serializeStart = SystemClock::nowSystem();
+        ok = ok && item->write(itemBuffer);
+        serializeTime.add(SystemClock::nowSystem() - serializeStart);
+        if (ok && !itemBuffer.dropRequested()) {
+            size_t len = 0;
+            for (size_t i = 0; i < itemBuffer.length(); i++) {
+                len += itemBuffer.length(i);
+            }
+            BufferedConnectionWriter& batch = batches[pendingBatch];
+            batch.appendInt32(static_cast<std::int32_t>(envelopeString.length()));
+            batch.appendInt32(static_cast<std::int32_t>(len));
+            batch.appendBlockCopy(Bytes(const_cast<char*>(envelopeString.c_str()), envelopeString.length()));
+            for (size_t i = 0; i < itemBuffer.length(); i++) {
+                batch.appendBlockCopy(Bytes(const_cast<char*>(itemBuffer.data(i)), itemBuffer.length(i)));
+            }
+            if (batchCount == 0) {
+                batchStart = SystemClock::nowSystem();
+            }
+            batchCount++;
+            if (!flushing && !waitAfter) {
+                flushing = true;
+                schedule = true;
+            }
+        }
+    }
+    batchMutex.unlock();
+
+    if (waitAfter) {
+        sendBatch(false);
+    } else if (schedule) {
+        wakeBackground();
+    }
+
+    // the message was copied, the tracker is not needed anymore
+    return tracker;
+}
+
+
+void* PortCoreOutputUnit::sendQueued(const yarp::os::PortWriter& writer,
+                                     void* tracker,
+                                     const std::string& envelopeString)
+{
+    prepareBackground();
+
+    void* dropped = nullptr;
+    bool schedule = false;
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        size_t room = queueCapacity;
+        if (queueCount >= queueCapacity) {
+            switch (overflow) {
+            case Overflow::Block:
+                // The writer waits once it released the port
+                if (!queueFull) {
+                    blockedOut.fetch_add(1, std::memory_order_relaxed);
+                    room = queue.size();
+                }
+                break;
+            case Overflow::DropOldest:
+            case Overflow::KeepLatest: {
+                QueuedMessage& oldest = queue[queueHead];
+                dropped = oldest.tracker;
+                oldest.writer = nullptr;
+                oldest.tracker = nullptr;
+                queueHead = (queueHead + 1) % queue.size();
+                queueCount--;
+                break;
+            }
+            case Overflow::DropNewest:
+                break;
+            }
+        }
+        if (queueCount < room && !closing && !finished) {
+            QueuedMessage& last = queue[(queueHead + queueCount) % queue.size()];
+            last.writer = &writer;
+            last.tracker = tracker;
+            last.envelope.assign(envelopeString);
+            last.queuedAt = SystemClock::nowSystem();
+            queueCount++;
+            tracker = nullptr;
+            if (queueCount > queueCapacity) {
+                queueFull = true;
+                getOwner().setQueueFull(true);
+            }
+            if (!draining) {
+                draining = true;
+                schedule = true;
+            }
+        }
+    }
+
+    if (dropped != nullptr) {
+        yCDebug(PORTCOREOUTPUTUNIT, "dropping the oldest message in the queue");
+        droppedOut.fetch_add(1, std::memory_order_relaxed);
+        getOwner().notifyCompletion(dropped);
+    }
+    if (tracker != nullptr) {
+        yCDebug(PORTCOREOUTPUTUNIT, "skipping message, the queue is full");
+        droppedOut.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (schedule) {
+        wakeBackground();
+    }
+
+    // a tracker is returned only if the message was not queued
+    return tracker;
+}
+
+
+void PortCoreOutputUnit::sendQueue()
+{
+    std::string envelope;
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (queueCount > 0 && !closing) {
+        QueuedMessage& next = queue[queueHead];
+        const PortWriter* writer = next.writer;
+        envelope.swap(next.envelope);
+        void* tracker = next.tracker;
+        double start = next.queuedAt;
+        next.writer = nullptr;
+        next.tracker = nullptr;
+        queueHead = (queueHead + 1) % queue.size();
+        queueCount--;
+        checkQueueRoom();
+        lock.unlock();
+
+        queueTime.add(SystemClock::nowSystem() - start);
+        sendHelper(*writer, nullptr, envelope, tracker);
+        getOwner().notifyCompletion(tracker);
+        lock.lock();
+    }
+    draining = false;
+    // a failed write closes the connection, don't leave the writer waiting
+    checkQueueRoom();
+}
+
+
+void PortCoreOutputUnit::dropQueue()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    while (queueCount > 0) {
+        QueuedMessage& oldest = queue[queueHead];
+        getOwner().notifyCompletion(oldest.tracker);
+        oldest.writer = nullptr;
+        oldest.tracker = nullptr;
+        queueHead = (queueHead + 1) % queue.size();
+        queueCount--;
+    }
+    checkQueueRoom();
+}
+
+
+void PortCoreOutputUnit::checkQueueRoom()
+{
+    if (queueFull && (queueCount <= queueCapacity || closing || finished)) {
+        queueFull = false;
+        getOwner().setQueueFull(false);
+    }
+}
+
+
+bool PortCoreOutputUnit::acceptsBatches()
+{
+    // The 'b' command came with the version 1.3 of the administrative
+    // commands, an older receiver would not understand it.  The version
+    // is asked on the connection itself, so the answer is the one of the
+    // port that will get the batches.
+    Bottle cmd;
+    cmd.addVocab(Vocab::encode("ver"));
+    Bottle reply;
+    BufferedConnectionWriter buf(false, op->getConnection().isBareMode());
+    buf.setReplyHandler(reply);
+    if (!cmd.write(buf)) {
+        return false;
+    }
+    buf.addToHeader();
+    PortCommand pc('a', "");
+    pc.write(buf);
+    if (!op->write(buf) || !op->isOk()) {
+        return false;
+    }
+    if (reply.get(0).asVocab() != Vocab::encode("ver")) {
+        return false;
+    }
+    int major = reply.get(1).asInt32();
+    int minor = reply.get(2).asInt32();
+    return major > 1 || (major == 1 && minor >= 3);
+}
+
+
+double PortCoreOutputUnit::batchWait()
+{
+    if (closing || !coalesce) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(batchMutex);
+    if (batchCount == 0) {
+        return 0;
+    }
+    return batchStart + coalesceBudget - SystemClock::nowSystem();
+}
+
+
+bool PortCoreOutputUnit::sendBatch(bool background)
+{
+    // Taking the batch with the write lock keeps the messages in order
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (op == nullptr) {
+        return false;
+    }
+    batchMutex.lock();
+    if (batchCount == 0) {
+        if (background) {
+            flushing = false;
+        }
+        batchMutex.unlock();
+        return false;
+    }
+    BufferedConnectionWriter& batch = batches[pendingBatch];
+    int count = batchCount;
+    double start = batchStart;
+    pendingBatch = 1 - pendingBatch;
+    batches[pendingBatch].restart();
+    batchCount = 0;
+    batchMutex.unlock();
+
+    batch.addToHeader();
+    PortCommand pc('b', "");
+    pc.write(batch);
+    batch.appendInt32(count);
+
+    // The first message of the batch is the one that waited the longest
+    queueTime.add(SystemClock::nowSystem() - start);
+    if (op->getConnection().isActive()) {
+        op->write(batch);
+        if (op->isOk()) {
+            messagesOut.fetch_add(count, std::memory_order_relaxed);
+            bytesOut.fetch_add(batch.dataSize(), std::memory_order_relaxed);
+        }
+    }
+    if (!op->isOk()) {
+        closeBasic();
+        closing = true;
+        finished = true;
+        setDoomed();
+    }
+    return true;
+}
+
+
 void* PortCoreOutputUnit::takeTracker()
 {
     void* tracker = nullptr;
@@ -420,7 +970,14 @@ void* PortCoreOutputUnit::takeTracker()
 
 bool PortCoreOutputUnit::isBusy()
 {
-    return sending;
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        if (sending) {
+            return true;
+        }
+    }
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return draining;
 }
 
 void PortCoreOutputUnit::setCarrierParams(const yarp::os::Property& params)
@@ -441,3 +998,40 @@ OutputProtocol* PortCoreOutputUnit::getOutPutProtocol()
 {
     return op;
 }
+
+void PortCoreOutputUnit::getBufferStats(yarp::os::Property& stats) const
+{
+    stats.put("allocations", static_cast<int>(bufAllocations));
+    stats.put("pooled_bytes", static_cast<int>(bufPooled));
+    stats.put("high_water_mark", static_cast<int>(bufHighWater));
+}
+
+void PortCoreOutputUnit::getStats(yarp::os::Property& stats)
+{
+    int depth = 0;
+    if (coalesce) {
+        batchMutex.lock();
+        depth = batchCount;
+        batchMutex.unlock();
+    } else if (queueCapacity > 0) {
+        queueMutex.lock();
+        depth = static_cast<int>(queueCount);
+        queueMutex.unlock();
+    } else {
+        trackerMutex.lock();
+        depth = sending ? 1 : 0;
+        trackerMutex.unlock();
+    }
+    stats.put("messages", Value::makeInt64(static_cast<std::int64_t>(messagesOut.load(std::memory_order_relaxed))));
+    stats.put("bytes", Value::makeInt64(static_cast<std::int64_t>(bytesOut.load(std::memory_order_relaxed))));
+    stats.put("dropped", Value::makeInt64(static_cast<std::int64_t>(droppedOut.load(std::memory_order_relaxed))));
+    stats.put("queue_depth", depth);
+    if (queueCapacity > 0) {
+        static const char* const overflowNames[] = {"block", "drop_oldest", "drop_newest", "keep_latest"};
+        stats.put("queue_capacity", static_cast<int>(queueCapacity));
+        stats.put("overflow", overflowNames[static_cast<int>(overflow)]);
+        stats.put("blocked", Value::makeInt64(static_cast<std::int64_t>(blockedOut.load(std::memory_order_relaxed))));
+    }
+    serializeTime.report(stats.addGroup("serialize_time"));
+    queueTime.report(stats.addGroup("queue_time"));
+}
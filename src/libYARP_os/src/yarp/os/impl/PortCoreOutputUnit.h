@@ -12,10 +12,18 @@
 
 #include <yarp/os/OutputProtocol.h>
 #include <yarp/os/Semaphore.h>
+#include <yarp/os/impl/BufferedConnectionWriter.h>
+#include <yarp/os/impl/LatencyHistogram.h>
 #include <yarp/os/impl/PortCore.h>
+#include <yarp/os/impl/PortCoreReactor.h>
 #include <yarp/os/impl/PortCoreUnit.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace yarp {
 namespace os {
@@ -24,9 +32,34 @@ namespace impl {
 /**
  * Manager for a single output from a port.  Associated
  * with a PortCore object.
+ *
+ * Background writes are done by a dedicated thread, or by the threads of
+ * the PortCoreReactor when it is enabled.  A connection whose writes block
+ * a thread of the reactor for long (e.g. a slow peer) gets a dedicated
+ * thread.
+ *
+ * If the carrier of the connection has a "coalesce" modifier (e.g.
+ * "tcp+coalesce.200"), messages written in background are copied into a
+ * batch and sent together as a single message, that the input unit on
+ * the other side unpacks.  The first message of a batch waits at most the
+ * number of microseconds given by the modifier; the messages that arrive
+ * while a batch is being sent go in the next one.  The receiver is asked
+ * first if it understands batches, if it does not the messages are sent
+ * one by one.
+ *
+ * If the carrier has a "queue" modifier (e.g. "tcp+queue.8"), up to that
+ * number of messages written in background wait for their turn instead
+ * of being skipped while the connection is busy.  The "overflow" modifier
+ * chooses what happens when the queue is full: "block" the writer,
+ * "drop_oldest" waiting message, "drop_newest" (the one being written, the
+ * default), or "keep_latest" (only the newest message waits, whatever the
+ * size of the queue).  A blocked writer puts its message in a spare entry
+ * of the queue, and waits for room after releasing the port (see
+ * PortCore::setQueueFull()).
  */
 class PortCoreOutputUnit :
-        public PortCoreUnit
+        public PortCoreUnit,
+        public PortCoreReactor::Handler
 {
 public:
     /**
@@ -55,6 +88,11 @@ public:
      */
     void run() override;
 
+    /**
+     * Called by the reactor to do a background send.
+     */
+    void handleEvent() override;
+
     /**
      * Perform send operations without a separate thread.
      */
@@ -106,15 +144,30 @@ public:
     // return the protocol object
     OutputProtocol* getOutPutProtocol();
 
+    /**
+     * Get the memory usage of the buffer used to serialize the messages
+     * sent on this connection ("allocations", "pooled_bytes" and
+     * "high_water_mark", see BufferedConnectionWriter).
+     */
+    void getBufferStats(yarp::os::Property& stats) const;
+
+    // documented in PortCoreUnit
+    void getStats(yarp::os::Property& stats) override;
+
 private:
     OutputProtocol *op; ///< protocol object for writing/reading
-    bool closing;       ///< should this connection close
+    std::atomic<bool> closing; ///< should this connection close
     bool finished;      ///< has this connection finished
     bool running;       ///< is a thread running
     bool threaded;      ///< do we need a thread for background writing
-    bool sending;       ///< are we sending something right now
+    bool reactive;      ///< are background writes done by the reactor
+    bool sending;       ///< are we sending something right now, protected by trackerMutex
     yarp::os::Semaphore phase;        ///< let main thread kick sending thread
     yarp::os::Semaphore activate;     ///< signal when we have a new tracker
+    std::mutex reactorMutex; ///< protect the state of the background writes
+    std::condition_variable reactorIdle; ///< signal when the reactor is done
+    bool posted;             ///< the reactor has background writes to do
+    bool reposted;           ///< more writes came while the reactor was busy
     std::mutex trackerMutex; ///< protect the tracker during outside access
     const yarp::os::PortWriter* cachedWriter;   ///< the message the send
     yarp::os::PortReader *cachedReader;   ///< where to put a reply
@@ -122,11 +175,143 @@ private:
                                           ///< completion events
     void *cachedTracker;        ///< memory tracker for current message
     std::string cachedEnvelope;      ///< some text to pass along with the message
+    BufferedConnectionWriter sendBuffer; ///< reused to serialize each message
+    std::atomic<size_t> bufAllocations;  ///< copy of sendBuffer.allocationCount()
+    std::atomic<size_t> bufPooled;       ///< copy of sendBuffer.pooledSize()
+    std::atomic<size_t> bufHighWater;    ///< copy of sendBuffer.pooledHighWaterMark()
+    std::mutex writeMutex;   ///< keep writes of batches and single messages apart
+    bool coalesce;           ///< are background messages sent in batches
+    double coalesceBudget;   ///< how long a batch waits for more messages [s]
+    std::mutex batchMutex;   ///< protect the pending batch
+    bool flushing;           ///< a background send of the batches is scheduled
+    double batchStart;       ///< when the first message of the pending batch came
+    int batchCount;          ///< number of messages in the pending batch
+    int pendingBatch;        ///< which of the batches is collecting messages
+    BufferedConnectionWriter batches[2]; ///< pending batch, and batch being sent
+    BufferedConnectionWriter itemBuffer; ///< reused to serialize each message of a batch
+    std::atomic<std::uint64_t> messagesOut; ///< messages written
+    std::atomic<std::uint64_t> bytesOut;    ///< bytes written
+    std::atomic<std::uint64_t> droppedOut;  ///< messages skipped because the connection was busy
+    std::atomic<std::uint64_t> blockedOut;  ///< writes that waited for room in the queue
+    double queuedAt;                    ///< when the cached message was left to the background
+    LatencyHistogram serializeTime;     ///< time spent serializing each message
+    LatencyHistogram queueTime;         ///< time spent by each message waiting to be written
+
+    /**
+     * What to do with a message written in background when the queue of
+     * the connection is full.
+     */
+    enum class Overflow
+    {
+        Block,
+        DropOldest,
+        DropNewest,
+        KeepLatest
+    };
+
+    /**
+     * A message waiting in the queue.  The tracker keeps the message alive
+     * until it is sent or dropped.
+     */
+    struct QueuedMessage
+    {
+        const yarp::os::PortWriter* writer{nullptr};
+        void* tracker{nullptr};
+        std::string envelope;
+        double queuedAt{0.0};
+    };
+
+    size_t queueCapacity;    ///< messages that can wait, 0 if there is no queue
+    Overflow overflow;       ///< what to do when the queue is full
+    std::mutex queueMutex;   ///< protect the queue
+    std::vector<QueuedMessage> queue;   ///< ring of waiting messages, allocated once
+    size_t queueHead;        ///< first message in the ring
+    size_t queueCount;       ///< number of messages in the ring
+    bool queueFull;          ///< a blocked writer took the spare entry
+    bool draining;           ///< the queue is being sent
 
     /**
      * The core logic for sending a message.
+     * @param writer the message
+     * @param reader where to put the reply, or nullptr
+     * @param envelope some text to pass along with the message
+     * @param tracker the packet of the message, whose TransformCache is
+     * the current one while the message is sent
+     */
+    bool sendHelper(const yarp::os::PortWriter& writer,
+                    yarp::os::PortReader* reader,
+                    const std::string& envelope,
+                    void* tracker);
+
+    /**
+     * Send the cached message and notify its completion.
+     */
+    void sendInBackground();
+
+    /**
+     * Copy a message at the end of the pending batch.
+     */
+    void* sendCoalesced(const yarp::os::PortWriter& writer,
+                        void* tracker,
+                        const std::string& envelopeString,
+                        bool waitAfter);
+
+    /**
+     * Put a message written in background in the queue, applying the
+     * overflow policy when the queue is full.
+     */
+    void* sendQueued(const yarp::os::PortWriter& writer,
+                     void* tracker,
+                     const std::string& envelopeString);
+
+    /**
+     * Send the queued messages until the queue is empty.
+     */
+    void sendQueue();
+
+    /**
+     * Notify the completion of all the messages still in the queue.
+     */
+    void dropQueue();
+
+    /**
+     * Let the blocked writer go on when the queue has room again, or when
+     * the connection is closing.  Must be called with queueMutex locked.
+     */
+    void checkQueueRoom();
+
+    /**
+     * Ask the receiver if it understands coalesced messages.
+     * @return true if it does
+     */
+    bool acceptsBatches();
+
+    /**
+     * @return the time [s] the pending batch can still wait for more
+     * messages, 0 or less if it must be sent now.
+     */
+    double batchWait();
+
+    /**
+     * Send the pending batch, if there is one.
+     *
+     * @param background true when called by the background sender, that
+     * stops being scheduled when nothing is left to send
+     * @return true if a batch was sent
+     */
+    bool sendBatch(bool background);
+
+    /**
+     * Make sure that a thread or the reactor is available for background
+     * writes.
+     */
+    void prepareBackground();
+
+    /**
+     * Have the thread or the reactor do the background writes.  This never
+     * waits for the writes in progress.
      */
-    bool sendHelper();
+    void wakeBackground();
 
     /**
      * Try to close the connection, but not very hard.
@@ -12,6 +12,9 @@
 
 #include <yarp/os/NetType.h>
 #include <yarp/os/PortWriter.h>
+#include <yarp/os/TransformCache.h>
+
+#include <atomic>
 
 namespace yarp {
 namespace os {
@@ -24,14 +27,15 @@ namespace impl {
 class PortCorePacket
 {
 public:
-    PortCorePacket* prev_;                ///< this packet will be in a list of active packets
-    PortCorePacket* next_;                ///< this packet will be in a list of active packets
+    PortCorePacket* prev_;                ///< unused
+    PortCorePacket* next_;                ///< next packet in the list of inactive packets
     const yarp::os::PortWriter* content;  ///< the object being sent
     const yarp::os::PortWriter* callback; ///< where to send event notifications
-    int ct;                               ///< number of uses of the messagae
+    std::atomic<int> ct;                  ///< number of uses of the messagae
     bool owned;                           ///< should we memory-manage the content object
     bool ownedCallback;                   ///< should we memory-manage the callback object
     bool completed;                       ///< has a notification of completion been sent
+    yarp::os::TransformCache transforms;  ///< results of the transformations of the content, shared by the connections
 
     /**
      * Constructor.
@@ -63,7 +67,7 @@ public:
      */
     int getCount()
     {
-        return ct;
+        return ct.load();
     }
 
     /**
@@ -76,10 +80,12 @@ public:
 
     /**
      * Decrement the usage count for this messagae.
+     *
+     * @return the number of users left, only one thread sees it reach 0.
      */
-    void dec()
+    int dec()
     {
-        ct--;
+        return --ct;
     }
 
     /**
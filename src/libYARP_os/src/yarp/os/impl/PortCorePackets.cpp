@@ -11,48 +11,101 @@
 
 #include <yarp/os/impl/LogComponent.h>
 
+#include <algorithm>
+
 using yarp::os::impl::PortCorePacket;
 using yarp::os::impl::PortCorePackets;
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTCOREPACKETS, "yarp.os.impl.PortCorePackets")
+
+// Number of packets allocated together
+constexpr size_t blockSize = 16;
 } // namespace
 
-PortCorePackets::~PortCorePackets()
+PortCorePackets::~PortCorePackets() = default;
+
+size_t PortCorePackets::getCount()
 {
-    while (!inactive.empty()) {
-        delete inactive.back();
-        inactive.pop_back();
-    }
-    while (!active.empty()) {
-        delete active.back();
-        active.pop_back();
-    }
+    return active.load();
 }
 
-size_t PortCorePackets::getCount()
+size_t PortCorePackets::getAllocatedCount() const
+{
+    return allocated.load();
+}
+
+size_t PortCorePackets::getPeakCount() const
+{
+    return peak.load();
+}
+
+size_t PortCorePackets::getDroppedCount() const
+{
+    return dropped.load();
+}
+
+size_t PortCorePackets::getTransformHits() const
 {
-    return active.size();
+    return transformHits.load();
+}
+
+size_t PortCorePackets::getTransformMisses() const
+{
+    return transformMisses.load();
+}
+
+void PortCorePackets::setCapacity(size_t capacity)
+{
+    this->capacity = capacity;
+}
+
+size_t PortCorePackets::getCapacity() const
+{
+    return capacity;
 }
 
 PortCorePacket* PortCorePackets::getFreePacket()
 {
-    if (inactive.empty()) {
-        PortCorePacket* obj = nullptr;
-        obj = new PortCorePacket();
-        yCAssert(PORTCOREPACKETS, obj != nullptr);
-        inactive.push_back(obj);
+    // There is only one thread taking packets, so the head cannot be taken
+    // and put back while we look at it.
+    PortCorePacket* next = inactive.load(std::memory_order_acquire);
+    while (next != nullptr && !inactive.compare_exchange_weak(next, next->next_, std::memory_order_acquire)) {
+        // another thread freed a packet meanwhile, try again
     }
-    PortCorePacket* next = inactive.front();
+
     if (next == nullptr) {
-        yCError(PORTCOREPACKETS, "*** YARP consistency check failed.\n");
-        yCError(PORTCOREPACKETS, "*** There has been a low-level failure in \"PortCorePackets\".\n");
-        yCError(PORTCOREPACKETS, "*** This typically occurs when ports are accessed in a non-threadsafe way.\n");
-        yCError(PORTCOREPACKETS, "*** For help: https://github.com/robotology/yarp/issues/new\n");
+        size_t count = blockSize;
+        if (capacity > 0) {
+            if (allocated >= capacity) {
+                dropped++;
+                yCDebug(PORTCOREPACKETS, "all the %zu packets are in use", capacity);
+                return nullptr;
+            }
+            count = std::min(count, capacity - allocated);
+        }
+        std::unique_ptr<PortCorePacket[]> block(new PortCorePacket[count]);
+        yCAssert(PORTCOREPACKETS, block != nullptr);
+        // Keep the first packet, the others are inactive
+        for (size_t i = 1; i < count; i++) {
+            block[i].next_ = (i + 1 < count) ? &block[i + 1] : nullptr;
+        }
+        if (count > 1) {
+            PortCorePacket* head = inactive.load(std::memory_order_relaxed);
+            do {
+                block[count - 1].next_ = head;
+            } while (!inactive.compare_exchange_weak(head, &block[1], std::memory_order_release, std::memory_order_relaxed));
+        }
+        next = &block[0];
+        blocks.push_back(std::move(block));
+        allocated += count;
+    }
+
+    next->next_ = nullptr;
+    size_t now = ++active;
+    if (now > peak.load()) {
+        peak = now;
     }
-    yCAssert(PORTCOREPACKETS, next != nullptr);
-    inactive.remove(next);
-    active.push_back(next);
     return next;
 }
 
@@ -62,9 +115,15 @@ void PortCorePackets::freePacket(PortCorePacket* packet, bool clear)
         if (clear) {
             packet->reset();
         }
+        transformHits += packet->transforms.getHits();
+        transformMisses += packet->transforms.getMisses();
+        packet->transforms.clear();
         packet->completed = true;
-        active.remove(packet);
-        inactive.push_back(packet);
+        active--;
+        PortCorePacket* head = inactive.load(std::memory_order_relaxed);
+        do {
+            packet->next_ = head;
+        } while (!inactive.compare_exchange_weak(head, packet, std::memory_order_release, std::memory_order_relaxed));
     }
 }
 
@@ -79,10 +138,11 @@ bool PortCorePackets::completePacket(PortCorePacket* packet)
     return false;
 }
 
-bool PortCorePackets::checkPacket(PortCorePacket* packet)
+bool PortCorePackets::releasePacket(PortCorePacket* packet)
 {
     if (packet != nullptr) {
-        if (packet->getCount() <= 0) {
+        // Only the last user sees the count reach zero
+        if (packet->dec() <= 0) {
             packet->complete();
             freePacket(packet);
             return true;
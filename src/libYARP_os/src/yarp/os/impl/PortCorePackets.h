@@ -14,7 +14,9 @@
 
 #include <yarp/os/Log.h>
 
-#include <list>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace yarp {
 namespace os {
@@ -24,12 +26,26 @@ namespace impl {
  * A collection of messages being transmitted over connections.
  * This tracks uses of the messages for memory management purposes.
  * We call messages "packets" for no particular reason.
+ *
+ * Packets are allocated in blocks and never freed until the collection is
+ * destroyed.  The inactive packets are kept in a lock-free list, linked
+ * through PortCorePacket::next_, so that packets can be freed from any
+ * thread without locks or allocations.  Only one thread at a time may
+ * call getFreePacket().
  */
 class PortCorePackets
 {
 private:
-    std::list<PortCorePacket*> inactive; // unused packets we may reuse
-    std::list<PortCorePacket*> active;   // a list of packets being sent
+    std::atomic<PortCorePacket*> inactive {nullptr};       // unused packets we may reuse
+    std::vector<std::unique_ptr<PortCorePacket[]>> blocks; // all the packets
+    std::atomic<size_t> allocated {0};                     // number of packets in the blocks
+    size_t capacity {0};                                   // maximum number of packets, 0 for no limit
+    std::atomic<size_t> active {0};                        // number of packets being sent
+    std::atomic<size_t> peak {0};                          // maximum number of packets being sent
+    std::atomic<size_t> dropped {0};                       // number of times no packet was available
+    std::atomic<size_t> transformHits {0};                 // transformations shared by the connections
+    std::atomic<size_t> transformMisses {0};               // transformations run
+
 public:
     virtual ~PortCorePackets();
 
@@ -38,18 +54,60 @@ public:
      */
     size_t getCount();
 
+    /**
+     * @return the number of packets created.
+     */
+    size_t getAllocatedCount() const;
+
+    /**
+     * @return the maximum number of packets that were being sent at the
+     * same time.
+     */
+    size_t getPeakCount() const;
+
+    /**
+     * @return how many times getFreePacket() failed because the capacity
+     * was reached.
+     */
+    size_t getDroppedCount() const;
+
+    /**
+     * @return how many times a connection found the transformation of a
+     * message (e.g. its compression) in the TransformCache of its packet.
+     */
+    size_t getTransformHits() const;
+
+    /**
+     * @return how many transformations of the messages were run.
+     */
+    size_t getTransformMisses() const;
+
+    /**
+     * Limit the number of packets that can be created.
+     *
+     * @param capacity the maximum number of packets, 0 for no limit
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * @return the maximum number of packets, 0 if there is no limit.
+     */
+    size_t getCapacity() const;
+
     /**
      * Get a packet that we can prepare for sending.  If a previously sent
      * packet that is not being used is available, we take that.  Otherwise
      * we create one.
      *
-     * @return an unused or freshly created packet
+     * @return an unused or freshly created packet, or nullptr if all the
+     * packets allowed by the capacity are being sent
      */
     PortCorePacket* getFreePacket();
 
     /**
-     * Force the given packet into an inactive state.  See checkPacket() for
-     * a less drastic way to nudge a packet onwards in its lifecycle.
+     * Force the given packet into an inactive state.  See releasePacket()
+     * for a less drastic way to nudge a packet onwards in its lifecycle.
+     * The TransformCache of the packet is emptied.
      * @param packet the packet to work on
      * @param clear whether to reset the contents of the packet
      */
@@ -64,12 +122,12 @@ public:
     bool completePacket(PortCorePacket* packet);
 
     /**
-     * Move a packet to the inactive state if it has finished being
-     * sent on all connections.
+     * Decrement the usage count of a packet, and move it to the inactive
+     * state if it has finished being sent on all connections.
      * @param packet the packet to work on
      * @return true if the packet was made inactive
      */
-    bool checkPacket(PortCorePacket* packet);
+    bool releasePacket(PortCorePacket* packet);
 };
 
 
@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCoreReactor.h>
+
+#include <yarp/conf/environment.h>
+
+#include <yarp/os/NetType.h>
+#include <yarp/os/impl/LogComponent.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__)
+#    include <cerrno>
+#    include <cstring>
+#    include <sys/epoll.h>
+#    include <sys/eventfd.h>
+#    include <unistd.h>
+#endif
+
+using yarp::os::impl::PortCoreReactor;
+
+namespace {
+YARP_OS_LOG_COMPONENT(PORTCOREREACTOR, "yarp.os.impl.PortCoreReactor")
+
+#if defined(__linux__)
+// Identifier used in the epoll set for the posted handlers
+constexpr std::uint64_t postedId = 0;
+#endif
+} // namespace
+
+
+constexpr double PortCoreReactor::blockedHandlerDelay;
+
+
+class PortCoreReactor::Private
+{
+public:
+    struct Entry
+    {
+        Handler* handler;
+        int fd;
+        bool busy;  // a pool thread is calling the handler
+        bool rearm; // rearm requested while busy
+    };
+
+    struct Worker
+    {
+        std::thread thread;
+        std::chrono::steady_clock::time_point busySince;
+        bool busy {false};    // calling a handler
+        bool retired {false}; // replaced, it leaves when its handler returns
+        bool done {false};    // left, it can be joined
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::uint64_t, Entry> entries;
+    std::deque<Handler*> queue;
+    std::multimap<std::chrono::steady_clock::time_point, Handler*> timers;
+    std::list<Worker> workers;
+    size_t active {0};
+    std::thread monitor;
+    std::condition_variable monitorWake;
+    size_t wanted {0};
+    std::uint64_t nextId {1};
+    bool stopping {false};
+    int epfd {-1};
+    int wakefd {-1};
+
+    Private()
+    {
+        std::string threads = yarp::conf::environment::getEnvironment("YARP_PORT_REACTOR_THREADS");
+        if (!threads.empty()) {
+            int count = yarp::os::NetType::toInt(threads);
+            wanted = (count > 0) ? static_cast<size_t>(count) : 0;
+        }
+#if defined(__linux__)
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        wakefd = eventfd(0, EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epfd < 0 || wakefd < 0) {
+            yCError(PORTCOREREACTOR, "cannot create the epoll set: %s", strerror(errno));
+            wanted = 0;
+            return;
+        }
+        epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u64 = postedId;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, wakefd, &ev);
+#else
+        wanted = 0;
+#endif
+    }
+
+    ~Private()
+    {
+#if defined(__linux__)
+        if (epfd >= 0) {
+            ::close(epfd);
+        }
+        if (wakefd >= 0) {
+            ::close(wakefd);
+        }
+#endif
+    }
+
+    // Must be called with the mutex locked
+    void startWorkers()
+    {
+        while (active < wanted) {
+            workers.emplace_back();
+            Worker& worker = workers.back();
+            worker.thread = std::thread(&Private::run, this, &worker);
+            active++;
+        }
+        if (!monitor.joinable()) {
+            monitor = std::thread(&Private::watchWorkers, this);
+        }
+    }
+
+    // Must be called with the mutex locked
+    void setBusy(Worker& worker)
+    {
+        worker.busy = true;
+        worker.busySince = std::chrono::steady_clock::now();
+    }
+
+    // Must be called with the mutex locked.
+    // Returns false if the worker must leave the pool.
+    bool setIdle(Worker& worker)
+    {
+        worker.busy = false;
+        if (worker.retired) {
+            worker.done = true;
+            return false;
+        }
+        return true;
+    }
+
+    // A handler that doesn't return (e.g. reading a message from a slow
+    // peer) would keep the other connections waiting once all the threads
+    // are busy.  Its thread is replaced in the pool, and leaves it when
+    // the handler returns.
+    // The handlers posted with a delay are queued when their time comes.
+    void watchWorkers()
+    {
+        const auto delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(blockedHandlerDelay));
+        std::unique_lock<std::mutex> lock(mutex);
+        auto nextCheck = std::chrono::steady_clock::now() + delay;
+        while (!stopping) {
+            auto until = nextCheck;
+            if (!timers.empty() && timers.begin()->first < until) {
+                until = timers.begin()->first;
+            }
+            monitorWake.wait_until(lock, until);
+            if (stopping) {
+                break;
+            }
+            auto now = std::chrono::steady_clock::now();
+            std::uint64_t due = 0;
+            while (!timers.empty() && timers.begin()->first <= now) {
+                queue.push_back(timers.begin()->second);
+                timers.erase(timers.begin());
+                due++;
+            }
+            wake(due);
+            if (now < nextCheck) {
+                continue;
+            }
+            nextCheck = now + delay;
+            for (auto it = workers.begin(); it != workers.end();) {
+                if (it->done) {
+                    it->thread.join();
+                    it = workers.erase(it);
+                    continue;
+                }
+                if (it->busy && !it->retired && now - it->busySince > delay) {
+                    yCDebug(PORTCOREREACTOR, "a handler is blocked, starting another thread");
+                    it->retired = true;
+                    active--;
+                }
+                ++it;
+            }
+            startWorkers();
+        }
+    }
+
+    void wake(std::uint64_t count)
+    {
+#if defined(__linux__)
+        for (std::uint64_t i = 0; i < count; i++) {
+            std::uint64_t one = 1;
+            if (::write(wakefd, &one, sizeof(one)) != sizeof(one)) {
+                yCError(PORTCOREREACTOR, "cannot wake the pool: %s", strerror(errno));
+            }
+        }
+#else
+        YARP_UNUSED(count);
+#endif
+    }
+
+    // Must be called with the mutex locked
+    bool arm(Entry& entry, std::uint64_t id, int op)
+    {
+#if defined(__linux__)
+        epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.u64 = id;
+        if (epoll_ctl(epfd, op, entry.fd, &ev) != 0) {
+            yCDebug(PORTCOREREACTOR, "cannot watch descriptor %d: %s", entry.fd, strerror(errno));
+            return false;
+        }
+        return true;
+#else
+        YARP_UNUSED(entry);
+        YARP_UNUSED(id);
+        YARP_UNUSED(op);
+        return false;
+#endif
+    }
+
+    // Returns false if the worker must leave the pool
+    bool runPosted(Worker& worker)
+    {
+#if defined(__linux__)
+        std::uint64_t token;
+        if (::read(wakefd, &token, sizeof(token)) != sizeof(token)) {
+            // Another thread got it
+            return true;
+        }
+#endif
+        Handler* handler = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queue.empty()) {
+                return true;
+            }
+            handler = queue.front();
+            queue.pop_front();
+            setBusy(worker);
+        }
+        handler->handleEvent();
+        std::lock_guard<std::mutex> lock(mutex);
+        return setIdle(worker);
+    }
+
+    // Returns false if the worker must leave the pool
+    bool runWatched(Worker& worker, std::uint64_t id)
+    {
+        Handler* handler = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(id);
+            if (it == entries.end()) {
+                // Stale event for a registration that was removed
+                return true;
+            }
+            it->second.busy = true;
+            it->second.rearm = false;
+            handler = it->second.handler;
+            setBusy(worker);
+        }
+
+        handler->handleEvent();
+
+        // If the registration was removed meanwhile, whoever removed it
+        // takes care of the handler.
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it != entries.end()) {
+            Entry& entry = it->second;
+            entry.busy = false;
+#if defined(__linux__)
+            if (entry.rearm) {
+                arm(entry, id, EPOLL_CTL_MOD);
+            }
+#endif
+            entry.rearm = false;
+        }
+        return setIdle(worker);
+    }
+
+    void run(Worker* worker)
+    {
+#if defined(__linux__)
+        while (true) {
+            // One event at a time, so that a slow handler doesn't delay
+            // the events that another thread could serve.
+            epoll_event ev;
+            int n = epoll_wait(epfd, &ev, 1, -1);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                yCError(PORTCOREREACTOR, "epoll_wait failed: %s", strerror(errno));
+                return;
+            }
+            if (n == 0) {
+                continue;
+            }
+            if (ev.data.u64 == postedId) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (stopping) {
+                        return;
+                    }
+                }
+                if (!runPosted(*worker)) {
+                    return;
+                }
+            } else if (!runWatched(*worker, ev.data.u64)) {
+                return;
+            }
+        }
+#else
+        YARP_UNUSED(worker);
+#endif
+    }
+};
+
+
+PortCoreReactor::Handler::~Handler() = default;
+
+
+PortCoreReactor::PortCoreReactor() :
+        mPriv(new Private)
+{
+}
+
+PortCoreReactor::~PortCoreReactor()
+{
+    std::list<Private::Worker> workers;
+    std::thread monitor;
+    size_t active = 0;
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        mPriv->stopping = true;
+        workers.swap(mPriv->workers);
+        monitor.swap(mPriv->monitor);
+        active = mPriv->active;
+    }
+    mPriv->wake(active);
+    mPriv->monitorWake.notify_all();
+    if (monitor.joinable()) {
+        monitor.join();
+    }
+    for (auto& worker : workers) {
+        worker.thread.join();
+    }
+    delete mPriv;
+}
+
+PortCoreReactor& PortCoreReactor::getInstance()
+{
+    static PortCoreReactor instance;
+    return instance;
+}
+
+bool PortCoreReactor::isAvailable()
+{
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PortCoreReactor::isEnabled() const
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    return mPriv->wanted > 0;
+}
+
+void PortCoreReactor::setThreadCount(size_t count)
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    if (!isAvailable() || mPriv->epfd < 0) {
+        return;
+    }
+    mPriv->wanted = count;
+}
+
+size_t PortCoreReactor::getThreadCount() const
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    return mPriv->active;
+}
+
+size_t PortCoreReactor::getWatchCount() const
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    return mPriv->entries.size();
+}
+
+std::uint64_t PortCoreReactor::watch(int fd, Handler* handler)
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    if (mPriv->wanted == 0 || mPriv->stopping) {
+        return 0;
+    }
+    mPriv->startWorkers();
+    std::uint64_t id = mPriv->nextId++;
+    Private::Entry& entry = mPriv->entries[id];
+    entry = Private::Entry{handler, fd, false, false};
+#if defined(__linux__)
+    if (!mPriv->arm(entry, id, EPOLL_CTL_ADD)) {
+        mPriv->entries.erase(id);
+        return 0;
+    }
+#endif
+    return id;
+}
+
+bool PortCoreReactor::rearm(std::uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    auto it = mPriv->entries.find(id);
+    if (it == mPriv->entries.end()) {
+        return false;
+    }
+    Private::Entry& entry = it->second;
+    if (entry.busy) {
+        // The thread calling the handler rearms it after it returns,
+        // so that the handler is never called twice at the same time.
+        entry.rearm = true;
+        return true;
+    }
+#if defined(__linux__)
+    return mPriv->arm(entry, id, EPOLL_CTL_MOD);
+#else
+    return false;
+#endif
+}
+
+bool PortCoreReactor::unwatch(std::uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    auto it = mPriv->entries.find(id);
+    if (it == mPriv->entries.end()) {
+        return false;
+    }
+    Private::Entry& entry = it->second;
+#if defined(__linux__)
+    epoll_ctl(mPriv->epfd, EPOLL_CTL_DEL, entry.fd, nullptr);
+#endif
+    // A handler that asked to be rearmed is done with this event
+    bool waiting = !entry.busy || entry.rearm;
+    mPriv->entries.erase(it);
+    return waiting;
+}
+
+bool PortCoreReactor::post(Handler* handler)
+{
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        if (mPriv->wanted == 0 || mPriv->stopping) {
+            return false;
+        }
+        mPriv->startWorkers();
+        mPriv->queue.push_back(handler);
+    }
+    mPriv->wake(1);
+    return true;
+}
+
+bool PortCoreReactor::post(Handler* handler, double delay)
+{
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        if (mPriv->wanted == 0 || mPriv->stopping) {
+            return false;
+        }
+        mPriv->startWorkers();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(delay));
+        bool earliest = mPriv->timers.empty() || deadline < mPriv->timers.begin()->first;
+        mPriv->timers.emplace(deadline, handler);
+        if (!earliest) {
+            return true;
+        }
+    }
+    // The monitor may be waiting for a later time
+    mPriv->monitorWake.notify_all();
+    return true;
+}
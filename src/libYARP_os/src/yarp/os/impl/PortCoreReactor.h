@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_PORTCOREREACTOR_H
+#define YARP_OS_IMPL_PORTCOREREACTOR_H
+
+#include <yarp/os/api.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * A small pool of threads shared by the connections of all the ports of
+ * the process.
+ *
+ * By default each input connection of a port is served by its own thread,
+ * and so is each output connection that sends messages in background.
+ * When the reactor is enabled, input connections based on sockets wait
+ * for data on a single epoll set, and the pool threads read a message
+ * from a connection only when it is available.  Background writes are
+ * queued to the same threads.
+ *
+ * The reactor is enabled by setting the YARP_PORT_REACTOR_THREADS
+ * environment variable to the number of threads of the pool, or by
+ * calling setThreadCount().  It is available only on Linux.
+ *
+ * A handler that blocks for a long time (e.g. a port that waits for the
+ * user to read each message) keeps a pool thread busy, therefore only the
+ * connections that don't need it should be handed to the reactor.  When a
+ * handler runs for longer than blockedHandlerDelay (e.g. it is reading from
+ * a slow peer), its thread is replaced in the pool, so that the other
+ * connections are still served; the connection should then leave the
+ * reactor and use a thread of its own.
+ */
+class YARP_os_impl_API PortCoreReactor
+{
+public:
+    /**
+     * Something that is called by a pool thread.
+     */
+    class YARP_os_impl_API Handler
+    {
+    public:
+        virtual ~Handler();
+
+        /**
+         * Called when the descriptor being watched is ready to be read,
+         * or when the handler was queued with post().
+         */
+        virtual void handleEvent() = 0;
+    };
+
+    /**
+     * Time [s] after which a running handler is considered blocked.
+     */
+    static constexpr double blockedHandlerDelay = 0.1;
+
+    static PortCoreReactor& getInstance();
+
+    /**
+     * @return true if the platform supports the reactor.
+     */
+    static bool isAvailable();
+
+    /**
+     * @return true if new connections should be handed to the reactor.
+     */
+    bool isEnabled() const;
+
+    /**
+     * Set the number of threads of the pool.  Threads already running are
+     * never stopped, 0 disables the reactor for new connections.
+     */
+    void setThreadCount(size_t count);
+
+    /**
+     * @return the number of threads of the pool that are running, not
+     * counting the ones replaced because their handler was blocked.
+     */
+    size_t getThreadCount() const;
+
+    /**
+     * @return the number of descriptors being watched.
+     */
+    size_t getWatchCount() const;
+
+    /**
+     * Call handler->handleEvent() once, from a pool thread, the next time
+     * the descriptor is ready to be read.
+     *
+     * @return an identifier of the registration, or 0 on failure.
+     */
+    std::uint64_t watch(int fd, Handler* handler);
+
+    /**
+     * Wait again for the descriptor of a registration. Usually called by
+     * the handler at the end of handleEvent().
+     *
+     * @return false if the registration doesn't exist anymore.
+     */
+    bool rearm(std::uint64_t id);
+
+    /**
+     * Remove a registration.  This does not wait for a handler that is
+     * running, so the descriptor must not be closed before calling this.
+     *
+     * @return true if the registration existed and it was waiting for the
+     * descriptor (i.e. the handler will not be called anymore), false if
+     * it didn't exist or its handler is running.
+     */
+    bool unwatch(std::uint64_t id);
+
+    /**
+     * Call handler->handleEvent() once, from a pool thread, as soon as
+     * possible.  The handler must stay valid until then.
+     *
+     * @return false if the reactor is not available.
+     */
+    bool post(Handler* handler);
+
+    /**
+     * Call handler->handleEvent() once, from a pool thread, after a delay,
+     * without keeping a thread busy meanwhile.  The handler must stay valid
+     * until then.
+     *
+     * @param delay time to wait [s]
+     * @return false if the reactor is not available.
+     */
+    bool post(Handler* handler, double delay);
+
+private:
+    PortCoreReactor();
+    ~PortCoreReactor();
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    class Private;
+    Private* const mPriv;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_PORTCOREREACTOR_H
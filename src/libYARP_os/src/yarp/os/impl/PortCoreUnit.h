@@ -271,6 +271,17 @@ public:
         YARP_UNUSED(params);
     }
 
+    /**
+     * Describe the traffic of this connection: messages and bytes
+     * transferred, and histograms of the time spent by the messages.
+     *
+     * @param [out]stats the statistics of the connection
+     */
+    virtual void getStats(yarp::os::Property& stats)
+    {
+        YARP_UNUSED(stats);
+    }
+
 
 protected:
     /**
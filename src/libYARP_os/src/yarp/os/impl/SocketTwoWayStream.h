@@ -29,6 +29,8 @@
 #    include <netinet/tcp.h>
 #endif
 
+#include <vector>
+
 YARP_DECLARE_LOG_COMPONENT(SOCKETTWOWAYSTREAM)
 
 namespace yarp {
@@ -161,6 +163,30 @@ public:
         }
     }
 
+    void writeBlocks(const Bytes* blocks, size_t count) override
+    {
+        if (!isOk()) {
+            return;
+        }
+        // The whole list goes out with a single writev/sendmsg, unless
+        // the socket accepts only part of it.
+        iov.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            iov[i].iov_base = const_cast<char*>(blocks[i].get());
+            iov[i].iov_len = blocks[i].length();
+        }
+        yarp::conf::ssize_t result;
+        if (haveWriteTimeout) {
+            result = stream.sendv_n(iov.data(), static_cast<int>(count), &writeTimeout);
+        } else {
+            result = stream.sendv_n(iov.data(), static_cast<int>(count));
+        }
+        if (result < 0) {
+            happy = false;
+            yCDebug(SOCKETTWOWAYSTREAM, "bad socket write");
+        }
+    }
+
     void flush() override
     {
 #ifdef TCP_CORK
@@ -230,6 +256,16 @@ public:
     bool setTypeOfService(int tos) override;
     int getTypeOfService() override;
 
+#if !defined(_WIN32)
+    /**
+     * @return the descriptor of the socket
+     */
+    int getHandle()
+    {
+        return stream.get_handle();
+    }
+#endif
+
 private:
     yarp::os::impl::TcpStream stream;
     bool haveWriteTimeout;
@@ -238,6 +274,7 @@ private:
     YARP_timeval readTimeout;
     Contact localAddress, remoteAddress;
     bool happy;
+    std::vector<iovec> iov;
     void updateAddresses();
 };
 
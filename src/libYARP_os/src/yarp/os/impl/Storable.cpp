@@ -29,6 +29,7 @@ using yarp::os::ConnectionWriter;
 using yarp::os::Value;
 using yarp::os::impl::BottleImpl;
 using yarp::os::impl::Storable;
+using yarp::os::impl::StorableArena;
 using yarp::os::impl::StoreBlob;
 using yarp::os::impl::StoreDict;
 using yarp::os::impl::StoreFloat32;
@@ -44,6 +45,17 @@ using yarp::os::impl::StoreVocab;
 
 YARP_OS_LOG_COMPONENT(STORABLE, "yarp.os.impl.Storable")
 
+namespace {
+template <typename T>
+Storable* make(StorableArena* arena)
+{
+    if (arena != nullptr) {
+        return arena->create<T>();
+    }
+    return new T();
+}
+} // namespace
+
 
 const int StoreInt8::code = BOTTLE_TAG_INT8;
 const int StoreInt16::code = BOTTLE_TAG_INT16;
@@ -65,39 +77,44 @@ const int StoreDict::code = BOTTLE_TAG_LIST | BOTTLE_TAG_DICT;
 Storable::~Storable() = default;
 
 Storable* Storable::createByCode(std::int32_t id)
+{
+    return createByCode(id, nullptr);
+}
+
+Storable* Storable::createByCode(std::int32_t id, StorableArena* arena)
 {
     Storable* storable = nullptr;
     std::int32_t subCode = 0;
     switch (id) {
     case StoreInt8::code:
-        storable = new StoreInt8();
+        storable = make<StoreInt8>(arena);
         break;
     case StoreInt16::code:
-        storable = new StoreInt16();
+        storable = make<StoreInt16>(arena);
         break;
     case StoreInt32::code:
-        storable = new StoreInt32();
+        storable = make<StoreInt32>(arena);
         break;
     case StoreInt64::code:
-        storable = new StoreInt64();
+        storable = make<StoreInt64>(arena);
         break;
     case StoreVocab::code:
-        storable = new StoreVocab();
+        storable = make<StoreVocab>(arena);
         break;
     case StoreFloat32::code:
-        storable = new StoreFloat32();
+        storable = make<StoreFloat32>(arena);
         break;
     case StoreFloat64::code:
-        storable = new StoreFloat64();
+        storable = make<StoreFloat64>(arena);
         break;
     case StoreString::code:
-        storable = new StoreString();
+        storable = make<StoreString>(arena);
         break;
     case StoreBlob::code:
-        storable = new StoreBlob();
+        storable = make<StoreBlob>(arena);
         break;
     case StoreList::code:
-        storable = new StoreList();
+        storable = make<StoreList>(arena);
         yCAssert(STORABLE, storable != nullptr);
         storable->asList()->implementation->setNested(true);
         break;
@@ -106,10 +123,10 @@ Storable* Storable::createByCode(std::int32_t id)
             // typed list
             subCode = (id & UNIT_MASK);
             if ((id & BOTTLE_TAG_DICT) != 0) {
-                storable = new StoreDict();
+                storable = make<StoreDict>(arena);
                 yCAssert(STORABLE, storable != nullptr);
             } else {
-                storable = new StoreList();
+                storable = make<StoreList>(arena);
                 yCAssert(STORABLE, storable != nullptr);
                 storable->asList()->implementation->specialize(subCode);
                 storable->asList()->implementation->setNested(true);
@@ -615,7 +632,7 @@ bool StoreList::writeRaw(ConnectionWriter& writer) const
 
 std::int32_t StoreList::subCode() const
 {
-    return subCoder(*(content.implementation));
+    return content.implementation->subCode();
 }
 
 
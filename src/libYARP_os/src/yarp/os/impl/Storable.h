@@ -16,6 +16,7 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/Value.h>
 #include <yarp/os/Vocab.h>
+#include <yarp/os/impl/StorableArena.h>
 
 
 #define UNIT_MASK         \
@@ -86,6 +87,12 @@ public:
 
     static Storable* createByCode(std::int32_t id);
 
+    /**
+     * Factory method, creating the item in arena (if not nullptr).
+     * The item must then be destroyed by calling its destructor.
+     */
+    static Storable* createByCode(std::int32_t id, StorableArena* arena);
+
 
     bool read(ConnectionReader& connection) override;
     bool write(ConnectionWriter& connection) const override;
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/StorableArena.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+using yarp::os::impl::StorableArena;
+
+namespace {
+constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+constexpr size_t aligned(size_t size)
+{
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+} // namespace
+
+void* StorableArena::allocate(size_t size)
+{
+    size = aligned(size);
+    if (blocks.empty() || used + size > blocks.back().size) {
+        size_t last = blocks.empty() ? 0 : blocks.back().size;
+        addBlock(std::max({size, 2 * last, MIN_BLOCK_SIZE}));
+    }
+    void* ptr = blocks.back().data.get() + used;
+    used += size;
+    return ptr;
+}
+
+bool StorableArena::owns(const void* ptr) const
+{
+    // pointers to different blocks cannot be compared, compare addresses
+    auto at = reinterpret_cast<std::uintptr_t>(ptr);
+    for (const auto& block : blocks) {
+        auto begin = reinterpret_cast<std::uintptr_t>(block.data.get());
+        if (at >= begin && at < begin + block.size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StorableArena::reset()
+{
+    if (blocks.size() > 1) {
+        size_t total = 0;
+        for (const auto& block : blocks) {
+            total += block.size;
+        }
+        blocks.clear();
+        addBlock(total);
+    }
+    used = 0;
+}
+
+void StorableArena::addBlock(size_t size)
+{
+    // operator new[] aligns for any type of at most ALIGNMENT
+    blocks.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+    used = 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_STORABLEARENA_H
+#define YARP_OS_IMPL_STORABLEARENA_H
+
+#include <yarp/os/api.h>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * Memory for the items of a Bottle that is being parsed.
+ * The memory is taken from a few large blocks, one item after the other,
+ * and it is given back all at once by reset().  The items created in the
+ * arena must be destroyed by calling their destructor, not deleted.
+ */
+class YARP_os_impl_API StorableArena
+{
+public:
+    StorableArena() = default;
+    StorableArena(const StorableArena&) = delete;
+    StorableArena& operator=(const StorableArena&) = delete;
+
+    /**
+     * Get size bytes, aligned for any type.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Check if ptr was given by allocate().
+     */
+    bool owns(const void* ptr) const;
+
+    /**
+     * Give back all the memory.  After the first reset, the memory is kept
+     * in a single block, so that parsing again a message of the same size
+     * does not allocate.
+     */
+    void reset();
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+private:
+    static constexpr size_t MIN_BLOCK_SIZE = 4096;
+
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<Block>) blocks;
+    size_t used {0};
+
+    void addBlock(size_t size);
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_STORABLEARENA_H
@@ -9,14 +9,20 @@
 
 #include <yarp/os/impl/UdpCarrier.h>
 
+#include <yarp/os/Bottle.h>
 #include <yarp/os/ConnectionState.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/impl/LogComponent.h>
 
 #include <string>
 
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
+namespace {
+YARP_OS_LOG_COMPONENT(UDPCARRIER, "yarp.os.impl.UdpCarrier")
+} // namespace
+
 yarp::os::impl::UdpCarrier::UdpCarrier() = default;
 
 yarp::os::Carrier* yarp::os::impl::UdpCarrier::create() const
@@ -60,9 +66,46 @@ bool yarp::os::impl::UdpCarrier::isConnectionless() const
 }
 
 
+bool yarp::os::impl::UdpCarrier::configure(ConnectionState& proto)
+{
+    configureFromSpecifier(proto.getSenderSpecifier());
+    return true;
+}
+
+void yarp::os::impl::UdpCarrier::configureFromSpecifier(const std::string& specifier)
+{
+    Bottle b(specifier);
+    batch = 0;
+    if (b.check("batch")) {
+        int messages = b.find("batch").asInt32();
+        batch = (messages > 0) ? messages : 1;
+    }
+    checksum = DgramTwoWayStream::Checksum::Crc32;
+    if (b.check("crc")) {
+        std::string name = b.find("crc").asString();
+        if (name == "crc32c") {
+            checksum = DgramTwoWayStream::Checksum::Crc32c;
+        } else if (name == "none") {
+            checksum = DgramTwoWayStream::Checksum::None;
+        } else if (name != "crc32") {
+            yCWarning(UDPCARRIER, "Unknown checksum \"%s\", using crc32 (try crc32c or none)", name.c_str());
+        }
+    }
+}
+
+void yarp::os::impl::UdpCarrier::configureStream(DgramTwoWayStream* stream) const
+{
+    stream->setChecksum(checksum);
+    if (batch > 0) {
+        stream->setBatchMode(batch);
+    }
+}
+
+
 bool yarp::os::impl::UdpCarrier::respondToHeader(ConnectionState& proto)
 {
     // I am the receiver
+    configureFromSpecifier(proto.getSenderSpecifier());
 
     // issue: need a fresh port number...
     auto* stream = new DgramTwoWayStream();
@@ -75,6 +118,8 @@ bool yarp::os::impl::UdpCarrier::respondToHeader(ConnectionState& proto)
         return false;
     }
 
+    configureStream(stream);
+
     int myPort = stream->getLocalAddress().getPort();
     writeYarpInt(myPort, proto);
     proto.takeStreams(stream);
@@ -104,6 +149,7 @@ bool yarp::os::impl::UdpCarrier::expectReplyToHeader(ConnectionState& proto)
         delete stream;
         return false;
     }
+    configureStream(stream);
     proto.takeStreams(stream);
     return true;
 }
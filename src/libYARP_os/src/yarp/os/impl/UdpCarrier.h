@@ -19,10 +19,21 @@ namespace impl {
 
 /**
  * Communicating between two ports via UDP.
+ *
+ * With "udp+batch" the batched datagram format of DgramTwoWayStream is used;
+ * "udp+batch.N" also lets up to N messages share a datagram.
+ * "udp+crc.crc32c" and "udp+crc.none" choose the checksum of the datagrams.
  */
 class UdpCarrier :
         public AbstractCarrier
 {
+protected:
+    int batch {0}; ///< messages per batch, 0 if not batched
+    DgramTwoWayStream::Checksum checksum {DgramTwoWayStream::Checksum::Crc32};
+
+    void configureFromSpecifier(const std::string& specifier);
+    void configureStream(DgramTwoWayStream* stream) const;
+
 public:
     UdpCarrier();
 
@@ -37,6 +48,7 @@ public:
     void setParameters(const Bytes& header) override;
     bool requireAck() const override;
     bool isConnectionless() const override;
+    bool configure(ConnectionState& proto) override;
     bool respondToHeader(ConnectionState& proto) override;
     bool expectReplyToHeader(ConnectionState& proto) override;
 };
@@ -20,7 +20,11 @@
 using namespace yarp::os::impl;
 using namespace yarp::os;
 
-#define BACKLOG                1
+// Room for the connections that arrive while the port thread is busy
+// attaching the previous one, e.g. many clients of the name server
+// starting together.  With a shorter queue the kernel drops them, and
+// the clients wait a whole SYN retransmission (1 s) before retrying.
+#define BACKLOG                SOMAXCONN
 
 namespace {
 YARP_OS_LOG_COMPONENT(TCPACCEPTOR_POSIX, "yarp.os.impl.TcpAcceptor.posix")
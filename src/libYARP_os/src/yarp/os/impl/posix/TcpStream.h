@@ -13,12 +13,18 @@
 // General files
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 
+#include <climits>
 #include <cstring>
 
+#ifndef IOV_MAX
+#    define IOV_MAX 16
+#endif
+
 namespace yarp {
 namespace os {
 namespace impl {
@@ -76,6 +82,41 @@ public:
         return ::send(sd, buf, n, 0);
     }
 
+    // Send all the blocks described by iov, resuming after partial writes.
+    // The iov array is modified.
+    inline ssize_t sendv_n(struct iovec *iov, int iovcnt)
+    {
+        ssize_t total = 0;
+        while (iovcnt > 0) {
+            struct msghdr msg;
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = (iovcnt < IOV_MAX) ? iovcnt : IOV_MAX;
+            ssize_t n = ::sendmsg(sd, &msg, 0);
+            if (n < 0) {
+                return n;
+            }
+            total += n;
+            size_t sent = static_cast<size_t>(n);
+            while (iovcnt > 0 && sent >= iov->iov_len) {
+                sent -= iov->iov_len;
+                ++iov;
+                --iovcnt;
+            }
+            if (iovcnt > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + sent;
+                iov->iov_len -= sent;
+            }
+        }
+        return total;
+    }
+
+    inline ssize_t sendv_n(struct iovec *iov, int iovcnt, struct timeval *tv)
+    {
+        setsockopt(sd, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<char *>(tv), sizeof (*tv));
+        return sendv_n(iov, iovcnt);
+    }
+
     // No idea what this should do...
     void flush() { }
 
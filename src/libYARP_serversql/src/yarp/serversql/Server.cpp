@@ -70,6 +70,7 @@ int yarp::serversql::Server::run(int argc, char** argv)
         yCInfo(SERVER, "  --portdb ports.db        Store port information in named database.\n");
         yCInfo(SERVER, "                           Must not be on an NFS file system.\n");
         yCInfo(SERVER, "                           Set to :memory: to store in memory (faster).\n");
+        yCInfo(SERVER, "                           Set to :native: to store in memory without sqlite (fastest).\n");
         yCInfo(SERVER, "  --subdb subs.db          Store subscription information in named database.\n");
         yCInfo(SERVER, "                           Must not be on an NFS file system.\n");
         yCInfo(SERVER, "                           Set to :memory: to store in memory (faster).\n");
@@ -48,6 +48,11 @@ public:
         return ns2->apply(cmd,reply,event,remote);
     }
 
+    bool isReadOnly(const yarp::os::Bottle& cmd) override
+    {
+        return ns1->isReadOnly(cmd) && ns2->isReadOnly(cmd);
+    }
+
     void onEvent(yarp::os::Bottle& event) override
     {
         ns1->onEvent(event);
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/serversql/impl/MemoryTripleSource.h>
+
+#include <yarp/serversql/impl/LogComponent.h>
+
+using yarp::serversql::impl::MemoryTripleSource;
+using yarp::serversql::impl::Triple;
+using yarp::serversql::impl::TripleContext;
+
+namespace {
+YARP_SERVERSQL_LOG_COMPONENT(MEMORYTRIPLESOURCE, "yarp.serversql.impl.MemoryTripleSource")
+
+// Same rules as SqliteTripleSource::condition(): a missing field only
+// matches a missing field, "*" matches anything.
+bool matchField(bool has, const std::string& pattern, bool recordHas, const std::string& value)
+{
+    if (!has) {
+        return !recordHas;
+    }
+    if (pattern == "*") {
+        return true;
+    }
+    return recordHas && pattern == value;
+}
+
+bool matches(const Triple& t, const Triple& record)
+{
+    return matchField(t.hasNs, t.ns, record.hasNs, record.ns) &&
+           matchField(t.hasName, t.name, record.hasName, record.name) &&
+           matchField(t.hasValue, t.value, record.hasValue, record.value);
+}
+
+int ridOf(TripleContext *context)
+{
+    return (context != nullptr) ? context->rid : -1;
+}
+} // namespace
+
+
+std::vector<int> MemoryTripleSource::select(Triple& t, TripleContext *context)
+{
+    std::vector<int> ids;
+    int rid = ridOf(context);
+    const std::set<int>* candidates = nullptr;
+    if (t.hasName && t.name != "*" && t.hasValue && t.value != "*") {
+        auto it = byNameValue.find(NameValueKey(rid, t.name, t.value));
+        if (it == byNameValue.end()) {
+            return ids;
+        }
+        candidates = &it->second;
+    } else if (t.hasName && t.name != "*") {
+        auto it = byName.find(NameKey(rid, t.name));
+        if (it == byName.end()) {
+            return ids;
+        }
+        candidates = &it->second;
+    } else {
+        auto it = byRid.find(rid);
+        if (it == byRid.end()) {
+            return ids;
+        }
+        candidates = &it->second;
+    }
+    for (int id : *candidates) {
+        if (matches(t, records.at(id).triple)) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+void MemoryTripleSource::index(int id, const Record& record)
+{
+    byRid[record.rid].insert(id);
+    if (record.triple.hasName) {
+        byName[NameKey(record.rid, record.triple.name)].insert(id);
+        if (record.triple.hasValue) {
+            byNameValue[NameValueKey(record.rid, record.triple.name, record.triple.value)].insert(id);
+        }
+    }
+}
+
+void MemoryTripleSource::unindex(int id, const Record& record)
+{
+    auto it = byRid.find(record.rid);
+    if (it != byRid.end()) {
+        it->second.erase(id);
+        if (it->second.empty()) {
+            byRid.erase(it);
+        }
+    }
+    if (record.triple.hasName) {
+        auto it2 = byName.find(NameKey(record.rid, record.triple.name));
+        if (it2 != byName.end()) {
+            it2->second.erase(id);
+            if (it2->second.empty()) {
+                byName.erase(it2);
+            }
+        }
+    }
+    if (record.triple.hasName && record.triple.hasValue) {
+        auto it3 = byNameValue.find(NameValueKey(record.rid, record.triple.name, record.triple.value));
+        if (it3 != byNameValue.end()) {
+            it3->second.erase(id);
+            if (it3->second.empty()) {
+                byNameValue.erase(it3);
+            }
+        }
+    }
+}
+
+void MemoryTripleSource::erase(int id)
+{
+    auto it = records.find(id);
+    if (it == records.end()) {
+        return;
+    }
+    unindex(id, it->second);
+    records.erase(it);
+}
+
+int MemoryTripleSource::find(Triple& t, TripleContext *context)
+{
+    std::vector<int> ids = select(t, context);
+    if (ids.empty()) {
+        return -1;
+    }
+    if (ids.size() > 1) {
+        yCWarning(MEMORYTRIPLESOURCE, "WARNING: multiple matches ignored");
+    }
+    return ids.back();
+}
+
+void MemoryTripleSource::remove_query(Triple& ti, TripleContext *context)
+{
+    for (int id : select(ti, context)) {
+        erase(id);
+    }
+}
+
+void MemoryTripleSource::prune(TripleContext *context)
+{
+    YARP_UNUSED(context);
+    std::vector<int> orphans;
+    for (const auto& it : byRid) {
+        if (it.first != -1 && records.find(it.first) == records.end()) {
+            orphans.insert(orphans.end(), it.second.begin(), it.second.end());
+        }
+    }
+    for (int id : orphans) {
+        erase(id);
+    }
+}
+
+std::list<Triple> MemoryTripleSource::query(Triple& ti, TripleContext *context)
+{
+    std::list<Triple> q;
+    for (int id : select(ti, context)) {
+        q.push_back(records.at(id).triple);
+    }
+    return q;
+}
+
+void MemoryTripleSource::insert(Triple& t, TripleContext *context)
+{
+    yCDebug(MEMORYTRIPLESOURCE, "Insert: %s", t.toString().c_str());
+    int id = ++lastId;
+    // Triple only declares a copy constructor, the record is built in place
+    const Record& record = records.emplace(id, Record{ridOf(context), t}).first->second;
+    index(id, record);
+}
+
+void MemoryTripleSource::update(Triple& t, TripleContext *context)
+{
+    std::vector<int> ids;
+    if (t.hasName||t.hasNs) {
+        Triple t2(t);
+        t2.value = "*";
+        ids = select(t2, context);
+    } else if (records.find(ridOf(context)) != records.end()) {
+        ids.push_back(ridOf(context));
+    }
+    for (int id : ids) {
+        Record& record = records[id];
+        unindex(id, record);
+        record.triple.hasValue = t.hasValue;
+        record.triple.value = t.value;
+        index(id, record);
+    }
+    if (ids.empty() && (t.hasName||t.hasNs)) {
+        insert(t,context);
+    }
+}
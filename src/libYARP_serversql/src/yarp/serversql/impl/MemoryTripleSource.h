@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SERVERSQL_IMPL_MEMORYTRIPLESOURCE_H
+#define YARP_SERVERSQL_IMPL_MEMORYTRIPLESOURCE_H
+
+#include <yarp/serversql/impl/TripleSource.h>
+#include <yarp/serversql/impl/Triple.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace yarp {
+namespace serversql {
+namespace impl {
+
+/**
+ * A collection of triples kept in memory, without a database.  It
+ * matches triples the same way as SqliteTripleSource, but nothing is
+ * ever written to disk, so it is only useful for a name server that
+ * does not need to remember its ports across restarts.
+ * Reading does not change the containers, so several threads can read
+ * at the same time, as long as none writes.
+ */
+class MemoryTripleSource : public TripleSource
+{
+public:
+    int find(Triple& t, TripleContext *context) override;
+    void remove_query(Triple& ti, TripleContext *context) override;
+    void prune(TripleContext *context) override;
+    std::list<Triple> query(Triple& ti, TripleContext *context) override;
+    void insert(Triple& t, TripleContext *context) override;
+    void update(Triple& t, TripleContext *context) override;
+    void begin(TripleContext* /*context*/) override {}
+    void end(TripleContext* /*context*/) override {}
+
+private:
+    struct Record
+    {
+        int rid;
+        Triple triple;
+    };
+
+    using NameKey = std::tuple<int, std::string>;
+    using NameValueKey = std::tuple<int, std::string, std::string>;
+
+    std::vector<int> select(Triple& t, TripleContext *context);
+    void index(int id, const Record& record);
+    void unindex(int id, const Record& record);
+    void erase(int id);
+
+    std::map<int, Record> records;
+    std::map<int, std::set<int>> byRid;
+    std::map<NameKey, std::set<int>> byName;
+    std::map<NameValueKey, std::set<int>> byNameValue;
+    int lastId {0};
+};
+
+} // namespace impl
+} // namespace serversql
+} // namespace yarp
+
+
+#endif // YARP_SERVERSQL_IMPL_MEMORYTRIPLESOURCE_H
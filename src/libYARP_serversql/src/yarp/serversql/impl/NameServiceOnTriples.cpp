@@ -33,7 +33,7 @@ Contact NameServiceOnTriples::query(const std::string& portName,
                                     bool nested)
 {
     if (!nested) {
-        lock();
+        lockShared();
     }
     Triple t;
     t.setNameValue("port",portName.c_str());
@@ -83,7 +83,7 @@ Contact NameServiceOnTriples::query(const std::string& portName,
             typ = lst.begin()->value;
         }
         if (!nested) {
-            unlock();
+            unlockShared();
         }
         Contact result = Contact(portName, carrier, host, sock);
         if (!typ.empty() && typ!="*") {
@@ -95,7 +95,7 @@ Contact NameServiceOnTriples::query(const std::string& portName,
         return result;
     }
     if (!nested) {
-        unlock();
+        unlockShared();
     }
     if (delegate && !nested) {
         return delegate->queryName(portName);
@@ -401,7 +401,7 @@ bool NameServiceOnTriples::cmdListRunners(NameTripleState& act)
     {
         act.reply.addString("ports");
     }
-    lock();
+    lockShared();
     Triple t;
     t.setNameValue("port","*");
 
@@ -418,7 +418,7 @@ bool NameServiceOnTriples::cmdListRunners(NameTripleState& act)
         t.setNameValue("port",port.c_str());
         int rid = act.mem.find(t, nullptr);
         if (rid == -1) {
-            unlock();
+            unlockShared();
             return false;
         }
 
@@ -437,7 +437,7 @@ bool NameServiceOnTriples::cmdListRunners(NameTripleState& act)
             cmdQuery(act, true);
         }
     }
-    unlock();
+    unlockShared();
     return true;
 }
 
@@ -448,7 +448,7 @@ bool NameServiceOnTriples::cmdList(NameTripleState& act)
     } else {
         act.reply.addString("ports");
     }
-    lock();
+    lockShared();
     Triple t;
     t.setNameValue("port","*");
     std::string prefix;
@@ -478,7 +478,7 @@ bool NameServiceOnTriples::cmdList(NameTripleState& act)
             }
         }
     }
-    unlock();
+    unlockShared();
     return true;
 }
 
@@ -521,7 +521,7 @@ bool NameServiceOnTriples::cmdSet(NameTripleState& act)
 
 bool NameServiceOnTriples::cmdGet(NameTripleState& act)
 {
-    lock();
+    lockShared();
     if (!act.bottleMode) {
         if (act.reply.size()==0) {
             act.reply.addString("old");
@@ -533,7 +533,7 @@ bool NameServiceOnTriples::cmdGet(NameTripleState& act)
     t.setNameValue("port",port.c_str());
     int result = act.mem.find(t, nullptr);
     if (result==-1) {
-        unlock();
+        unlockShared();
         return false;
     }
     TripleContext context;
@@ -557,14 +557,14 @@ bool NameServiceOnTriples::cmdGet(NameTripleState& act)
             q.add(v);
         }
     }
-    unlock();
+    unlockShared();
     return true;
 }
 
 
 bool NameServiceOnTriples::cmdCheck(NameTripleState& act)
 {
-    lock();
+    lockShared();
     if (act.reply.size()==0) {
         act.reply.addString("old");
     }
@@ -575,7 +575,7 @@ bool NameServiceOnTriples::cmdCheck(NameTripleState& act)
     t.setNameValue("port",port.c_str());
     int result = act.mem.find(t, nullptr);
     if (result==-1) {
-        unlock();
+        unlockShared();
         return false;
     }
     TripleContext context;
@@ -597,7 +597,7 @@ bool NameServiceOnTriples::cmdCheck(NameTripleState& act)
         }
     }
     q.addString(present);
-    unlock();
+    unlockShared();
     return true;
 }
 
@@ -676,7 +676,6 @@ bool NameServiceOnTriples::apply(yarp::os::Bottle& cmd,
     access.post();
 
     TripleSource& mem = *db;
-    //mem.begin();
     mem.reset();
     reply.clear();
     NameTripleState act(cmd,reply,event,remote,mem);
@@ -697,6 +696,21 @@ bool NameServiceOnTriples::apply(yarp::os::Bottle& cmd,
         key = cmd.get(0).asString();
     }
 
+    // Commands that change the store run as a single transaction rather
+    // than committing after each of their steps
+    bool grouped = (key=="register" || key=="unregister" || key=="set");
+    if (grouped) {
+        lock();
+    }
+    bool ok = dispatch(act, key);
+    if (grouped) {
+        unlock();
+    }
+    return ok;
+}
+
+bool NameServiceOnTriples::dispatch(NameTripleState& act, const std::string& key)
+{
     if (key=="register") {
         return cmdRegister(act);
     }
@@ -734,21 +748,66 @@ bool NameServiceOnTriples::apply(yarp::os::Bottle& cmd,
     // not understood
     act.reply.addString("old");
 
-    //mem.end();
-
     return true;
 }
 
 
 
+bool NameServiceOnTriples::isReadOnly(const yarp::os::Bottle& cmd)
+{
+    size_t at = 0;
+    std::string key = cmd.get(at).toString();
+    if (key == "NAME_SERVER") {
+        key = cmd.get(++at).asString();
+    }
+    if (key == "bot") {
+        key = cmd.get(++at).asString();
+    }
+    return key == "query" ||
+           key == "list" ||
+           key == "runners" ||
+           key == "get" ||
+           key == "check" ||
+           key == "route" ||
+           key == "help";
+}
+
 void NameServiceOnTriples::lock()
 {
-    mutex.lock();
+    if (writer == std::this_thread::get_id()) {
+        depth++;
+    } else {
+        mutex.lock();
+        writer = std::this_thread::get_id();
+        depth = 1;
+    }
     db->begin(nullptr);
 }
 
 void NameServiceOnTriples::unlock()
 {
     db->end(nullptr);
-    mutex.unlock();
+    if (--depth == 0) {
+        writer = std::thread::id();
+        mutex.unlock();
+    }
+}
+
+void NameServiceOnTriples::lockShared()
+{
+    // Reads done while changing the store are part of the change
+    if (writer == std::this_thread::get_id()) {
+        lock();
+        return;
+    }
+    mutex.lock_shared();
+}
+
+void NameServiceOnTriples::unlockShared()
+{
+    if (writer == std::this_thread::get_id()) {
+        unlock();
+        return;
+    }
+    mutex.unlock_shared();
 }
@@ -17,7 +17,9 @@
 #include <yarp/os/NameStore.h>
 #include <yarp/os/Semaphore.h>
 
-#include <mutex>
+#include <atomic>
+#include <shared_mutex>
+#include <thread>
 
 namespace yarp {
 namespace serversql {
@@ -64,7 +66,9 @@ private:
     Subscriber *subscriber;
     std::string lastRegister;
     yarp::os::Contact serverContact;
-    std::mutex mutex;
+    std::shared_timed_mutex mutex;
+    std::atomic<std::thread::id> writer;
+    int depth;
     yarp::os::Semaphore access;
     bool gonePublic;
     bool silent;
@@ -76,6 +80,8 @@ public:
             subscriber(nullptr),
             lastRegister(""),
             mutex(),
+            writer(std::thread::id()),
+            depth(0),
             access(1),
             gonePublic(false),
             silent(false),
@@ -133,6 +139,8 @@ public:
 
     bool cmdHelp(NameTripleState& act);
 
+    bool dispatch(NameTripleState& act, const std::string& key);
+
     bool apply(yarp::os::Bottle& cmd,
                yarp::os::Bottle& reply,
                yarp::os::Bottle& event,
@@ -143,10 +151,23 @@ public:
         gonePublic = true;
     }
 
+    bool isReadOnly(const yarp::os::Bottle& cmd) override;
+
+    /**
+     * Lock the store for a change.  The lock is recursive, and a thread
+     * holding it can also take the shared lock.
+     */
     void lock() override;
 
     void unlock() override;
 
+    /**
+     * Lock the store for reading, concurrently with other readers.
+     */
+    void lockShared() override;
+
+    void unlockShared() override;
+
     void setDelegate(yarp::os::NameSpace *delegate)
     {
         this->delegate = delegate;
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/serversql/impl/SqliteStatementCache.h>
+
+#include <yarp/serversql/impl/LogComponent.h>
+
+using yarp::serversql::impl::SqliteStatementCache;
+
+namespace {
+YARP_SERVERSQL_LOG_COMPONENT(SQLITESTATEMENTCACHE, "yarp.serversql.impl.SqliteStatementCache")
+} // namespace
+
+sqlite3_stmt *SqliteStatementCache::get(const std::string& sql)
+{
+    auto it = statements.find(sql);
+    if (it != statements.end()) {
+        sqlite3_reset(it->second);
+        sqlite3_clear_bindings(it->second);
+        return it->second;
+    }
+
+    sqlite3_stmt *statement = nullptr;
+    int result = sqlite3_prepare_v2(db, sql.c_str(), static_cast<int>(sql.length()), &statement, nullptr);
+    if (result != SQLITE_OK) {
+        yCError(SQLITESTATEMENTCACHE, "Error in query: %s", sqlite3_errmsg(db));
+        yCError(SQLITESTATEMENTCACHE, "(Query was): %s", sql.c_str());
+        sqlite3_finalize(statement);
+        return nullptr;
+    }
+    statements.emplace(sql, statement);
+    return statement;
+}
+
+void SqliteStatementCache::clear()
+{
+    for (auto& it : statements) {
+        sqlite3_finalize(it.second);
+    }
+    statements.clear();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SERVERSQL_IMPL_SQLITESTATEMENTCACHE_H
+#define YARP_SERVERSQL_IMPL_SQLITESTATEMENTCACHE_H
+
+#include <sqlite3.h>
+
+#include <string>
+#include <unordered_map>
+
+
+namespace yarp {
+namespace serversql {
+namespace impl {
+
+/**
+ * Prepared statements of a Sqlite database, compiled the first time
+ * their SQL text is used and then kept for the lifetime of the
+ * connection.  Values must be passed as parameters ("?") rather than
+ * written into the SQL text, so that the text can be reused.
+ *
+ * A statement returned by get() has been reset and has no bindings.
+ * Call sqlite3_reset() on it once done, so that it does not keep the
+ * database locked.
+ */
+class SqliteStatementCache
+{
+public:
+    SqliteStatementCache() = default;
+    SqliteStatementCache(const SqliteStatementCache&) = delete;
+    SqliteStatementCache& operator=(const SqliteStatementCache&) = delete;
+
+    ~SqliteStatementCache()
+    {
+        clear();
+    }
+
+    void setDatabase(sqlite3 *db)
+    {
+        clear();
+        this->db = db;
+    }
+
+    /**
+     * Get the statement for a given SQL text, compiling it if needed.
+     * @return the statement, or nullptr if the SQL text is invalid.
+     */
+    sqlite3_stmt *get(const std::string& sql);
+
+    /**
+     * Finalize all statements.  Must be called before closing the
+     * database.
+     */
+    void clear();
+
+    static void bindText(sqlite3_stmt *statement, int index, const char *text)
+    {
+        // a nullptr binds NULL
+        sqlite3_bind_text(statement, index, text, -1, SQLITE_TRANSIENT);
+    }
+
+    static void bindText(sqlite3_stmt *statement, int index, const std::string& text)
+    {
+        sqlite3_bind_text(statement, index, text.c_str(), static_cast<int>(text.length()), SQLITE_TRANSIENT);
+    }
+
+private:
+    sqlite3 *db {nullptr};
+    std::unordered_map<std::string, sqlite3_stmt*> statements;
+};
+
+} // namespace impl
+} // namespace serversql
+} // namespace yarp
+
+
+#endif // YARP_SERVERSQL_IMPL_SQLITESTATEMENTCACHE_H
@@ -11,8 +11,7 @@
 
 #include <yarp/serversql/impl/LogComponent.h>
 
-#include <cstdlib>
-#include <cstdio>
+#include <string>
 
 using yarp::serversql::impl::SqliteTripleSource;
 using yarp::serversql::impl::Triple;
@@ -24,43 +23,37 @@ YARP_SERVERSQL_LOG_COMPONENT(SQLITETRIPLESOURCE, "yarp.serversql.impl.SqliteTrip
 
 SqliteTripleSource::SqliteTripleSource(sqlite3 *db) : db(db)
 {
+    statements.setDatabase(db);
 }
 
 std::string SqliteTripleSource::condition(Triple& t, TripleContext *context)
 {
+    // The values are bound by bindCondition(), only the shape of the
+    // condition is part of the SQL text
     int rid = (context != nullptr) ? context->rid : -1;
     std::string cond = "";
     if (rid==-1) {
         cond = "rid IS NULL";
     } else {
-        cond = "rid = " + expressContext(context);
+        cond = "rid = ?";
     }
     if (t.hasNs) {
         if (t.ns!="*") {
-            char *query = nullptr;
-            query = sqlite3_mprintf(" AND ns = %Q",t.getNs());
-            cond = cond + query;
-            sqlite3_free(query);
+            cond += " AND ns = ?";
         }
     } else {
         cond += " AND ns IS NULL";
     }
     if (t.hasName) {
         if (t.name!="*") {
-            char *query = nullptr;
-            query = sqlite3_mprintf(" AND name = %Q",t.getName());
-            cond = cond + query;
-            sqlite3_free(query);
+            cond += " AND name = ?";
         }
     } else {
         cond += " AND name IS NULL";
     }
     if (t.hasValue) {
         if (t.value!="*") {
-            char *query = nullptr;
-            query = sqlite3_mprintf(" AND value = %Q",t.getValue());
-            cond = cond + query;
-            sqlite3_free(query);
+            cond += " AND value = ?";
         }
     } else {
         cond += " AND value IS NULL";
@@ -68,67 +61,93 @@ std::string SqliteTripleSource::condition(Triple& t, TripleContext *context)
     return cond;
 }
 
+int SqliteTripleSource::bindCondition(sqlite3_stmt *statement, int index, Triple& t, TripleContext *context)
+{
+    int rid = (context != nullptr) ? context->rid : -1;
+    if (rid!=-1) {
+        sqlite3_bind_int(statement, index++, rid);
+    }
+    if (t.hasNs && t.ns!="*") {
+        SqliteStatementCache::bindText(statement, index++, t.ns);
+    }
+    if (t.hasName && t.name!="*") {
+        SqliteStatementCache::bindText(statement, index++, t.name);
+    }
+    if (t.hasValue && t.value!="*") {
+        SqliteStatementCache::bindText(statement, index++, t.value);
+    }
+    return index;
+}
+
 int SqliteTripleSource::find(Triple& t, TripleContext *context)
 {
+    std::lock_guard<std::mutex> lock(mutex);
     int out = -1;
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
-    query = sqlite3_mprintf("SELECT id FROM tags WHERE %s",
-                            condition(t,context).c_str());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_prepare_v2(db, query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
+    std::string query = "SELECT id FROM tags WHERE " + condition(t,context);
+    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query.c_str());
+    sqlite3_stmt *statement = statements.get(query);
+    if (statement == nullptr) {
         yCWarning(SQLITETRIPLESOURCE, "Error in query");
+        return out;
     }
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    bindCondition(statement, 1, t, context);
+    while (sqlite3_step(statement) == SQLITE_ROW) {
         if (out!=-1) {
             yCWarning(SQLITETRIPLESOURCE, "WARNING: multiple matches ignored");
         }
         out = sqlite3_column_int(statement,0);
         yCTrace(SQLITETRIPLESOURCE, "Match %d", out);
     }
-
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    sqlite3_reset(statement);
     return out;
 }
 
 void SqliteTripleSource::remove_query(Triple& ti, TripleContext *context)
 {
-    char *query = nullptr;
-    query = sqlite3_mprintf("DELETE FROM tags WHERE %s",condition(ti,context).c_str());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, nullptr);
-    if (result!=SQLITE_OK) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string query = "DELETE FROM tags WHERE " + condition(ti,context);
+    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query.c_str());
+    sqlite3_stmt *statement = statements.get(query);
+    if (statement == nullptr) {
+        yCWarning(SQLITETRIPLESOURCE, "Error in query");
+        return;
+    }
+    bindCondition(statement, 1, ti, context);
+    if (sqlite3_step(statement) != SQLITE_DONE) {
         yCWarning(SQLITETRIPLESOURCE, "Error in query");
     }
-    sqlite3_free(query);
+    sqlite3_reset(statement);
 }
 
 void SqliteTripleSource::prune(TripleContext *context)
 {
-    char *query = nullptr;
-    query = sqlite3_mprintf("DELETE FROM tags WHERE rid IS NOT NULL AND rid  NOT IN (SELECT id FROM tags)");
+    std::lock_guard<std::mutex> lock(mutex);
+    const char *query = "DELETE FROM tags WHERE rid IS NOT NULL AND rid  NOT IN (SELECT id FROM tags)";
     yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, nullptr);
-    if (result!=SQLITE_OK) {
+    sqlite3_stmt *statement = statements.get(query);
+    if (statement == nullptr) {
         yCWarning(SQLITETRIPLESOURCE, "Error in query");
+        return;
     }
-    sqlite3_free(query);
+    if (sqlite3_step(statement) != SQLITE_DONE) {
+        yCWarning(SQLITETRIPLESOURCE, "Error in query");
+    }
+    sqlite3_reset(statement);
 }
 
 std::list<Triple> SqliteTripleSource::query(Triple& ti, TripleContext *context)
 {
+    std::lock_guard<std::mutex> lock(mutex);
     std::list<Triple> q;
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
-    query = sqlite3_mprintf("SELECT id, ns, name, value FROM tags WHERE %s",condition(ti,context).c_str());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_prepare_v2(db, query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
+    std::string query = "SELECT id, ns, name, value FROM tags WHERE " + condition(ti,context);
+    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query.c_str());
+    sqlite3_stmt *statement = statements.get(query);
+    if (statement == nullptr) {
         yCWarning(SQLITETRIPLESOURCE, "Error in query");
+        return q;
     }
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    bindCondition(statement, 1, ti, context);
+    while (sqlite3_step(statement) == SQLITE_ROW) {
         //int id = sqlite3_column_int(statement,0);
         char *ns = (char *)sqlite3_column_text(statement,1);
         char *name = (char *)sqlite3_column_text(statement,2);
@@ -148,72 +167,79 @@ std::list<Triple> SqliteTripleSource::query(Triple& ti, TripleContext *context)
         }
         q.push_back(t);
     }
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    sqlite3_reset(statement);
     return q;
 }
 
-std::string SqliteTripleSource::expressContext(TripleContext *context)
+void SqliteTripleSource::insert(Triple& t, TripleContext *context)
 {
-    int rid = (context != nullptr)?context->rid:-1;
-    char buf[100] = "NULL";
+    std::lock_guard<std::mutex> lock(mutex);
+    const char *query = "INSERT INTO tags (rid,ns,name,value) VALUES(?,?,?,?)";
+    yCDebug(SQLITETRIPLESOURCE, "Query: %s [%s]", query, t.toString().c_str());
+    sqlite3_stmt *statement = statements.get(query);
+    if (statement == nullptr) {
+        return;
+    }
+    int rid = (context != nullptr) ? context->rid : -1;
     if (rid!=-1) {
-        std::snprintf(buf, 100, "%d", rid);
+        sqlite3_bind_int(statement, 1, rid);
     }
-    return buf;
-}
-
-void SqliteTripleSource::insert(Triple& t, TripleContext *context)
-{
-    char *msg = nullptr;
-    char *query = sqlite3_mprintf("INSERT INTO tags (rid,ns,name,value) VALUES(%s,%Q,%Q,%Q)",
-                                  expressContext(context).c_str(),
-                                  t.getNs(),t.getName(),t.getValue());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, &msg);
-    if (result!=SQLITE_OK) {
-        if (msg != nullptr) {
-            yCError(SQLITETRIPLESOURCE, "Error: %s", msg);
-            yCError(SQLITETRIPLESOURCE, "(Query was): %s", query);
-            yCError(SQLITETRIPLESOURCE, "(Location): %s:%d", __FILE__, __LINE__);
-            sqlite3_free(msg);
-        }
+    SqliteStatementCache::bindText(statement, 2, t.getNs());
+    SqliteStatementCache::bindText(statement, 3, t.getName());
+    SqliteStatementCache::bindText(statement, 4, t.getValue());
+    if (sqlite3_step(statement) != SQLITE_DONE) {
+        yCError(SQLITETRIPLESOURCE, "Error: %s", sqlite3_errmsg(db));
+        yCError(SQLITETRIPLESOURCE, "(Query was): %s [%s]", query, t.toString().c_str());
+        yCError(SQLITETRIPLESOURCE, "(Location): %s:%d", __FILE__, __LINE__);
     }
-    sqlite3_free(query);
+    sqlite3_reset(statement);
 }
 
 void SqliteTripleSource::update(Triple& t, TripleContext *context)
 {
-    char *msg = nullptr;
-    char *query = nullptr;
+    std::unique_lock<std::mutex> lock(mutex);
+    sqlite3_stmt *statement = nullptr;
     if (t.hasName||t.hasNs) {
         Triple t2(t);
         t2.value = "*";
-        query = sqlite3_mprintf("UPDATE tags SET value = %Q WHERE %s",
-                                t.getValue(),
-                                condition(t2,context).c_str());
+        std::string query = "UPDATE tags SET value = ? WHERE " + condition(t2,context);
+        yCDebug(SQLITETRIPLESOURCE, "Query: %s", query.c_str());
+        statement = statements.get(query);
+        if (statement == nullptr) {
+            return;
+        }
+        SqliteStatementCache::bindText(statement, 1, t.getValue());
+        bindCondition(statement, 2, t2, context);
     } else {
-        query = sqlite3_mprintf("UPDATE tags SET value = %Q WHERE id = %Q",
-                                t.getValue(),
-                                expressContext(context).c_str());
-    }
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, &msg);
-    if (result!=SQLITE_OK) {
-        if (msg != nullptr) {
-            yCError(SQLITETRIPLESOURCE, "Error: %s", msg);
-            sqlite3_free(msg);
+        const char *query = "UPDATE tags SET value = ? WHERE id = ?";
+        yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
+        statement = statements.get(query);
+        if (statement == nullptr) {
+            return;
+        }
+        SqliteStatementCache::bindText(statement, 1, t.getValue());
+        int rid = (context != nullptr) ? context->rid : -1;
+        if (rid!=-1) {
+            sqlite3_bind_int(statement, 2, rid);
         }
     }
+    if (sqlite3_step(statement) != SQLITE_DONE) {
+        yCError(SQLITETRIPLESOURCE, "Error: %s", sqlite3_errmsg(db));
+    }
+    sqlite3_reset(statement);
     int ct = sqlite3_changes(db);
+    lock.unlock();
     if (ct==0 && (t.hasName||t.hasNs)) {
         insert(t,context);
     }
-    sqlite3_free(query);
 }
 
 void SqliteTripleSource::begin(TripleContext *context)
 {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (depth++ > 0) {
+        return;
+    }
     int result = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
     yCDebug(SQLITETRIPLESOURCE, "Query: BEGIN TRANSACTION;");
     if (result!=SQLITE_OK) {
@@ -223,6 +249,10 @@ void SqliteTripleSource::begin(TripleContext *context)
 
 void SqliteTripleSource::end(TripleContext *context)
 {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--depth > 0) {
+        return;
+    }
     int result = sqlite3_exec(db, "END TRANSACTION;", nullptr, nullptr, nullptr);
     yCDebug(SQLITETRIPLESOURCE, "Query: END TRANSACTION;");
     if (result!=SQLITE_OK) {
@@ -12,9 +12,12 @@
 
 #include <yarp/serversql/impl/TripleSource.h>
 #include <yarp/serversql/impl/Triple.h>
+#include <yarp/serversql/impl/SqliteStatementCache.h>
 
 #include <sqlite3.h>
 
+#include <mutex>
+
 namespace yarp {
 namespace serversql {
 namespace impl {
@@ -23,19 +26,26 @@ namespace impl {
  * Sqlite database, viewed as a collection of triples.  These are the
  * minimum functions needed by the name server to use a Sqlite
  * database.
+ *
+ * Queries are compiled once and kept as prepared statements.
+ * Transactions can be nested: only the outermost begin()/end() pair
+ * reaches the database, so that a caller can group several operations
+ * in a single commit.  The connection is shared, so each operation
+ * runs alone.
  */
 class SqliteTripleSource : public TripleSource
 {
 public:
     SqliteTripleSource(sqlite3 *db);
+    ~SqliteTripleSource() override = default;
 
     std::string condition(Triple& t, TripleContext *context);
+    int bindCondition(sqlite3_stmt *statement, int index, Triple& t, TripleContext *context);
 
     int find(Triple& t, TripleContext *context) override;
     void remove_query(Triple& ti, TripleContext *context) override;
     void prune(TripleContext *context) override;
     std::list<Triple> query(Triple& ti, TripleContext *context) override;
-    std::string expressContext(TripleContext *context);
     void insert(Triple& t, TripleContext *context) override;
     void update(Triple& t, TripleContext *context) override;
     void begin(TripleContext *context) override;
@@ -43,6 +53,9 @@ public:
 
 private:
     sqlite3 *db;
+    SqliteStatementCache statements;
+    std::mutex mutex;
+    int depth {0};
 };
 
 } // namespace impl
@@ -33,6 +33,12 @@ public:
                yarp::os::Bottle& event,
                const yarp::os::Contact& remote) override;
 
+    bool isReadOnly(const yarp::os::Bottle& cmd) override
+    {
+        // web pages are cached on first use
+        return cmd.get(0).asString() != "web";
+    }
+
 private:
     yarp::os::Property options;
     yarp::os::Property content;
@@ -17,6 +17,19 @@ namespace {
 YARP_SERVERSQL_LOG_COMPONENT(SUBSCRIBER, "yarp.serversql.impl.Subscriber")
 } // namespace
 
+bool Subscriber::isReadOnly(const yarp::os::Bottle& cmd)
+{
+    // Even listing subscriptions or topics goes through the same commands
+    // that change them
+    std::string tag = cmd.get(0).asString();
+    return !(tag == "subscribe" ||
+             tag == "unsubscribe" ||
+             tag == "announce" ||
+             tag == "topic" ||
+             tag == "untopic" ||
+             tag == "type");
+}
+
 bool Subscriber::apply(yarp::os::Bottle& cmd,
                        yarp::os::Bottle& reply,
                        yarp::os::Bottle& event,
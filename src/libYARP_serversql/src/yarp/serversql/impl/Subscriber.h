@@ -93,6 +93,8 @@ public:
                yarp::os::Bottle& event,
                const yarp::os::Contact& remote) override;
 
+    bool isReadOnly(const yarp::os::Bottle& cmd) override;
+
     void onEvent(yarp::os::Bottle& event) override
     {
     }
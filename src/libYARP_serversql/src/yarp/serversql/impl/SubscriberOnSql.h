@@ -12,6 +12,8 @@
 
 #include <yarp/serversql/impl/Subscriber.h>
 
+#include <yarp/serversql/impl/SqliteStatementCache.h>
+
 #include <mutex>
 
 
@@ -90,6 +92,7 @@ public:
 
 private:
     void *implementation {nullptr};
+    SqliteStatementCache statements;
     std::mutex mutex;
 };
 
@@ -11,6 +11,7 @@
 
 #include <yarp/conf/compiler.h>
 #include <yarp/serversql/impl/SqliteTripleSource.h>
+#include <yarp/serversql/impl/MemoryTripleSource.h>
 
 #if !defined(_WIN32)
 #include <unistd.h>
@@ -47,6 +48,12 @@ static bool sql_enact(sqlite3 *db, const char *cmd) {
 TripleSource *TripleSourceCreator::open(const char *filename,
                                         bool cautious,
                                         bool fresh) {
+    if (string(filename) == ":native:") {
+        // No database at all, the triples live in plain containers
+        accessor = new MemoryTripleSource();
+        return accessor;
+    }
+
     sqlite3 *db = nullptr;
     if (fresh) {
         int result = access(filename,F_OK);
@@ -88,6 +95,17 @@ TripleSource *TripleSourceCreator::open(const char *filename,
         std::exit(1);
     }
 
+    if (string(filename) != ":memory:") {
+        // With a write-ahead log, a commit appends to the log instead of
+        // rewriting the database, and readers do not block the writer.
+        // Not all file systems support it, in which case sqlite keeps
+        // the default journal.
+        result = sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+        if (result!=SQLITE_OK) {
+            fprintf(stderr,"Cannot use a write-ahead log for %s, continuing\n", filename);
+        }
+    }
+
     string cmd_synch = string("PRAGMA synchronous=") + (cautious?"FULL":"OFF") + ";";
     sql_enact(db,cmd_synch.c_str());
 
@@ -20,6 +20,8 @@ namespace impl {
 
 /**
  * Open and close a database, viewed as a collection of triples.
+ * The special file name ":native:" gives a MemoryTripleSource, that
+ * does not use sqlite at all.
  */
 class TripleSourceCreator
 {
@@ -28,7 +30,7 @@ public:
 
     virtual ~TripleSourceCreator()
     {
-        if (implementation != nullptr) {
+        if (implementation != nullptr || accessor != nullptr) {
             close();
         }
     }
@@ -18,9 +18,11 @@
 #include <yarp/os/ConnectionReader.h>
 #include <yarp/os/ConnectionWriter.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/SharedBufferPool.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Vocab.h>
 
+#include <yarp/sig/ImageBufferPool.h>
 #include <yarp/sig/ImageNetworkHeader.h>
 #include <yarp/sig/impl/IplImage.h>
 #include <yarp/sig/impl/DeBayer.h>
@@ -28,6 +30,7 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
 
 
 using namespace yarp::sig;
@@ -78,6 +81,8 @@ public:
     size_t extern_type_quantum;
     size_t quantum;
     bool topIsLow;
+    bool use_shared;
+    bool is_shared;
 
 protected:
     Image& owner;
@@ -86,6 +91,11 @@ protected:
 
     int is_owner;
 
+    // The row pointers, Data points here.  The array is kept when the
+    // image is resized, and reallocated only when it's too short.
+    char **rows;
+    size_t rows_capacity;
+
     // ipl allocation is done in two steps.
     // _alloc allocates the actual ipl pointer.
     // _alloc_data allocates the image array and data.
@@ -120,15 +130,20 @@ public:
         type_id = 0;
         pImage = nullptr;
         Data = nullptr;
+        rows = nullptr;
+        rows_capacity = 0;
         is_owner = 1;
         quantum = 0;
         topIsLow = true;
         extern_type_id = 0;
         extern_type_quantum = -1;
+        use_shared = false;
+        is_shared = false;
     }
 
     ~ImageStorage() {
         _free_complete();
+        delete[] rows;
     }
 
     void resize(size_t x, size_t y, int pixel_type,
@@ -138,6 +153,8 @@ public:
                                 size_t quantum, bool topIsLow);
     int getTypeId();
 
+    void setSharedMemory(bool shared);
+
 };
 
 
@@ -173,12 +190,28 @@ void ImageStorage::_alloc () {
 
     _free(); // was iplDeallocateImage(pImage); but that won't work with refs
 
-    if ((type_id == VOCAB_PIXEL_MONO_FLOAT) ||
-        (type_id == VOCAB_PIXEL_RGB_FLOAT)  ||
-        (type_id == VOCAB_PIXEL_HSV_FLOAT)) {
-        iplAllocateImageFP(pImage, 0, 0);
+    if (use_shared && pImage->imageSize > 0) {
+        pImage->imageData = yarp::os::SharedBufferPool::getInstance().allocate(pImage->imageSize);
+        if (pImage->imageData != nullptr) {
+            // same as iplAllocateImage
+            if (pImage->origin == IPL_ORIGIN_TL) {
+                pImage->imageDataOrigin = pImage->imageData + pImage->imageSize - pImage->widthStep;
+            } else {
+                pImage->imageDataOrigin = pImage->imageData;
+            }
+            is_shared = true;
+            iplSetBorderMode (pImage, IPL_BORDER_CONSTANT, IPL_SIDE_ALL, 0);
+            return;
+        }
+    }
+
+    // same as iplAllocateImage, but the memory comes from the pool
+    pImage->imageData = ImageBufferPool::getInstance().allocate(pImage->imageSize);
+    yAssert(pImage->imageData != nullptr);
+    if (pImage->origin == IPL_ORIGIN_TL) {
+        pImage->imageDataOrigin = pImage->imageData + pImage->imageSize - pImage->widthStep;
     } else {
-        iplAllocateImage (pImage, 0, 0);
+        pImage->imageDataOrigin = pImage->imageData;
     }
 
     iplSetBorderMode (pImage, IPL_BORDER_CONSTANT, IPL_SIDE_ALL, 0);
@@ -211,9 +244,13 @@ void ImageStorage::_alloc_data ()
 
     yAssert(Data==nullptr);
 
-    char **ptr = new char *[pImage->height];
+    if (rows == nullptr || rows_capacity < static_cast<size_t>(pImage->height)) {
+        delete[] rows;
+        rows = new char *[pImage->height];
+        rows_capacity = pImage->height;
+    }
 
-    Data = ptr;
+    Data = rows;
 
     yAssert(Data != nullptr);
 
@@ -240,13 +277,15 @@ void ImageStorage::_free ()
     if (pImage != nullptr) {
         if (pImage->imageData != nullptr) {
             if (is_owner) {
-                iplDeallocateImage (pImage);
-                delete[] Data;
-            } else {
-                delete[] Data;
+                if (is_shared) {
+                    yarp::os::SharedBufferPool::getInstance().release(pImage->imageData);
+                } else {
+                    ImageBufferPool::getInstance().release(pImage->imageData);
+                }
             }
 
             is_owner = 1;
+            is_shared = false;
             Data = nullptr;
             pImage->imageData = nullptr;
         }
@@ -386,6 +425,20 @@ void ImageStorage::_alloc_complete_extern(const void *buf, size_t x, size_t y, i
 
 
 
+void ImageStorage::setSharedMemory(bool shared)
+{
+    use_shared = shared;
+    if (pImage == nullptr || pImage->imageData == nullptr || !is_owner || is_shared == shared) {
+        return;
+    }
+
+    // move the pixels to the new kind of storage
+    std::vector<char> pixels(pImage->imageData, pImage->imageData + pImage->imageSize);
+    resize(pImage->width, pImage->height, type_id, quantum, topIsLow);
+    memcpy(pImage->imageData, pixels.data(), pixels.size());
+}
+
+
 int ImageStorage::_pad_bytes (size_t linesize, size_t align) const
 {
     return yarp::sig::PAD_BYTES (linesize, align);
@@ -729,20 +782,11 @@ bool Image::read(yarp::os::ConnectionReader& connection) {
             return false;
         }
 
-        if (getPixelCode() == VOCAB_PIXEL_BGR && header.id==VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_BGR(flex, *this, 3);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_BGRA && header.id == VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_BGR(flex, *this, 4);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_RGB && header.id==VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_RGB(flex, *this, 3);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_RGBA && header.id == VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_RGB(flex, *this, 4);
+        if (deBayer8(header.id, flex, *this)) {
+            return true;
         }
 
-        YARP_FIXME_NOTIMPLEMENTED("Conversion from bayer encoding not yet implemented\n");
+        YARP_FIXME_NOTIMPLEMENTED("Conversion from bayer encoding to this pixel type not yet implemented\n");
         return false;
     }
 
@@ -889,6 +933,17 @@ void Image::setExternal(const void *data, size_t imgWidth, size_t imgHeight) {
 }
 
 
+void Image::setSharedMemory(bool shared) {
+    (static_cast<ImageStorage*>(implementation))->setSharedMemory(shared);
+    synchronize();
+}
+
+
+bool Image::isSharedMemory() const {
+    return (static_cast<ImageStorage*>(implementation))->is_shared;
+}
+
+
 bool Image::copy(const Image& alt, size_t w, size_t h) {
     if (getPixelCode()==0) {
         setPixelCode(alt.getPixelCode());
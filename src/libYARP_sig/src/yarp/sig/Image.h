@@ -270,6 +270,22 @@ public:
      */
     void setExternal(const void *data, size_t imgWidth, size_t imgHeight);
 
+    /**
+     * Allocate the pixels of this image in shared memory
+     * (see yarp::os::SharedBufferPool).
+     * When the image is written to a "shmem+ring" connection, only a handle
+     * to the pixels is sent, and the reader copies them directly from the
+     * shared memory segment.  The current content of the image is preserved.
+     * If shared memory is not available the image is allocated as usual.
+     * @param shared true to use shared memory for the following allocations
+     */
+    void setSharedMemory(bool shared);
+
+    /**
+     * @return true if the pixels of this image are in shared memory.
+     */
+    bool isSharedMemory() const;
+
     /**
     * Access to the internal image buffer.
     * @return pointer to the internal image buffer.
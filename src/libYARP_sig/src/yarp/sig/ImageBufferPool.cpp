@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/ImageBufferPool.h>
+
+#include <yarp/conf/environment.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+using yarp::sig::ImageBufferPool;
+
+namespace {
+YARP_LOG_COMPONENT(IMAGEBUFFERPOOL, "yarp.sig.ImageBufferPool")
+
+size_t roundUp(size_t size, size_t step)
+{
+    return (size + step - 1) / step * step;
+}
+
+// The size actually allocated for a request of size bytes: a multiple of
+// the alignment for the small buffers, a multiple of a huge page for the
+// large ones, and in between one of the four sizes 2^k, 1.25 * 2^k,
+// 1.5 * 2^k and 1.75 * 2^k, wasting less than 25% of the memory.
+size_t sizeClass(size_t size)
+{
+    if (size <= 4 * ImageBufferPool::alignment) {
+        return (size == 0) ? ImageBufferPool::alignment : roundUp(size, ImageBufferPool::alignment);
+    }
+    if (size >= ImageBufferPool::hugePageSize) {
+        return roundUp(size, ImageBufferPool::hugePageSize);
+    }
+    size_t power = 4 * ImageBufferPool::alignment;
+    while (power * 2 < size) {
+        power *= 2;
+    }
+    return roundUp(size, power / 4);
+}
+} // namespace
+
+
+class ImageBufferPool::Private
+{
+public:
+    struct Block
+    {
+        void* base;
+        size_t size;
+        bool hugePages;
+        bool used;
+        // Position in the list of the cached blocks, when not used
+        std::list<char*>::iterator cached;
+    };
+
+    Private()
+    {
+        std::string env = yarp::conf::environment::getEnvironment("YARP_IMAGE_POOL_CAPACITY");
+        if (!env.empty()) {
+            capacity = static_cast<size_t>(std::strtoull(env.c_str(), nullptr, 10));
+        }
+    }
+
+    char* allocate(size_t size)
+    {
+        size = sizeClass(size);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // The most recently released buffer of the same size is the most
+        // likely to be still in the cache.
+        auto bucket = buckets.find(size);
+        if (bucket != buckets.end() && !bucket->second.empty()) {
+            char* ptr = bucket->second.back();
+            bucket->second.pop_back();
+            Block& block = blocks.at(ptr);
+            order.erase(block.cached);
+            block.used = true;
+            stats.bytesCached -= size;
+            stats.bytesInUse += size;
+            stats.reuses++;
+            return ptr;
+        }
+
+        Block block;
+        char* ptr = create(size, block);
+        if (ptr == nullptr) {
+            return nullptr;
+        }
+        blocks[ptr] = block;
+        stats.allocations++;
+        stats.bytesInUse += size;
+        if (block.hugePages) {
+            stats.bytesHugePages += size;
+        }
+        if (stats.bytesInUse + stats.bytesCached > stats.peakBytes) {
+            stats.peakBytes = stats.bytesInUse + stats.bytesCached;
+        }
+        return ptr;
+    }
+
+    void release(char* ptr)
+    {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = blocks.find(ptr);
+        if (it == blocks.end() || !it->second.used) {
+            yCError(IMAGEBUFFERPOOL, "Trying to release a buffer not allocated by the pool");
+            return;
+        }
+        Block& block = it->second;
+        stats.bytesInUse -= block.size;
+        if (block.size > capacity) {
+            destroy(it);
+            return;
+        }
+        block.used = false;
+        block.cached = order.insert(order.end(), ptr);
+        buckets[block.size].push_back(ptr);
+        stats.bytesCached += block.size;
+        shrink();
+    }
+
+    void setCapacity(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        capacity = bytes;
+        shrink();
+    }
+
+    size_t getCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return capacity;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!order.empty()) {
+            evictOldest();
+        }
+    }
+
+    Statistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+private:
+    // Free the cached blocks released first, until the cache fits in the
+    // capacity.
+    void shrink()
+    {
+        while (stats.bytesCached > capacity) {
+            evictOldest();
+        }
+    }
+
+    void evictOldest()
+    {
+        char* ptr = order.front();
+        order.pop_front();
+        auto it = blocks.find(ptr);
+        auto& bucket = buckets[it->second.size];
+        for (auto jt = bucket.begin(); jt != bucket.end(); ++jt) {
+            if (*jt == ptr) {
+                bucket.erase(jt);
+                break;
+            }
+        }
+        stats.bytesCached -= it->second.size;
+        destroy(it);
+    }
+
+    void destroy(std::unordered_map<char*, Block>::iterator it)
+    {
+        Block& block = it->second;
+        if (block.hugePages) {
+            stats.bytesHugePages -= block.size;
+#if defined(__linux__)
+            ::munmap(block.base, block.size);
+#endif
+        } else {
+            std::free(block.base);
+        }
+        stats.deallocations++;
+        blocks.erase(it);
+    }
+
+    static char* create(size_t size, Block& block)
+    {
+        block.used = true;
+        block.hugePages = false;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (size >= hugePageSize) {
+            // Map one more huge page and trim the ends, so that the buffer
+            // starts on a huge page boundary.
+            size_t mapSize = size + hugePageSize;
+            void* map = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (map != MAP_FAILED) {
+                auto* begin = static_cast<char*>(map);
+                auto* ptr = reinterpret_cast<char*>(roundUp(reinterpret_cast<std::uintptr_t>(begin), hugePageSize));
+                if (ptr != begin) {
+                    ::munmap(begin, ptr - begin);
+                }
+                if (ptr + size != begin + mapSize) {
+                    ::munmap(ptr + size, begin + mapSize - (ptr + size));
+                }
+                // Only an advice, the buffer is still usable if the kernel
+                // does not support transparent huge pages.
+                ::madvise(ptr, size, MADV_HUGEPAGE);
+                block.base = ptr;
+                block.size = size;
+                block.hugePages = true;
+                return ptr;
+            }
+        }
+#endif
+        void* base = std::malloc(size + alignment - 1);
+        if (base == nullptr) {
+            yCError(IMAGEBUFFERPOOL, "Can't allocate %zu bytes", size);
+            return nullptr;
+        }
+        block.base = base;
+        block.size = size;
+        return reinterpret_cast<char*>(roundUp(reinterpret_cast<std::uintptr_t>(base), alignment));
+    }
+
+    mutable std::mutex mutex;
+    size_t capacity{defaultCapacity};
+    Statistics stats{0, 0, 0, 0, 0, 0, 0};
+    // All the blocks, used or cached, by the address of their data
+    std::unordered_map<char*, Block> blocks;
+    // The cached blocks, by size
+    std::map<size_t, std::vector<char*>> buckets;
+    // The cached blocks, in the order they were released
+    std::list<char*> order;
+};
+
+
+constexpr size_t ImageBufferPool::alignment;
+constexpr size_t ImageBufferPool::hugePageSize;
+constexpr size_t ImageBufferPool::defaultCapacity;
+
+ImageBufferPool::ImageBufferPool() :
+        mPriv(new Private)
+{
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+    // mPriv is intentionally leaked, release() can still be called by
+    // images destroyed after the pool.
+}
+
+ImageBufferPool& ImageBufferPool::getInstance()
+{
+    static ImageBufferPool instance;
+    return instance;
+}
+
+char* ImageBufferPool::allocate(size_t size)
+{
+    return mPriv->allocate(size);
+}
+
+void ImageBufferPool::release(char* ptr)
+{
+    mPriv->release(ptr);
+}
+
+void ImageBufferPool::setCapacity(size_t bytes)
+{
+    mPriv->setCapacity(bytes);
+}
+
+size_t ImageBufferPool::getCapacity() const
+{
+    return mPriv->getCapacity();
+}
+
+void ImageBufferPool::clear()
+{
+    mPriv->clear();
+}
+
+ImageBufferPool::Statistics ImageBufferPool::getStatistics() const
+{
+    return mPriv->getStatistics();
+}
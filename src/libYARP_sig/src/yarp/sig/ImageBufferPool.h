@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMAGEBUFFERPOOL_H
+#define YARP_SIG_IMAGEBUFFERPOOL_H
+
+#include <yarp/sig/api.h>
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+
+/**
+ * \ingroup sig_class
+ *
+ * A process-wide pool for the pixels of the yarp::sig::Image objects.
+ *
+ * The sizes are rounded up to a few classes (four for each power of two,
+ * multiples of hugePageSize for the large buffers), and the released
+ * buffers are kept and reused for the next allocation of the same class,
+ * so that a program resizing, receiving and destroying images of the same
+ * size over and over does not allocate memory.
+ *
+ * The buffers are aligned to `alignment` bytes.  On Linux, the buffers of
+ * at least hugePageSize bytes are mapped separately, aligned to
+ * hugePageSize and advised to use transparent huge pages.
+ *
+ * The memory kept by the pool (not used by any image) is limited by the
+ * capacity; when it is exceeded the buffers released first are freed.
+ * The default capacity can be changed with the `YARP_IMAGE_POOL_CAPACITY`
+ * environment variable (in bytes); 0 disables the pool.
+ */
+class YARP_sig_API ImageBufferPool
+{
+public:
+    struct Statistics
+    {
+        /// Buffers taken from the system.
+        size_t allocations;
+        /// Buffers given to an image without taking them from the system.
+        size_t reuses;
+        /// Buffers given back to the system.
+        size_t deallocations;
+        /// Bytes of the buffers used by some image.
+        size_t bytesInUse;
+        /// Bytes of the buffers kept for reuse.
+        size_t bytesCached;
+        /// Maximum of bytesInUse + bytesCached.
+        size_t peakBytes;
+        /// Bytes (in use or cached) of the buffers advised to use huge pages.
+        size_t bytesHugePages;
+    };
+
+    static constexpr size_t alignment = 64;
+    static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+    static constexpr size_t defaultCapacity = 64 * 1024 * 1024;
+
+    static ImageBufferPool& getInstance();
+
+    /**
+     * Allocate a buffer of at least size bytes (the content is undefined).
+     * @return a pointer to the buffer, or nullptr if the memory is over.
+     */
+    char* allocate(size_t size);
+
+    /**
+     * Release a buffer returned by allocate().
+     */
+    void release(char* ptr);
+
+    /**
+     * Set the maximum number of bytes kept for reuse, freeing the buffers
+     * that do not fit any more.
+     */
+    void setCapacity(size_t bytes);
+
+    size_t getCapacity() const;
+
+    /**
+     * Free all the buffers kept for reuse.
+     */
+    void clear();
+
+    Statistics getStatistics() const;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+private:
+    ImageBufferPool();
+    ~ImageBufferPool();
+    ImageBufferPool(const ImageBufferPool&) = delete;
+    ImageBufferPool& operator=(const ImageBufferPool&) = delete;
+
+    class Private;
+    Private* const mPriv;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMAGEBUFFERPOOL_H
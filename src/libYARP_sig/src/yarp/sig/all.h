@@ -12,6 +12,7 @@
 #ifndef YARP_SIG_ALL_H
 #define YARP_SIG_ALL_H
 
+#include <yarp/sig/ImageBufferPool.h>
 #include <yarp/sig/ImageDraw.h>
 #include <yarp/sig/ImageFile.h>
 #include <yarp/sig/Image.h>
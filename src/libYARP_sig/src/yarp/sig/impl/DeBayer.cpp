@@ -7,160 +7,109 @@
  */
 
 #include <yarp/sig/impl/DeBayer.h>
+#include <yarp/sig/impl/Demosaic.h>
 #include <yarp/os/Log.h>
 
-bool deBayer_GRBG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+using yarp::sig::impl::BayerOrder;
+using yarp::sig::impl::DemosaicMethod;
+
+namespace {
+
+bool convert(BayerOrder order, yarp::sig::Image &source, yarp::sig::Image &dest)
 {
-    yAssert(((pixelSize == 3) && (dest.getPixelCode() == VOCAB_PIXEL_BGR)) ||
-        ((pixelSize == 4 && dest.getPixelCode() == VOCAB_PIXEL_BGRA)))
-
-        dest.resize(source.width(), source.height());
-    // perform conversion, skip borders
-    for (size_t r = 0; r < source.height() - 2; r += 2)
-    {
-        unsigned char *destRow = dest.getRow(r);
-        unsigned char *sourceRowCurrent = source.getRow(r);
-        unsigned char *sourceRowNext = source.getRow(r + 1);
-
-        //row i GRGRGR...
-        for (size_t c = 0; c < dest.width() - 2; c += 2)
-        {
-            //source is on G pixel
-            destRow[0] = sourceRowNext[0];       //blue
-            destRow[1] = sourceRowCurrent[0];    //green
-            destRow[2] = sourceRowCurrent[1];    //red
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on R pixel
-            destRow[0] = sourceRowNext[0];         //blue
-            destRow[1] = sourceRowCurrent[1];     //green
-            destRow[2] = sourceRowCurrent[0];     //red
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-        }
-
-        destRow = dest.getRow(r + 1);
-        sourceRowCurrent = source.getRow(r + 1);
-        sourceRowNext = source.getRow(r + 2);
-
-        //row is now BGBGBG...
-        for (size_t c = 0; c < dest.width() - 2; c += 2)
-        {
-            //source is on B pixel
-            destRow[0] = sourceRowCurrent[0];   //blue
-            destRow[1] = sourceRowCurrent[1];   //green
-            destRow[2] = sourceRowNext[1];;     //red
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on G pixel
-            destRow[0] = sourceRowCurrent[1];    //blue
-            destRow[1] = sourceRowCurrent[0];    //green
-            destRow[2] = sourceRowNext[0];       //red
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-        }
-    }
-    return true;
+    dest.resize(source.width(), source.height());
+    return yarp::sig::impl::demosaic(source.getRawImage(), source.getRowSize(),
+                                     dest.getRawImage(), dest.getRowSize(), dest.getPixelCode(),
+                                     source.width(), source.height(),
+                                     order, DemosaicMethod::Bilinear);
 }
 
-bool deBayer_GRBG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+bool deBayer(BayerOrder order, yarp::sig::Image &source, yarp::sig::Image &dest, int code3, int code4, int pixelSize)
 {
-    yAssert(((pixelSize == 3) && (dest.getPixelCode() == VOCAB_PIXEL_RGB)) ||
-    ((pixelSize == 4 && dest.getPixelCode() == VOCAB_PIXEL_RGBA)))
+    yAssert(((pixelSize == 3) && (dest.getPixelCode() == code3)) ||
+            ((pixelSize == 4) && (dest.getPixelCode() == code4)))
 
-    dest.resize(source.width(), source.height());
-    // perform conversion, skip borders
-    for (size_t r = 0; r < source.height() - 2; r += 2)
-    {
-        unsigned char *destRow = dest.getRow(r);
-        unsigned char *sourceRowCurrent = source.getRow(r);
-        unsigned char *sourceRowNext = source.getRow(r + 1);
-
-        //row i GRGRGR...
-        for (size_t c = 0; c < source.width() - 2; c += 2)
-        {
-            //source is on G pixel
-            destRow[0] = sourceRowCurrent[1];    //red
-            destRow[1] = sourceRowCurrent[0];    //green
-            destRow[2] = sourceRowNext[0];;     //blue
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on R pixel
-            destRow[0] = sourceRowCurrent[0];     //red
-            destRow[1] = sourceRowCurrent[1];     //green
-            destRow[2] = sourceRowNext[0];        //red
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-        }
-
-        destRow = dest.getRow(r + 1);
-        sourceRowCurrent = source.getRow(r + 1);
-        sourceRowNext = source.getRow(r + 2);
-
-        //row is now BGBGBG...
-        for (size_t c = 0; c < dest.width() - 2; c += 2)
-        {
-            //source is on B pixel
-            destRow[0] = sourceRowNext[1];      //red
-            destRow[1] = sourceRowCurrent[1];   //green
-            destRow[2] = sourceRowCurrent[0];   //blue
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on G pixel
-            destRow[0] = sourceRowNext[0];     //red
-            destRow[1] = sourceRowCurrent[0];  //green
-            destRow[2] = sourceRowCurrent[1];  //blue
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-        }
-    }
-    return true;
+    return convert(order, source, dest);
+}
+
+bool deBayerRGB(BayerOrder order, yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+{
+    return deBayer(order, source, dest, VOCAB_PIXEL_RGB, VOCAB_PIXEL_RGBA, pixelSize);
+}
+
+bool deBayerBGR(BayerOrder order, yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+{
+    return deBayer(order, source, dest, VOCAB_PIXEL_BGR, VOCAB_PIXEL_BGRA, pixelSize);
+}
+
+} // namespace
+
+bool deBayer_GRBG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+{
+    return deBayerRGB(BayerOrder::GRBG, source, dest, pixelSize);
 }
 
 bool deBayer_BGGR8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_BGGR8_TO_RGB\n");
-    return false;
+    return deBayerRGB(BayerOrder::BGGR, source, dest, pixelSize);
+}
+
+bool deBayer_GBRG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+{
+    return deBayerRGB(BayerOrder::GBRG, source, dest, pixelSize);
 }
 
 bool deBayer_RGGB8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_RGGB8_TO_RGB\n");
-    return false;
+    return deBayerRGB(BayerOrder::RGGB, source, dest, pixelSize);
+}
+
+bool deBayer_GRBG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+{
+    return deBayerBGR(BayerOrder::GRBG, source, dest, pixelSize);
 }
 
 bool deBayer_BGGR8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_BGGR8_TO_BGR\n");
-    return false;
+    return deBayerBGR(BayerOrder::BGGR, source, dest, pixelSize);
+}
+
+bool deBayer_GBRG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+{
+    return deBayerBGR(BayerOrder::GBRG, source, dest, pixelSize);
 }
 
 bool deBayer_RGGB8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_RGGB8_TO_BGR\n");
-    return false;
+    return deBayerBGR(BayerOrder::RGGB, source, dest, pixelSize);
+}
+
+bool deBayer8(int bayerCode, yarp::sig::Image &source, yarp::sig::Image &dest)
+{
+    BayerOrder order;
+    switch (bayerCode) {
+    case VOCAB_PIXEL_ENCODING_BAYER_GRBG8:
+        order = BayerOrder::GRBG;
+        break;
+    case VOCAB_PIXEL_ENCODING_BAYER_BGGR8:
+        order = BayerOrder::BGGR;
+        break;
+    case VOCAB_PIXEL_ENCODING_BAYER_GBRG8:
+        order = BayerOrder::GBRG;
+        break;
+    case VOCAB_PIXEL_ENCODING_BAYER_RGGB8:
+        order = BayerOrder::RGGB;
+        break;
+    default:
+        return false;
+    }
+    switch (dest.getPixelCode()) {
+    case VOCAB_PIXEL_RGB:
+    case VOCAB_PIXEL_RGBA:
+    case VOCAB_PIXEL_BGR:
+    case VOCAB_PIXEL_BGRA:
+        return convert(order, source, dest);
+    default:
+        return false;
+    }
 }
@@ -8,10 +8,10 @@
  */
 
 /**
- * Basic implementations of debayering functions. Used to convert Bayer images received
- * in a YARP port. Prototype implementation, in the future we should replace these functions
- * with better implementations, like the ones in the Bayer Carrier. If we decide to implement
- * debayering by chaining carriers this code could be removed completely.
+ * Debayering functions. Used to convert Bayer images received in a YARP port.
+ * They use the same bilinear interpolation of the Bayer Carrier (see
+ * yarp::sig::impl::demosaic()). If we decide to implement debayering by
+ * chaining carriers this code could be removed completely.
  */
 
 #ifndef YARP_SIG_IMPL_DEBAYER_H
@@ -42,21 +42,29 @@ inline bool isBayer16(int v)
 }
 
 /*
- * Nearest neighbor debayer implementation (warning: skip borders)
+ * Bilinear debayer implementation, dest is resized to the size of source.
+ * pixelSize is 3 for RGB (BGR) images and 4 for RGBA (BGRA) images.
  */
 bool deBayer_GRBG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
 bool deBayer_BGGR8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
+bool deBayer_GBRG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
+
 bool deBayer_RGGB8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
-/*
- * Nearest neighbor debayer implementation (warning: skip borders)
- */
 bool deBayer_GRBG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
 bool deBayer_BGGR8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
-inline bool deBayer_RGGB8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
+bool deBayer_GBRG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
+
+bool deBayer_RGGB8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
+
+/*
+ * Debayer an 8 bit bayer image (bayerCode is one of the
+ * VOCAB_PIXEL_ENCODING_BAYER_*8 codes) to an RGB, BGR, RGBA or BGRA image.
+ */
+bool deBayer8(int bayerCode, yarp::sig::Image &source, yarp::sig::Image &dest);
 
 #endif // YARP_SIG_IMPL_DEBAYER_H
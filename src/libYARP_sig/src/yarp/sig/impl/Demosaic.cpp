@@ -0,0 +1,656 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/Demosaic.h>
+
+#include <yarp/sig/Image.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define YARP_DEMOSAIC_SSSE3
+#    include <tmmintrin.h>
+#endif
+
+using yarp::sig::impl::BayerOrder;
+using yarp::sig::impl::DemosaicMethod;
+using yarp::sig::impl::DemosaicWorkers;
+
+namespace {
+
+// the smallest band of rows given to a thread
+constexpr size_t MIN_BAND_ROWS = 32;
+
+struct Layout
+{
+    size_t pixelSize;
+    size_t r;
+    size_t b;
+};
+
+bool getLayout(int code, Layout& layout)
+{
+    switch (code) {
+    case VOCAB_PIXEL_RGB:
+        layout = {3, 0, 2};
+        return true;
+    case VOCAB_PIXEL_BGR:
+        layout = {3, 2, 0};
+        return true;
+    case VOCAB_PIXEL_RGBA:
+        layout = {4, 0, 2};
+        return true;
+    case VOCAB_PIXEL_BGRA:
+        layout = {4, 2, 0};
+        return true;
+    default:
+        return false;
+    }
+}
+
+struct Pattern
+{
+    size_t goff; // x of the green pixels in the even rows
+    size_t roff; // parity of the rows with red pixels
+};
+
+Pattern getPattern(BayerOrder order)
+{
+    switch (order) {
+    case BayerOrder::GRBG:
+        return {0, 0};
+    case BayerOrder::GBRG:
+        return {0, 1};
+    case BayerOrder::RGGB:
+        return {1, 0};
+    case BayerOrder::BGGR:
+    default:
+        return {1, 1};
+    }
+}
+
+constexpr int HORIZONTAL[2][2] = {{-1, 0}, {1, 0}};
+constexpr int VERTICAL[2][2] = {{0, -1}, {0, 1}};
+constexpr int CROSS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+constexpr int DIAGONAL[4][2] = {{-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
+struct Converter;
+
+// converts the inner pixels of a row starting from x = 1, and returns
+// the first pixel that was not converted
+using RowFunction = size_t (*)(const Converter& d, size_t y);
+
+/*
+ * A row with red pixels has green and red pixels, the colour of the row
+ * (red) is the average of the horizontal neighbours of a green pixel,
+ * the other colour (blue) is the average of the vertical neighbours of a
+ * green pixel, or of the diagonal neighbours of a red pixel.  The rows
+ * with blue pixels are the same, swapping red and blue.
+ */
+struct Converter
+{
+    const unsigned char* src;
+    size_t srcStep;
+    unsigned char* dest;
+    size_t destStep;
+    size_t w;
+    size_t h;
+    Layout layout;
+    Pattern pattern;
+    DemosaicMethod method;
+    RowFunction innerRow;
+
+    const unsigned char* row(size_t y) const
+    {
+        return src + y * srcStep;
+    }
+
+    bool isGreen(size_t x, size_t y) const
+    {
+        return (x + y) % 2 == pattern.goff;
+    }
+
+    bool isRedRow(size_t y) const
+    {
+        return y % 2 == pattern.roff;
+    }
+
+    void write(size_t x, size_t y, int same, int g, int other) const
+    {
+        unsigned char* p = dest + y * destStep + x * layout.pixelSize;
+        bool red = isRedRow(y);
+        p[layout.r] = static_cast<unsigned char>(red ? same : other);
+        p[1] = static_cast<unsigned char>(g);
+        p[layout.b] = static_cast<unsigned char>(red ? other : same);
+        if (layout.pixelSize == 4) {
+            p[3] = 255;
+        }
+    }
+
+    // the average of the neighbours inside the image
+    template <size_t N>
+    int average(size_t x, size_t y, const int (&offsets)[N][2]) const
+    {
+        int sum = 0;
+        int count = 0;
+        for (const auto& offset : offsets) {
+            auto nx = static_cast<long>(x) + offset[0];
+            auto ny = static_cast<long>(y) + offset[1];
+            if (nx >= 0 && ny >= 0 && nx < static_cast<long>(w) && ny < static_cast<long>(h)) {
+                sum += row(ny)[nx];
+                count++;
+            }
+        }
+        return (count > 0) ? sum / count : 0;
+    }
+
+    void borderPixel(size_t x, size_t y) const
+    {
+        int c = row(y)[x];
+        if (isGreen(x, y)) {
+            write(x, y, average(x, y, HORIZONTAL), c, average(x, y, VERTICAL));
+        } else {
+            write(x, y, c, average(x, y, CROSS), average(x, y, DIAGONAL));
+        }
+    }
+
+    void innerPixel(size_t x, size_t y) const
+    {
+        const unsigned char* a = row(y - 1);
+        const unsigned char* c = row(y);
+        const unsigned char* b = row(y + 1);
+        int horizontal = c[x - 1] + c[x + 1];
+        int vertical = a[x] + b[x];
+        if (isGreen(x, y)) {
+            write(x, y, horizontal / 2, c[x], vertical / 2);
+            return;
+        }
+        int g = (horizontal + vertical) / 4;
+        if (method == DemosaicMethod::EdgeAware) {
+            int dh = std::abs(c[x - 1] - c[x + 1]);
+            int dv = std::abs(a[x] - b[x]);
+            if (dh < dv) {
+                g = horizontal / 2;
+            } else if (dv < dh) {
+                g = vertical / 2;
+            }
+        }
+        write(x, y, c[x], g, (a[x - 1] + a[x + 1] + b[x - 1] + b[x + 1]) / 4);
+    }
+
+    void convertRows(size_t y0, size_t y1) const
+    {
+        for (size_t y = y0; y < y1; y++) {
+            if (y == 0 || y + 1 >= h) {
+                for (size_t x = 0; x < w; x++) {
+                    borderPixel(x, y);
+                }
+                continue;
+            }
+            borderPixel(0, y);
+            size_t x = (innerRow != nullptr) ? innerRow(*this, y) : 1;
+            for (; x + 1 < w; x++) {
+                innerPixel(x, y);
+            }
+            if (w > 1) {
+                borderPixel(w - 1, y);
+            }
+        }
+    }
+};
+
+struct HalfConverter;
+
+// converts the first pixels of a row of the half size image, and returns
+// the first pixel that was not converted
+using HalfRowFunction = size_t (*)(const HalfConverter& d, size_t y);
+
+struct HalfConverter
+{
+    const unsigned char* src;
+    size_t srcStep;
+    unsigned char* dest;
+    size_t destStep;
+    size_t w;
+    Layout layout;
+    Pattern pattern;
+    HalfRowFunction halfRow;
+
+    // the position of each colour in a 2x2 cell
+    size_t g0() const
+    {
+        return pattern.goff;
+    }
+
+    size_t g1() const
+    {
+        return 1 - pattern.goff;
+    }
+
+    size_t rx() const
+    {
+        return 1 - (pattern.goff + pattern.roff) % 2;
+    }
+
+    size_t bx() const
+    {
+        return 1 - (pattern.goff + 1 - pattern.roff) % 2;
+    }
+
+    void convertRows(size_t y0, size_t y1) const
+    {
+        const size_t ry = pattern.roff;
+        const size_t by = 1 - pattern.roff;
+        for (size_t y = y0; y < y1; y++) {
+            const unsigned char* cell[2] = {src + 2 * y * srcStep, src + (2 * y + 1) * srcStep};
+            size_t x = (halfRow != nullptr) ? halfRow(*this, y) : 0;
+            unsigned char* p = dest + y * destStep + x * layout.pixelSize;
+            for (; x < w; x++, p += layout.pixelSize) {
+                p[layout.r] = cell[ry][2 * x + rx()];
+                p[1] = static_cast<unsigned char>((cell[0][2 * x + g0()] + cell[1][2 * x + g1()]) / 2);
+                p[layout.b] = cell[by][2 * x + bx()];
+                if (layout.pixelSize == 4) {
+                    p[3] = 255;
+                }
+            }
+        }
+    }
+};
+
+// The threads needed to convert h rows
+size_t bandsFor(size_t h, size_t threads)
+{
+    return std::max<size_t>(1, std::min(threads, h / MIN_BAND_ROWS));
+}
+
+// Convert the rows [0, h) with the workers, each one taking a band of
+// consecutive rows.
+template <typename F>
+void convertBands(size_t h, DemosaicWorkers& workers, const F& convertRows)
+{
+    size_t bands = bandsFor(h, workers.size());
+    if (bands == 1) {
+        convertRows(0, h);
+        return;
+    }
+    workers.run(bands, [h, bands, &convertRows](size_t i) { convertRows(h * i / bands, h * (i + 1) / bands); });
+}
+
+#if defined(YARP_DEMOSAIC_SSSE3)
+
+inline __attribute__((target("ssse3"))) __m128i load(const unsigned char* p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline __attribute__((target("ssse3"))) void store(unsigned char* p, __m128i v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+inline __attribute__((target("ssse3"))) __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// (p + q) / 2, rounded down (pavgb rounds up)
+inline __attribute__((target("ssse3"))) __m128i half(__m128i p, __m128i q)
+{
+    return _mm_sub_epi8(_mm_avg_epu8(p, q), _mm_and_si128(_mm_xor_si128(p, q), _mm_set1_epi8(1)));
+}
+
+// (p + q + r + s) / 4, rounded down
+inline __attribute__((target("ssse3"))) __m128i quarter(__m128i p, __m128i q, __m128i r, __m128i s)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(p, zero), _mm_unpacklo_epi8(q, zero)),
+                               _mm_add_epi16(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(s, zero)));
+    __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(p, zero), _mm_unpackhi_epi8(q, zero)),
+                               _mm_add_epi16(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(s, zero)));
+    return _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2));
+}
+
+inline __attribute__((target("ssse3"))) __m128i absDiff(__m128i p, __m128i q)
+{
+    return _mm_or_si128(_mm_subs_epu8(p, q), _mm_subs_epu8(q, p));
+}
+
+// masks[v][c] takes the bytes of the channel c for the block v of 16
+// bytes of 16 pixels with 3 channels
+struct InterleaveMasks
+{
+    alignas(16) unsigned char masks[3][3][16];
+
+    InterleaveMasks()
+    {
+        for (size_t v = 0; v < 3; v++) {
+            for (size_t c = 0; c < 3; c++) {
+                for (size_t i = 0; i < 16; i++) {
+                    size_t t = 16 * v + i;
+                    masks[v][c][i] = (t % 3 == c) ? static_cast<unsigned char>(t / 3) : 0x80;
+                }
+            }
+        }
+    }
+};
+
+template <size_t PIXEL_SIZE>
+struct Writer;
+
+template <>
+struct Writer<3>
+{
+    __m128i masks[3][3];
+
+    __attribute__((target("ssse3"))) Writer()
+    {
+        static const InterleaveMasks interleave;
+        for (size_t v = 0; v < 3; v++) {
+            for (size_t c = 0; c < 3; c++) {
+                masks[v][c] = load(interleave.masks[v][c]);
+            }
+        }
+    }
+
+    __attribute__((target("ssse3"))) void write(unsigned char* p, __m128i c0, __m128i c1, __m128i c2) const
+    {
+        for (size_t v = 0; v < 3; v++) {
+            store(p + 16 * v, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, masks[v][0]),
+                                                        _mm_shuffle_epi8(c1, masks[v][1])),
+                                           _mm_shuffle_epi8(c2, masks[v][2])));
+        }
+    }
+};
+
+template <>
+struct Writer<4>
+{
+    __attribute__((target("ssse3"))) void write(unsigned char* p, __m128i c0, __m128i c1, __m128i c2) const
+    {
+        const __m128i alpha = _mm_set1_epi8(-1);
+        __m128i lo01 = _mm_unpacklo_epi8(c0, c1);
+        __m128i hi01 = _mm_unpackhi_epi8(c0, c1);
+        __m128i lo23 = _mm_unpacklo_epi8(c2, alpha);
+        __m128i hi23 = _mm_unpackhi_epi8(c2, alpha);
+        store(p, _mm_unpacklo_epi16(lo01, lo23));
+        store(p + 16, _mm_unpackhi_epi16(lo01, lo23));
+        store(p + 32, _mm_unpacklo_epi16(hi01, hi23));
+        store(p + 48, _mm_unpackhi_epi16(hi01, hi23));
+    }
+};
+
+template <size_t PIXEL_SIZE, bool EDGE_AWARE>
+__attribute__((target("ssse3"))) size_t innerRow_ssse3(const Converter& d, size_t y)
+{
+    const unsigned char* a = d.row(y - 1);
+    const unsigned char* c = d.row(y);
+    const unsigned char* b = d.row(y + 1);
+    unsigned char* out = d.dest + y * d.destStep;
+    const bool red = d.isRedRow(y);
+    const bool rgb = (d.layout.r == 0);
+    const Writer<PIXEL_SIZE> writer;
+
+    // x is always odd, the green pixels are the even or the odd bytes
+    const __m128i green = d.isGreen(1, y) ? _mm_set1_epi16(0x00FF) : _mm_set1_epi16(static_cast<short>(0xFF00));
+
+    size_t x = 1;
+    // the last byte read is x + 16
+    for (; x + 16 < d.w; x += 16) {
+        __m128i left = load(c + x - 1);
+        __m128i center = load(c + x);
+        __m128i right = load(c + x + 1);
+        __m128i up = load(a + x);
+        __m128i down = load(b + x);
+
+        __m128i horizontal = half(left, right);
+        __m128i vertical = half(up, down);
+        __m128i cross = quarter(left, right, up, down);
+        __m128i diagonal = quarter(load(a + x - 1), load(a + x + 1), load(b + x - 1), load(b + x + 1));
+        if (EDGE_AWARE) {
+            __m128i dh = absDiff(left, right);
+            __m128i dv = absDiff(up, down);
+            __m128i most = _mm_max_epu8(dh, dv);
+            // dh <= dv and dv <= dh, with a tie green is the average of four
+            __m128i hSmaller = _mm_cmpeq_epi8(most, dv);
+            __m128i vSmaller = _mm_cmpeq_epi8(most, dh);
+            __m128i tie = _mm_and_si128(hSmaller, vSmaller);
+            cross = select(_mm_andnot_si128(tie, hSmaller), horizontal,
+                           select(_mm_andnot_si128(tie, vSmaller), vertical, cross));
+        }
+
+        __m128i same = select(green, horizontal, center);
+        __m128i g = select(green, center, cross);
+        __m128i other = select(green, vertical, diagonal);
+        __m128i r = red ? same : other;
+        __m128i blue = red ? other : same;
+        writer.write(out + x * PIXEL_SIZE, rgb ? r : blue, g, rgb ? blue : r);
+    }
+    return x;
+}
+
+bool hasSsse3()
+{
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+    return ssse3;
+}
+
+// the even and the odd bytes of 32 bytes
+inline __attribute__((target("ssse3"))) void split(const unsigned char* p, __m128i& even, __m128i& odd)
+{
+    const __m128i low = _mm_set1_epi16(0x00FF);
+    __m128i a = load(p);
+    __m128i b = load(p + 16);
+    even = _mm_packus_epi16(_mm_and_si128(a, low), _mm_and_si128(b, low));
+    odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+}
+
+template <size_t PIXEL_SIZE>
+__attribute__((target("ssse3"))) size_t halfRow_ssse3(const HalfConverter& d, size_t y)
+{
+    const unsigned char* row[2] = {d.src + 2 * y * d.srcStep, d.src + (2 * y + 1) * d.srcStep};
+    unsigned char* out = d.dest + y * d.destStep;
+    const bool rgb = (d.layout.r == 0);
+    const Writer<PIXEL_SIZE> writer;
+
+    size_t x = 0;
+    for (; x + 16 <= d.w; x += 16) {
+        __m128i cells[2][2];
+        split(row[0] + 2 * x, cells[0][0], cells[0][1]);
+        split(row[1] + 2 * x, cells[1][0], cells[1][1]);
+        __m128i r = cells[d.pattern.roff][d.rx()];
+        __m128i g = half(cells[0][d.g0()], cells[1][d.g1()]);
+        __m128i b = cells[1 - d.pattern.roff][d.bx()];
+        writer.write(out + x * PIXEL_SIZE, rgb ? r : b, g, rgb ? b : r);
+    }
+    return x;
+}
+
+HalfRowFunction selectHalfRow(size_t pixelSize)
+{
+    if (!hasSsse3()) {
+        return nullptr;
+    }
+    return (pixelSize == 3) ? halfRow_ssse3<3> : halfRow_ssse3<4>;
+}
+
+RowFunction selectInnerRow(size_t pixelSize, DemosaicMethod method)
+{
+    if (!hasSsse3()) {
+        return nullptr;
+    }
+    bool edgeAware = (method == DemosaicMethod::EdgeAware);
+    if (pixelSize == 3) {
+        return edgeAware ? innerRow_ssse3<3, true> : innerRow_ssse3<3, false>;
+    }
+    return edgeAware ? innerRow_ssse3<4, true> : innerRow_ssse3<4, false>;
+}
+
+#else
+
+RowFunction selectInnerRow(size_t pixelSize, DemosaicMethod method)
+{
+    YARP_UNUSED(pixelSize);
+    YARP_UNUSED(method);
+    return nullptr;
+}
+
+HalfRowFunction selectHalfRow(size_t pixelSize)
+{
+    YARP_UNUSED(pixelSize);
+    return nullptr;
+}
+
+#endif
+
+} // namespace
+
+class DemosaicWorkers::Private
+{
+public:
+    std::vector<std::thread> threads;
+    std::mutex runMutex; // one conversion at a time
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* body {nullptr};
+    size_t count {0};
+    size_t next {0};
+    size_t running {0};
+    size_t generation {0};
+    bool stopping {false};
+
+    // Take the calls left, with the lock held
+    void work(std::unique_lock<std::mutex>& lock)
+    {
+        while (next < count) {
+            size_t i = next++;
+            lock.unlock();
+            (*body)(i);
+            lock.lock();
+        }
+    }
+
+    void loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t seen = generation;
+        while (true) {
+            started.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            running++;
+            work(lock);
+            running--;
+            if (running == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+
+DemosaicWorkers::DemosaicWorkers(size_t threads) :
+        mPriv(new Private)
+{
+    for (size_t i = 1; i < threads; i++) {
+        mPriv->threads.emplace_back(&Private::loop, mPriv);
+    }
+}
+
+DemosaicWorkers::~DemosaicWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        mPriv->stopping = true;
+    }
+    mPriv->started.notify_all();
+    for (auto& thread : mPriv->threads) {
+        thread.join();
+    }
+    delete mPriv;
+}
+
+size_t DemosaicWorkers::size() const
+{
+    return mPriv->threads.size() + 1;
+}
+
+void DemosaicWorkers::run(size_t count, const std::function<void(size_t)>& body)
+{
+    std::lock_guard<std::mutex> runLock(mPriv->runMutex);
+    std::unique_lock<std::mutex> lock(mPriv->mutex);
+    mPriv->body = &body;
+    mPriv->count = count;
+    mPriv->next = 0;
+    mPriv->generation++;
+    mPriv->started.notify_all();
+    mPriv->work(lock);
+    // The calls taken by the threads are over when none of them is working
+    mPriv->finished.wait(lock, [this]() { return mPriv->running == 0; });
+    mPriv->body = nullptr;
+}
+
+
+bool yarp::sig::impl::demosaic(const unsigned char* src, size_t srcStep,
+                               unsigned char* dest, size_t destStep, int destCode,
+                               size_t w, size_t h,
+                               BayerOrder order, DemosaicMethod method,
+                               size_t threads)
+{
+    DemosaicWorkers workers(bandsFor(h, threads));
+    return demosaic(src, srcStep, dest, destStep, destCode, w, h, order, method, workers);
+}
+
+bool yarp::sig::impl::demosaic(const unsigned char* src, size_t srcStep,
+                               unsigned char* dest, size_t destStep, int destCode,
+                               size_t w, size_t h,
+                               BayerOrder order, DemosaicMethod method,
+                               DemosaicWorkers& workers)
+{
+    Layout layout;
+    if (!getLayout(destCode, layout)) {
+        return false;
+    }
+    const Converter converter {src, srcStep, dest, destStep, w, h, layout, getPattern(order), method,
+                               selectInnerRow(layout.pixelSize, method)};
+    convertBands(h, workers, [&converter](size_t y0, size_t y1) { converter.convertRows(y0, y1); });
+    return true;
+}
+
+bool yarp::sig::impl::demosaicHalf(const unsigned char* src, size_t srcStep,
+                                   unsigned char* dest, size_t destStep, int destCode,
+                                   size_t w, size_t h,
+                                   BayerOrder order,
+                                   size_t threads)
+{
+    DemosaicWorkers workers(bandsFor(h / 2, threads));
+    return demosaicHalf(src, srcStep, dest, destStep, destCode, w, h, order, workers);
+}
+
+bool yarp::sig::impl::demosaicHalf(const unsigned char* src, size_t srcStep,
+                                   unsigned char* dest, size_t destStep, int destCode,
+                                   size_t w, size_t h,
+                                   BayerOrder order,
+                                   DemosaicWorkers& workers)
+{
+    Layout layout;
+    if (!getLayout(destCode, layout)) {
+        return false;
+    }
+    const HalfConverter converter {src, srcStep, dest, destStep, w / 2, layout, getPattern(order),
+                                   selectHalfRow(layout.pixelSize)};
+    convertBands(h / 2, workers, [&converter](size_t y0, size_t y1) { converter.convertRows(y0, y1); });
+    return true;
+}
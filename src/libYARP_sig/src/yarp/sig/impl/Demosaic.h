@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_DEMOSAIC_H
+#define YARP_SIG_IMPL_DEMOSAIC_H
+
+#include <yarp/sig/api.h>
+
+#include <cstddef>
+#include <functional>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * The colours of the first two pixels of the first two rows of a bayer
+ * image.
+ */
+enum class BayerOrder
+{
+    GRBG,
+    GBRG,
+    RGGB,
+    BGGR
+};
+
+enum class DemosaicMethod
+{
+    /**
+     * Each missing colour is the average of the nearest pixels of that
+     * colour (two or four).
+     */
+    Bilinear,
+    /**
+     * As Bilinear, but the green of the red and blue pixels is the average
+     * of the two green pixels along the direction (horizontal or vertical)
+     * where the green changes less, when there is one.
+     */
+    EdgeAware
+};
+
+/**
+ * Threads converting the bands of rows of the images, kept from an image
+ * to the next.  A conversion uses the calling thread too, so `threads`
+ * includes it and a single thread starts no other thread.
+ * The conversions using the same workers are done one at a time.
+ */
+class YARP_sig_API DemosaicWorkers
+{
+public:
+    explicit DemosaicWorkers(size_t threads = 1);
+    ~DemosaicWorkers();
+
+    DemosaicWorkers(const DemosaicWorkers&) = delete;
+    DemosaicWorkers& operator=(const DemosaicWorkers&) = delete;
+
+    /**
+     * @return the number of threads, the calling thread included.
+     */
+    size_t size() const;
+
+    /**
+     * Call body(i) for each i in [0, count), at the same time on the
+     * threads, and return when they are all done.
+     */
+    void run(size_t count, const std::function<void(size_t)>& body);
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    class Private;
+    Private* const mPriv;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+/**
+ * Convert an 8 bit bayer image (w x h pixels, rows of srcStep bytes) to
+ * a colour image with the same size, written directly in dest (rows of
+ * destStep bytes).
+ * The pixels on the border of the image average the neighbours that are
+ * inside the image.  The inner pixels are converted with SSSE3
+ * instructions when the CPU supports them, with the same result.
+ * The rows are split in bands, converted at the same time by up to
+ * `threads` threads (the calling thread included).  The threads are
+ * started for this image only, use the overload taking DemosaicWorkers to
+ * convert a sequence of images.
+ *
+ * @param destCode the pixel type of dest, VOCAB_PIXEL_RGB, VOCAB_PIXEL_BGR,
+ *        VOCAB_PIXEL_RGBA or VOCAB_PIXEL_BGRA (the alpha is set to 255)
+ * @return false if destCode is not supported
+ */
+YARP_sig_API bool demosaic(const unsigned char* src, size_t srcStep,
+                           unsigned char* dest, size_t destStep, int destCode,
+                           size_t w, size_t h,
+                           BayerOrder order, DemosaicMethod method,
+                           size_t threads = 1);
+
+/**
+ * As demosaic() above, with the bands converted by `workers`.
+ */
+YARP_sig_API bool demosaic(const unsigned char* src, size_t srcStep,
+                           unsigned char* dest, size_t destStep, int destCode,
+                           size_t w, size_t h,
+                           BayerOrder order, DemosaicMethod method,
+                           DemosaicWorkers& workers);
+
+/**
+ * Convert an 8 bit bayer image (w x h pixels) to a colour image of
+ * w/2 x h/2 pixels, one for each 2x2 cell of the bayer image (the green
+ * is the average of the two green pixels of the cell).
+ * The arguments are the same of demosaic().
+ */
+YARP_sig_API bool demosaicHalf(const unsigned char* src, size_t srcStep,
+                               unsigned char* dest, size_t destStep, int destCode,
+                               size_t w, size_t h,
+                               BayerOrder order,
+                               size_t threads = 1);
+
+/**
+ * As demosaicHalf() above, with the bands converted by `workers`.
+ */
+YARP_sig_API bool demosaicHalf(const unsigned char* src, size_t srcStep,
+                               unsigned char* dest, size_t destStep, int destCode,
+                               size_t w, size_t h,
+                               BayerOrder order,
+                               DemosaicWorkers& workers);
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_DEMOSAIC_H
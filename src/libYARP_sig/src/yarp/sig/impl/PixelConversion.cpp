@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/PixelConversion.h>
+
+#include <yarp/sig/Image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define YARP_PIXEL_CONVERSION_SSSE3
+#    include <tmmintrin.h>
+#endif
+
+#if defined(YARP_PIXEL_CONVERSION_SSSE3)
+namespace {
+
+/*
+ * There are two kinds of conversions:
+ *  - shuffle: each byte of the destination pixel is a byte of the source
+ *    pixel, or 255 (alpha).  A step loads 16 bytes of the source, and
+ *    stores `vectors` blocks of 16 bytes, each one made by a pshufb.
+ *  - average: the destination is mono, (r + g + b) / 3.  A step loads
+ *    `vectors` blocks of 16 bytes of the source, gathers the channels
+ *    with a pshufb for each block and channel, and adds them.
+ * Each step converts `pixels` pixels, the pixels at the end of the row
+ * that do not fill a step are converted one by one.
+ * The row functions are templates on the pixel sizes, so that the
+ * compiler can unroll the steps.
+ */
+struct Conversion;
+
+using RowFunction = size_t (*)(const Conversion& c, const unsigned char* src, unsigned char* dest, size_t w);
+
+struct Conversion
+{
+    int id1;
+    int id2;
+    size_t srcSize;
+    size_t destSize;
+    bool average;
+    // the byte of the source pixel for each byte of the destination
+    // pixel, -1 for 255
+    int map[4];
+    size_t pixels;
+    size_t vectors;
+    // shuffle: masks[v] makes the destination block v
+    // average: masks[3 * v + c] takes channel c from the source block v
+    alignas(16) unsigned char masks[12][16];
+    alignas(16) unsigned char fill[4][16];
+    RowFunction row;
+};
+
+struct Layout
+{
+    int id;
+    const char* channels;
+};
+
+constexpr Layout layouts[] = {
+    {VOCAB_PIXEL_MONO, "m"},
+    {VOCAB_PIXEL_RGB, "rgb"},
+    {VOCAB_PIXEL_BGR, "bgr"},
+    {VOCAB_PIXEL_RGBA, "rgba"},
+    {VOCAB_PIXEL_BGRA, "bgra"},
+};
+
+constexpr unsigned char ZERO = 0x80;
+
+inline __attribute__((target("ssse3"))) __m128i load(const unsigned char* p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline __attribute__((target("ssse3"))) void store(unsigned char* p, __m128i v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+template <size_t SRC, size_t DEST>
+__attribute__((target("ssse3"))) size_t shuffleRow_ssse3(const Conversion& c, const unsigned char* src, unsigned char* dest, size_t w)
+{
+    constexpr size_t VECTORS = (SRC == 1) ? DEST : 1;
+    constexpr size_t PIXELS = (SRC == 1) ? 16 : ((SRC > DEST) ? 16 / SRC : 16 / DEST);
+    // a step stores a single vector when the source has more channels,
+    // there are four independent steps in each iteration
+    constexpr size_t UNROLL = (SRC == 1) ? 1 : 4;
+    // bytes read and written by an iteration, the last bytes of each
+    // step are written again by the next one
+    constexpr size_t READ = (UNROLL - 1) * PIXELS * SRC + 16;
+    constexpr size_t WRITE = (UNROLL - 1) * PIXELS * DEST + 16 * VECTORS;
+
+    __m128i masks[VECTORS];
+    __m128i fill[VECTORS];
+    for (size_t v = 0; v < VECTORS; v++) {
+        masks[v] = load(c.masks[v]);
+        fill[v] = load(c.fill[v]);
+    }
+    const size_t srcBytes = w * SRC;
+    const size_t destBytes = w * DEST;
+    size_t j = 0;
+    for (; j * SRC + READ <= srcBytes && j * DEST + WRITE <= destBytes; j += UNROLL * PIXELS) {
+        for (size_t u = 0; u < UNROLL; u++) {
+            __m128i in = load(src + (j + u * PIXELS) * SRC);
+            for (size_t v = 0; v < VECTORS; v++) {
+                store(dest + (j + u * PIXELS) * DEST + 16 * v, _mm_or_si128(_mm_shuffle_epi8(in, masks[v]), fill[v]));
+            }
+        }
+    }
+    for (; j * SRC + 16 <= srcBytes && j * DEST + 16 * VECTORS <= destBytes; j += PIXELS) {
+        __m128i in = load(src + j * SRC);
+        for (size_t v = 0; v < VECTORS; v++) {
+            store(dest + j * DEST + 16 * v, _mm_or_si128(_mm_shuffle_epi8(in, masks[v]), fill[v]));
+        }
+    }
+    return j;
+}
+
+// (x * 21846) >> 16 == x / 3 for x <= 3 * 255
+inline __attribute__((target("ssse3"))) __m128i third(__m128i lo, __m128i hi)
+{
+    const __m128i k = _mm_set1_epi16(21846);
+    return _mm_packus_epi16(_mm_mulhi_epu16(lo, k), _mm_mulhi_epu16(hi, k));
+}
+
+template <size_t SRC>
+__attribute__((target("ssse3"))) size_t averageRow_ssse3(const Conversion& c, const unsigned char* src, unsigned char* dest, size_t w)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i masks[3 * SRC];
+    for (size_t m = 0; m < 3 * SRC; m++) {
+        masks[m] = load(c.masks[m]);
+    }
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        __m128i channels[3] = {zero, zero, zero};
+        for (size_t v = 0; v < SRC; v++) {
+            __m128i in = load(src + j * SRC + 16 * v);
+            for (size_t k = 0; k < 3; k++) {
+                channels[k] = _mm_or_si128(channels[k], _mm_shuffle_epi8(in, masks[3 * v + k]));
+            }
+        }
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(channels[0], zero),
+                                                 _mm_unpacklo_epi8(channels[1], zero)),
+                                   _mm_unpacklo_epi8(channels[2], zero));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(channels[0], zero),
+                                                 _mm_unpackhi_epi8(channels[1], zero)),
+                                   _mm_unpackhi_epi8(channels[2], zero));
+        store(dest + j, third(lo, hi));
+    }
+    return j;
+}
+
+// with four bytes per pixel the channels are added by pmaddubsw, that
+// gives r + g and b + 0 for each pixel, and by phaddw
+template <>
+__attribute__((target("ssse3"))) size_t averageRow_ssse3<4>(const Conversion& c, const unsigned char* src, unsigned char* dest, size_t w)
+{
+    YARP_UNUSED(c);
+    const __m128i weights = _mm_setr_epi8(1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0);
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        __m128i a = _mm_maddubs_epi16(load(src + j * 4), weights);
+        __m128i b = _mm_maddubs_epi16(load(src + j * 4 + 16), weights);
+        __m128i d = _mm_maddubs_epi16(load(src + j * 4 + 32), weights);
+        __m128i e = _mm_maddubs_epi16(load(src + j * 4 + 48), weights);
+        store(dest + j, third(_mm_hadd_epi16(a, b), _mm_hadd_epi16(d, e)));
+    }
+    return j;
+}
+
+template <size_t SRC>
+RowFunction shuffleRow(size_t destSize)
+{
+    return (destSize == 3) ? shuffleRow_ssse3<SRC, 3> : shuffleRow_ssse3<SRC, 4>;
+}
+
+Conversion makeShuffle(const Layout& from, const Layout& to)
+{
+    Conversion c {};
+    c.id1 = from.id;
+    c.id2 = to.id;
+    c.srcSize = strlen(from.channels);
+    c.destSize = strlen(to.channels);
+    c.average = false;
+    for (size_t i = 0; i < c.destSize; i++) {
+        const char* found = (c.srcSize == 1) ? from.channels : strchr(from.channels, to.channels[i]);
+        if (to.channels[i] == 'a' && (c.srcSize == 1 || found == nullptr)) {
+            c.map[i] = -1;
+        } else {
+            c.map[i] = static_cast<int>(found - from.channels);
+        }
+    }
+    if (c.srcSize == 1) {
+        c.pixels = 16;
+        c.vectors = c.destSize;
+    } else {
+        c.pixels = std::min(16 / c.srcSize, 16 / c.destSize);
+        c.vectors = 1;
+    }
+    for (size_t v = 0; v < c.vectors; v++) {
+        for (size_t b = 0; b < 16; b++) {
+            size_t t = 16 * v + b;
+            size_t pixel = t / c.destSize;
+            int src = c.map[t % c.destSize];
+            c.masks[v][b] = ZERO;
+            c.fill[v][b] = 0;
+            if (pixel >= c.pixels) {
+                // rewritten by the next step
+                continue;
+            }
+            if (src < 0) {
+                c.fill[v][b] = 255;
+            } else {
+                c.masks[v][b] = static_cast<unsigned char>(pixel * c.srcSize + src);
+            }
+        }
+    }
+    switch (c.srcSize) {
+    case 1:
+        c.row = shuffleRow<1>(c.destSize);
+        break;
+    case 3:
+        c.row = shuffleRow<3>(c.destSize);
+        break;
+    default:
+        c.row = shuffleRow<4>(c.destSize);
+        break;
+    }
+    return c;
+}
+
+Conversion makeAverage(const Layout& from, const Layout& to)
+{
+    Conversion c {};
+    c.id1 = from.id;
+    c.id2 = to.id;
+    c.srcSize = strlen(from.channels);
+    c.destSize = 1;
+    c.average = true;
+    c.pixels = 16;
+    c.vectors = c.srcSize;
+    // r, g and b are always the first three bytes, in some order
+    for (size_t v = 0; v < c.vectors; v++) {
+        for (size_t channel = 0; channel < 3; channel++) {
+            for (size_t pixel = 0; pixel < 16; pixel++) {
+                size_t t = pixel * c.srcSize + channel;
+                c.masks[3 * v + channel][pixel] = (t / 16 == v) ? static_cast<unsigned char>(t % 16) : ZERO;
+            }
+        }
+    }
+    c.row = (c.srcSize == 3) ? averageRow_ssse3<3> : averageRow_ssse3<4>;
+    return c;
+}
+
+std::vector<Conversion> makeConversions()
+{
+    std::vector<Conversion> conversions;
+    for (const auto& from : layouts) {
+        for (const auto& to : layouts) {
+            if (to.id != VOCAB_PIXEL_MONO) {
+                conversions.push_back(makeShuffle(from, to));
+            } else if (from.id != VOCAB_PIXEL_MONO) {
+                conversions.push_back(makeAverage(from, to));
+            }
+        }
+    }
+    return conversions;
+}
+
+void convertTail(const Conversion& c, const unsigned char* src, unsigned char* dest, size_t j, size_t w)
+{
+    for (; j < w; j++) {
+        const unsigned char* s = src + j * c.srcSize;
+        unsigned char* d = dest + j * c.destSize;
+        if (c.average) {
+            *d = static_cast<unsigned char>((s[0] + s[1] + s[2]) / 3);
+            continue;
+        }
+        for (size_t i = 0; i < c.destSize; i++) {
+            d[i] = (c.map[i] < 0) ? 255 : s[c.map[i]];
+        }
+    }
+}
+
+} // namespace
+#endif
+
+bool yarp::sig::impl::convertPixels(const unsigned char* src, int id1,
+                                    unsigned char* dest, int id2,
+                                    size_t w, size_t h,
+                                    size_t quantum1, size_t quantum2,
+                                    bool flip)
+{
+#if defined(YARP_PIXEL_CONVERSION_SSSE3)
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+    static const std::vector<Conversion> conversions = makeConversions();
+    if (!ssse3 || quantum1 == 0 || quantum2 == 0) {
+        return false;
+    }
+    auto it = std::find_if(conversions.begin(), conversions.end(), [&](const Conversion& c) {
+        return c.id1 == id1 && c.id2 == id2;
+    });
+    if (it == conversions.end()) {
+        return false;
+    }
+    const Conversion& c = *it;
+    const size_t srcStep = w * c.srcSize + PAD_BYTES(w * c.srcSize, quantum1);
+    const size_t destStep = w * c.destSize + PAD_BYTES(w * c.destSize, quantum2);
+    for (size_t i = 0; i < h; i++) {
+        const unsigned char* s = src + i * srcStep;
+        unsigned char* d = dest + (flip ? (h - 1 - i) : i) * destStep;
+        size_t j = c.row(c, s, d, w);
+        convertTail(c, s, d, j, w);
+    }
+    return true;
+#else
+    YARP_UNUSED(src);
+    YARP_UNUSED(id1);
+    YARP_UNUSED(dest);
+    YARP_UNUSED(id2);
+    YARP_UNUSED(w);
+    YARP_UNUSED(h);
+    YARP_UNUSED(quantum1);
+    YARP_UNUSED(quantum2);
+    YARP_UNUSED(flip);
+    return false;
+#endif
+}
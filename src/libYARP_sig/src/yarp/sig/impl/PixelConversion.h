@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_PIXELCONVERSION_H
+#define YARP_SIG_IMPL_PIXELCONVERSION_H
+
+#include <yarp/sig/api.h>
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * Vectorized conversions between the 8 bit pixel types (mono, rgb, bgr,
+ * rgba and bgra), used by Image::copyPixels().  The result is the same
+ * of the CopyPixel() functions in Image.copyPixels.cpp.
+ * The arguments are the same of Image::copyPixels(), flip is true when
+ * the images have a different origin.
+ *
+ * @return false if there is no vectorized conversion for these pixel
+ *         codes on this CPU, and nothing was copied.
+ */
+YARP_sig_API bool convertPixels(const unsigned char* src, int id1,
+                                unsigned char* dest, int id2,
+                                size_t w, size_t h,
+                                size_t quantum1, size_t quantum2,
+                                bool flip);
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_PIXELCONVERSION_H
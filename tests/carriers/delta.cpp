@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+#include <yarp/os/Network.h>
+#include <yarp/sig/Vector.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+TEST_CASE("carriers::delta", "[carriers]")
+{
+    YARP_REQUIRE_PLUGIN("portmonitor", "carrier");
+    YARP_REQUIRE_PLUGIN("delta", "portmonitor");
+
+    Network::setLocalMode(true);
+
+    SECTION("test keyframes and deltas")
+    {
+        BufferedPort<Vector> in;
+        Port out;
+        in.setStrict();
+
+        REQUIRE(in.open("/delta/in"));
+        REQUIRE(out.open("/delta/out"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "tcp+send.portmonitor+recv.portmonitor+type.dll+file.delta+keyframe.10"));
+
+        Vector v(20, 0.0);
+        for (int i = 0; i < 35; i++) {
+            // only a few values change, and once the size too
+            v[i % 20] += 0.5;
+            if (i == 25) {
+                v.push_back(1.0);
+            }
+            out.write(v);
+
+            Vector* received = in.read();
+            REQUIRE(received != nullptr);
+            REQUIRE(received->size() == v.size());
+            for (size_t j = 0; j < v.size(); j++) {
+                CHECK((*received)[j] == v[j]);
+            }
+        }
+
+        in.close();
+        out.close();
+    }
+
+    Network::setLocalMode(false);
+}
@@ -13,6 +13,8 @@
 #include <catch.hpp>
 #include <harness.h>
 
+#include <cstdlib>
+
 using namespace yarp::os;
 using namespace yarp::sig;
 
@@ -53,5 +55,91 @@ TEST_CASE("carriers::mjpeg", "[carriers]")
         out.close();
     }
 
+    SECTION("test quality, subsampling and envelope")
+    {
+        BufferedPort<ImageOf<PixelRgb>> out;
+        BufferedPort<ImageOf<PixelRgb>> high;
+        BufferedPort<ImageOf<PixelRgb>> low;
+        BufferedPort<ImageOf<PixelRgb>> low2;
+        BufferedPort<ImageOf<PixelRgb>> gray;
+
+        REQUIRE(out.open("/mjpeg/out"));
+        REQUIRE(high.open("/mjpeg/high"));
+        REQUIRE(low.open("/mjpeg/low"));
+        REQUIRE(low2.open("/mjpeg/low2"));
+        REQUIRE(gray.open("/mjpeg/gray"));
+        REQUIRE(Network::connect(out.getName(), high.getName(), "mjpeg+quality.95+subsampling.444"));
+        REQUIRE(Network::connect(out.getName(), low.getName(), "mjpeg+quality.20"));
+        REQUIRE(Network::connect(out.getName(), low2.getName(), "mjpeg+quality.20"));
+        REQUIRE(Network::connect(out.getName(), gray.getName(), "mjpeg+subsampling.gray"));
+
+        // sharp colour edges, that are lost with a low quality
+        ImageOf<PixelRgb>& outImg = out.prepare();
+        outImg.resize(320, 240);
+        for (size_t y = 0; y < outImg.height(); y++) {
+            for (size_t x = 0; x < outImg.width(); x++) {
+                bool square = ((x / 8) + (y / 8)) % 2 != 0;
+                outImg.pixel(x, y) = PixelRgb(square ? 220 : 20, x % 256, square ? 30 : 200);
+            }
+        }
+        ImageOf<PixelRgb> sent = outImg;
+
+        Stamp stamp(42, 1.5);
+        out.setEnvelope(stamp);
+        out.write();
+        yarp::os::Time::delay(0.4);
+
+        auto error = [&sent](const ImageOf<PixelRgb>& img) {
+            double total = 0;
+            for (size_t y = 0; y < sent.height(); y++) {
+                for (size_t x = 0; x < sent.width(); x++) {
+                    total += std::abs(img.pixel(x, y).r - sent.pixel(x, y).r);
+                    total += std::abs(img.pixel(x, y).g - sent.pixel(x, y).g);
+                    total += std::abs(img.pixel(x, y).b - sent.pixel(x, y).b);
+                }
+            }
+            return total / (sent.width() * sent.height() * 3);
+        };
+
+        ImageOf<PixelRgb>* highImg = high.read();
+        ImageOf<PixelRgb>* lowImg = low.read();
+        ImageOf<PixelRgb>* low2Img = low2.read();
+        ImageOf<PixelRgb>* grayImg = gray.read();
+        REQUIRE(highImg != nullptr);
+        REQUIRE(lowImg != nullptr);
+        REQUIRE(low2Img != nullptr);
+        REQUIRE(grayImg != nullptr);
+        REQUIRE(highImg->width() == sent.width());
+        REQUIRE(lowImg->width() == sent.width());
+        REQUIRE(low2Img->width() == sent.width());
+        REQUIRE(grayImg->width() == sent.width());
+
+        INFO("quality 95: " << error(*highImg) << ", quality 20: " << error(*lowImg));
+        CHECK(error(*highImg) < 3);
+        CHECK(error(*highImg) * 2 < error(*lowImg));
+        CHECK(error(*low2Img) == error(*lowImg)); // same frame
+
+        bool allGray = true;
+        for (size_t y = 0; y < grayImg->height(); y++) {
+            for (size_t x = 0; x < grayImg->width(); x++) {
+                const PixelRgb& p = grayImg->pixel(x, y);
+                allGray = allGray && p.r == p.g && p.g == p.b;
+            }
+        }
+        CHECK(allGray);
+
+        Stamp received;
+        CHECK(high.getEnvelope(received));
+        CHECK(received.getCount() == 42);
+        CHECK(received.getTime() == 1.5);
+        CHECK(gray.getEnvelope(received));
+        CHECK(received.getCount() == 42);
+
+        for (auto* port : {&high, &low, &low2, &gray, &out}) {
+            port->interrupt();
+            port->close();
+        }
+    }
+
     Network::setLocalMode(false);
 }
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+#include <yarp/os/Network.h>
+#include <yarp/sig/all.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <thread>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+TEST_CASE("carriers::shmem", "[carriers]")
+{
+    YARP_REQUIRE_PLUGIN("shmem", "carrier");
+
+#if !defined(__linux__)
+    YARP_SKIP_TEST("shmem+ring is available only on Linux");
+#endif
+
+    Network::setLocalMode(true);
+
+    SECTION("test ring with messages larger than the ring")
+    {
+        std::string inName {"/shmem/in"};
+        std::string outName {"/shmem/out"};
+
+        BufferedPort<ImageOf<PixelRgb>> in;
+        Port out;
+
+        REQUIRE(in.open(inName));
+        REQUIRE(out.open(outName));
+        // A 64 KB ring is smaller than the image, so the writer has to wait
+        // for the reader several times while sending a single frame.
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shmem+ring+size.65536"));
+
+        size_t width {320};
+        size_t height {240};
+        ImageOf<PixelRgb> outImg;
+        outImg.resize(width, height);
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                outImg.pixel(x, y) = PixelRgb(x % 256, y % 256, (x + y) % 256);
+            }
+        }
+
+        for (int i = 0; i < 5; ++i) {
+            outImg.pixel(0, 0).r = static_cast<unsigned char>(i);
+            out.write(outImg);
+
+            ImageOf<PixelRgb>* inImg = in.read();
+            REQUIRE(inImg != nullptr);
+            CHECK(inImg->width() == width);
+            CHECK(inImg->height() == height);
+            CHECK(inImg->pixel(0, 0).r == i);
+            CHECK(inImg->pixel(width - 1, height - 1).g == (height - 1) % 256);
+            CHECK(inImg->pixel(width - 1, height - 1).b == (width + height - 2) % 256);
+        }
+
+        REQUIRE(Network::disconnect(out.getName(), in.getName()));
+
+        in.interrupt();
+        in.close();
+        out.interrupt();
+        out.close();
+    }
+
+    SECTION("test ring with images in shared memory")
+    {
+        BufferedPort<ImageOf<PixelRgb>> in;
+        Port out;
+
+        REQUIRE(in.open("/shmem/in"));
+        REQUIRE(out.open("/shmem/out"));
+        // The image is bigger than the ring, but only its handle goes
+        // through the ring.
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shmem+ring+size.65536"));
+
+        size_t width {640};
+        size_t height {480};
+        ImageOf<PixelRgb> outImg;
+        outImg.setSharedMemory(true);
+        outImg.resize(width, height);
+        REQUIRE(outImg.isSharedMemory());
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                outImg.pixel(x, y) = PixelRgb(x % 256, y % 256, (x + y) % 256);
+            }
+        }
+
+        for (int i = 0; i < 5; ++i) {
+            outImg.pixel(0, 0).r = static_cast<unsigned char>(i);
+            out.write(outImg);
+
+            ImageOf<PixelRgb>* inImg = in.read();
+            REQUIRE(inImg != nullptr);
+            CHECK(inImg->width() == width);
+            CHECK(inImg->height() == height);
+            CHECK(inImg->pixel(0, 0).r == i);
+            CHECK(inImg->pixel(width - 1, height - 1).g == (height - 1) % 256);
+            CHECK(inImg->pixel(width - 1, height - 1).b == (width + height - 2) % 256);
+        }
+
+        REQUIRE(Network::disconnect(out.getName(), in.getName()));
+
+        in.interrupt();
+        in.close();
+        out.interrupt();
+        out.close();
+    }
+
+    SECTION("test ring with replies")
+    {
+        Port server;
+        Port client;
+
+        REQUIRE(server.open("/shmem/server"));
+        REQUIRE(client.open("/shmem/client"));
+        REQUIRE(Network::connect(client.getName(), server.getName(), "shmem+ring"));
+
+        Bottle cmd;
+        Bottle reply;
+        cmd.addString("hello");
+        cmd.addInt32(42);
+
+        bool done = false;
+        std::thread responder([&]() {
+            Bottle in;
+            Bottle out;
+            if (server.read(in, true)) {
+                out.addString("ack");
+                out.append(in);
+                server.reply(out);
+            }
+            done = true;
+        });
+
+        REQUIRE(client.write(cmd, reply));
+        responder.join();
+        CHECK(done);
+        CHECK(reply.toString() == "ack hello 42");
+
+        client.close();
+        server.close();
+    }
+
+    Network::setLocalMode(false);
+}
@@ -279,6 +279,24 @@ TEST_CASE("dev::ControlBoardRemapperTest", "[yarp::dev]")
         // Test the controlboardremapper
         checkRemapper(ddRemapper,200,nrOfRemappedAxes);
 
+        // Open a controlboardremapper reading the controlboards in parallel
+        PolyDriver ddParallelRemapper;
+        Property pParallelRemapper;
+        pParallelRemapper.fromString(pRemapper.toString());
+        pParallelRemapper.put("parallel_subdevices", true);
+
+        REQUIRE(ddParallelRemapper.open(pParallelRemapper)); // parallel controlboardremapper open reported successful
+
+        yarp::dev::IMultipleWrapper *imultwrapParallel = nullptr;
+        REQUIRE(ddParallelRemapper.view(imultwrapParallel)); // interface for multiple wrapper correctly opened
+
+        CHECK(imultwrapParallel->attachAll(fmcList)); // attachAll for parallel controlboardremapper successful
+
+        checkRemapper(ddParallelRemapper,300,nrOfRemappedAxes);
+
+        imultwrapParallel->detachAll();
+        ddParallelRemapper.close();
+
         // Open the remotecontrolboardremapper
         PolyDriver ddRemoteRemapper;
         Property pRemoteRemapper;
@@ -10,6 +10,7 @@
 #include <yarp/dev/PolyDriver.h>
 
 #include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
 #include <yarp/dev/FrameGrabberInterfaces.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/IMultipleWrapper.h>
@@ -69,3 +70,79 @@ TEST_CASE("dev::ControlBoardWrapper2", "[yarp::dev]")
         CHECK(dd2.close()); // close dd2 reported successful
     }
 }
+
+TEST_CASE("dev::ControlBoardWrapper2ParallelSubdevices", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("fakeMotionControl", "device");
+    YARP_REQUIRE_PLUGIN("remote_controlboard", "device");
+
+    Network::setLocalMode(true);
+
+    SECTION("test reading the subdevices in parallel")
+    {
+        // Two boards, merged by a wrapper that reads them in parallel
+        PolyDriver board1;
+        PolyDriver board2;
+        Property pb1;
+        Property pb2;
+        pb1.fromConfig("device fakeMotionControl\n[GENERAL]\nJoints 2\n");
+        pb2.fromConfig("device fakeMotionControl\n[GENERAL]\nJoints 3\n");
+        REQUIRE(board1.open(pb1)); // first fakeMotionControl open reported successful
+        REQUIRE(board2.open(pb2)); // second fakeMotionControl open reported successful
+
+        PolyDriver dd;
+        Property p;
+        p.fromConfig("device controlboardwrapper2\n"
+                     "name /parallelMotor\n"
+                     "period 10\n"
+                     "parallel_subdevices true\n"
+                     "networks (net_1 net_2)\n"
+                     "joints 5\n"
+                     "net_1 (0 1 0 1)\n"
+                     "net_2 (2 4 0 2)\n");
+        REQUIRE(dd.open(p)); // controlboardwrapper open reported successful
+
+        yarp::dev::IMultipleWrapper* iwrap = nullptr;
+        REQUIRE(dd.view(iwrap)); // IMultipleWrapper view reported successful
+        PolyDriverList list;
+        list.push(&board1, "net_1");
+        list.push(&board2, "net_2");
+        REQUIRE(iwrap->attachAll(list)); // controlboardwrapper attached to both boards
+
+        IPositionControl* pos = nullptr;
+        REQUIRE(dd.view(pos)); // interface reported
+        double refs[5] = {10.0, 20.0, 30.0, 40.0, 50.0};
+        CHECK(pos->positionMove(refs)); // positionMove correctly called
+
+        // The client reads the state published by the wrapper thread
+        PolyDriver dd2;
+        Property p2;
+        p2.put("device","remote_controlboard");
+        p2.put("remote","/parallelMotor");
+        p2.put("local","/parallelMotor/client");
+        p2.put("carrier","tcp");
+        p2.put("ignoreProtocolCheck","true");
+        REQUIRE(dd2.open(p2)); // remote_controlboard open reported successful
+
+        IEncoders* encs = nullptr;
+        REQUIRE(dd2.view(encs)); // interface reported
+        double read[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        bool ok = false;
+        for (int wait = 0; wait < 100 && !ok; wait++) {
+            yarp::os::Time::delay(0.01);
+            ok = encs->getEncoders(read);
+        }
+        CHECK(ok); // getEncoders correctly called
+        for (int i = 0; i < 5; i++) {
+            CHECK(read[i] == refs[i]); // encoders read in parallel match the references
+        }
+
+        CHECK(dd2.close()); // close dd2 reported successful
+        CHECK(iwrap->detachAll()); // detachAll reported successful
+        CHECK(dd.close()); // close dd reported successful
+        CHECK(board1.close()); // close board1 reported successful
+        CHECK(board2.close()); // close board2 reported successful
+    }
+
+    Network::setLocalMode(false);
+}
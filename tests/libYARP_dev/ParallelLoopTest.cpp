@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/dev/impl/ParallelLoop.h>
+
+#include <yarp/os/SystemClock.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using yarp::dev::impl::ParallelLoop;
+
+TEST_CASE("dev::impl::ParallelLoopTest", "[yarp::dev]")
+{
+    SECTION("Without workers the loop is sequential")
+    {
+        ParallelLoop loop;
+        CHECK(loop.getWorkers() == 0);
+
+        std::vector<size_t> order;
+        loop.run(5, [&](size_t i) { order.push_back(i); });
+        CHECK(order == std::vector<size_t>{0, 1, 2, 3, 4});
+    }
+
+    SECTION("Each iteration runs once")
+    {
+        ParallelLoop loop;
+        REQUIRE(loop.start(3));
+        CHECK(loop.getWorkers() == 3);
+
+        std::vector<std::atomic<int>> calls(16);
+        for (int run = 0; run < 100; run++) {
+            for (auto& c : calls) {
+                c = 0;
+            }
+            loop.run(calls.size(), [&](size_t i) { calls[i]++; });
+            for (auto& c : calls) {
+                CHECK(c == 1);
+            }
+        }
+
+        loop.stop();
+        CHECK(loop.getWorkers() == 0);
+    }
+
+    SECTION("The iterations run at the same time")
+    {
+        ParallelLoop loop;
+        REQUIRE(loop.start(3));
+
+        // 4 iterations of 0.1s each take about 0.1s when run in parallel
+        double start = yarp::os::SystemClock::nowSystem();
+        loop.run(4, [](size_t) { yarp::os::SystemClock::delaySystem(0.1); });
+        double elapsed = yarp::os::SystemClock::nowSystem() - start;
+        CHECK(elapsed < 0.3);
+    }
+
+    SECTION("Loops run by several threads are not mixed")
+    {
+        ParallelLoop loop;
+        REQUIRE(loop.start(2));
+
+        auto caller = [&loop](std::vector<std::atomic<int>>& calls, int& errors) {
+            for (int run = 0; run < 200; run++) {
+                for (auto& c : calls) {
+                    c = 0;
+                }
+                loop.run(calls.size(), [&calls](size_t i) {
+                    calls[i]++;
+                    std::this_thread::yield();
+                });
+                for (auto& c : calls) {
+                    if (c != 1) {
+                        errors++;
+                    }
+                }
+            }
+        };
+        std::vector<std::atomic<int>> callsA(8);
+        std::vector<std::atomic<int>> callsB(5);
+        int errorsA = 0;
+        int errorsB = 0;
+        std::thread other([&]() { caller(callsB, errorsB); });
+        caller(callsA, errorsA);
+        other.join();
+        CHECK(errorsA == 0); // "each loop runs its own iterations, once"
+        CHECK(errorsB == 0);
+    }
+}
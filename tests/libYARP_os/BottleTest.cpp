@@ -17,6 +17,9 @@
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
+#include <thread>
+#include <vector>
+
 #include <catch.hpp>
 #include <harness.h>
 
@@ -538,4 +541,130 @@ TEST_CASE("os::BottleTest", "[yarp::os]")
 
 
     }
+
+    SECTION("test homogeneous numeric lists")
+    {
+        // Lists of numbers of the same type are kept packed until an
+        // item is needed, check that nothing changes from the outside
+        Bottle b;
+        for (int i = 0; i < 100; i++) {
+            b.addFloat64(i * 0.5);
+        }
+        Bottle& sub = b.addList();
+        sub.addInt16(1);
+        sub.addInt16(-2);
+        Bottle vocabs;
+        vocabs.addVocab(createVocab('p', 'o', 's'));
+        vocabs.addVocab(createVocab('v', 'e', 'l'));
+
+        DummyConnector con;
+        b.write(con.getWriter());
+        Bottle b2;
+        b2.read(con.getReader());
+        REQUIRE(b2.size() == 101);
+        CHECK(b2.get(10).isFloat64());
+        CHECK(b2.get(99).asFloat64() == 49.5);
+        Bottle* sub2 = b2.get(100).asList();
+        REQUIRE(sub2 != nullptr);
+        CHECK(sub2->get(1).isInt16());
+        CHECK(sub2->get(1).asInt16() == -2);
+        CHECK(b2.toString() == b.toString());
+
+        Bottle ints;
+        for (int i = 0; i < 10; i++) {
+            ints.addInt32(i);
+        }
+        con.reset();
+        ints.write(con.getWriter());
+        Bottle ints2;
+        ints2.read(con.getReader());
+        CHECK(ints2.size() == 10);
+        CHECK(ints2.getSpecialization() == BOTTLE_TAG_INT32);
+
+        // copies and ranges
+        Bottle ints3 = ints2;
+        CHECK(ints3.toString() == "0 1 2 3 4 5 6 7 8 9");
+        Bottle range;
+        range.copy(ints2, 7, 10);
+        CHECK(range.toString() == "7 8 9");
+        ints2.copy(ints2, 2, 3);
+        CHECK(ints2.toString() == "2 3 4");
+
+        // adding a different type, and vocabs
+        ints3.addFloat64(1.5);
+        ints3.addString("end");
+        CHECK(ints3.size() == 12);
+        CHECK(ints3.get(10).isFloat64());
+        CHECK(ints3.get(9).asInt32() == 9);
+        CHECK(ints3.pop().asString() == "end");
+        con.reset();
+        vocabs.write(con.getWriter());
+        Bottle vocabs2;
+        vocabs2.read(con.getReader());
+        CHECK(vocabs2.get(1).isVocab());
+        CHECK(vocabs2.toString() == "[pos] [vel]");
+    }
+
+    SECTION("test reading a packed list from several threads")
+    {
+        // The first threads asking for an item create all of them
+        Bottle ints;
+        for (int i = 0; i < 1000; i++) {
+            ints.addInt32(i);
+        }
+        const Bottle& shared = ints;
+        const int threads = 4;
+        std::vector<int> sums(threads, 0);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < threads; t++) {
+            readers.emplace_back([&shared, &sums, t]() {
+                for (size_t i = 0; i < shared.size(); i++) {
+                    sums[t] += shared.get(i).asInt32();
+                }
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        for (int t = 0; t < threads; t++) {
+            CHECK(sums[t] == 999 * 1000 / 2);
+        }
+    }
+
+    SECTION("test reading again into the same bottle")
+    {
+        // The items of a parsed message share the memory of the outermost
+        // bottle, check that they stay valid when they leave it
+        const std::string text = "(a 1 (b 2.5 \"c\")) (d (e f)) 42 \"str\" [vocab] null true";
+        Bottle src(text);
+        DummyConnector con;
+        src.write(con.getWriter());
+
+        Bottle b;
+        for (int i = 0; i < 5; i++) {
+            b.read(con.getReader());
+            CHECK(b.toString() == src.toString());
+            b.fromString(text);
+            CHECK(b.toString() == src.toString());
+        }
+
+        Value last = b.pop();
+        CHECK(last.isVocab());
+        CHECK(b.size() == 6);
+
+        Bottle moved = std::move(*b.get(1).asList());
+        b.clear();
+        CHECK(moved.toString() == "d (e f)");
+        moved.get(1).asList()->fromString("g h");
+        CHECK(moved.toString() == "d (g h)");
+
+        b.read(con.getReader());
+        Bottle* nested = b.get(0).asList();
+        REQUIRE(nested != nullptr);
+        nested->fromString("x y z");
+        nested->addInt32(3);
+        CHECK(b.get(0).toString() == "x y z 3");
+        b.read(con.getReader());
+        CHECK(b.toString() == src.toString());
+    }
 }
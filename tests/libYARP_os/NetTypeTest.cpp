@@ -43,6 +43,37 @@ TEST_CASE("os::NetTypeTest", "[yarp::os]")
         CHECK(ct1==ct2); // two identical sequences again
     }
 
+    SECTION("checking crc32c")
+    {
+        char check[] = "123456789";
+        CHECK(NetType::getCrc32c(check, 9) == 0xe3069283); // standard check value
+        CHECK(NetType::getCrc32c(check, 0) == 0);
+
+        // Compare with a bit at a time implementation, with all the
+        // alignments and the lengths that are not multiple of a word
+        char buf[300];
+        for (size_t i=0; i<sizeof(buf); i++) {
+            buf[i] = (char)(i*7+3);
+        }
+        bool ok = true;
+        for (size_t offset=0; offset<8; offset++) {
+            for (size_t len=0; len+offset<=sizeof(buf); len+=(len<40)?1:37) {
+                std::uint32_t crc = 0xffffffff;
+                for (size_t i=0; i<len; i++) {
+                    crc ^= (unsigned char)buf[offset+i];
+                    for (int k=0; k<8; k++) {
+                        crc = (crc & 1) ? (0x82f63b78 ^ (crc >> 1)) : (crc >> 1);
+                    }
+                }
+                crc ^= 0xffffffff;
+                if (NetType::getCrc32c(buf+offset, len) != crc) {
+                    ok = false;
+                }
+            }
+        }
+        CHECK(ok);
+    }
+
     SECTION("checking integer representation")
     {
         union {
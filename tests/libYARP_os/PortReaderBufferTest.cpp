@@ -13,6 +13,8 @@
 #include <yarp/os/Network.h>
 #include <yarp/os/Time.h>
 
+#include <thread>
+
 #include <catch.hpp>
 #include <harness.h>
 
@@ -174,5 +176,63 @@ TEST_CASE("os::PortReaderBufferTest", "[yarp::os]")
         }
     }
 
+    SECTION("checking limited buffers")
+    {
+        Port out;
+        BufferedPort<Bottle> in(2);
+        in.setStrict();
+        out.open("/out");
+        in.open("/in");
+        Network::connect("/out", "/in");
+        Network::sync("/out");
+        Network::sync("/in");
+
+        // the writer waits for a free buffer while the queue is full
+        std::thread writer([&out]() {
+            for (int i = 0; i < 10; i++) {
+                Bottle data;
+                data.addInt32(i);
+                out.write(data);
+            }
+        });
+        Time::delay(0.5);
+        CHECK(in.getPendingReads() == 2); // queue full
+
+        for (int i = 0; i < 10; i++) {
+            Bottle* bot = in.read();
+            REQUIRE(bot != nullptr); // message received
+            CHECK(bot->get(0).asInt32() == i); // no message lost
+        }
+        writer.join();
+        out.close();
+        in.close();
+    }
+
+    SECTION("checking limited buffers without strict mode")
+    {
+        Port out;
+        BufferedPort<Bottle> in(1);
+        out.open("/out");
+        in.open("/in");
+        Network::connect("/out", "/in");
+        Network::sync("/out");
+        Network::sync("/in");
+
+        // the writer does not wait, the new messages replace the old one
+        for (int i = 0; i < 10; i++) {
+            Bottle data;
+            data.addInt32(i);
+            out.write(data);
+        }
+        CHECK(in.getPendingReads() == 1);
+
+        Bottle* bot = in.read();
+        REQUIRE(bot != nullptr); // message received
+        CHECK(bot->get(0).asInt32() == 9); // the latest message
+        CHECK(in.getPendingReads() == 0);
+        out.close();
+        in.close();
+    }
+
     NetworkBase::setLocalMode(false);
 }
@@ -28,6 +28,7 @@
 #include <yarp/os/RpcServer.h>
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/TransformCache.h>
 
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/Drivers.h>
@@ -36,6 +37,9 @@
 
 #include <yarp/companion/impl/Companion.h>
 
+#include <memory>
+#include <string>
+
 #include <catch.hpp>
 #include <harness.h>
 
@@ -461,6 +465,44 @@ size_t TestModifyingCarrier::cnt_accept_out = 0;
 size_t TestModifyingCarrier::cnt_modify_out = 0;
 size_t TestModifyingCarrier::cnt_modify_reply = 0;
 
+// Appends " transformed" to the bottles it sends, sharing the result with
+// the other connections of the port through the TransformCache.
+class TestTransformingCarrier :
+        public yarp::os::ModifyingCarrier
+{
+public:
+    Carrier* create() const override
+    {
+        return new TestTransformingCarrier();
+    }
+
+    std::string getName() const override
+    {
+        return "test_transform";
+    }
+
+    const yarp::os::PortWriter& modifyOutgoingData(const yarp::os::PortWriter& writer) override
+    {
+        auto transform = [&writer]() -> std::shared_ptr<const std::string> {
+            ++cnt_transform;
+            const auto* bottle = dynamic_cast<const Bottle*>(&writer);
+            return std::make_shared<std::string>(bottle->toString() + " transformed");
+        };
+        TransformCache* cache = TransformCache::getCurrent();
+        text = (cache != nullptr) ? cache->get<std::string>(getName(), transform) : transform();
+        out.fromString(*text);
+        return out;
+    }
+
+    static size_t cnt_transform;
+
+private:
+    std::shared_ptr<const std::string> text;
+    Bottle out;
+};
+
+size_t TestTransformingCarrier::cnt_transform = 0;
+
 class BottleWithAck :
         public yarp::os::Bottle
 {
@@ -489,6 +531,7 @@ TEST_CASE("os::PortTest", "[yarp::os]")
                                                                                    "BrokenDevice"));
 
     yarp::os::Carriers::addCarrierPrototype(new TestModifyingCarrier);
+    yarp::os::Carriers::addCarrierPrototype(new TestTransformingCarrier);
 
     constexpr double duration_100ms = 0.1;
     constexpr double duration_200ms = 0.2;
@@ -1985,5 +2028,32 @@ TEST_CASE("os::PortTest", "[yarp::os]")
 #endif // ENABLE_BROKEN_TESTS
     }
 
+    SECTION("Check that the connections share the transformations of a message")
+    {
+        Port out;
+        BufferedPort<Bottle> in[3];
+        CHECK(out.open("/out"));
+        for (int i = 0; i < 3; i++) {
+            CHECK(in[i].open("/in" + std::to_string(i)));
+            CHECK(Network::connect(out.getName(), in[i].getName(), "tcp+send.test_transform"));
+        }
+        Network::sync("/out");
+
+        TestTransformingCarrier::cnt_transform = 0;
+        for (int msg = 1; msg <= 2; msg++) {
+            Bottle cmd_out("hello");
+            out.write(cmd_out);
+            for (auto& port : in) {
+                Bottle* cmd_in = port.read();
+                REQUIRE(cmd_in != nullptr);
+                CHECK(cmd_in->toString() == "hello transformed");
+            }
+            CHECK(TestTransformingCarrier::cnt_transform == static_cast<size_t>(msg)); // "once for each message"
+        }
+
+        // Without a port there is nothing to share
+        CHECK(TransformCache::getCurrent() == nullptr);
+    }
+
     NetworkBase::setLocalMode(false);
 }
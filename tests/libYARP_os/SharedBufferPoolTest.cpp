@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/SharedBufferPool.h>
+
+#include <string>
+
+#if defined(__linux__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+
+TEST_CASE("os::SharedBufferPoolTest", "[yarp::os]")
+{
+    if (!SharedBufferPool::isAvailable()) {
+        YARP_SKIP_TEST("Shared memory is not available on this platform");
+    }
+
+    SharedBufferPool& pool = SharedBufferPool::getInstance();
+
+    SECTION("pinned buffers are recycled when unpinned")
+    {
+        char* buffer = pool.allocate(10000);
+        REQUIRE(buffer != nullptr);
+        const auto* header = reinterpret_cast<const SharedBufferPool::SegmentHeader*>(buffer - SharedBufferPool::dataOffset);
+
+        SharedBufferPool::Handle handle;
+        REQUIRE(pool.pin(buffer + 100, 200, handle));
+        CHECK(handle.offset == SharedBufferPool::dataOffset + 100);
+        CHECK(handle.length == 200);
+
+        // released while a receiver can be reading it
+        pool.release(buffer);
+        CHECK(header->generation == handle.generation); // "not recycled"
+        SharedBufferPool::Handle other;
+        CHECK_FALSE(pool.find(buffer, 200, other)); // "no longer sent"
+        char* next = pool.allocate(10000);
+        CHECK(next != buffer);
+
+        pool.unpin(handle);
+        CHECK(header->generation == handle.generation + 1); // "recycled"
+        pool.release(next);
+    }
+
+#if defined(__linux__)
+    SECTION("segments of processes no longer running are removed")
+    {
+        // no process has this pid
+        const std::string name = SharedBufferPool::segmentName(2147483000, 7);
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+        REQUIRE(fd >= 0);
+        close(fd);
+
+        CHECK(SharedBufferPool::removeStaleSegments() >= 1);
+        fd = shm_open(name.c_str(), O_RDONLY, 0);
+        CHECK(fd < 0);
+        if (fd >= 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+        }
+
+        // the segments of this process are kept
+        char* buffer = pool.allocate(10000);
+        REQUIRE(buffer != nullptr);
+        SharedBufferPool::removeStaleSegments();
+        SharedBufferPool::Handle handle;
+        REQUIRE(pool.find(buffer, 10, handle));
+        fd = shm_open(SharedBufferPool::segmentName(handle.pid, handle.segment).c_str(), O_RDONLY, 0);
+        CHECK(fd >= 0);
+        if (fd >= 0) {
+            close(fd);
+        }
+        pool.release(buffer);
+    }
+#endif
+}
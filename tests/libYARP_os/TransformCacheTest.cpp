@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/TransformCache.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+
+TEST_CASE("os::TransformCacheTest", "[yarp::os]")
+{
+    SECTION("results are shared by key")
+    {
+        TransformCache cache;
+        int transforms = 0;
+        auto make = [&transforms](const std::string& text) {
+            return [&transforms, text]() -> std::shared_ptr<const std::string> {
+                transforms++;
+                return std::make_shared<std::string>(text);
+            };
+        };
+
+        auto first = cache.get<std::string>("carrier?a=1", make("one"));
+        auto second = cache.get<std::string>("carrier?a=1", make("ignored"));
+        auto other = cache.get<std::string>("carrier?a=2", make("two"));
+        CHECK(*first == "one");
+        CHECK(second == first);
+        CHECK(*other == "two");
+        CHECK(transforms == 2);
+        CHECK(cache.getHits() == 1);
+        CHECK(cache.getMisses() == 2);
+
+        cache.clear();
+        CHECK(cache.getHits() == 0);
+        CHECK(cache.getMisses() == 0);
+        CHECK(*cache.get<std::string>("carrier?a=1", make("again")) == "again");
+        CHECK(*first == "one"); // "the results outlive the cache"
+    }
+
+    SECTION("failed transformations are not kept")
+    {
+        TransformCache cache;
+        auto fail = []() -> std::shared_ptr<const int> { return nullptr; };
+        auto succeed = []() -> std::shared_ptr<const int> { return std::make_shared<int>(42); };
+        CHECK(cache.get<int>("key", fail) == nullptr);
+        auto result = cache.get<int>("key", succeed);
+        REQUIRE(result != nullptr);
+        CHECK(*result == 42);
+        CHECK(cache.getMisses() == 2);
+    }
+
+    SECTION("transformations that throw are not kept")
+    {
+        TransformCache cache;
+        auto fail = []() -> std::shared_ptr<const int> { throw std::runtime_error("failed"); };
+        auto succeed = []() -> std::shared_ptr<const int> { return std::make_shared<int>(42); };
+        CHECK_THROWS_AS(cache.get<int>("key", fail), std::runtime_error);
+        auto result = cache.get<int>("key", succeed);
+        REQUIRE(result != nullptr);
+        CHECK(*result == 42);
+        CHECK(cache.getMisses() == 2);
+    }
+
+    SECTION("concurrent users wait for a single transformation")
+    {
+        TransformCache cache;
+        std::atomic<int> transforms {0};
+        const int threads = 4;
+        std::vector<std::shared_ptr<const int>> results(threads);
+        std::vector<std::thread> users;
+        for (int i = 0; i < threads; i++) {
+            users.emplace_back([&cache, &transforms, &results, i]() {
+                results[i] = cache.get<int>("key", [&transforms]() -> std::shared_ptr<const int> {
+                    transforms++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    return std::make_shared<int>(7);
+                });
+            });
+        }
+        for (auto& user : users) {
+            user.join();
+        }
+        CHECK(transforms == 1);
+        for (const auto& result : results) {
+            CHECK(result == results[0]);
+        }
+        CHECK(cache.getHits() == threads - 1);
+    }
+
+    SECTION("the current cache is set for each thread")
+    {
+        TransformCache outer;
+        TransformCache inner;
+        CHECK(TransformCache::getCurrent() == nullptr);
+        {
+            TransformCache::Scope outerScope(&outer);
+            CHECK(TransformCache::getCurrent() == &outer);
+            {
+                TransformCache::Scope innerScope(&inner);
+                CHECK(TransformCache::getCurrent() == &inner);
+                TransformCache* seen = &inner;
+                std::thread other([&seen]() { seen = TransformCache::getCurrent(); });
+                other.join();
+                CHECK(seen == nullptr);
+            }
+            CHECK(TransformCache::getCurrent() == &outer);
+        }
+        CHECK(TransformCache::getCurrent() == nullptr);
+    }
+}
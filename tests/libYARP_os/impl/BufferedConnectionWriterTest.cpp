@@ -22,6 +22,23 @@ using namespace yarp::os;
 using namespace yarp::os::impl;
 using namespace yarp::sig;
 
+namespace {
+class GatherOutputStream : public StringOutputStream
+{
+public:
+    size_t gathered {0};
+    size_t blocks {0};
+
+    using StringOutputStream::write;
+    void writeBlocks(const Bytes* b, size_t count) override
+    {
+        gathered++;
+        blocks += count;
+        OutputStream::writeBlocks(b, count);
+    }
+};
+} // namespace
+
 typedef PortablePair<PortablePair<PortablePair<Bottle, ImageOf<PixelRgb> >,
                                   PortablePair<ImageOf<PixelRgb>, Stamp> >,
                      Bottle> Monster;
@@ -107,11 +124,13 @@ TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]"
             CHECK(img2.pixel(10, 5).r == 42); // pixel behavior is correct
             img2.resize(1, 1);
             // Now resend, checking that no memory is allocated
+            size_t allocations = bbr.allocationCount();
             bbr.restart();
             img1.write(bbr);
             bbr.write(img2);
             CHECK(img2.width() == img1.width()); // image width still matches
             CHECK(img2.height() == img1.height()); // image height still matches
+            CHECK(bbr.allocationCount() == allocations); // no allocation
 
             // Now send something completely different
             Monster m1, m2;
@@ -124,10 +143,12 @@ TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]"
             CHECK(m2.body.get(0).asString() == "hello"); // tail matches
             // Now resend, checking that no memory is allocated
             m2 = Monster();
+            allocations = bbr.allocationCount();
             bbr.restart();
             m1.write(bbr);
             bbr.write(m2);
             CHECK(m2.body.get(0).asString() == "hello"); // tail still matches
+            CHECK(bbr.allocationCount() == allocations); // no allocation
 
             // Now send something completely different
             Stamp stamp1(42, 1.23), stamp2;
@@ -137,12 +158,67 @@ TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]"
             CHECK(stamp1.getCount() == stamp2.getCount()); // stamp matches
             // Now resend, checking that no memory is allocated
             stamp2 = Stamp();
+            allocations = bbr.allocationCount();
             bbr.restart();
             stamp1.write(bbr);
             bbr.write(stamp2);
             CHECK(stamp1.getCount() == stamp2.getCount()); // stamp still matches
+            CHECK(bbr.allocationCount() == allocations); // no allocation
 
             INFO("pool size of " << Bottle::toString(pool_sizes[i]) << " had " << Bottle::toString(bbr.bufferCount()) << " buffers");
         }
     }
+
+    SECTION("test buffer space statistics")
+    {
+        BufferedConnectionWriter bbr;
+        CHECK(bbr.allocationCount() == 0);
+        CHECK(bbr.pooledSize() == 0);
+
+        Bottle b;
+        b.fromString("1 2 3 (4 5 6) \"a string\" [vocab] {1 2 3 4}");
+        b.write(bbr);
+        size_t allocations = bbr.allocationCount();
+        size_t pooled = bbr.pooledSize();
+        CHECK(allocations > 0);
+        CHECK(pooled >= BUFFERED_CONNECTION_INITIAL_POOL_SIZE);
+        CHECK(bbr.pooledHighWaterMark() == pooled);
+
+        // Steady state: the same message doesn't allocate anything
+        for (int i = 0; i < 10; i++) {
+            bbr.restart();
+            b.write(bbr);
+            Bottle b2;
+            bbr.write(b2);
+            CHECK(b2.toString() == b.toString());
+        }
+        CHECK(bbr.allocationCount() == allocations);
+        CHECK(bbr.pooledSize() == pooled);
+
+        // A larger message grows the buffer space
+        std::string big(100000, 'x');
+        bbr.restart();
+        bbr.appendBlock(big.c_str(), big.length());
+        CHECK(bbr.allocationCount() > allocations);
+        CHECK(bbr.pooledSize() >= big.length());
+        CHECK(bbr.pooledHighWaterMark() >= big.length());
+
+        bbr.clear();
+        CHECK(bbr.pooledSize() == 0);
+    }
+
+    SECTION("test writing all fragments at once")
+    {
+        GatherOutputStream gos;
+        BufferedConnectionWriter bbr;
+        ImageOf<PixelRgb> img;
+        img.resize(32, 24);
+        img.zero();
+        img.write(bbr);
+        CHECK(bbr.length() > 1);
+        bbr.write(gos);
+        CHECK(gos.gathered == 1); // a single vectored write
+        CHECK(gos.blocks == bbr.length());
+        CHECK(gos.toString().length() == bbr.dataSize());
+    }
 }
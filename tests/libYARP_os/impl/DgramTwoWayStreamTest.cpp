@@ -8,6 +8,7 @@
  */
 
 #include <yarp/os/impl/DgramTwoWayStream.h>
+#include <yarp/os/SystemClock.h>
 
 #include <cstdio>
 #include <string>
@@ -251,4 +252,133 @@ TEST_CASE("os::impl::DgramTwoWayStreamTest", "[yarp::os][yarp::os::impl]")
             }
         }
     }
+
+    SECTION("Test Dgram checksums")
+    {
+        for (size_t i=0; i<msg.length(); i++) {
+            msg.get()[i] = i%128;
+        }
+        for (auto checksum : {DgramTwoWayStream::Checksum::Crc32c, DgramTwoWayStream::Checksum::None}) {
+            DgramTest out2;
+            DgramTest in2;
+            out2.openMonitor(sz, sz);
+            out2.setChecksum(checksum);
+            out2.beginPacket();
+            out2.write(msg.bytes());
+            out2.flush();
+            out2.endPacket();
+
+            in2.openMonitor(sz, sz);
+            in2.setChecksum(checksum);
+            in2.copyMonitor(out2);
+            in2.copyMonitor(out2);
+            in2.corrupt(4, 20);
+
+            in2.beginPacket();
+            CHECK((size_t) in2.readFull(recv.bytes()) == recv.length()); // "good message"
+            in2.endPacket();
+            in2.beginPacket();
+            int len = in2.readFull(recv.bytes());
+            in2.endPacket();
+            if (checksum == DgramTwoWayStream::Checksum::None) {
+                CHECK((size_t) len == recv.length()); // "corruption not detected"
+            } else {
+                CHECK(len == -1); // "corruption detected"
+            }
+        }
+    }
+
+    SECTION("Test batched Dgram")
+    {
+        INFO("checking that small messages share a datagram");
+        out.openMonitor(sz, sz);
+        out.setBatchMode(4);
+        ManagedBytes small(20);
+        for (int k=0; k<4; k++) {
+            for (size_t i=0; i<small.length(); i++) {
+                small.get()[i] = k;
+            }
+            out.beginPacket();
+            out.write(small.bytes());
+            out.flush();
+            out.endPacket();
+            CHECK(out.size() == ((k<3) ? 0 : 1)); // "sent after the fourth message"
+        }
+
+        in.openMonitor(sz, sz);
+        in.setBatchMode(1);
+        in.copyMonitor(out);
+        mismatch = false;
+        for (int k=0; k<4; k++) {
+            in.beginPacket();
+            CHECK((size_t) in.readFull(small.bytes()) == small.length());
+            in.endPacket();
+            for (size_t i=0; i<small.length(); i++) {
+                if (small.get()[i]!=k) {
+                    mismatch = true;
+                }
+            }
+        }
+        CHECK_FALSE(mismatch); // "all messages received"
+
+        ////////////////////////////////////////////////////////////////////
+        // A message does not wait for its batch longer than the delay
+        INFO("checking that a late batch is sent");
+        out.clear();
+        out.setBatchMode(4, 0.01);
+        out.beginPacket();
+        out.write(small.bytes());
+        out.endPacket();
+        CHECK(out.size() == 0); // "the first message waits"
+        yarp::os::SystemClock::delaySystem(0.02);
+        out.beginPacket();
+        out.write(small.bytes());
+        out.endPacket();
+        CHECK(out.size() == 1); // "sent after the delay"
+
+        ////////////////////////////////////////////////////////////////////
+        // Send three messages of two datagrams each, and lose one
+        INFO("checking that a lost datagram costs only its message");
+        out.clear();
+        in.clear();
+        DgramTest out2;
+        DgramTest in2;
+        out2.openMonitor(sz, sz);
+        out2.setBatchMode(1);
+        ManagedBytes big(150);
+        for (int k=0; k<3; k++) {
+            for (size_t i=0; i<big.length(); i++) {
+                big.get()[i] = k;
+            }
+            out2.beginPacket();
+            out2.write(big.bytes());
+            out2.flush();
+            out2.endPacket();
+        }
+        CHECK(out2.size() == 6); // "two datagrams per message"
+
+        in2.openMonitor(sz, sz);
+        in2.setBatchMode(1);
+        in2.copyMonitor(out2);
+        in2.corruptDrop(1);
+
+        bool goodRead[4];
+        for (int k=0; k<4; k++) {
+            in2.beginPacket();
+            int len = in2.readFull(big.bytes());
+            in2.endPacket();
+            goodRead[k] = ((size_t) len == big.length());
+            for (size_t i=0; goodRead[k] && i<big.length(); i++) {
+                if (big.get()[i]!=k) {
+                    goodRead[k] = false;
+                }
+            }
+        }
+        CHECK(!goodRead[0]);                // "first message lost its tail"
+        CHECK(goodRead[1]);                 // "second message is good"
+        CHECK(goodRead[2]);                 // "third message is good"
+        CHECK(!goodRead[3]);                // "fourth read is nothing"
+        CHECK(in2.getDroppedCount() == 1);  // "the loss is counted"
+        CHECK(in2.isOk() == false);         // "the monitor ran out of data"
+    }
 }
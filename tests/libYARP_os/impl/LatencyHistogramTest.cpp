@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/LatencyHistogram.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+TEST_CASE("os::impl::LatencyHistogramTest", "[yarp::os][yarp::os::impl]")
+{
+    SECTION("empty histogram")
+    {
+        LatencyHistogram h;
+        CHECK(h.getCount() == 0);
+        CHECK(h.getMean() == 0.0);
+        CHECK(h.getPercentile(0.5) == 0);
+        CHECK(h.getMax() == 0);
+    }
+
+    SECTION("percentiles")
+    {
+        LatencyHistogram h;
+        // 90 fast messages and 10 slow ones
+        for (int i = 0; i < 90; i++) {
+            h.add(10e-6);
+        }
+        for (int i = 0; i < 10; i++) {
+            h.add(1000e-6);
+        }
+        h.add(-1.0); // ignored
+        CHECK(h.getCount() == 100);
+        CHECK(h.getMax() == 1000);
+        CHECK(h.getMean() == Approx(109.0).epsilon(0.02));
+        // 10us is in the [8, 16) bucket, 1000us in the [512, 1024) bucket
+        CHECK(h.getPercentile(0.5) == 16);
+        CHECK(h.getPercentile(0.9) == 1000);
+        CHECK(h.getPercentile(0.99) == 1000);
+
+        Property stats;
+        h.report(stats);
+        CHECK(stats.find("count").asInt64() == 100);
+        CHECK(stats.find("p50_us").asInt64() == 16);
+        CHECK(stats.find("max_us").asInt64() == 1000);
+
+        h.clear();
+        CHECK(h.getCount() == 0);
+        CHECK(h.getMax() == 0);
+    }
+}
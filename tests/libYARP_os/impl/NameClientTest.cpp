@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/NameClient.h>
+
+#include <yarp/os/SystemClock.h>
+
+#include <memory>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+TEST_CASE("os::impl::NameClientTest", "[yarp::os][yarp::os::impl]")
+{
+    // A client talking to a name server in the same process
+    std::unique_ptr<NameClient> nic(NameClient::create());
+    nic->setFakeMode(true);
+
+    SECTION("checking that the cache is disabled by default")
+    {
+        NameClient::setCacheTimeouts(0, 0);
+        Contact c1 = nic->registerName("/cache/disabled");
+        REQUIRE(c1.isValid());
+        nic->send("NAME_SERVER unregister /cache/disabled");
+        CHECK_FALSE(nic->queryName("/cache/disabled").isValid()); // not cached
+    }
+
+    SECTION("checking cached addresses")
+    {
+        NameClient::setCacheTimeouts(60, 60);
+        Contact c1 = nic->registerName("/cache/positive");
+        REQUIRE(c1.isValid());
+        Contact c2 = nic->queryName("/cache/positive");
+        CHECK(c2.getPort() == c1.getPort());
+
+        // the name server changes behind the back of the cache
+        nic->send("NAME_SERVER unregister /cache/positive");
+        Contact c3 = nic->queryName("/cache/positive");
+        CHECK(c3.isValid()); // cached
+        CHECK(c3.getPort() == c1.getPort());
+
+        CHECK(NameClient::forgetName("/cache/positive"));
+        CHECK_FALSE(NameClient::forgetName("/cache/positive"));
+        CHECK_FALSE(nic->queryName("/cache/positive").isValid()); // asked again
+
+        NameClient::setCacheTimeouts(0, 0);
+    }
+
+    SECTION("checking cached missing ports")
+    {
+        NameClient::setCacheTimeouts(60, 60);
+        CHECK_FALSE(nic->queryName("/cache/negative").isValid());
+        nic->send("NAME_SERVER register /cache/negative tcp 127.0.0.1 9999");
+        CHECK_FALSE(nic->queryName("/cache/negative").isValid()); // cached
+
+        // registering a port from this process invalidates the cache
+        nic->registerName("/cache/negative");
+        CHECK(nic->queryName("/cache/negative").isValid());
+
+        nic->unregisterName("/cache/negative");
+        CHECK_FALSE(nic->queryName("/cache/negative").isValid());
+
+        NameClient::setCacheTimeouts(0, 0);
+    }
+
+    SECTION("checking that cached entries expire")
+    {
+        NameClient::setCacheTimeouts(60, 0.01);
+        CHECK_FALSE(nic->queryName("/cache/expire").isValid());
+        nic->send("NAME_SERVER register /cache/expire tcp 127.0.0.1 9998");
+        SystemClock::delaySystem(0.1);
+        CHECK(nic->queryName("/cache/expire").isValid()); // missing ports are forgotten sooner
+
+        NameClient::setCacheTimeouts(0, 0);
+    }
+}
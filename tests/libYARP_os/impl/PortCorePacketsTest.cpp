@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCorePackets.h>
+#include <yarp/os/Bottle.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+namespace {
+class CompletionCounter : public PortWriter
+{
+public:
+    mutable int completions {0};
+
+    bool write(ConnectionWriter& writer) const override
+    {
+        YARP_UNUSED(writer);
+        return true;
+    }
+
+    void onCompletion() const override
+    {
+        completions++;
+    }
+};
+} // namespace
+
+TEST_CASE("os::impl::PortCorePacketsTest", "[yarp::os][yarp::os::impl]")
+{
+    SECTION("packets are reused")
+    {
+        PortCorePackets packets;
+        CompletionCounter writer;
+        PortCorePacket* packet = packets.getFreePacket();
+        REQUIRE(packet != nullptr);
+        packet->setContent(&writer);
+        CHECK(packets.getCount() == 1);
+
+        packet->inc();
+        CHECK_FALSE(packets.releasePacket(packet)); // "still used by a connection"
+        CHECK(writer.completions == 0);
+        CHECK(packets.releasePacket(packet)); // "last user"
+        CHECK(writer.completions == 1);
+        CHECK(packets.getCount() == 0);
+
+        PortCorePacket* again = packets.getFreePacket();
+        CHECK(again == packet);
+        CHECK(again->getContent() == nullptr);
+        packets.freePacket(again);
+        CHECK(packets.getPeakCount() == 1);
+    }
+
+    SECTION("capacity is respected")
+    {
+        PortCorePackets packets;
+        packets.setCapacity(3);
+        std::vector<PortCorePacket*> taken;
+        for (int i = 0; i < 3; i++) {
+            taken.push_back(packets.getFreePacket());
+            CHECK(taken.back() != nullptr);
+        }
+        CHECK(packets.getFreePacket() == nullptr);
+        CHECK(packets.getDroppedCount() == 1);
+        CHECK(packets.getAllocatedCount() == 3);
+
+        packets.freePacket(taken.back());
+        CHECK(packets.getFreePacket() == taken.back());
+        for (auto* packet : taken) {
+            packets.freePacket(packet);
+        }
+        CHECK(packets.getCount() == 0);
+        CHECK(packets.getPeakCount() == 3);
+    }
+
+    SECTION("transformations are counted and dropped with the packet")
+    {
+        PortCorePackets packets;
+        CompletionCounter writer;
+        auto transform = []() -> std::shared_ptr<const int> { return std::make_shared<int>(1); };
+        PortCorePacket* packet = packets.getFreePacket();
+        REQUIRE(packet != nullptr);
+        packet->setContent(&writer);
+        packet->transforms.get<int>("a", transform);
+        packet->transforms.get<int>("a", transform);
+        packet->transforms.get<int>("b", transform);
+        CHECK(packets.releasePacket(packet));
+        CHECK(packets.getTransformHits() == 1);
+        CHECK(packets.getTransformMisses() == 2);
+
+        PortCorePacket* again = packets.getFreePacket();
+        REQUIRE(again == packet);
+        CHECK(again->transforms.getMisses() == 0);
+        again->transforms.get<int>("a", transform);
+        CHECK(again->transforms.getMisses() == 1); // "the results of the previous message are gone"
+        packets.freePacket(again);
+        CHECK(packets.getTransformMisses() == 3);
+    }
+
+    SECTION("packets are released by many threads")
+    {
+        PortCorePackets packets;
+        CompletionCounter writer;
+        const int threads = 4;
+        const int rounds = 2000;
+        for (int i = 0; i < rounds; i++) {
+            PortCorePacket* packet = packets.getFreePacket();
+            REQUIRE(packet != nullptr);
+            packet->setContent(&writer);
+            for (int j = 0; j < threads; j++) {
+                packet->inc();
+            }
+            std::vector<std::thread> users;
+            for (int j = 0; j < threads; j++) {
+                users.emplace_back([&packets, packet]() { packets.releasePacket(packet); });
+            }
+            packets.releasePacket(packet);
+            for (auto& user : users) {
+                user.join();
+            }
+        }
+        CHECK(writer.completions == rounds); // "one completion for each message"
+        CHECK(packets.getCount() == 0);
+        CHECK(packets.getAllocatedCount() <= 16);
+    }
+}
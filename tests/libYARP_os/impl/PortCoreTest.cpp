@@ -10,9 +10,26 @@
 #include <yarp/os/impl/PortCore.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Carriers.h>
+#include <yarp/os/OutputProtocol.h>
+#include <yarp/os/PortInfo.h>
 #include <yarp/os/PortReader.h>
+#include <yarp/os/PortReaderCreator.h>
+#include <yarp/os/PortReport.h>
+#include <yarp/os/Route.h>
 #include <yarp/os/impl/BottleImpl.h>
+#include <yarp/os/impl/BufferedConnectionWriter.h>
+#include <yarp/os/impl/PortCommand.h>
+#include <yarp/os/impl/PortCoreReactor.h>
 #include <yarp/os/Network.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/SystemClock.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <catch.hpp>
 #include <harness.h>
@@ -20,6 +37,141 @@
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
+// Each connection gets a reader that forwards to the test
+class ForwardingReader : public PortReader {
+public:
+    PortReader& target;
+    explicit ForwardingReader(PortReader& target) : target(target) {}
+    bool read(ConnectionReader& reader) override { return target.read(reader); }
+};
+
+// Counts the times it was sent on all the connections of a port
+class TrackedBottle : public Bottle {
+public:
+    mutable std::mutex mutex;
+    mutable std::condition_variable changed;
+    mutable int completions {0};
+
+    void onCompletion() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        completions++;
+        changed.notify_all();
+    }
+
+    bool waitCompletions(int count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(10), [this, count] { return completions >= count; });
+    }
+};
+
+// Keeps reading a message until it is released, like a slow peer
+class BlockingReader : public PortReader, public PortReaderCreator {
+public:
+    std::mutex mutex;
+    std::condition_variable changed;
+    int reads {0};
+    bool released {false};
+
+    PortReader* create() const override {
+        return new ForwardingReader(const_cast<BlockingReader&>(*this));
+    }
+
+    bool read(ConnectionReader& reader) override {
+        BottleImpl bot;
+        bot.read(reader);
+        std::unique_lock<std::mutex> lock(mutex);
+        reads++;
+        changed.notify_all();
+        changed.wait(lock, [this] { return released; });
+        return true;
+    }
+
+    bool waitReads(int count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(10), [this, count] { return reads >= count; });
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+        changed.notify_all();
+    }
+};
+
+// Counts the input connections removed from a port
+class InputReport : public PortReport {
+public:
+    std::mutex mutex;
+    std::condition_variable changed;
+    int removed {0};
+
+    void report(const PortInfo& info) override {
+        if (info.tag == PortInfo::PORTINFO_CONNECTION && info.incoming && !info.created) {
+            std::lock_guard<std::mutex> lock(mutex);
+            removed++;
+            changed.notify_all();
+        }
+    }
+
+    bool waitRemoved(int count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(10), [this, count] { return removed >= count; });
+    }
+};
+
+// Counts the messages received by a port, and remembers their first value
+class CountingReader : public PortReader, public PortReaderCreator {
+public:
+    std::mutex mutex;
+    std::condition_variable changed;
+    int receives {0};
+    std::vector<int> values;
+
+    PortReader* create() const override {
+        return new ForwardingReader(const_cast<CountingReader&>(*this));
+    }
+
+    bool read(ConnectionReader& reader) override {
+        if (!reader.isValid()) {
+            return false;
+        }
+        BottleImpl bot;
+        bot.read(reader);
+        std::lock_guard<std::mutex> lock(mutex);
+        receives++;
+        values.push_back(bot.get(0).asInt32());
+        changed.notify_all();
+        return true;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        receives = 0;
+        values.clear();
+    }
+
+    bool waitReceives(int count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(10), [this, count] { return receives >= count; });
+    }
+
+    // Wait for a message whose first value is the given one
+    bool waitLast(int value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(10), [this, value] { return !values.empty() && values.back() == value; });
+    }
+
+    // Were the values 0, 1, ... count-1 received, in order?
+    bool inOrder(int count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool ordered = (values.size() == static_cast<size_t>(count));
+        for (size_t i=0; ordered && i<values.size(); i++) {
+            ordered = (values[i] == (int)i);
+        }
+        return ordered;
+    }
+};
+
 class PortCoreTest : public PortReader {
 public:
     int safePort() { return Network::getDefaultPortRange()+100; }
@@ -162,12 +314,426 @@ public:
         sender.close();
         receiver.close();
     }
+
+
+};
+
+// The tests of the connections added with the reactor, the coalesced
+// messages, the queues and the statistics
+class PortCoreConnectionTest {
+public:
+    int safePort() { return Network::getDefaultPortRange()+100; }
+
+    CountingReader received;
+
+    void testReactor() {
+        PortCoreReactor& reactor = PortCoreReactor::getInstance();
+        bool wasEnabled = reactor.isEnabled();
+        if (!wasEnabled) {
+            reactor.setThreadCount(2);
+        }
+        size_t watched = reactor.getWatchCount();
+
+        received.reset();
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read = NetworkBase::registerContact(Contact("/read", "tcp", "127.0.0.1", safePort()+1));
+
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+
+        // Connections with their own reader can be served by the reactor
+        PortCore receiver;
+        InputReport inputs;
+        receiver.setReadCreator(received);
+        receiver.setReportCallback(&inputs);
+        sender.listen(write);
+        receiver.listen(read);
+        sender.start();
+        receiver.start();
+        NetworkBase::connect("/write", "/read");
+
+        // A message written while the previous one is being sent is skipped
+        TrackedBottle bot;
+        bot.addInt32(0);
+        bot.addString("Hello world");
+        for (int i=0; i<10; i++) {
+            sender.send(bot);
+            CHECK(bot.waitCompletions(i+1)); // "message sent"
+            CHECK(received.waitReceives(i+1)); // "message received"
+        }
+        CHECK(reactor.getWatchCount() == watched + 1); // "input connection handed to the reactor"
+
+        NetworkBase::disconnect("/write", "/read");
+        CHECK(inputs.waitRemoved(1)); // "input connection removed"
+        CHECK(reactor.getWatchCount() == watched); // "connection removed from the reactor"
+
+        receiver.resetReportCallback();
+        sender.close();
+        receiver.close();
+        if (!wasEnabled) {
+            reactor.setThreadCount(0);
+        }
+    }
+
+
+    void testReactorSlowPeer() {
+        PortCoreReactor& reactor = PortCoreReactor::getInstance();
+        bool wasEnabled = reactor.isEnabled();
+        if (!wasEnabled) {
+            reactor.setThreadCount(1);
+        }
+        size_t watched = reactor.getWatchCount();
+
+        received.reset();
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact writeSlow = NetworkBase::registerContact(Contact("/write_slow", "tcp", "127.0.0.1", safePort()+1));
+        Contact slow = NetworkBase::registerContact(Contact("/slow", "tcp", "127.0.0.1", safePort()+2));
+        Contact fast = NetworkBase::registerContact(Contact("/fast", "tcp", "127.0.0.1", safePort()+3));
+
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+        PortCore slowSender;
+        slowSender.setWaitBeforeSend(false);
+        slowSender.setWaitAfterSend(false);
+        BlockingReader blocking;
+        PortCore slowReceiver;
+        slowReceiver.setReadCreator(blocking);
+        PortCore fastReceiver;
+        fastReceiver.setReadCreator(received);
+        sender.listen(write);
+        slowSender.listen(writeSlow);
+        slowReceiver.listen(slow);
+        fastReceiver.listen(fast);
+        sender.start();
+        slowSender.start();
+        slowReceiver.start();
+        fastReceiver.start();
+        NetworkBase::connect("/write_slow", "/slow");
+        NetworkBase::connect("/write", "/fast");
+
+        // The reader of the slow connection, and the writer waiting for
+        // its acknowledgement, keep threads of the reactor busy
+        TrackedBottle slowBot;
+        slowBot.addInt32(0);
+        slowSender.send(slowBot);
+        CHECK(blocking.waitReads(1)); // "slow connection reading"
+        double blockedSince = SystemClock::nowSystem();
+
+        // The other connections are still served
+        TrackedBottle bot;
+        bot.addInt32(1);
+        sender.send(bot);
+        CHECK(bot.waitCompletions(1)); // "message sent"
+        CHECK(received.waitReceives(1)); // "fast connection served"
+
+        // Keep reading for longer than a handler of the reactor may take
+        double left = blockedSince + PortCoreReactor::blockedHandlerDelay - SystemClock::nowSystem();
+        if (left > 0) {
+            SystemClock::delaySystem(left);
+        }
+        blocking.release();
+        CHECK(slowBot.waitCompletions(1)); // "slow message sent"
+
+        // After its slow message, the connection has its own threads
+        slowSender.send(slowBot);
+        CHECK(slowBot.waitCompletions(2)); // "slow message sent"
+        CHECK(blocking.waitReads(2)); // "slow connection served"
+        CHECK(reactor.getWatchCount() == watched + 1); // "slow connection left the reactor"
+
+        sender.close();
+        slowSender.close();
+        slowReceiver.close();
+        fastReceiver.close();
+        if (!wasEnabled) {
+            reactor.setThreadCount(0);
+        }
+    }
+
+
+    void testCoalesce() {
+        received.reset();
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read = NetworkBase::registerContact(Contact("/read", "tcp", "127.0.0.1", safePort()+1));
+
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+
+        PortCore receiver;
+        receiver.setReadHandler(received);
+        sender.listen(write);
+        receiver.listen(read);
+        sender.start();
+        receiver.start();
+        NetworkBase::connect("/write", "/read", "tcp+coalesce.10000");
+        Time::delay(0.3);
+
+        // The messages wait up to 10ms in a batch, so they are not lost
+        // even though they are sent faster than they can be written
+        const int count = 50;
+        for (int i=0; i<count; i++) {
+            Bottle bot;
+            bot.addInt32(i);
+            bot.addString("Hello world");
+            sender.send(bot);
+        }
+        CHECK(received.waitReceives(count)); // "everything received"
+        CHECK(received.inOrder(count)); // "received in order"
+
+        // Through the reactor, the batches wait for their messages without
+        // keeping a thread of the pool busy
+        PortCoreReactor& reactor = PortCoreReactor::getInstance();
+        bool wasEnabled = reactor.isEnabled();
+        if (!wasEnabled) {
+            reactor.setThreadCount(1);
+        }
+        NetworkBase::disconnect("/write", "/read");
+        NetworkBase::connect("/write", "/read", "tcp+coalesce.10000");
+        Time::delay(0.3);
+        received.reset();
+        for (int i=0; i<count; i++) {
+            Bottle bot;
+            bot.addInt32(i);
+            sender.send(bot);
+        }
+        CHECK(received.waitReceives(count)); // "everything received through the reactor"
+        CHECK(received.inOrder(count)); // "received in order through the reactor"
+
+        sender.close();
+        receiver.close();
+        if (!wasEnabled) {
+            reactor.setThreadCount(0);
+        }
+    }
+
+
+    void testBrokenBatch() {
+        received.reset();
+
+        Contact read = NetworkBase::registerContact(Contact("/read", "tcp", "127.0.0.1", safePort()));
+        PortCore receiver;
+        InputReport inputs;
+        receiver.setReadHandler(received);
+        receiver.setReportCallback(&inputs);
+        receiver.listen(read);
+        receiver.start();
+
+        // A batch whose message is longer than the batch itself, sent
+        // without negotiating it
+        auto sendBatch = [](std::int32_t len, size_t available) {
+            OutputProtocol* out = Carriers::connect(NetworkBase::queryName("/read"));
+            REQUIRE(out != nullptr);
+            out->open(Route("/broken", "/read", "tcp"));
+            std::vector<char> data(available, 'x');
+            BufferedConnectionWriter bw(false, false);
+            bw.appendInt32(0);
+            bw.appendInt32(len);
+            bw.appendBlockCopy(Bytes(data.data(), data.size()));
+            bw.addToHeader();
+            PortCommand pc('b', "");
+            pc.write(bw);
+            bw.appendInt32(1);
+            out->write(bw);
+            out->close();
+            delete out;
+        };
+
+        // oversized
+        sendBatch(0x7FFFFFF0, 8);
+        CHECK(inputs.waitRemoved(1)); // "oversized batch closes the connection"
+        // truncated
+        sendBatch(100, 10);
+        CHECK(inputs.waitRemoved(2)); // "truncated batch closes the connection"
+        CHECK(received.receives == 0); // "nothing delivered"
+
+        // The port is still working
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()+1));
+        PortCore sender;
+        sender.listen(write);
+        sender.start();
+        NetworkBase::connect("/write", "/read");
+        Bottle bot;
+        bot.addInt32(0);
+        sender.send(bot);
+        CHECK(received.waitReceives(1)); // "port still working"
+
+        receiver.resetReportCallback();
+        sender.close();
+        receiver.close();
+    }
+
+
+    void testQueue() {
+        received.reset();
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read = NetworkBase::registerContact(Contact("/read", "tcp", "127.0.0.1", safePort()+1));
+
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+        PortCore receiver;
+        receiver.setReadHandler(received);
+        sender.listen(write);
+        receiver.listen(read);
+        sender.start();
+        receiver.start();
+        NetworkBase::connect("/write", "/read", "tcp+queue.100+overflow.block");
+        Time::delay(0.3);
+
+        // The messages are written in background faster than they can be
+        // sent, they wait in the queue instead of being skipped.  They must
+        // stay alive until they are sent.
+        const int count = 50;
+        std::vector<Bottle> messages(count);
+        for (int i=0; i<count; i++) {
+            messages[i].addInt32(i);
+            messages[i].addString("Hello world");
+            sender.send(messages[i]);
+        }
+        CHECK(received.waitReceives(count)); // "everything received"
+        CHECK(received.inOrder(count)); // "received in order"
+
+        // Only the newest message waits, the others are dropped
+        NetworkBase::disconnect("/write", "/read");
+        NetworkBase::connect("/write", "/read", "tcp+overflow.keep_latest");
+        Time::delay(0.3);
+        received.reset();
+        for (int i=0; i<count; i++) {
+            sender.send(messages[i]);
+        }
+        CHECK(received.waitLast(count-1)); // "newest message received"
+
+        Bottle cmd;
+        Bottle reply;
+        cmd.addVocab(createVocab('s', 't', 'a', 't'));
+        REQUIRE(NetworkBase::write(Contact("/write"), cmd, reply, true, true, 2.0));
+        INFO(reply.toString());
+        Bottle& out = reply.findGroup("out");
+        CHECK(out.find("overflow").asString() == "keep_latest");
+        CHECK(out.find("queue_capacity").asInt32() == 1);
+        CHECK(out.find("messages").asInt64() + out.find("dropped").asInt64() == count);
+
+        sender.close();
+        receiver.close();
+    }
+
+
+    void testQueueBlock() {
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact slow = NetworkBase::registerContact(Contact("/slow", "tcp", "127.0.0.1", safePort()+1));
+
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+        BlockingReader blocking;
+        PortCore receiver;
+        receiver.setReadCreator(blocking);
+        sender.listen(write);
+        receiver.listen(slow);
+        sender.start();
+        receiver.start();
+        NetworkBase::connect("/write", "/slow", "tcp+queue.1+overflow.block");
+
+        // The first message is being read, the second one waits in the
+        // queue, the writer of the third one waits for room
+        std::vector<TrackedBottle> messages(3);
+        sender.send(messages[0]);
+        CHECK(blocking.waitReads(1)); // "slow connection reading"
+        std::atomic<bool> written {false};
+        std::thread writer([&]() {
+            sender.send(messages[1]);
+            sender.send(messages[2]);
+            written = true;
+        });
+        SystemClock::delaySystem(0.3);
+        CHECK_FALSE(written.load()); // "writer blocked"
+
+        // The port is not locked by the blocked writer
+        Bottle cmd;
+        Bottle reply;
+        cmd.addVocab(createVocab('s', 't', 'a', 't'));
+        CHECK(NetworkBase::write(Contact("/write"), cmd, reply, true, true, 2.0)); // "port still usable"
+        INFO(reply.toString());
+        CHECK(reply.findGroup("out").find("blocked").asInt64() == 1);
+
+        blocking.release();
+        writer.join();
+        CHECK(blocking.waitReads(3)); // "everything received"
+        for (auto& message : messages) {
+            CHECK(message.waitCompletions(1)); // "message sent"
+        }
+
+        sender.close();
+        receiver.close();
+    }
+
+
+    void testStats() {
+        received.reset();
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read = NetworkBase::registerContact(Contact("/read", "tcp", "127.0.0.1", safePort()+1));
+
+        PortCore sender;
+        PortCore receiver;
+        receiver.setReadHandler(received);
+        sender.listen(write);
+        receiver.listen(read);
+        sender.start();
+        receiver.start();
+        NetworkBase::connect("/write", "/read");
+        Time::delay(0.3);
+
+        const int count = 5;
+        for (int i=0; i<count; i++) {
+            Stamp stamp(i, Time::now());
+            sender.setEnvelope(stamp);
+            Bottle bot;
+            bot.addInt32(i);
+            sender.send(bot);
+        }
+        CHECK(received.waitReceives(count)); // "everything received"
+
+        Bottle cmd;
+        Bottle reply;
+        cmd.addVocab(createVocab('s', 't', 'a', 't'));
+        REQUIRE(NetworkBase::write(Contact("/write"), cmd, reply, true, true, 2.0));
+        INFO(reply.toString());
+        Bottle* port = reply.find("port").asList();
+        REQUIRE(port != nullptr);
+        CHECK(port->find("messages_out").asInt64() == count);
+        CHECK(port->find("bytes_out").asInt64() > 0);
+        Bottle& out = reply.findGroup("out");
+        CHECK(out.get(1).asString() == "/read");
+        CHECK(out.find("messages").asInt64() == count);
+        CHECK(out.findGroup("serialize_time").find("count").asInt64() == count);
+
+        cmd.addString("/write");
+        REQUIRE(NetworkBase::write(Contact("/read"), cmd, reply, true, true, 2.0));
+        INFO(reply.toString());
+        Bottle& in = reply.findGroup("in");
+        CHECK(in.get(1).asString() == "/write");
+        CHECK(in.find("messages").asInt64() == count);
+        Bottle& latency = in.findGroup("latency");
+        CHECK(latency.find("count").asInt64() == count);
+        CHECK(latency.find("max_us").asInt64() >= latency.find("p50_us").asInt64());
+
+        sender.close();
+        receiver.close();
+    }
 };
 
 TEST_CASE("os::impl::PortCoreTest", "[yarp::os][yarp::os::impl]")
 {
     Network::setLocalMode(true);
     PortCoreTest thePortCoreTest;
+    PortCoreConnectionTest theConnectionTest;
 
     SECTION("checking start/stop works")
     {
@@ -184,5 +750,46 @@ TEST_CASE("os::impl::PortCoreTest", "[yarp::os][yarp::os::impl]")
         thePortCoreTest.testBackground();
     }
 
+    SECTION("transmission through the reactor check")
+    {
+        if (!PortCoreReactor::isAvailable()) {
+            YARP_SKIP_TEST("The reactor is not available on this platform");
+        }
+        theConnectionTest.testReactor();
+    }
+
+    SECTION("reactor with a slow connection check")
+    {
+        if (!PortCoreReactor::isAvailable()) {
+            YARP_SKIP_TEST("The reactor is not available on this platform");
+        }
+        theConnectionTest.testReactorSlowPeer();
+    }
+
+    SECTION("coalesced transmission check")
+    {
+        theConnectionTest.testCoalesce();
+    }
+
+    SECTION("broken batch check")
+    {
+        theConnectionTest.testBrokenBatch();
+    }
+
+    SECTION("queued transmission check")
+    {
+        theConnectionTest.testQueue();
+    }
+
+    SECTION("queued transmission with a slow connection check")
+    {
+        theConnectionTest.testQueueBlock();
+    }
+
+    SECTION("connection statistics check")
+    {
+        theConnectionTest.testStats();
+    }
+
     Network::setLocalMode(false);
 }
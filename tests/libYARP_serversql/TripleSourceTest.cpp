@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Contact.h>
+#include <yarp/os/SystemClock.h>
+
+#include <yarp/serversql/impl/AllocatorOnTriples.h>
+#include <yarp/serversql/impl/NameServiceOnTriples.h>
+#include <yarp/serversql/impl/TripleSourceCreator.h>
+
+#include <cstdio>
+#include <string>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::serversql::impl;
+
+namespace {
+
+void removeDatabase(const std::string& filename)
+{
+    std::remove(filename.c_str());
+    std::remove((filename + "-wal").c_str());
+    std::remove((filename + "-shm").c_str());
+}
+
+void checkTriples(TripleSource& mem)
+{
+    Triple t;
+    t.setNameValue("port", "/check/triples");
+    CHECK(mem.find(t, nullptr) == -1);
+    mem.insert(t, nullptr);
+    int rid = mem.find(t, nullptr);
+    REQUIRE(rid != -1);
+
+    TripleContext context;
+    context.setRid(rid);
+    t.setNameValue("host", "localhost");
+    mem.update(t, &context); // inserts
+    t.setNameValue("host", "127.0.0.1");
+    mem.update(t, &context); // replaces
+    t.setNameValue("socket", "10002");
+    mem.update(t, &context);
+
+    t.setNameValue("host", "*");
+    std::list<Triple> lst = mem.query(t, &context);
+    REQUIRE(lst.size() == 1);
+    CHECK(lst.begin()->value == "127.0.0.1");
+
+    t.setNsNameValue("*", "*", "*");
+    CHECK(mem.query(t, &context).size() == 2); // any namespace
+    t.setNameValue("*", "*");
+    CHECK(mem.query(t, &context).size() == 2);
+    CHECK(mem.query(t, nullptr).size() == 1); // only the port
+
+    t.setNameValue("host", "*");
+    mem.remove_query(t, &context);
+    CHECK(mem.query(t, &context).empty());
+
+    // the details of a port go away with the port
+    t.setNameValue("port", "/check/triples");
+    mem.remove_query(t, nullptr);
+    mem.prune(nullptr);
+    t.setNameValue("*", "*");
+    CHECK(mem.query(t, &context).empty());
+    CHECK(mem.query(t, nullptr).empty());
+}
+
+double registerPorts(TripleSource* mem, int nports)
+{
+    AllocatorConfig config;
+    config.minPortNumber = 10002;
+    config.maxPortNumber = 10002 + nports + 1000;
+    AllocatorOnTriples alloc;
+    alloc.open(mem, config);
+    NameServiceOnTriples ns;
+    ns.open(mem, &alloc, Contact("/root", "tcp", "127.0.0.1", 10000));
+    ns.setSilent(true);
+
+    Contact remote("tcp", "127.0.0.1", 10001);
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < nports; i++) {
+        Bottle cmd;
+        Bottle reply;
+        Bottle event;
+        cmd.addString("register");
+        cmd.addString("/check/throughput/" + std::to_string(i));
+        ns.apply(cmd, reply, event, remote);
+        cmd.clear();
+        reply.clear();
+        cmd.fromString("set /check/throughput/" + std::to_string(i) + " offers (tcp udp)");
+        ns.apply(cmd, reply, event, remote);
+    }
+    double elapsed = SystemClock::nowSystem() - start;
+
+    Bottle cmd("list");
+    Bottle reply;
+    Bottle event;
+    ns.apply(cmd, reply, event, remote);
+    CHECK(reply.toString().find("/check/throughput/" + std::to_string(nports - 1)) != std::string::npos);
+    return elapsed;
+}
+
+} // namespace
+
+TEST_CASE("serversql::TripleSourceTest", "[yarp::serversql]")
+{
+    const std::string filename = "_yarp_serversql_ports.db";
+
+    SECTION("check sqlite triples")
+    {
+        TripleSourceCreator db;
+        TripleSource* mem = db.open(":memory:");
+        REQUIRE(mem != nullptr);
+        checkTriples(*mem);
+    }
+
+    SECTION("check native triples")
+    {
+        TripleSourceCreator db;
+        TripleSource* mem = db.open(":native:");
+        REQUIRE(mem != nullptr);
+        checkTriples(*mem);
+    }
+
+    SECTION("check registration throughput")
+    {
+        // Not a pass/fail check, just the time each store takes to
+        // register many ports the way a robot does at startup
+        const int nports = 300;
+        removeDatabase(filename);
+        for (const std::string& name : {filename, std::string(":memory:"), std::string(":native:")}) {
+            TripleSourceCreator db;
+            TripleSource* mem = db.open(name.c_str(), true);
+            REQUIRE(mem != nullptr);
+            double elapsed = registerPorts(mem, nports);
+            printf("%d registrations in %s: %.3f s (%.0f/s)\n",
+                   nports,
+                   name.c_str(),
+                   elapsed,
+                   nports / elapsed);
+        }
+        removeDatabase(filename);
+    }
+}
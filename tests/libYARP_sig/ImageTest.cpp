@@ -10,8 +10,10 @@
 #include <yarp/os/NetType.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/sig/Image.h>
+#include <yarp/sig/ImageBufferPool.h>
 #include <yarp/sig/ImageDraw.h>
 #include <yarp/sig/ImageUtils.h>
+#include <yarp/sig/impl/Demosaic.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/PortReaderBuffer.h>
 #include <yarp/os/Port.h>
@@ -19,10 +21,16 @@
 #include <yarp/os/Time.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/PeriodicThread.h>
+#include <yarp/os/SharedBufferPool.h>
 
 #include <catch.hpp>
 #include <harness.h>
 
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
 using namespace yarp::os::impl;
 using namespace yarp::sig;
 using namespace yarp::sig::draw;
@@ -501,6 +509,245 @@ TEST_CASE("sig::ImageTest", "[yarp::sig]")
         CHECK(img2(4,2).r == 10); // r level copied
     }
 
+    SECTION("check conversions between 8 bit pixel types.")
+    {
+        // These conversions are vectorized, check them pixel by pixel for
+        // widths that fill and that do not fill the vectors, with
+        // padding and with different origins
+        struct Type
+        {
+            int code;
+            std::string channels;
+        };
+        const std::vector<Type> types {
+            {VOCAB_PIXEL_MONO, "m"},
+            {VOCAB_PIXEL_RGB, "rgb"},
+            {VOCAB_PIXEL_BGR, "bgr"},
+            {VOCAB_PIXEL_RGBA, "rgba"},
+            {VOCAB_PIXEL_BGRA, "bgra"}
+        };
+
+        int mismatch = 0;
+        unsigned char value = 1;
+        for (const auto& from : types) {
+            for (const auto& to : types) {
+                for (size_t w : {1, 5, 16, 17, 33, 71}) {
+                    FlexImage src;
+                    src.setPixelCode(from.code);
+                    src.resize(w, 3);
+                    for (size_t y = 0; y < src.height(); y++) {
+                        for (size_t x = 0; x < src.getRowSize(); x++) {
+                            src.getRow(y)[x] = value;
+                            value = value * 7 + 3;
+                        }
+                    }
+                    FlexImage dest;
+                    dest.setPixelCode(to.code);
+                    dest.setQuantum(1);
+                    dest.setTopIsLowIndex(w % 2 == 0);
+                    dest.resize(w, 3);
+                    dest.copy(src);
+
+                    for (size_t y = 0; y < src.height(); y++) {
+                        for (size_t x = 0; x < w; x++) {
+                            const unsigned char* s = src.getPixelAddress(x, y);
+                            const unsigned char* d = dest.getPixelAddress(x, y);
+                            auto channel = [&](char c) -> int {
+                                if (from.channels == "m") {
+                                    return (c == 'a') ? 255 : s[0];
+                                }
+                                size_t i = from.channels.find(c);
+                                return (i == std::string::npos) ? 255 : s[i];
+                            };
+                            for (size_t i = 0; i < to.channels.size(); i++) {
+                                int expected = (to.channels[i] == 'm') ? (channel('r') + channel('g') + channel('b')) / 3
+                                                                       : channel(to.channels[i]);
+                                if (d[i] != expected) {
+                                    mismatch++;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        CHECK(mismatch == 0);
+    }
+
+    SECTION("check demosaicing of bayer images.")
+    {
+        // The inner pixels are vectorized, check them against a plain
+        // implementation, for widths that fill and that do not fill the
+        // vectors, and with more than one band of rows
+        struct Bayer
+        {
+            int code;
+            yarp::sig::impl::BayerOrder order;
+            size_t goff;
+            size_t roff;
+        };
+        const std::vector<Bayer> orders {
+            {VOCAB_PIXEL_ENCODING_BAYER_GRBG8, yarp::sig::impl::BayerOrder::GRBG, 0, 0},
+            {VOCAB_PIXEL_ENCODING_BAYER_GBRG8, yarp::sig::impl::BayerOrder::GBRG, 0, 1},
+            {VOCAB_PIXEL_ENCODING_BAYER_RGGB8, yarp::sig::impl::BayerOrder::RGGB, 1, 0},
+            {VOCAB_PIXEL_ENCODING_BAYER_BGGR8, yarp::sig::impl::BayerOrder::BGGR, 1, 1}
+        };
+        struct Type
+        {
+            int code;
+            size_t r;
+            size_t b;
+        };
+        const std::vector<Type> types {
+            {VOCAB_PIXEL_RGB, 0, 2},
+            {VOCAB_PIXEL_BGR, 2, 0},
+            {VOCAB_PIXEL_RGBA, 0, 2},
+            {VOCAB_PIXEL_BGRA, 2, 0}
+        };
+        const std::vector<std::pair<size_t, size_t>> sizes {{1, 1}, {2, 2}, {5, 3}, {17, 5}, {33, 8}, {50, 70}};
+
+        auto expected = [](const FlexImage& src, const Bayer& bayer, bool edgeAware, size_t x, size_t y, int rgb[3]) {
+            const int w = static_cast<int>(src.width());
+            const int h = static_cast<int>(src.height());
+            auto at = [&](int px, int py) {
+                return static_cast<int>(*src.getPixelAddress(px, py));
+            };
+            auto average = [&](const std::vector<std::pair<int, int>>& offsets) {
+                int sum = 0;
+                int count = 0;
+                for (const auto& offset : offsets) {
+                    int px = static_cast<int>(x) + offset.first;
+                    int py = static_cast<int>(y) + offset.second;
+                    if (px >= 0 && py >= 0 && px < w && py < h) {
+                        sum += at(px, py);
+                        count++;
+                    }
+                }
+                return (count > 0) ? sum / count : 0;
+            };
+            const int cx = static_cast<int>(x);
+            const int cy = static_cast<int>(y);
+            int same;
+            int g;
+            int other;
+            if ((x + y) % 2 == bayer.goff) {
+                g = at(cx, cy);
+                same = average({{-1, 0}, {1, 0}});
+                other = average({{0, -1}, {0, 1}});
+            } else {
+                same = at(cx, cy);
+                g = average({{-1, 0}, {1, 0}, {0, -1}, {0, 1}});
+                other = average({{-1, -1}, {1, -1}, {-1, 1}, {1, 1}});
+                if (edgeAware && cx > 0 && cy > 0 && cx + 1 < w && cy + 1 < h) {
+                    int dh = std::abs(at(cx - 1, cy) - at(cx + 1, cy));
+                    int dv = std::abs(at(cx, cy - 1) - at(cx, cy + 1));
+                    if (dh < dv) {
+                        g = (at(cx - 1, cy) + at(cx + 1, cy)) / 2;
+                    } else if (dv < dh) {
+                        g = (at(cx, cy - 1) + at(cx, cy + 1)) / 2;
+                    }
+                }
+            }
+            bool red = (y % 2 == bayer.roff);
+            rgb[0] = red ? same : other;
+            rgb[1] = g;
+            rgb[2] = red ? other : same;
+        };
+
+        int mismatch = 0;
+        unsigned int seed = 1;
+        for (const auto& bayer : orders) {
+            for (const auto& size : sizes) {
+                FlexImage src;
+                src.setPixelCode(bayer.code);
+                src.resize(size.first, size.second);
+                for (size_t y = 0; y < src.height(); y++) {
+                    for (size_t x = 0; x < src.getRowSize(); x++) {
+                        seed = seed * 1103515245 + 12345;
+                        src.getRow(y)[x] = static_cast<unsigned char>(seed >> 16);
+                    }
+                }
+
+                // received by a port, bilinear
+                ImageOf<PixelRgb> rgbImage;
+                ImageOf<PixelBgr> bgrImage;
+                ImageOf<PixelRgba> rgbaImage;
+                ImageOf<PixelBgra> bgraImage;
+                const std::vector<Image*> received {&rgbImage, &bgrImage, &rgbaImage, &bgraImage};
+                for (size_t i = 0; i < types.size(); i++) {
+                    const Type& type = types[i];
+                    Image& dest = *received[i];
+                    CHECK(dest.getPixelCode() == type.code);
+                    CHECK(Portable::copyPortable(src, dest));
+                    CHECK(dest.width() == src.width());
+                    CHECK(dest.height() == src.height());
+                    for (size_t y = 0; y < dest.height(); y++) {
+                        for (size_t x = 0; x < dest.width(); x++) {
+                            int rgb[3];
+                            expected(src, bayer, false, x, y, rgb);
+                            const unsigned char* d = dest.getPixelAddress(x, y);
+                            if (d[type.r] != rgb[0] || d[1] != rgb[1] || d[type.b] != rgb[2] ||
+                                (dest.getPixelSize() == 4 && d[3] != 255)) {
+                                mismatch++;
+                            }
+                        }
+                    }
+                }
+
+                // both the methods, with more threads kept for both
+                yarp::sig::impl::DemosaicWorkers workers(3);
+                for (bool edgeAware : {false, true}) {
+                    ImageOf<PixelRgb> dest;
+                    dest.resize(src.width(), src.height());
+                    CHECK(yarp::sig::impl::demosaic(src.getRawImage(), src.getRowSize(),
+                                         dest.getRawImage(), dest.getRowSize(), VOCAB_PIXEL_RGB,
+                                         src.width(), src.height(), bayer.order,
+                                         edgeAware ? yarp::sig::impl::DemosaicMethod::EdgeAware : yarp::sig::impl::DemosaicMethod::Bilinear,
+                                         workers));
+                    for (size_t y = 0; y < dest.height(); y++) {
+                        for (size_t x = 0; x < dest.width(); x++) {
+                            int rgb[3];
+                            expected(src, bayer, edgeAware, x, y, rgb);
+                            const PixelRgb& d = dest.pixel(x, y);
+                            if (d.r != rgb[0] || d.g != rgb[1] || d.b != rgb[2]) {
+                                mismatch++;
+                            }
+                        }
+                    }
+                }
+
+                // half size, one pixel for each 2x2 cell
+                ImageOf<PixelBgra> half;
+                half.resize(src.width() / 2, src.height() / 2);
+                CHECK(yarp::sig::impl::demosaicHalf(src.getRawImage(), src.getRowSize(),
+                                         half.getRawImage(), half.getRowSize(), VOCAB_PIXEL_BGRA,
+                                         src.width(), src.height(), bayer.order, 3));
+                for (size_t y = 0; y < half.height(); y++) {
+                    for (size_t x = 0; x < half.width(); x++) {
+                        int rgb[3] = {0, 0, 0};
+                        int greens = 0;
+                        for (size_t i = 0; i < 4; i++) {
+                            size_t px = 2 * x + i % 2;
+                            size_t py = 2 * y + i / 2;
+                            int v = *src.getPixelAddress(px, py);
+                            if ((px + py) % 2 == bayer.goff) {
+                                rgb[1] += v;
+                                greens++;
+                            } else {
+                                rgb[(py % 2 == bayer.roff) ? 0 : 2] = v;
+                            }
+                        }
+                        const PixelBgra& d = half.pixel(x, y);
+                        if (greens != 2 || d.r != rgb[0] || d.g != rgb[1] / 2 || d.b != rgb[2] || d.a != 255) {
+                            mismatch++;
+                        }
+                    }
+                }
+            }
+        }
+        CHECK(mismatch == 0);
+    }
+
     SECTION("check origin.")
     {
 
@@ -579,6 +826,87 @@ TEST_CASE("sig::ImageTest", "[yarp::sig]")
         CHECK(img.height() == EXT_HEIGHT*2); // height check
     }
 
+    SECTION("check shared memory images.")
+    {
+        if (!yarp::os::SharedBufferPool::isAvailable()) {
+            YARP_SKIP_TEST("Shared memory is not available on this platform");
+        }
+
+        ImageOf<PixelRgb> img;
+        img.resize(EXT_WIDTH,EXT_HEIGHT);
+        img.pixel(1,2) = PixelRgb(10,20,30);
+        CHECK_FALSE(img.isSharedMemory());
+
+        img.setSharedMemory(true);
+        CHECK(img.isSharedMemory()); // allocated in shared memory
+        CHECK(img.pixel(1,2).g == 20); // content preserved
+
+        img.resize(EXT_WIDTH*2,EXT_HEIGHT*2);
+        CHECK(img.isSharedMemory()); // reallocated in shared memory
+
+        ImageOf<PixelRgb> img2;
+        img2.copy(img);
+        CHECK_FALSE(img2.isSharedMemory()); // copies use the heap
+
+        img.pixel(1,2) = PixelRgb(40,50,60);
+        img.setSharedMemory(false);
+        CHECK_FALSE(img.isSharedMemory());
+        CHECK(img.pixel(1,2).b == 60); // content preserved
+    }
+
+    SECTION("check image buffer pool.")
+    {
+        ImageBufferPool& pool = ImageBufferPool::getInstance();
+        size_t capacity = pool.getCapacity();
+        pool.setCapacity(ImageBufferPool::defaultCapacity);
+        pool.clear();
+        ImageBufferPool::Statistics before = pool.getStatistics();
+        CHECK(before.bytesCached == 0);
+
+        // a video stream: the frames are always the same size
+        for (int i = 0; i < 10; i++) {
+            ImageOf<PixelRgb> img;
+            img.resize(640, 480);
+            CHECK(reinterpret_cast<size_t>(img.getRawImage()) % ImageBufferPool::alignment == 0);
+            img.pixel(639, 479) = PixelRgb(1, 2, 3);
+            ImageOf<PixelMono> mono;
+            mono.resize(35, 7);
+            mono.pixel(34, 6) = 4;
+        }
+        ImageBufferPool::Statistics after = pool.getStatistics();
+        CHECK(after.allocations - before.allocations == 2); // first frame only
+        CHECK(after.reuses - before.reuses == 18); // then recycled
+        CHECK(after.bytesInUse == before.bytesInUse);
+        CHECK(after.bytesCached >= 640 * 480 * 3 + 35 * 7);
+
+        // resizing back and forth
+        ImageOf<PixelRgb> img;
+        img.resize(1920, 1080);
+        img.resize(640, 480);
+        img.resize(1920, 1080);
+        CHECK(pool.getStatistics().allocations - after.allocations == 1);
+        if (pool.getStatistics().bytesHugePages > 0) {
+            CHECK(reinterpret_cast<size_t>(img.getRawImage()) % ImageBufferPool::hugePageSize == 0);
+        }
+        img.pixel(1919, 1079) = PixelRgb(1, 2, 3);
+        CHECK(img.pixel(1919, 1079).b == 3);
+
+        // the memory kept for reuse is limited by the capacity
+        pool.setCapacity(640 * 480 * 3 * 2);
+        CHECK(pool.getStatistics().bytesCached <= 640 * 480 * 3 * 2);
+        img.resize(32, 32); // the large buffer doesn't fit
+        CHECK(pool.getStatistics().bytesCached <= 640 * 480 * 3 * 2);
+        pool.setCapacity(0);
+        CHECK(pool.getStatistics().bytesCached == 0);
+        size_t allocations = pool.getStatistics().allocations;
+        img.resize(16, 16);
+        img.resize(32, 32);
+        CHECK(pool.getStatistics().allocations - allocations == 2); // nothing kept
+        CHECK(pool.getStatistics().peakBytes >= 1920 * 1080 * 3);
+
+        pool.setCapacity(capacity);
+    }
+
     SECTION("readWrite test")
     {
         yarp::os::Network net;